@@ -0,0 +1,270 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    keypad.c                                       *
+*          Interrupt-scanned 4x4 keypad on Port A         *
+*---------------------------------------------------------*
+* Keypad_ISR is the only producer of the event queue and  *
+* the main program the only consumer, so neither side     *
+* needs to mask interrupts: each index is a single byte   *
+* written by one side only.                               *
+**********************************************************/
+
+#include "derivative.h"
+#include "keypad.h"
+#include "scheduler.h"
+
+#define TICK_TICKS  ((unsigned int)(KEYPAD_TIMER_HZ / 1000L * KEYPAD_TICK_US / 1000L))
+#define QUEUE_MASK  (KEYPAD_QUEUE_SIZE - 1)
+#define EVENT_DOWN  0x80            // queued as key | EVENT_DOWN
+
+// Drives one row high at a time, PA3 first
+static const unsigned char scanCode[4] = {0xF8, 0xF4, 0xF2, 0xF1};
+
+static const unsigned char *keyCodes;
+static unsigned char scanRow = 0;                   // row driven since the last tick
+static unsigned char rowColumns[4];                 // last reading of each row, bit n = column PA(4+n)
+static unsigned char keyCount[16];                  // scans a key has read differently from keysDown
+static volatile unsigned int keysDown = 0;          // debounced state, bit n = key n
+static unsigned char ghosted = 0;
+static volatile unsigned int keypadTicks = 0;       // KEYPAD_TICK_US periods since initializeKeypad(), wrapping
+
+static unsigned char keyQueue[KEYPAD_QUEUE_SIZE];
+static unsigned int keyTicks[KEYPAD_QUEUE_SIZE];
+static volatile unsigned char keyHead = 0;          // next free slot, written by Keypad_ISR
+static volatile unsigned char keyTail = 0;          // next event to read, written by the main program
+
+// Written by Keypad_ISR; keypadSequence changes on every tick so the main loop can copy them safely
+static volatile unsigned char keypadSequence = 0;
+static volatile unsigned long events = 0;
+static volatile unsigned int dropped = 0, bounces = 0, ghosts = 0;
+static volatile unsigned char queueMax = 0;
+
+// Scheduler task woken for every queued event
+static unsigned char keyTask = SCHEDULER_NO_TASK;
+static unsigned char keyTaskEvents = 0;
+
+/************************************************
+*   initializeKeypad                            *
+*                                               *
+*   Desc.: Sets up Port A and starts the scan   *
+*          on ECT channel 5. Needs interrupts   *
+*          enabled (CLI).                       *
+*   Inputs:  table - 16 key codes in scan       *
+*            order; keys with code 0 are still  *
+*            queued but getKeypress() skips     *
+*            them                               *
+*   Outputs: None                               *
+************************************************/
+
+void initializeKeypad(const unsigned char *table){
+    unsigned char i;
+
+    TIE_C5I = 0;
+    keyCodes = table;
+    for (i = 0; i < 16; i++)
+        keyCount[i] = 0;
+    for (i = 0; i < 4; i++)
+        rowColumns[i] = 0;
+    keysDown = 0;
+    ghosted = 0;
+    keypadTicks = 0;
+    keyHead = 0;
+    keyTail = 0;
+
+    DDRA = 0x0F;
+    scanRow = 0;
+    PORTA = scanCode[0];
+
+    TSCR1_TEN = 1;
+    TSCR2 = (TSCR2 & ~0x07) | KEYPAD_TIMER_PRESCALE;
+    TIOS_IOS5 = 1;                      // output compare, no pin action
+    TC5 = TCNT + TICK_TICKS;
+    TFLG1 = TFLG1_C5F_MASK;
+    TIE_C5I = 1;
+}
+
+/************************************************
+*   setKeypadTask                               *
+*                                               *
+*   Desc.: Has Keypad_ISR post events to a task *
+*          each time it queues a press or a     *
+*          release                              *
+*   Inputs:  task - From addTask(), or          *
+*            SCHEDULER_NO_TASK to stop          *
+*            events - Events to post            *
+*   Outputs: None                               *
+************************************************/
+
+void setKeypadTask(unsigned char task, unsigned char events){
+    keyTask = SCHEDULER_NO_TASK;        // not used by Keypad_ISR while half set
+    keyTaskEvents = events;
+    keyTask = task;
+}
+
+/************************************************
+*   getKeyEvent                                 *
+*                                               *
+*   Desc.: Takes the oldest press or release    *
+*          out of the queue. Never waits.       *
+*   Inputs:  event - Where to put it            *
+*   Outputs: 1 if there was one, 0 if not       *
+************************************************/
+
+unsigned char getKeyEvent(struct keyEvent *event){
+    unsigned char entry;
+
+    if (keyTail == keyHead)
+        return 0;
+    entry = keyQueue[keyTail];
+
+    event->key = entry & 0x0F;
+    event->code = keyCodes[event->key];
+    event->down = (entry & EVENT_DOWN) != 0;
+    event->ticks = keyTicks[keyTail];
+    keyTail = (keyTail + 1) & QUEUE_MASK;
+    return 1;
+}
+
+/************************************************
+*   getKeypress                                 *
+*                                               *
+*   Desc.: A whole keystroke: the code of the   *
+*          next key released, as the labs act   *
+*          on the release. Presses, and keys    *
+*          with code 0, are passed over.        *
+*   Inputs:  None                               *
+*   Outputs: Key code, 0 if none is waiting     *
+************************************************/
+
+unsigned char getKeypress(void){
+    struct keyEvent event;
+
+    while (getKeyEvent(&event))
+        if (!event.down && event.code != 0)
+            return event.code;
+    return 0;
+}
+
+unsigned int getKeysDown(void){
+    return keysDown;
+}
+
+// A time base for the main loop, e.g. for the gap between two keystrokes; one tick is KEYPAD_TICK_US
+unsigned int getKeypadTicks(void){
+    return keypadTicks;
+}
+
+/************************************************
+*   getKeypadStats                              *
+*                                               *
+*   Desc.: Copies the scan counters             *
+*   Inputs:  stats - Where to copy them         *
+*   Outputs: None                               *
+************************************************/
+
+void getKeypadStats(struct keypadStats *stats){
+    unsigned char sequence;
+
+    do {
+        sequence = keypadSequence;
+        stats->events = events;
+        stats->dropped = dropped;
+        stats->bounces = bounces;
+        stats->ghosts = ghosts;
+        stats->queueMax = queueMax;
+    } while (sequence != keypadSequence);
+}
+
+/************************************************
+*   isGhosted                                   *
+*                                               *
+*   Desc.: Rows are driven push-pull, so two    *
+*          keys in one column short a high row  *
+*          to a low one, and three keys on the  *
+*          corners of a rectangle can make the  *
+*          fourth read as pressed. Any pattern  *
+*          with two rows sharing two columns    *
+*          may be such a phantom.               *
+*   Inputs:  None                               *
+*   Outputs: 1 if the matrix is ambiguous       *
+************************************************/
+
+static unsigned char isGhosted(void){
+    unsigned char i, j, shared;
+
+    for (i = 0; i < 3; i++)
+        for (j = i + 1; j < 4; j++){
+            shared = rowColumns[i] & rowColumns[j];
+            if (shared & (shared - 1))
+                return 1;
+        }
+    return 0;
+}
+
+/************************************************
+*   Keypad_ISR                                  *
+*                                               *
+*   Desc.: Reads the row driven on the last     *
+*          tick, which has had a whole tick to  *
+*          settle, then drives the next one.    *
+*          While the matrix is ambiguous no new *
+*          press is accepted, but releases are, *
+*          so any keys without a phantom still  *
+*          roll over.                           *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void interrupt VectorNumber_Vtimch5 Keypad_ISR(void){
+    unsigned char columns, column, key, depth, pressed;
+    unsigned int mask;
+
+    TC5 = TC5 + TICK_TICKS;
+    TFLG1 = TFLG1_C5F_MASK;
+    keypadTicks++;
+
+    columns = (PORTA >> 4) & 0x0F;
+    rowColumns[scanRow] = columns;
+    if (isGhosted()){
+        if (!ghosted)
+            ghosts++;
+        ghosted = 1;
+    }
+    else
+        ghosted = 0;
+
+    key = scanRow << 2;
+    for (column = 0; column < 4; column++, key++){
+        mask = 1U << key;
+        pressed = (columns >> column) & 1;
+        if (pressed == ((keysDown & mask) != 0) || (pressed && ghosted)){
+            if (keyCount[key] != 0)
+                bounces++;
+            keyCount[key] = 0;
+            continue;
+        }
+        if (++keyCount[key] < KEYPAD_DEBOUNCE_SCANS)
+            continue;
+
+        keyCount[key] = 0;
+        keysDown ^= mask;
+        events++;
+        depth = (keyHead - keyTail) & QUEUE_MASK;
+        if (depth == QUEUE_MASK)
+            dropped++;
+        else{
+            keyQueue[keyHead] = pressed ? (key | EVENT_DOWN) : key;
+            keyTicks[keyHead] = keypadTicks;
+            keyHead = (keyHead + 1) & QUEUE_MASK;
+            if (depth + 1 > queueMax)
+                queueMax = depth + 1;
+            if (keyTask != SCHEDULER_NO_TASK)
+                postEvent(keyTask, keyTaskEvents);
+        }
+    }
+
+    scanRow = (scanRow + 1) & 0x03;
+    PORTA = scanCode[scanRow];
+    keypadSequence++;
+}
\ No newline at end of file
@@ -0,0 +1,693 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    ringlink.c                                     *
+*          Timer-clocked link layer for the Lab 7 ring    *
+*---------------------------------------------------------*
+* Sending: ECT channel 3 interrupts every half bit and    *
+* steps SCL/SDA on RING_OUT, so a frame costs a few       *
+* instructions per edge instead of a busy wait.           *
+* Receiving: PT0 (SCL) and PT1 (SDA) are the ECT input    *
+* capture pins 0 and 1; a rising SCL shifts in one bit,   *
+* and an SDA edge while SCL is high is a start or stop.   *
+* The ACK line is a one-wire return channel clocked by    *
+* the sender's SCL: idle high, then two 0 start bits, an *
+* 8 bit code and a 1 stop bit. The code is RING_ACK|seq   *
+* (everything up to seq arrived) or RING_NAK|seq (resend  *
+* from seq), sent once as is and once inverted. Lost or   *
+* damaged frames are resent go-back-N style.              *
+* Both directions are store-and-forward queues: frames    *
+* wait in the outbound queue until they fit in the        *
+* window, and received frames wait in the inbound queue   *
+* until the main loop gets to them.                       *
+**********************************************************/
+
+#include "derivative.h"
+#include "ringlink.h"
+#include "scheduler.h"
+#include "timebase.h"
+
+// Pin mapping for input and output
+#define RING_OUT_SCL    PORTB_BIT0
+#define RING_OUT_SDA    PORTB_BIT1
+#define RING_OUT_ACK    PORTB_BIT2
+
+#define RING_IN_SCL     PTT_PTT0
+#define RING_IN_SDA     PTT_PTT1
+#define RING_IN_ACK     PTT_PTT2
+
+// Return channel codes; the low 3 bits carry the sequence number. On the wire the 4 bit code is
+// followed by its complement, so one flipped bit cannot turn into a different acknowledgement.
+#define RING_ACK        0x08
+#define RING_NAK        0x00
+
+// Sender states, one step per half bit
+#define TX_IDLE         0   // SCL = SDA = 1, between frames
+#define TX_POLL         1   // SCL low while idle, to clock in the return channel
+#define TX_LOW          2   // SCL 1->0, next data bit onto SDA
+#define TX_HIGH         3   // SCL 0->1, the receiver samples SDA
+#define TX_END_LOW      4
+#define TX_END_HIGH     5
+#define TX_STOP         6   // SDA 0->1 with SCL high
+
+// Receiver states
+#define RX_IDLE         0
+#define RX_FRAME        1
+#define RX_DISCARD      2   // too long; wait for the stop condition
+
+// CRC-16/CCITT, one nibble at a time
+static const unsigned int crcTable[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+// Outbound queue, CRC excluded. The indexes count frames modulo 256; slot (index % RING_TX_QUEUE) holds the
+// frame and (index % 8) is its sequence number on the wire. Only txBase..txBase+RING_WINDOW-1 may be sent.
+static unsigned char txFrames[RING_TX_QUEUE][RING_HEADER + RING_MAX_PAYLOAD];
+static unsigned long txArrived[RING_TX_QUEUE];     // when a forwarded frame reached this node
+static unsigned char txForwarded[RING_TX_QUEUE];
+static volatile unsigned char txHead = 0;   // next free slot (main loop only)
+static volatile unsigned char txBase = 0;   // oldest frame not yet acknowledged
+static unsigned char txNext = 0;            // next frame to put on the wire
+static unsigned char txSent = 0;            // one past the newest frame that has been on the wire
+static unsigned char txSync = 1;            // the next node has not yet accepted anything from us
+static unsigned char txRewind = 0;
+static unsigned char txState = TX_IDLE;
+static unsigned char *txFrame;
+static unsigned char txIndex, txLength, txShift, txBits;
+static unsigned int txCrc;
+static unsigned int ackTimer = 0, retries = 0;
+static unsigned char ackIn, ackInBits = 0;
+
+// Inbound queue. Slot (rxHead % RING_RX_QUEUE) is the one being filled, so it never holds a waiting frame.
+static unsigned char rxFrames[RING_RX_QUEUE][RING_FRAME_MAX];
+static unsigned long rxArrived[RING_RX_QUEUE];
+static volatile unsigned char rxHead = 0;   // receive interrupt only
+static volatile unsigned char rxTail = 0;   // main loop only
+static unsigned char rxState = RX_IDLE;
+static unsigned char rxCount, rxShift, rxBits;
+static unsigned int rxCrc;
+static unsigned char rxExpected = 0;
+static unsigned char ackOut, ackOutBits = 0, ackOutPending = 0, ackOutCode;
+
+// Statistics; ringSequence changes at the end of every ring interrupt so the main loop can copy them safely
+static volatile unsigned char ringSequence = 0;
+static unsigned long framesSent = 0, framesAcked = 0, framesReceived = 0;
+static unsigned int resends = 0, framesDropped = 0, crcErrors = 0, rxOverruns = 0;
+static unsigned int txBytes = 0, rxBytes = 0, txBytesPerSecond = 0, rxBytesPerSecond = 0;
+static unsigned long rateTicks = 0;
+static volatile unsigned int overflows = 0;
+static unsigned char txDepthMax = 0, rxDepthMax = 0;
+static unsigned long framesForwarded = 0, forwardTotal = 0, forwardMax = 0;
+
+// Scheduler task woken when a frame arrives or outbound slots are freed
+static unsigned char ringTask = SCHEDULER_NO_TASK;
+static unsigned char ringTaskEvents = 0;
+
+// crc is unsigned short so the shifts drop the top nibble also where int is wider than 16 bits (host builds)
+static unsigned int crcByte(unsigned short crc, unsigned char b){
+    crc = (crc << 4) ^ crcTable[(crc >> 12) ^ (b >> 4)];
+    crc = (crc << 4) ^ crcTable[(crc >> 12) ^ (b & 0x0F)];
+    return crc;
+}
+
+// Microseconds since initializeRing(), wrapping after 71 minutes. Also right inside an interrupt, where an
+// overflow may be pending but not yet counted.
+static unsigned long ringTime(void){
+    unsigned int high, low;
+
+    do {
+        high = overflows;
+        low = TCNT;
+    } while (high != overflows);
+    if (TFLG2_TOF && low < 0x8000)
+        high++;
+    return ((unsigned long)high << 16) | low;
+}
+
+/************************************************
+*   ringOverflow                                *
+*                                               *
+*   Desc.: TCNT overflow, every 65536 ticks,    *
+*          called from Timebase_ISR. Latches    *
+*          the payload byte counts once a       *
+*          second has gone by.                  *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+static void ringOverflow(void){
+    overflows++;
+    rateTicks += 65536L;
+    if (rateTicks >= RING_TIMER_HZ){
+        rateTicks -= RING_TIMER_HZ;
+        txBytesPerSecond = txBytes;
+        rxBytesPerSecond = rxBytes;
+        txBytes = 0;
+        rxBytes = 0;
+    }
+    ringSequence++;
+}
+
+/************************************************
+*   initializeRing                              *
+*                                               *
+*   Desc.: Sets up the ring pins, ECT channels  *
+*          0, 1 and 3 and the overflow count    *
+*          used for the byte rates, which the   *
+*          timebase passes on. Needs interrupts *
+*          enabled (CLI) afterwards.            *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void initializeRing(void){
+    TIE &= ~(TIE_C0I_MASK | TIE_C1I_MASK | TIE_C3I_MASK);
+
+    // PB0 (SCL), PB1 (SDA) out, PB2 (ACK) in; PT0 (SCL), PT1 (SDA) in, PT2 (ACK) out
+    DDRB = (DDRB & ~0x04) | 0x03;
+    DDRT = (DDRT & ~0x03) | 0x04;
+    RING_OUT_SCL = 1;
+    RING_OUT_SDA = 1;
+    RING_IN_ACK = 1;
+
+    TSCR1_TEN = 1;
+    TSCR2 = (TSCR2 & ~0x07) | RING_TIMER_PRESCALE;
+    TIOS = (TIOS & ~(TIOS_IOS0_MASK | TIOS_IOS1_MASK | TIOS_IOS2_MASK)) | TIOS_IOS3_MASK;
+    TCTL4 = (TCTL4 & 0xF0) | 0x0D;      // capture rising edges on PT0, both edges on PT1
+    TFLG1 = TFLG1_C0F_MASK | TFLG1_C1F_MASK | TFLG1_C3F_MASK;
+
+    txState = TX_IDLE;
+    rxState = RX_IDLE;
+    rxHead = rxTail = 0;
+    initializeTimebase();
+    addTimebaseListener(ringOverflow);
+    TIE |= TIE_C0I_MASK | TIE_C1I_MASK;
+}
+
+/************************************************
+*   setRingTask                                 *
+*                                               *
+*   Desc.: Has the receive and send interrupts  *
+*          post events to a task when a frame   *
+*          is queued for readRingFrame() and    *
+*          when acknowledged frames free room   *
+*          for queueRingFrame() and             *
+*          forwardRingFrame()                   *
+*   Inputs:  task - From addTask(), or          *
+*            SCHEDULER_NO_TASK to stop          *
+*            events - Events to post            *
+*   Outputs: None                               *
+************************************************/
+
+void setRingTask(unsigned char task, unsigned char events){
+    ringTask = SCHEDULER_NO_TASK;       // not used by the interrupts while half set
+    ringTaskEvents = events;
+    ringTask = task;
+}
+
+// Makes the newest outbound slot part of the queue and starts the bit clock if it is stopped
+static void commitTxFrame(void){
+    unsigned char depth;
+
+    txHead++;
+    depth = (unsigned char)(txHead - txBase);
+    if (depth > txDepthMax)
+        txDepthMax = depth;
+
+    // The channel 3 interrupt switches itself off once everything is acknowledged
+    if (!TIE_C3I){
+        TC3 = TCNT + RING_HALF_BIT_US;
+        TFLG1 = TFLG1_C3F_MASK;
+        TIE_C3I = 1;
+    }
+}
+
+/************************************************
+*   queueRingFrame                              *
+*                                               *
+*   Desc.: Adds a frame to the outbound queue.  *
+*          Returns at once.                     *
+*   Inputs:  len - Payload length               *
+*            rec, sender - Header bytes         *
+*            buf - Payload                      *
+*   Outputs: RING_SUCCESS, or RING_FAILURE if   *
+*            the queue is full or len is too    *
+*            long                               *
+************************************************/
+
+int queueRingFrame(unsigned char len, unsigned char rec, unsigned char sender, unsigned char *buf){
+    unsigned char slot = txHead & (RING_TX_QUEUE - 1);
+    unsigned char *frame = txFrames[slot];
+    int i;
+
+    if (len > RING_MAX_PAYLOAD || (unsigned char)(txHead - txBase) >= RING_TX_QUEUE)
+        return RING_FAILURE;
+
+    frame[1] = len;
+    frame[2] = rec;
+    frame[3] = sender;
+    for (i = 0; i < len; i++)
+        frame[RING_HEADER + i] = buf[i];
+    txForwarded[slot] = 0;
+    commitTxFrame();
+    return RING_SUCCESS;
+}
+
+/************************************************
+*   forwardRingFrame                            *
+*                                               *
+*   Desc.: Moves the oldest inbound frame to    *
+*          the outbound queue as it is, for the *
+*          next node. Its time from arrival to  *
+*          acknowledgement downstream counts in *
+*          the forward latency.                 *
+*   Inputs:  None                               *
+*   Outputs: RING_SUCCESS, or RING_FAILURE if   *
+*            nothing is waiting or the outbound *
+*            queue is full (try again later)    *
+************************************************/
+
+int forwardRingFrame(void){
+    unsigned char slot = txHead & (RING_TX_QUEUE - 1);
+    unsigned char *from, *to = txFrames[slot];
+    int i, n;
+
+    if (rxHead == rxTail || (unsigned char)(txHead - txBase) >= RING_TX_QUEUE)
+        return RING_FAILURE;
+
+    from = rxFrames[rxTail & (RING_RX_QUEUE - 1)];
+    n = from[1] + RING_HEADER;
+    for (i = 1; i < n; i++)
+        to[i] = from[i];
+    txArrived[slot] = rxArrived[rxTail & (RING_RX_QUEUE - 1)];
+    txForwarded[slot] = 1;
+    rxTail++;
+    commitTxFrame();
+    return RING_SUCCESS;
+}
+
+int getRingQueueFree(void){
+    return RING_TX_QUEUE - (unsigned char)(txHead - txBase);
+}
+
+int isRingFrameWaiting(void){
+    return rxHead != rxTail;
+}
+
+/************************************************
+*   peekRingFrame                               *
+*                                               *
+*   Desc.: Reads the header of the oldest       *
+*          inbound frame, leaving it queued     *
+*   Inputs:  len, rec, sender - Header fields   *
+*   Outputs: RING_SUCCESS, or RING_FAILURE if   *
+*            nothing is waiting                 *
+************************************************/
+
+int peekRingFrame(unsigned char *len, unsigned char *rec, unsigned char *sender){
+    unsigned char *frame;
+
+    if (rxHead == rxTail)
+        return RING_FAILURE;
+
+    frame = rxFrames[rxTail & (RING_RX_QUEUE - 1)];
+    *len = frame[1];
+    *rec = frame[2];
+    *sender = frame[3];
+    return RING_SUCCESS;
+}
+
+/************************************************
+*   readRingFrame                               *
+*                                               *
+*   Desc.: Takes the oldest inbound frame off   *
+*          the queue                            *
+*   Inputs:  len, rec, sender - Header fields   *
+*            buf - Payload, room for            *
+*                  RING_MAX_PAYLOAD bytes       *
+*   Outputs: RING_SUCCESS, or RING_FAILURE if   *
+*            nothing is waiting                 *
+************************************************/
+
+int readRingFrame(unsigned char *len, unsigned char *rec, unsigned char *sender, unsigned char *buf){
+    unsigned char *frame;
+    int i;
+
+    if (rxHead == rxTail)
+        return RING_FAILURE;
+
+    frame = rxFrames[rxTail & (RING_RX_QUEUE - 1)];
+    *len = frame[1];
+    *rec = frame[2];
+    *sender = frame[3];
+    for (i = 0; i < frame[1]; i++)
+        buf[i] = frame[RING_HEADER + i];
+    rxTail++;
+    return RING_SUCCESS;
+}
+
+/************************************************
+*   getRingStats                                *
+*                                               *
+*   Desc.: Copies the link counters             *
+*   Inputs:  stats - Where to copy them         *
+*   Outputs: None                               *
+************************************************/
+
+void getRingStats(struct ringStats *stats){
+    unsigned char sequence;
+    unsigned long total;
+
+    do {
+        sequence = ringSequence;
+        stats->framesSent = framesSent;
+        stats->framesAcked = framesAcked;
+        stats->framesReceived = framesReceived;
+        stats->resends = resends;
+        stats->framesDropped = framesDropped;
+        stats->crcErrors = crcErrors;
+        stats->rxOverruns = rxOverruns;
+        stats->txBytesPerSecond = txBytesPerSecond;
+        stats->rxBytesPerSecond = rxBytesPerSecond;
+        stats->txQueueDepth = (unsigned char)(txHead - txBase);
+        stats->txQueueMax = txDepthMax;
+        stats->rxQueueDepth = (unsigned char)(rxHead - rxTail);
+        stats->rxQueueMax = rxDepthMax;
+        stats->framesForwarded = framesForwarded;
+        stats->forwardLatencyMax = forwardMax;
+        total = forwardTotal;
+    } while (sequence != ringSequence);
+
+    stats->forwardLatencyMean = stats->framesForwarded ? total / stats->framesForwarded : 0;
+}
+
+// The oldest frame is done with (acknowledged or given up on); its slot is free for queueRingFrame()
+static void releaseBase(void){
+    if (txNext == txBase)
+        txNext++;
+    if (txSent == txBase)
+        txSent++;
+    txBase++;
+}
+
+// Acknowledgements are cumulative: RING_ACK|s releases every frame up to and including s,
+// RING_NAK|s releases those before s and asks for a resend from s.
+static void handleAck(unsigned char code){
+    unsigned char n, slot;
+    unsigned long latency;
+
+    if ((code >> 4) != (~code & 0x0F))
+        return;
+    code >>= 4;
+    if (code & RING_ACK)
+        n = ((code - txBase) & RING_SEQ_MASK) + 1;
+    else{
+        n = (code - txBase) & RING_SEQ_MASK;
+        txRewind = 1;
+    }
+    // Noise on the ACK line can still fake a code, but never one for a frame that was not sent yet
+    if (n == 0 || n > (unsigned char)(txSent - txBase))
+        return;
+
+    while (n--){
+        slot = txBase & (RING_TX_QUEUE - 1);
+        txBytes += txFrames[slot][1];
+        framesAcked++;
+        if (txForwarded[slot]){
+            latency = ringTime() - txArrived[slot];
+            framesForwarded++;
+            forwardTotal += latency;
+            if (latency > forwardMax)
+                forwardMax = latency;
+        }
+        releaseBase();
+    }
+    ackTimer = 0;
+    retries = 0;
+    txSync = 0;
+    if (ringTask != SCHEDULER_NO_TASK)
+        postEvent(ringTask, ringTaskEvents);
+}
+
+// Called on every SCL 1->0: the receiver has had half a bit to put its next return bit out
+static void sampleAck(void){
+    unsigned char bit = RING_OUT_ACK;
+
+    if (ackInBits == 0){
+        if (bit == 0)
+            ackInBits = 10;             // first start bit
+    }
+    else if (ackInBits == 10)
+        ackInBits = bit ? 0 : 9;        // a lone 0 is noise, not a start
+    else if (--ackInBits != 0)
+        ackIn = (ackIn << 1) | bit;
+    else if (bit)
+        handleAck(ackIn);               // only with a good stop bit
+}
+
+static void loadTxByte(void){
+    if (txIndex < txLength){
+        txShift = txFrame[txIndex];
+        txCrc = crcByte(txCrc, txShift);
+    }
+    else if (txIndex == txLength)
+        txShift = (unsigned char)(txCrc >> 8);
+    else
+        txShift = (unsigned char)txCrc;
+    txBits = 8;
+}
+
+// Between frames: give up on, resend or start a frame, keep clocking for the return channel, or stop
+static void startNext(void){
+    if (txBase != txHead && ackTimer >= RING_ACK_TIMEOUT){
+        ackTimer = 0;
+        txRewind = 1;
+        if (++retries > RING_MAX_RETRIES){
+            retries = 0;
+            releaseBase();
+            framesDropped++;
+            txSync = 1;
+            if (ringTask != SCHEDULER_NO_TASK)
+                postEvent(ringTask, ringTaskEvents);
+        }
+    }
+    if (txRewind){
+        txRewind = 0;
+        if (txNext != txBase){
+            txNext = txBase;
+            resends++;
+        }
+    }
+
+    if (txNext != txHead && (unsigned char)(txNext - txBase) < RING_WINDOW){
+        txFrame = txFrames[txNext & (RING_TX_QUEUE - 1)];
+        txFrame[0] = txNext & RING_SEQ_MASK;
+        if (txSync && txNext == txBase)
+            txFrame[0] |= RING_SEQ_SYNC;
+        txLength = txFrame[1] + RING_HEADER;
+        txIndex = 0;
+        txCrc = 0xFFFF;
+        loadTxByte();
+        if ((unsigned char)(txNext - txBase) >= (unsigned char)(txSent - txBase))
+            txSent = txNext + 1;
+        txNext++;
+        RING_OUT_SDA = 0;               // start condition: SDA 1->0 with SCL high
+        txState = TX_LOW;
+    }
+    else if (txBase != txHead || ackInBits != 0){
+        RING_OUT_SCL = 0;
+        sampleAck();
+        txState = TX_POLL;
+    }
+    else
+        TIE_C3I = 0;
+}
+
+/************************************************
+*   RingSend_ISR                                *
+*                                               *
+*   Desc.: One clock edge of the outgoing link  *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void interrupt VectorNumber_Vtimch3 RingSend_ISR(void){
+    TC3 = TC3 + RING_HALF_BIT_US;
+    TFLG1 = TFLG1_C3F_MASK;
+    if (txBase != txHead)
+        ackTimer++;
+
+    switch (txState){
+        case TX_IDLE:
+            startNext();
+            break;
+        case TX_POLL:
+            RING_OUT_SCL = 1;
+            txState = TX_IDLE;
+            break;
+        case TX_LOW:
+            RING_OUT_SCL = 0;
+            sampleAck();
+            RING_OUT_SDA = (txShift & 0x80) ? 1 : 0;
+            txShift <<= 1;
+            txState = TX_HIGH;
+            break;
+        case TX_HIGH:
+            RING_OUT_SCL = 1;
+            txState = TX_LOW;
+            if (--txBits == 0){
+                if (++txIndex < txLength + 2)
+                    loadTxByte();
+                else
+                    txState = TX_END_LOW;
+            }
+            break;
+        case TX_END_LOW:
+            RING_OUT_SCL = 0;
+            sampleAck();
+            RING_OUT_SDA = 0;
+            txState = TX_END_HIGH;
+            break;
+        case TX_END_HIGH:
+            RING_OUT_SCL = 1;
+            txState = TX_STOP;
+            break;
+        case TX_STOP:
+            RING_OUT_SDA = 1;           // stop condition: SDA 0->1 with SCL high
+            framesSent++;
+            txState = TX_IDLE;
+            break;
+    }
+
+    // A late edge only stretches the bit, but never let the compare fall a whole TCNT wrap behind
+    if ((short)(TC3 - TCNT) <= 0)
+        TC3 = TCNT + RING_HALF_BIT_US;
+    ringSequence++;
+}
+
+// The newest code wins: they are cumulative, so an older one that never went out is not needed
+static void sendAck(unsigned char code){
+    ackOutCode = (code << 4) | (~code & 0x0F);
+    ackOutPending = 1;
+}
+
+static void endFrame(void){
+    unsigned char *frame = rxFrames[rxHead & (RING_RX_QUEUE - 1)];
+    unsigned char seq, depth;
+
+    rxState = RX_IDLE;
+    if (rxCount < RING_HEADER + 2 || frame[1] > RING_MAX_PAYLOAD || rxCount != frame[1] + RING_HEADER + 2
+        || rxCrc != 0){
+        crcErrors++;
+        sendAck(RING_NAK | rxExpected);
+        return;
+    }
+
+    seq = frame[0] & RING_SEQ_MASK;
+    if (seq == ((rxExpected - 1) & RING_SEQ_MASK)){
+        sendAck(RING_ACK | seq);        // a resend of the last frame we took: its ACK was lost
+        return;
+    }
+    if (seq != rxExpected && !(frame[0] & RING_SEQ_SYNC)){
+        sendAck(RING_NAK | rxExpected); // a frame in between was lost
+        return;
+    }
+    depth = (unsigned char)(rxHead - rxTail) + 1;
+    if (depth >= RING_RX_QUEUE){
+        rxOverruns++;                   // no ACK: the sender times out and tries again
+        return;
+    }
+
+    rxArrived[rxHead & (RING_RX_QUEUE - 1)] = ringTime();
+    rxHead++;
+    if (depth > rxDepthMax)
+        rxDepthMax = depth;
+    rxExpected = (seq + 1) & RING_SEQ_MASK;
+    framesReceived++;
+    rxBytes += frame[1];
+    sendAck(RING_ACK | seq);
+    if (ringTask != SCHEDULER_NO_TASK)
+        postEvent(ringTask, ringTaskEvents);
+}
+
+/************************************************
+*   RingClock_ISR                               *
+*                                               *
+*   Desc.: SCL 0->1 on RING_IN: shifts in one   *
+*          data bit and puts out the next       *
+*          return channel bit                   *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void interrupt VectorNumber_Vtimch0 RingClock_ISR(void){
+    TFLG1 = TFLG1_C0F_MASK;
+
+    if (rxState == RX_FRAME){
+        rxShift = (rxShift << 1) | (RING_IN_SDA ? 1 : 0);
+        if (++rxBits == 8){
+            rxBits = 0;
+            if (rxCount < RING_FRAME_MAX){
+                rxFrames[rxHead & (RING_RX_QUEUE - 1)][rxCount++] = rxShift;
+                rxCrc = crcByte(rxCrc, rxShift);
+            }
+            else
+                rxState = RX_DISCARD;
+        }
+    }
+
+    if (ackOutBits == 10){
+        RING_IN_ACK = 0;                // second start bit
+        ackOutBits--;
+    }
+    else if (ackOutBits != 0){
+        RING_IN_ACK = (ackOutBits == 1 || (ackOut & 0x80)) ? 1 : 0;    // 8 code bits, then the stop bit
+        ackOut <<= 1;
+        ackOutBits--;
+    }
+    else if (ackOutPending){
+        ackOut = ackOutCode;
+        ackOutPending = 0;
+        ackOutBits = 10;
+        RING_IN_ACK = 0;                // first start bit
+    }
+    else
+        RING_IN_ACK = 1;
+    ringSequence++;
+}
+
+/************************************************
+*   RingData_ISR                                *
+*                                               *
+*   Desc.: SDA edge on RING_IN. Only a change   *
+*          while SCL is high means anything:    *
+*          1->0 starts a frame, 0->1 ends it.   *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void interrupt VectorNumber_Vtimch1 RingData_ISR(void){
+    TFLG1 = TFLG1_C1F_MASK;
+    if (RING_IN_SCL == 0)
+        return;
+
+    // A glitch on SDA looks the same, so a start is only taken outside a frame, and a stop only right
+    // after the extra clock that follows the last byte. If a real stop is missed, that frame and the
+    // next one fail the CRC and are resent.
+    if (RING_IN_SDA == 0){
+        if (rxState != RX_FRAME){
+            rxState = RX_FRAME;
+            rxCount = 0;
+            rxBits = 0;
+            rxCrc = 0xFFFF;
+        }
+    }
+    else if (rxState == RX_FRAME){
+        if (rxBits == 1)
+            endFrame();
+    }
+    else
+        rxState = RX_IDLE;
+    ringSequence++;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    ringlink.h                                     *
+*          Timer-clocked link layer for the Lab 7 ring    *
+*---------------------------------------------------------*
+* Replaces the bit-banged sendChar()/recieveChar() pair.  *
+* Frames go out on RING_OUT with a start condition, a     *
+* 4 byte header, the payload, a CRC-16 and a stop         *
+* condition. The next node answers on the ACK line,       *
+* clocked by our own SCL, so up to RING_WINDOW frames can *
+* be in flight before the first one is acknowledged.      *
+* Frames to send and frames received wait in queues, so   *
+* the main loop never has to block on the link, and       *
+* setRingTask() can wake a scheduler task for it.         *
+**********************************************************/
+
+#ifndef _RINGLINK_H
+#define _RINGLINK_H
+
+// Bit clock. TCNT runs at 1MHz (8MHz bus / 8); SCL changes every RING_HALF_BIT_US, i.e. 12.5kbit/s.
+// The receiving node has half a bit to answer each edge, so this also bounds its interrupt latency.
+#define RING_TIMER_PRESCALE 3
+#define RING_TIMER_HZ       1000000L
+#define RING_HALF_BIT_US    40
+
+// Frame format: [seq] [length] [recipient] [sender] [payload...] [CRC high] [CRC low]
+// The CRC is CRC-16/CCITT (0x1021, preset 0xFFFF) over everything before it.
+#define RING_HEADER         4
+#define RING_MAX_PAYLOAD    16
+#define RING_FRAME_MAX      (RING_HEADER + RING_MAX_PAYLOAD + 2)
+
+// Sequence numbers run modulo 8, so at most 7 frames could be outstanding; 4 is plenty for a 9 byte message
+#define RING_SEQ_MASK       0x07
+#define RING_SEQ_SYNC       0x80    // set in [seq]: receiver takes this number as the next one expected
+#define RING_WINDOW         4
+
+// Queue sizes in frames, powers of two. The outbound queue includes the window; one inbound slot is always
+// the one being received into, so RING_RX_QUEUE - 1 frames can wait for the main loop.
+#define RING_TX_QUEUE       8
+#define RING_RX_QUEUE       8
+
+// Go back and resend everything unacknowledged after this many half bits (24ms, longer than a full-length
+// frame plus its ACK) without progress, and drop the oldest frame after this many resends in a row
+// (the next node is missing or not listening)
+#define RING_ACK_TIMEOUT    600
+#define RING_MAX_RETRIES    20
+
+// Return results
+#define RING_SUCCESS        0
+#define RING_FAILURE        -1
+
+struct ringStats {
+    unsigned long framesSent;       // including resends
+    unsigned long framesAcked;
+    unsigned long framesReceived;   // accepted in order and handed to readRingFrame()
+    unsigned int resends;           // go-back events after a timeout or NAK
+    unsigned int framesDropped;     // given up after RING_MAX_RETRIES
+    unsigned int crcErrors;
+    unsigned int rxOverruns;        // a good frame arrived before the last one was read; left unacknowledged
+    unsigned int txBytesPerSecond;  // payload bytes acknowledged by the next node during the last second
+    unsigned int rxBytesPerSecond;  // payload bytes accepted from the previous node during the last second
+    unsigned char txQueueDepth;     // frames in the outbound queue, including those in flight
+    unsigned char txQueueMax;
+    unsigned char rxQueueDepth;     // frames waiting for the main loop
+    unsigned char rxQueueMax;
+    unsigned long framesForwarded;
+    unsigned long forwardLatencyMean;   // us from arriving here to being acknowledged by the next node
+    unsigned long forwardLatencyMax;
+};
+
+// Function prototypes - tell the compiler that these functions exist somewhere
+void initializeRing(void);
+void setRingTask(unsigned char task, unsigned char events);
+int queueRingFrame(unsigned char len, unsigned char rec, unsigned char sender, unsigned char *buf);
+int forwardRingFrame(void);
+int getRingQueueFree(void);
+int isRingFrameWaiting(void);
+int peekRingFrame(unsigned char *len, unsigned char *rec, unsigned char *sender);
+int readRingFrame(unsigned char *len, unsigned char *rec, unsigned char *sender, unsigned char *buf);
+void getRingStats(struct ringStats *stats);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,179 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    textentry.c                                    *
+*          Multi-tap text entry on the keypad             *
+*---------------------------------------------------------*
+* The buffer always holds what the LCD shows, including   *
+* the character still being chosen, so committing it      *
+* costs no display write at all.                          *
+**********************************************************/
+
+#include "advancedLCD.h"
+#include "textentry.h"
+
+/************************************************
+*   isAllowed                                   *
+*                                               *
+*   Desc.: Checks a character against the       *
+*          entry's allowed set                  *
+*   Inputs:  text - Entry                       *
+*            c - Character                      *
+*   Outputs: 1 if it may be typed               *
+************************************************/
+
+static unsigned char isAllowed(const struct textEntry *text, char c){
+    const char *a = text->allowed;
+
+    if (!a)
+        return 1;
+    while (*a)
+        if (*a++ == c)
+            return 1;
+    return 0;
+}
+
+/************************************************
+*   nextGlyph                                   *
+*                                               *
+*   Desc.: Finds the next allowed character of  *
+*          a key after 'from', wrapping around  *
+*   Inputs:  text - Entry                       *
+*            glyphs - The key's characters      *
+*            from - Index to start after, or    *
+*                   TEXT_NO_KEY for the first   *
+*   Outputs: Its index, or TEXT_NO_KEY if the   *
+*            key has none                       *
+************************************************/
+
+static unsigned char nextGlyph(const struct textEntry *text, const char *glyphs, unsigned char from){
+    unsigned char count, i, n;
+
+    for (count = 0; glyphs[count] != '\0'; count++)
+        ;
+    i = (from == TEXT_NO_KEY) ? count - 1 : from;
+    for (n = 0; n < count; n++){
+        i = (i + 1 == count) ? 0 : i + 1;
+        if (isAllowed(text, glyphs[i]))
+            return i;
+    }
+    return TEXT_NO_KEY;
+}
+
+static void showCell(const struct textEntry *text, unsigned char i){
+    moveLCDTo(text->x + i, text->y);
+    printLCDChar(text->buffer[i]);
+}
+
+/************************************************
+*   initializeTextEntry                         *
+*                                               *
+*   Desc.: Sets up an empty entry. 'allowed'    *
+*          and 'overwrite' can be set after.    *
+*   Inputs:  text - Entry                       *
+*            glyphs - 16 strings, by key number *
+*            buffer - At least 'capacity' bytes *
+*            x, y - LCD cell of the first       *
+*                   character                   *
+*   Outputs: None                               *
+************************************************/
+
+void initializeTextEntry(struct textEntry *text, const char * const *glyphs, unsigned char *buffer,
+                         unsigned char capacity, unsigned char x, unsigned char y){
+    text->glyphs = glyphs;
+    text->allowed = 0;
+    text->overwrite = 0;
+    text->buffer = buffer;
+    text->capacity = capacity;
+    text->x = x;
+    text->y = y;
+    textClear(text);
+}
+
+/************************************************
+*   textKey                                     *
+*                                               *
+*   Desc.: One keystroke. The same key within   *
+*          TEXT_COMMIT_TICKS changes the last   *
+*          character to the next one on the     *
+*          key; anything else commits it and    *
+*          starts a new character.              *
+*   Inputs:  text - Entry                       *
+*            key - Key number (keypad.h)        *
+*            ticks - Its keyEvent ticks         *
+*   Outputs: 1 if the key typed, 0 if it has no *
+*            allowed characters or the buffer   *
+*            is full                            *
+************************************************/
+
+unsigned char textKey(struct textEntry *text, unsigned char key, unsigned int ticks){
+    const char *glyphs = text->glyphs[key];
+    unsigned char i;
+
+    if (!glyphs)
+        return 0;
+
+    if (key == text->key && (unsigned short)(ticks - text->ticks) < TEXT_COMMIT_TICKS){
+        i = nextGlyph(text, glyphs, text->glyph);
+        text->ticks = ticks;
+        if (i != text->glyph){
+            text->glyph = i;
+            text->buffer[text->length - 1] = glyphs[i];
+            showCell(text, text->length - 1);
+        }
+        return 1;
+    }
+
+    text->key = TEXT_NO_KEY;
+    i = nextGlyph(text, glyphs, TEXT_NO_KEY);
+    if (i == TEXT_NO_KEY)
+        return 0;
+    if (text->length == text->capacity){
+        if (!text->overwrite || text->length == 0)
+            return 0;
+        text->length--;
+    }
+    text->buffer[text->length] = glyphs[i];
+    showCell(text, text->length);
+    text->length++;
+    text->key = key;
+    text->glyph = i;
+    text->ticks = ticks;
+    return 1;
+}
+
+void textCommit(struct textEntry *text){
+    text->key = TEXT_NO_KEY;
+}
+
+/************************************************
+*   textTimeout                                 *
+*                                               *
+*   Desc.: Commits the changing character once  *
+*          TEXT_COMMIT_TICKS have passed since  *
+*          its last press. Call it from the     *
+*          main loop.                           *
+*   Inputs:  text - Entry                       *
+*            now - getKeypadTicks()             *
+*   Outputs: None                               *
+************************************************/
+
+void textTimeout(struct textEntry *text, unsigned int now){
+    if (text->key != TEXT_NO_KEY && (unsigned short)(now - text->ticks) >= TEXT_COMMIT_TICKS)
+        text->key = TEXT_NO_KEY;
+}
+
+void textBackspace(struct textEntry *text){
+    text->key = TEXT_NO_KEY;
+    if (text->length == 0)
+        return;
+    text->length--;
+    moveLCDTo(text->x + text->length, text->y);
+    printLCDChar(' ');
+}
+
+// Empties the entry; the caller clears its part of the LCD
+void textClear(struct textEntry *text){
+    text->length = 0;
+    text->key = TEXT_NO_KEY;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    textentry.h                                    *
+*          Multi-tap text entry on the keypad             *
+*---------------------------------------------------------*
+* Each key that types steps through its characters in a   *
+* glyph table kept in ROM, one per press. The character   *
+* shown is committed by any other key, by textCommit(),   *
+* or once TEXT_COMMIT_MS pass without a press, so the     *
+* next press of the same key starts a new character.      *
+*                                                         *
+* The text is shown on the LCD from a fixed position, and *
+* only the cell that changes is written. Nothing here     *
+* waits; use the LCD's buffered mode to keep it that way. *
+**********************************************************/
+
+#ifndef _TEXTENTRY_H
+#define _TEXTENTRY_H
+
+#include "keypad.h"
+
+#define TEXT_COMMIT_MS      1000
+#define TEXT_COMMIT_TICKS   ((unsigned int)(TEXT_COMMIT_MS * 1000L / KEYPAD_TICK_US))
+
+#define TEXT_NO_KEY         0xFF
+
+struct textEntry {
+    const char * const *glyphs; // for each key number, its characters in press order, or 0 if it does not type
+    const char *allowed;        // the only characters that may be typed, 0 for any
+    unsigned char overwrite;    // when full, a new character replaces the last one instead of being ignored
+    unsigned char *buffer;
+    unsigned char capacity;
+    unsigned char length;       // including a character that is still changing
+    unsigned char x, y;         // LCD cell of buffer[0]
+    unsigned char key;          // key whose character is still changing, or TEXT_NO_KEY
+    unsigned char glyph;        // index of that character in glyphs[key]
+    unsigned int ticks;         // getKeypadTicks() at its last press
+};
+
+// Function prototypes - tell the compiler that these functions exist somewhere
+void initializeTextEntry(struct textEntry *text, const char * const *glyphs, unsigned char *buffer,
+                         unsigned char capacity, unsigned char x, unsigned char y);
+unsigned char textKey(struct textEntry *text, unsigned char key, unsigned int ticks);
+void textCommit(struct textEntry *text);
+void textTimeout(struct textEntry *text, unsigned int now);
+void textBackspace(struct textEntry *text);
+void textClear(struct textEntry *text);
+
+#endif
\ No newline at end of file
@@ -12,13 +12,17 @@
 
 #include <hidef.h>         /* common defines and macros */
 #include <mc9s12dg256.h>     /* derivative information */
+#include "PLL.h"
 
 //********* PLL_Init ****************
 // Set 9S12DP512 PLL clock to 24 MHz
 // Inputs: none
 // Outputs: none
-// Errors: will hang if PLL does not stabilize 
+// Errors: if the PLL has not locked after PLL_LOCK_TRIES polls (about
+//         5ms) it is turned off again and the bus stays at 8 MHz
 void PLL_Init(void){  
+  unsigned int tries;
+
   SYNR = 0x02;
   REFDV = 0x01;
   
@@ -55,7 +59,11 @@ void PLL_Init(void){
   
   */
   
-  while((CRGFLG&0x08) == 0){ 	  // Wait for PLLCLK to stabilize.
+  for(tries = 0; (CRGFLG&0x08) == 0; tries++){ 	  // Wait for PLLCLK to stabilize.
+    if(tries == PLL_LOCK_TRIES){
+      PLLCTL_PLLON = 0;   // No lock: keep running from OSCCLK
+      return;
+    }
   }  
   CLKSEL_PLLSEL = 1;  // Switch to PLL clock
 }
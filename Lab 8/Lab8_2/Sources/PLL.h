@@ -15,5 +15,7 @@
 // Set 9S12DP512 PLL clock to 24 MHz
 // Inputs: none
 // Outputs: none
-// Errors: will hang if PLL does not stabilize 
+// Errors: if the PLL has not locked after PLL_LOCK_TRIES polls (about
+//         5ms) it is turned off again and the bus stays at 8 MHz
+#define PLL_LOCK_TRIES 5000
 void PLL_Init(void);
@@ -23,6 +23,7 @@ Note: C++ destructors of global objects are NOT yet supported in the HIWARE Obje
 
 #include "hidef.h"
 #include "start12.h"
+#include "startup.h"
 
 /***************************************************************************/
 /* Macros to control how the startup code handles the COP:                 */
@@ -57,6 +58,36 @@ Note: C++ destructors of global objects are NOT yet supported in the HIWARE Obje
 /* removing the this macro.                                                */
 /* Note: This macro is only supported for the HCS12X and when using ELF    */
 /***************************************************************************/
+/* _FAST_STARTUP_ define:                                                  */
+/* Init() zeroes out and copies down with word moves, as with -ot, even if */
+/* the project is compiled for size (-os, the default). This takes a few   */
+/* more bytes of code and about half the time per byte.                    */
+/***************************************************************************/
+/* _NO_INIT_SEG_ define:                                                   */
+/* Variables in the segment NOINIT are not zeroed out on a warm reset,     */
+/* i.e. when the key written into NOINIT after the last cold start is      */
+/* still intact. Otherwise the whole segment is zeroed. The prm file has   */
+/* to place NOINIT into a NO_INIT segment so that the linker leaves it out */
+/* of the zero out descriptors; _startupWarm tells main which case it was. */
+/***************************************************************************/
+/* _STARTUP_CYCLES_ define:                                                */
+/* _Startup runs the timer counter at the bus clock, stores the number of  */
+/* cycles from the stack setup up to the call of main in _startupCycles    */
+/* (0xFFFF if the counter wrapped) and switches the timer off again.       */
+/***************************************************************************/
+/* _STACK_PAINT_ define:                                                   */
+/* _Startup fills the free stack with _STACK_PAINT before Init, so that    */
+/* _StackHighWater() can tell how deep the stack has been used since the   */
+/* reset. The fill is counted in _startupCycles.                           */
+/***************************************************************************/
+#define _FAST_STARTUP_
+#define _NO_INIT_SEG_
+#define _STARTUP_CYCLES_
+#define _STACK_PAINT_
+
+#if defined(__OPTIMIZE_FOR_SIZE__) && !defined(_FAST_STARTUP_)
+#define __STARTUP_OPTIMIZE_FOR_SIZE__   /* byte loops in Init */
+#endif
 
 #ifdef __cplusplus
 #define __EXTERN_C  extern "C"
@@ -77,6 +108,27 @@ struct _tagStartup _startupData;  /*   read-only: */
 #pragma DATA_SEG DEFAULT
 #endif /* __ONLY_INIT_SP */
 
+#if defined(_STARTUP_CYCLES_)
+unsigned int _startupCycles;      /* bus cycles from _Startup to main */
+#endif
+
+#if defined(_NO_INIT_SEG_)
+#define _NO_INIT_KEY   0x5AC3
+unsigned char _startupWarm;       /* 1 if NOINIT was kept */
+#pragma DATA_SEG NOINIT
+static unsigned int _noInitKey[2];  /* _NO_INIT_KEY and its complement after a cold start */
+#pragma DATA_SEG DEFAULT
+__SEG_START_DEF(NOINIT);
+__SEG_SIZE_DEF(NOINIT);
+#endif
+
+#if defined(_STACK_PAINT_)
+#define _STACK_PAINT        0xA5
+#define _STACK_PAINT_WORD   0xA5A5    /* two bytes of _STACK_PAINT, for HLI */
+__SEG_START_DEF(SSTACK);
+__SEG_END_DEF(SSTACK);
+#endif
+
 #if defined(FAR_DATA) && (!defined(__HCS12X__) || defined(__BANKED_COPY_DOWN))
 #include "non_bank.sgm"
 /* the init function must be in non banked memory if banked variables are used */
@@ -118,6 +170,14 @@ __EXTERN_C void _SET_PAGE(void);  /* the inline assembler needs a prototype */
 #define ___INITEE      (*(volatile unsigned char *) 0x0012)
 #endif
 
+#if defined(_STARTUP_CYCLES_)
+      /* timer registers used to time the startup */
+#define ___TSCR1       (*(volatile unsigned char *) 0x0046)
+#define ___TSCR2       (*(volatile unsigned char *) 0x004D)
+#define ___TFLG2       (*(volatile unsigned char *) 0x004F)
+#define _TCNT_ADR      0x0044   /* TCNT, read in HLI */
+#endif
+
 #if defined(_DO_FEED_COP_)
 #define __FEED_COP_IN_HLI()  } __asm movb #0x55, _COP_RST_ADR; __asm movb #0xAA, _COP_RST_ADR; __asm {
 #else
@@ -161,7 +221,7 @@ NextZeroOut: PSHY                           ; save nofZeroOuts
 #if defined(__HCS12X__) && defined(FAR_DATA)
              PSHX
              LDX   0,X                      ; byte count
-#if defined(__OPTIMIZE_FOR_SIZE__)
+#if defined(__STARTUP_OPTIMIZE_FOR_SIZE__)
              CLRA
 NextWord:    GSTAA 1,Y+                     ; clear memory byte
              __FEED_COP_IN_HLI()            ; feed the COP if necessary /*lint !e505 !e522 asm code */
@@ -180,7 +240,7 @@ LastClr:
 #endif
              PULX
              LEAX  2,X
-#elif defined(__OPTIMIZE_FOR_SIZE__)               /* -os, default */
+#elif defined(__STARTUP_OPTIMIZE_FOR_SIZE__)      /* -os, default */
              LDD   2,X+                     ; byte count
 NextWord:    CLR   1,Y+                     ; clear memory byte
              __FEED_COP_IN_HLI()            ; feed the COP if necessary /*lint !e505 !e522 asm code */
@@ -231,7 +291,7 @@ NextBlock:
 #endif /* FAR_DATA */
 
 #if defined(__HCS12X__) && defined(FAR_DATA)
-#if defined(__OPTIMIZE_FOR_SIZE__)               /* -os, default */
+#if defined(__STARTUP_OPTIMIZE_FOR_SIZE__)      /* -os, default */
 Copy:        PSHA
              LDAA  1,X+
              GSTAA  1,Y+                    ; move a byte from ROM to the data area
@@ -253,7 +313,7 @@ Copy1:
              LDAA  1,X+
              GSTAA  1,Y+                    ; move a byte from ROM to the data area
 #endif
-#elif defined(__OPTIMIZE_FOR_SIZE__)               /* -os, default */
+#elif defined(__STARTUP_OPTIMIZE_FOR_SIZE__)      /* -os, default */
 Copy:        MOVB  1,X+,1,Y+                ; move a byte from ROM to the data area
              __FEED_COP_IN_HLI()            ; feed the COP if necessary /*lint !e505 !e522 asm code */
              DBNE  D,Copy                   ; copy-byte loop
@@ -371,6 +431,45 @@ done:;
 
 #include "non_bank.sgm"
 
+#if defined(_NO_INIT_SEG_)
+static void InitNoInit(void)
+{
+/* purpose:     zero out NOINIT unless it survived a warm reset  */
+/*   called from: _Startup, after Init                          */
+   unsigned int *dst;
+   unsigned int n;
+
+   if (_noInitKey[0] == _NO_INIT_KEY && _noInitKey[1] == (unsigned int)~_NO_INIT_KEY) {
+     _startupWarm = 1;
+     return;
+   }
+   dst = (unsigned int *)__SEG_START_REF(NOINIT);
+   for (n = (unsigned int)__SEG_SIZE_REF(NOINIT) >> 1; n != 0; n--) {
+     *dst++ = 0;                    /* word-clear */
+   }
+   if ((unsigned int)__SEG_SIZE_REF(NOINIT) & 1) {
+     *(unsigned char *)dst = 0;     /* last byte */
+   }
+   _noInitKey[0] = _NO_INIT_KEY;
+   _noInitKey[1] = (unsigned int)~_NO_INIT_KEY;
+}
+#endif
+
+#if defined(_STACK_PAINT_)
+unsigned int _StackHighWater(void)
+{
+/* purpose:     stack bytes used since the reset, from the top   */
+/*              down to the lowest byte that lost its paint      */
+/*   called from: the application, at any time                   */
+   const unsigned char *p = (const unsigned char *)__SEG_START_REF(SSTACK);
+
+   while (p < (const unsigned char *)__SEG_END_REF(SSTACK) && *p == _STACK_PAINT) {
+     p++;
+   }
+   return (unsigned int)((const unsigned char *)__SEG_END_REF(SSTACK) - p);
+}
+#endif
+
 #pragma MESSAGE DISABLE C12053 /* Stack-pointer change not in debugging-information */
 #pragma NO_FRAME
 #pragma NO_ENTRY
@@ -405,6 +504,16 @@ __EXTERN_C void _Startup(void) {
 
    /* initialize the stack pointer */
    INIT_SP_FROM_STARTUP_DESC(); /*lint !e522 asm code */ /* HLI macro definition in hidef.h */
+#if defined(_STARTUP_CYCLES_)
+   /* run the timer counter at the bus clock; the start count stays on the stack until main */
+   ___TSCR2 = 0x00;   /* prescaler 1, no overflow interrupt */
+   ___TFLG2 = 0x80;   /* clear the overflow flag */
+   ___TSCR1 = 0x80;   /* TEN */
+   __asm {
+             LDD   _TCNT_ADR
+             PSHD
+   }
+#endif
 
 #if defined(_HCS12_SERIALMON)
    /* for Monitor based software remap the RAM & EEPROM to adhere
@@ -414,6 +523,17 @@ __EXTERN_C void _Startup(void) {
    ___INITEE = 0x09;  /* lock EEPROM block to end at 0x0fff */
 #endif
 
+#if defined(_STACK_PAINT_)
+   /* paint the free stack below SP, a word at a time; STACKSIZE is even */
+   __asm {
+             TSX
+             LDD   #_STACK_PAINT_WORD
+PaintNext:   STD   2,-X
+             CPX   #__SEG_START_SSTACK
+             BHI   PaintNext
+   }
+#endif
+
    /* Here user defined code could be inserted, the stack could be used */
 #if defined(_DO_DISABLE_COP_)
    _DISABLE_COP();
@@ -460,11 +580,28 @@ __EXTERN_C void _Startup(void) {
    Init(); /* zero out, copy down, call constructors */
 #endif
 
+#if defined(_NO_INIT_SEG_)
+   InitNoInit(); /* zero out NOINIT after a cold start */
+#endif
+
    /* Here user defined code could be inserted, all global variables are initilized */
 #if defined(_DO_ENABLE_COP_)
    _ENABLE_COP(1);
 #endif
 
+#if defined(_STARTUP_CYCLES_)
+   __asm {
+             LDD   _TCNT_ADR
+             SUBD  2,SP+                    ; elapsed cycles, drop the start count
+             STD   _startupCycles
+   }
+   if (___TFLG2 & 0x80) {
+     _startupCycles = 0xFFFF;  /* counter wrapped */
+   }
+   ___TSCR1 = 0x00;   /* leave the timer as after reset */
+   ___TFLG2 = 0x80;
+#endif
+
    /* call main() */
    main();
 }
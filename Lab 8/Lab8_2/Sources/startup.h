@@ -0,0 +1,35 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    startup.h                                      *
+*          Startup diagnostics and warm-reset RAM         *
+*---------------------------------------------------------*
+* Start12.c zeroes out and copies down the variables with *
+* word moves, and times itself: _startupCycles holds the  *
+* bus cycles from _Startup to main(), or 0xFFFF if that   *
+* took longer than the timer counter can show.            *
+*                                                         *
+* Variables in the segment NOINIT keep their values over  *
+* a warm reset, and _startupWarm is then 1. After a power *
+* up, or a brown-out that lost the RAM, they start at 0.  *
+* Define them between #pragma DATA_SEG NOINIT and         *
+* #pragma DATA_SEG DEFAULT, and use the same pragmas      *
+* around their extern declarations.                       *
+*                                                         *
+* The stack is filled with a pattern before Init, and     *
+* _StackHighWater() returns the most bytes it has held    *
+* since the reset. Compare it with STACKSIZE in the prm   *
+* file, and with the static estimate of Tools/mapstat,    *
+* before cutting STACKSIZE. The figure reads low if the   *
+* deepest bytes pushed happen to equal the pattern, 0xA5. *
+**********************************************************/
+
+#ifndef _STARTUP_H
+#define _STARTUP_H
+
+extern unsigned int _startupCycles;
+extern unsigned char _startupWarm;
+
+unsigned int _StackHighWater(void);
+
+#endif
\ No newline at end of file
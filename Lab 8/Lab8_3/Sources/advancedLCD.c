@@ -1,5 +1,6 @@
 #include "derivative.h"
 #include "advancedLCD.h"
+#include "timebase.h"
 
 #define LCD_DATA PORTK
 #define LCD_CTRL PORTK
@@ -13,46 +14,52 @@ int lineNumber = 0;
 /************************************************
 *   shortWait	                                *
 *	                                            *
-*	Desc.: Waits roughly (ms) milliseconds	    *
+*	Desc.: Waits (ms) milliseconds on the       *
+*          timebase, whatever the bus clock     *
 *	Inputs:	 ms - Number of milliseconds	    *
 *	Outputs: None	                            *
 ************************************************/
 
 void shortWait(int ms){
-    int i, j;
-    for (i=0; i<ms; i++){
-        for (j=0; j<4000; j++);
-    }
+    delayMillis(ms);
 }
 
 /************************************************
-*	writeLCDValue	                            *
+*	writeLCDNibble	                            *
 *	                                            *
-*	Desc.: Writes a byte to the LCD	            *
-*	Inputs:	value - Byte to write	            *
+*	Desc.: Writes one nibble to the LCD and     *
+*          latches it with a pulse on EN. The   *
+*          caller waits for it to execute.      *
+*	Inputs:	nibble - value 0-15	                *
 *	        type - TYPE_CHAR or TYPE_INST	    *
 *	Outputs: None	                            *
 ************************************************/ 
 
-void writeLCDValue(char value, int type){
-    unsigned char x;
-
-    x = (value & 0xF0) >> 2;            //shift high nibble to center of byte for Pk5-Pk2
+static void writeLCDNibble(unsigned char nibble, int type){
     LCD_DATA =LCD_DATA & ~0x3C;         //clear bits Pk5-Pk2
-    LCD_DATA = LCD_DATA | x;            //sends high nibble to PORTK
+    LCD_DATA = LCD_DATA | (nibble << 2);    //nibble to the center of the byte, Pk5-Pk2
     LCD_CTRL = type ? (LCD_CTRL & ~RS) : (LCD_CTRL | RS);   //set RS to command (RS=0) if type = TYPE_INST
                                                             //                  (RS=1) if type = TYPE_CHAR
     LCD_CTRL = LCD_CTRL | EN;           //raise enable
-    shortWait(1);
+    delayMicros(LCD_ENABLE_US);
     LCD_CTRL = LCD_CTRL & ~EN;          //Drop enable to capture command
-    shortWait(1);                       //wait
-    x = (value & 0x0F)<< 2;             // shift low nibble to center of byte for Pk5-Pk2
-    LCD_DATA =LCD_DATA & ~0x3C;         //clear bits Pk5-Pk2
-    LCD_DATA =LCD_DATA | x;             //send low nibble to PORTK
-    LCD_CTRL = LCD_CTRL | EN;           //raise enable
-    shortWait(1);
-    LCD_CTRL = LCD_CTRL & ~EN;          //drop enable to capture command
-    shortWait(1);
+}
+
+/************************************************
+*	writeLCDValue	                            *
+*	                                            *
+*	Desc.: Writes a byte to the LCD	            *
+*	Inputs:	value - Byte to write	            *
+*	        type - TYPE_CHAR or TYPE_INST	    *
+*	Outputs: None	                            *
+************************************************/ 
+
+void writeLCDValue(char value, int type){
+    writeLCDNibble((value & 0xF0) >> 4, type);  //high nibble first
+    delayMicros(LCD_EXEC_US);           //wait
+    writeLCDNibble(value & 0x0F, type);
+    // Clear (0x01) and home (0x02, 0x03) take much longer than the other instructions
+    delayMicros(type == TYPE_INST && (unsigned char)value < 0x04 ? LCD_HOME_US : LCD_EXEC_US);
 }
 
 /************************************************
@@ -66,11 +73,17 @@ void writeLCDValue(char value, int type){
 void initializeLCD()
 {
     DDRK = 0xFF;  
-    shortWait(160);
-    writeLCDValue(0x33,TYPE_INST);      //reset sequence provided by data sheet
-    shortWait(160);
-    writeLCDValue(0x32,TYPE_INST);      //reset sequence provided by data sheet
-    shortWait(160);
+    initializeTimebase();
+    delayMillis(LCD_POWER_UP_MS);
+    // Reset sequence provided by data sheet: three 8 bit function sets, one nibble each, then 4 bit mode
+    writeLCDNibble(0x3,TYPE_INST);
+    delayMillis(LCD_RESET_MS);
+    writeLCDNibble(0x3,TYPE_INST);
+    delayMicros(LCD_RESET_US);
+    writeLCDNibble(0x3,TYPE_INST);
+    delayMicros(LCD_EXEC_US);
+    writeLCDNibble(0x2,TYPE_INST);
+    delayMicros(LCD_EXEC_US);
     writeLCDValue(0x28,TYPE_INST);      //Function set to four bit data length
                                         //2 line, 5 x 7 dot format
     writeLCDValue(0x08,TYPE_INST);      //Turn the display OFF 
@@ -78,7 +91,6 @@ void initializeLCD()
     writeLCDValue(0x01,TYPE_INST);      //Clear the display
     writeLCDValue(0x06,TYPE_INST);      //Turn to entry mode
     writeLCDValue(0x02,TYPE_INST);      //Send cursor to home 
-    shortWait(160);
 }
 
 /************************************************
@@ -161,7 +173,6 @@ void printLCDNumber(int num){
 void clearLCD(void){
     writeLCDValue(0x01,TYPE_INST);      //Clear the display
     writeLCDValue(0x02,TYPE_INST);      //Send cursor home
-    shortWait(1);    
     linePosition = 0;
 	  lineNumber = 0;
 }
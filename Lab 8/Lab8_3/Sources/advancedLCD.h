@@ -12,6 +12,15 @@
 #define FORMAT_HEX  1
 #define FORMAT_CHR	2
 
+// Waits from the HD44780 datasheet: power up (40ms at 2.7V), the enable pulse, most instructions (37us),
+// clear and home (1.52ms), and the pauses after the first two nibbles of the reset sequence (4.1ms, 100us)
+#define LCD_POWER_UP_MS     40
+#define LCD_ENABLE_US       1
+#define LCD_EXEC_US         40
+#define LCD_HOME_US         1600
+#define LCD_RESET_MS        5
+#define LCD_RESET_US        150
+
 // Function prototypes - tell the compiler that these functions exist somewhere
 void initializeLCD(void);
 void shortWait(int ms);
@@ -0,0 +1,286 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    dds.c                                          *
+*          Direct digital synthesis for DAC channel A     *
+**********************************************************/
+
+#include "derivative.h"
+#include "dds.h"
+#include <math.h>         // powf() for the log sweep ratio, once per sweep setup
+
+// Application layer in main.c
+void DAC_SetOutputA(unsigned int output);
+
+static const unsigned int *volatile ddsTable = 0;
+static const unsigned int *volatile ddsNextTable = 0;  // taken over when the next cycle starts
+static unsigned long ddsPhase = 0;
+static volatile unsigned long ddsTuningWord = 0;
+static volatile unsigned long ddsSamples = 0;      // DDS_SAMPLE_RATE per second: a time base for the caller
+
+#define SWEEP_SAMPLES ((unsigned char)(DDS_SAMPLE_RATE / DDS_SWEEP_RATE))
+
+// Sweep state, tuning words. sweepStep is the linear increment, or the log ratio - 1 (or 1 - ratio) in Q32.
+static volatile unsigned char sweepMode = DDS_SWEEP_OFF;
+static unsigned char sweepUp, sweepCountdown;
+static unsigned long sweepStart, sweepEnd, sweepStep;
+
+/************************************************
+*   initializeDDS                               *
+*                                               *
+*   Desc.: Prepares ECT channel 4. Nothing is   *
+*          output until startDDS().             *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void initializeDDS(void){
+    TIE_C4I = 0;
+    TSCR1_TEN = 1;
+    TSCR2 = (TSCR2 & ~0x07) | DDS_TIMER_PRESCALE;
+    TIOS_IOS4 = 1;                      // output compare, no pin action
+    ddsPhase = 0;
+}
+
+/************************************************
+*   setDDSTable                                 *
+*                                               *
+*   Desc.: Selects the waveform. The interrupt  *
+*          switches to it when the phase wraps, *
+*          so the cycle being played finishes   *
+*          unchanged. The first table is used   *
+*          at once. A table must stay valid     *
+*          while it is played or pending.       *
+*   Inputs:  table - DDS_TABLE_SIZE DAC codes,  *
+*            or 0 to cancel a pending switch    *
+*   Outputs: None                               *
+************************************************/
+
+void setDDSTable(const unsigned int *table){
+    if (ddsTable == 0)
+        ddsTable = table;
+    else
+        ddsNextTable = table;           // 16-bit stores, atomic on the HCS12
+}
+
+/************************************************
+*   getDDSTable                                 *
+*                                               *
+*   Desc.: The table being played. With no      *
+*          switch pending, every other table    *
+*          can be rewritten safely.             *
+*   Inputs:  None                               *
+*   Outputs: Table pointer, 0 if none           *
+************************************************/
+
+const unsigned int *getDDSTable(void){
+    return ddsTable;
+}
+
+int isDDSTablePending(void){
+    return ddsNextTable != 0;
+}
+
+/************************************************
+*   tuningWord                                  *
+*                                               *
+*   Desc.: Computes f * 2^32 / DDS_SAMPLE_RATE  *
+*          by long division, so no precision    *
+*          is lost.                             *
+*   Inputs:  millihertz - Output frequency in   *
+*            mHz, clamped to the DDS range      *
+*   Outputs: Tuning word                        *
+************************************************/
+
+static unsigned long tuningWord(unsigned long millihertz){
+    const unsigned long divisor = DDS_SAMPLE_RATE * 1000L;
+    unsigned long remainder, word = 0;
+    unsigned char bit;
+
+    if (millihertz < DDS_MIN_MILLIHZ)
+        millihertz = DDS_MIN_MILLIHZ;
+    if (millihertz > DDS_MAX_MILLIHZ)
+        millihertz = DDS_MAX_MILLIHZ;
+
+    // remainder < divisor < 2^31 throughout, so the shift cannot overflow
+    remainder = millihertz;
+    for (bit = 0; bit < 32; bit++){
+        remainder <<= 1;
+        word <<= 1;
+        if (remainder >= divisor){
+            remainder -= divisor;
+            word |= 1;
+        }
+    }
+    return word;
+}
+
+/************************************************
+*   setDDSFrequency                             *
+*                                               *
+*   Desc.: Sets a fixed output frequency and    *
+*          ends any sweep                       *
+*   Inputs:  millihertz - Output frequency in   *
+*            mHz, clamped to the DDS range      *
+*   Outputs: None                               *
+************************************************/
+
+void setDDSFrequency(unsigned long millihertz){
+    unsigned long word = tuningWord(millihertz);
+    unsigned char enabled = TIE_C4I;
+
+    TIE_C4I = 0;                        // the interrupt must not see half a tuning word
+    sweepMode = DDS_SWEEP_OFF;
+    ddsTuningWord = word;
+    TIE_C4I = enabled;
+}
+
+/************************************************
+*   startDDSSweep                               *
+*                                               *
+*   Desc.: Sweeps from startMilliHz to          *
+*          endMilliHz (either may be higher)    *
+*          in durationMs, repeating until       *
+*          setDDSFrequency() is called. The log *
+*          ratio needs one powf() here; the     *
+*          interrupt uses integers only.        *
+*   Inputs:  startMilliHz, endMilliHz - mHz     *
+*            durationMs - Time per sweep        *
+*            mode - DDS_SWEEP_LINEAR or _LOG    *
+*   Outputs: None                               *
+************************************************/
+
+void startDDSSweep(unsigned long startMilliHz, unsigned long endMilliHz, unsigned int durationMs, unsigned char mode){
+    unsigned long start = tuningWord(startMilliHz), end = tuningWord(endMilliHz), step;
+    unsigned long steps = (unsigned long)durationMs * DDS_SWEEP_RATE / 1000;
+    unsigned char enabled;
+    float ratio;
+
+    if (steps == 0)
+        steps = 1;
+    if (mode == DDS_SWEEP_LOG){
+        ratio = powf((float)end / (float)start, 1.0f / (float)steps);
+        step = (unsigned long)(fabsf(ratio - 1.0f) * 4294967296.0f);
+    }
+    else
+        step = (end > start ? end - start : start - end) / steps;
+    if (step == 0)
+        step = 1;
+
+    enabled = TIE_C4I;
+    TIE_C4I = 0;
+    sweepStart = start;
+    sweepEnd = end;
+    sweepStep = step;
+    sweepUp = end >= start;
+    sweepCountdown = SWEEP_SAMPLES;
+    ddsTuningWord = start;
+    sweepMode = mode;
+    TIE_C4I = enabled;
+}
+
+unsigned char getDDSSweepMode(void){
+    return sweepMode;
+}
+
+/************************************************
+*   mulHigh32                                   *
+*                                               *
+*   Desc.: (a * b) >> 32 from four 16x16        *
+*          multiplies (EMUL). The carry from    *
+*          the dropped low word is ignored,     *
+*          an error of at most 2.               *
+*   Inputs:  a, b                               *
+*   Outputs: High 32 bits of the product        *
+************************************************/
+
+static unsigned long mulHigh32(unsigned long a, unsigned long b){
+    unsigned int ah = (unsigned int)(a >> 16), al = (unsigned int)(a & 0xFFFF);
+    unsigned int bh = (unsigned int)(b >> 16), bl = (unsigned int)(b & 0xFFFF);
+
+    return (unsigned long)ah * bh + (((unsigned long)ah * bl) >> 16) + (((unsigned long)al * bh) >> 16);
+}
+
+/************************************************
+*   sweepTick                                   *
+*                                               *
+*   Desc.: One sweep step, called by DDS_ISR    *
+*          every SWEEP_SAMPLES samples. Past    *
+*          the end it starts over.              *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+static void sweepTick(void){
+    unsigned long word = ddsTuningWord, step = sweepStep;
+
+    if (sweepMode == DDS_SWEEP_LOG)
+        step = mulHigh32(word, step) | 1;   // never stall, even on a tiny ratio
+
+    if (sweepUp)
+        word = (word > sweepEnd - step) ? sweepStart : word + step;
+    else
+        word = (word < sweepEnd + step) ? sweepStart : word - step;
+    ddsTuningWord = word;
+}
+
+unsigned long getDDSTuningWord(void){
+    return ddsTuningWord;
+}
+
+unsigned long getDDSSampleCount(void){
+    unsigned long samples;
+    unsigned char enabled = TIE_C4I;
+
+    TIE_C4I = 0;
+    samples = ddsSamples;
+    TIE_C4I = enabled;
+    return samples;
+}
+
+/************************************************
+*   startDDS / stopDDS                          *
+*                                               *
+*   Desc.: Start or stop the sample interrupt.  *
+*          Needs interrupts enabled (CLI).      *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void startDDS(void){
+    TC4 = TCNT + DDS_PERIOD_TICKS;
+    TFLG1 = TFLG1_C4F_MASK;
+    TIE_C4I = 1;
+}
+
+void stopDDS(void){
+    TIE_C4I = 0;
+}
+
+/************************************************
+*   DDS_ISR                                     *
+*                                               *
+*   Desc.: Outputs one sample. The table index  *
+*          is taken from the high word of the   *
+*          phase to avoid a 32-bit shift.       *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void interrupt VectorNumber_Vtimch4 DDS_ISR(void){
+    TC4 = TC4 + DDS_PERIOD_TICKS;
+    TFLG1 = TFLG1_C4F_MASK;
+
+    ddsPhase += ddsTuningWord;
+    ddsSamples++;
+    if (sweepMode != DDS_SWEEP_OFF && --sweepCountdown == 0){
+        sweepCountdown = SWEEP_SAMPLES;
+        sweepTick();
+    }
+    if (ddsNextTable && ddsPhase < ddsTuningWord){
+        ddsTable = ddsNextTable;        // the phase wrapped: a new cycle starts
+        ddsNextTable = 0;
+    }
+    if (ddsTable)
+        DAC_SetOutputA(ddsTable[(unsigned int)(ddsPhase >> 16) >> (16 - DDS_TABLE_BITS)]);
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    dds.h                                          *
+*          Direct digital synthesis for DAC channel A     *
+*---------------------------------------------------------*
+* An ECT channel 4 output compare interrupt runs at       *
+* DDS_SAMPLE_RATE. Each sample adds the tuning word to a  *
+* 32-bit phase accumulator and sends the table entry at   *
+* the top DDS_TABLE_BITS of the phase to the DAC. The     *
+* output frequency is tuning word * rate / 2^32, so it    *
+* does not depend on how long the main loop takes.        *
+**********************************************************/
+
+#ifndef _DDS_H
+#define _DDS_H
+
+// Timing assumes setClock(CLOCK_24MHZ) has set the bus to 24MHz, which setTimebaseBusClock() divides by 8 for
+// TCNT. main.c does not start the DDS on any other bus.
+#define DDS_BUS_HZ          24000000L
+#define DDS_TIMER_PRESCALE  3
+#define DDS_TIMER_HZ        (DDS_BUS_HZ >> DDS_TIMER_PRESCALE)
+#define DDS_SAMPLE_RATE     50000L      // 2.5 samples per cycle at 20kHz
+#define DDS_PERIOD_TICKS    ((unsigned int)(DDS_TIMER_HZ / DDS_SAMPLE_RATE))
+
+// One cycle of the waveform, 10-bit DAC codes
+#define DDS_TABLE_BITS      10
+#define DDS_TABLE_SIZE      (1 << DDS_TABLE_BITS)
+
+// Output frequency range, in mHz. The resolution is DDS_SAMPLE_RATE / 2^32, about 12uHz.
+#define DDS_MIN_MILLIHZ     1000L
+#define DDS_MAX_MILLIHZ     20000000L
+
+// Sweeps: the interrupt itself steps the tuning word DDS_SWEEP_RATE times per second from the start to the
+// end frequency, then starts over. Linear sweeps add a constant, log sweeps multiply by a constant ratio.
+#define DDS_SWEEP_OFF       0
+#define DDS_SWEEP_LINEAR    1
+#define DDS_SWEEP_LOG       2
+#define DDS_SWEEP_RATE      1000L
+
+// Function prototypes - tell the compiler that these functions exist somewhere
+void initializeDDS(void);
+void setDDSTable(const unsigned int *table);
+const unsigned int *getDDSTable(void);
+int isDDSTablePending(void);
+void setDDSFrequency(unsigned long millihertz);
+void startDDSSweep(unsigned long startMilliHz, unsigned long endMilliHz, unsigned int durationMs, unsigned char mode);
+unsigned char getDDSSweepMode(void);
+unsigned long getDDSTuningWord(void);
+unsigned long getDDSSampleCount(void);
+void startDDS(void);
+void stopDDS(void);
+
+#endif
\ No newline at end of file
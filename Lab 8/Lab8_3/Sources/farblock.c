@@ -0,0 +1,42 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    farblock.c                                     *
+*          Bulk reads from paged memory                   *
+**********************************************************/
+
+#include "derivative.h"
+#include "farblock.h"
+
+#pragma CODE_SEG __NEAR_SEG NON_BANKED
+
+/************************************************
+*   readFarBlock                                *
+*                                               *
+*   Desc.: Copies a block from paged memory     *
+*          into RAM with PPAGE set once, two    *
+*          bytes at a time. PPAGE is restored   *
+*          afterwards.                          *
+*   Inputs:  dest - Not in 0x8000-0xBFFF        *
+*            source - Far address of the block  *
+*            size - Bytes to copy               *
+*   Outputs: None                               *
+************************************************/
+
+void readFarBlock(void *dest, const void *__far source, unsigned int size){
+    unsigned char *d = (unsigned char *)dest;
+    const unsigned char *s = (const unsigned char *)(unsigned int)(unsigned long)source;
+    unsigned char page = PPAGE;
+
+    PPAGE = (unsigned char)((unsigned long)source >> 16);
+    if (size & 1)
+        *d++ = *s++;
+    for (size >>= 1; size != 0; size--){
+        *(unsigned int *)d = *(const unsigned int *)s;
+        d += 2;
+        s += 2;
+    }
+    PPAGE = page;
+}
+
+#pragma CODE_SEG DEFAULT
\ No newline at end of file
@@ -0,0 +1,22 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    farblock.h                                     *
+*          Bulk reads from paged memory                   *
+*---------------------------------------------------------*
+* readFarBlock() of the Lab 9 datapage.c, for a project   *
+* that links none of the compiler's paging routines. A    *
+* table in paged flash, e.g. a stored waveform, is copied *
+* to RAM with PPAGE set only once, so the caller never    *
+* touches the page register itself.                       *
+**********************************************************/
+
+#ifndef _FARBLOCK_H
+#define _FARBLOCK_H
+
+// farblock.c is placed in NON_BANKED, so it can switch PPAGE
+#pragma CODE_SEG __NEAR_SEG NON_BANKED
+void readFarBlock(void *dest, const void *__far source, unsigned int size);
+#pragma CODE_SEG DEFAULT
+
+#endif
\ No newline at end of file
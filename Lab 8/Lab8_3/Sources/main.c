@@ -8,10 +8,14 @@
  
 #include <hidef.h>        // Common definitions for microcontroller family
 #include "derivative.h"   // Definitions specific to 9S12DG256
-#include "pll.h"          // Function to modify PLL on HCS12 to allow 24MHz operation
+#include "clock.h"        // Bus clock operating points (the PLL, up to 24MHz)
+#include "timebase.h"     // Timer tick that follows the bus clock
 #include "advancedLCD.h"  // LCD Functions
 #include "keypad.h"       // Keypad Functions
-#include <math.h>         // Sine function
+#include "dds.h"          // Timer-driven DDS engine
+#include "spi.h"          // Interrupt-driven SPI transmit queue
+#include "wavetable.h"    // Integer waveform table generation
+#include "scheduler.h"    // Run-to-completion tasks
 
 
 // TO USE FUNCTION GENERATOR: CONNECT SCOPE PROBE TO DACA CHANNEL ON PIN HEADERS (don't forget a ground connection too)
@@ -19,17 +23,60 @@
 // This is the core of the program. We need samples to be outputted to the DAC very quickly. We do not have time
 // to wait for the microcontroller to calculate a single floating point operation (as it does not have built-in
 // support - everything is done with 10s or 100s of int-calculations). To compensate, we pre-calculate a 'lookup
-// table' array based on the current frequency and amplitude. Arbitrary functions are possible in this way as
-// well. The main loop is thus very short - it just outputs a value to the DAC and increments a counter.
-unsigned int lookupTable[512] = { 0 };
-// In order to generate a range of frequencies, we shorten or lengthen the space used (to a max. of 512).
-unsigned int lookupTableDepth = 8;
-// At very low frequencies, the buffer gets too large. We cap its size and instead insert a delay between each
-// change in the DAC output.
-unsigned long addedDelay = 0;
-
-// This function is called whenever the frequency or amplitude changes
-void calculateLookupTable(unsigned long, unsigned long);
+// table' array holding one cycle of the waveform at the current amplitude. Arbitrary functions are possible in
+// this way as well. The DDS interrupt (dds.c) steps through the table at a fixed sample rate; the step size sets
+// the frequency, so the table never changes with frequency.
+// There are two tables: a new amplitude is built in the one not being played, and the DDS switches over at the
+// start of the next cycle, so the output never stops.
+unsigned int lookupTable[2][DDS_TABLE_SIZE] = { 0 };
+// Waveform played, WAVE_SINE to WAVE_USER (wavetable.h)
+unsigned char waveform = WAVE_SINE;
+char *waveNames[WAVE_COUNT] = {"Sin$", "Sqr$", "Tri$", "Saw$", "Nse$", "Usr$"};
+// Keys report their own lettering
+const unsigned char keypadTable[16] = {'A','B','C','D', '3','6','9','#', '2','5','8','0', '1','4','7','*'};
+
+// This function is called whenever the amplitude or waveform changes
+void calculateLookupTable(unsigned long);
+
+// Current amplitude and frequency
+unsigned long amplitude = 5000, frequency = 1000;
+
+// The user interface is three scheduler tasks, in priority order. None of them waits, so the longest any of
+// them holds up the others is one run, which getTaskStats() measures.
+//   keyTask     - woken by Keypad_ISR; types into the dialog on the LCD
+//   buttonTask  - every BUTTON_PERIOD_MS; opens the dialog of a newly pressed button
+//   measureTask - polls the DDS sample count while showThroughput() is measuring
+#define EVENT_KEY           0x02
+#define BUTTON_PERIOD_MS    20
+#define MEASURE_POLL_MS     10
+unsigned char keyTaskId, buttonTaskId, measureTaskId;
+
+void keyTask(unsigned char);
+void buttonTask(unsigned char);
+void measureTask(unsigned char);
+
+// Dialogs. Each asks for one number, ended with 'D'; numberEntered() acts on it and may ask the next question.
+#define DIALOG_NONE         0
+#define DIALOG_FREQUENCY    1
+#define DIALOG_AMPLITUDE    2
+#define DIALOG_WAVEFORM     3
+#define DIALOG_USER_POINT   4
+#define DIALOG_SWEEP_START  5
+#define DIALOG_SWEEP_END    6
+#define DIALOG_SWEEP_TIME   7
+#define DIALOG_SWEEP_TYPE   8
+#define DIALOG_MEASURE      9       // showThroughput() is counting; no number is asked for
+unsigned char dialog = DIALOG_NONE;
+unsigned int entry;                 // number typed so far
+unsigned char userPoint;
+unsigned int userLevels[WAVE_USER_POINTS];
+unsigned long sweepStart, sweepEnd, sweepTime;
+
+// USER INTERFACE - keypad dialogs and the status display
+void askNumber(unsigned char, char *);
+void numberEntered(unsigned int);
+void showStatus(unsigned long, unsigned long);
+void askUserPoint(void);
 
 // PHYSICAL LAYER - Communication over SPI specific to 68HCS12DG256, including PORT setup. No helper/inline functions
 // needed in this application.
@@ -43,124 +90,286 @@ void SPI_Send(unsigned char, unsigned char);
 void InitializeDAC(void);
 void DAC_SetOutputA(unsigned int);
 
+// Measures how many DAC updates per second actually reach the bus
+struct spiStats throughputBefore;
+unsigned long throughputStart;
+void showThroughput(void);
 
+// Controls:
+//   PH0 - new amplitude
+//   PH1 - new frequency; entering 0 sets up a sweep instead
+//   PH2 - measure the DAC update rate
+//   PH3 - choose the waveform
 
-// Helper function; used to add delays with low frequency
-#pragma INLINE
-void delay_us(long us) 
-{
-  long i;
-  for (i=0; i<us; i++)
-    asm NOP;
-}
 
 void main(void) 
 {
-  // Stores current amplitude and frequency
-  unsigned long amplitude = 5000, frequency = 1000;
-  unsigned int i=0;
-  // Sets the CPU clock to maximum possible (24 MHz)
-  PLL_Init();                                   
+  // Sets the CPU clock to maximum possible (24 MHz). The timer and the SPI follow the bus through their
+  // listeners.
+  addClockListener(setTimebaseBusClock);
+  addClockListener(setSPIBusClock);
+  setClock(CLOCK_24MHZ);
   
 	////////////////////////// LCD Initialization //////////////////////////////////
   	initializeLCD();
   	clearLCD();
-	printLCDText("f = 1000 Hz\nA = 5000 mV(P-P)$");
+
+  // The DDS and keypad periods are tick counts of the 3MHz timer, which the 8MHz crystal cannot give. Should
+  // the PLL not lock, say so and output nothing rather than the wrong frequency.
+  if (getClock() != CLOCK_24MHZ) 
+  {
+    printLCDText("PLL did not lock\nOutput stopped$");
+    EnableInterrupts;
+    for (;;)
+      __asm WAI;              // only the timer overflow is left to wake it
+  }
+	showStatus(frequency, amplitude);
 	////////////////////////// LCD Initialization //////////////////////////////////
 	
 	////////////////////////// UI Initialization ///////////////////////////////////
-	initializeKeypad();
+	initializeKeypad(keypadTable);
 	////////////////////////// UI Initialization ///////////////////////////////////
 	
 	////////////////////////// Hardware Initialization /////////////////////////////
 	InitializeDAC();
+	initializeDDS();
 	////////////////////////// Hardware Initialization /////////////////////////////
 
-  // Setup the initial loopup table, f=1000Hz, A=5000mV
-  calculateLookupTable(frequency, amplitude);
+  // Setup the initial loopup table, f=1000Hz, A=5000mV, and start the output
+  calculateLookupTable(amplitude);
+  setDDSFrequency(frequency * 1000);
+  startDDS();
+  EnableInterrupts;
+  
+  // The output runs in DDS_ISR from here on, also while a new value is being typed in
+  
+	////////////////////////// Scheduler Initialization ////////////////////////////
+	initializeScheduler();
+	keyTaskId = addTask(keyTask);
+	buttonTaskId = addTask(buttonTask);
+	measureTaskId = addTask(measureTask);
+	setKeypadTask(keyTaskId, EVENT_KEY);
+	startTaskTimer(buttonTaskId, 0, SCHEDULER_MS(BUTTON_PERIOD_MS));
+	////////////////////////// Scheduler Initialization ////////////////////////////
+	
+  runScheduler();
+}
+
+// Looks for buttons that were up on the last run and are down now (the buttons pull PH0-PH3 low), so holding
+// one down opens its dialog once. While a dialog is open the buttons are ignored.
+void buttonTask(unsigned char events) 
+{
+  static unsigned char released = 0x0F;
+  unsigned char up = PTH & 0x0F;
+  unsigned char pressed = released & ~up;
+  
+  released = up;
+  if (dialog != DIALOG_NONE)
+    return;
+  
+  // If PH1 is pressed, change frequency; entering 0 asks for a sweep instead
+  if (pressed & 0x02) 
+    askNumber(DIALOG_FREQUENCY, "Enter new freq.:\n$");
+  else if (pressed & 0x01) 
+    askNumber(DIALOG_AMPLITUDE, "Enter new ampl.:\n$");
+  else if (pressed & 0x04) 
+    showThroughput();
+  else if (pressed & 0x08) 
+    askNumber(DIALOG_WAVEFORM, "0Sin 1Sqr 2Tri\n3Saw 4Nse 5Usr $");
+}
+
+// Types into the number being asked for: digits are added, 'A' erases the last one and 'D' ends it.
+// Keystrokes with no dialog open are dropped.
+void keyTask(unsigned char events) 
+{
+  unsigned char k;
   
-  while (1) 
+  while ((k = getKeypress()) != 0) 
   {
-    // If PH1 is pressed, change frequency
-    if (PTH_PTH1 != 1) 
+    if (dialog == DIALOG_NONE || dialog == DIALOG_MEASURE)
+      continue;
+    if (k >= '0' && k <= '9') 
     {
-       clearLCD();
-       printLCDText("Enter new freq.:\n$"); 
-       // Use the new KEYPAD library to get a full number, with editing/correction possible
-       frequency = keypad_getNumber();
-       // Limits of generation: 1Hz-20KHz
-       if (frequency > 20000)
-          frequency = 20000;
-       if (frequency < 1)
-          frequency = 1;
-       // Display new generator status
-       clearLCD();
-       printLCDText("f = $"); printLCDNumber(frequency); printLCDText(" Hz\n$");
-       printLCDText("A = $"); printLCDNumber(amplitude); printLCDText(" mV(P-P)\n$");
-       // Update lookup table once; does not need to run multiple times
-       calculateLookupTable(frequency, amplitude);
-    } 
-    else if (PTH_PTH0 != 1) 
+      entry *= 10;
+      entry += (k - '0');
+      printLCDChar(k);  
+    }
+    else if (k == 'A') 
     {
-       clearLCD();
-       printLCDText("Enter new ampl.:\n$"); 
-       // Use the new KEYPAD library to get a full number, with editing/correction possible
-       amplitude = keypad_getNumber();
-       // Limits of generation: 0-5000mV, always with DC offset = 2.5V
-       if (amplitude > 5000)
-         amplitude = 5000;
-       // Display new generator status
-       clearLCD();
-       printLCDText("f = $"); printLCDNumber(frequency); printLCDText(" Hz\n$");
-       printLCDText("A = $"); printLCDNumber(amplitude); printLCDText(" mV(P-P)\n$");
-       // Update lookup table once; does not need to run multiple times
-       calculateLookupTable(frequency, amplitude);
+      entry /= 10;
+      moveLCDBack(1);
+      printLCDChar(' ');  
+      moveLCDBack(1);
     }
-    
-    // Calls the DAC rapidly to set output equal to each step of the sine wave 
-    i++; 
-    if (i >= lookupTableDepth) 
-      i = 0;
-    DAC_SetOutputA(lookupTable[i]);
-    // If there is added delay (on low frequencies), call delay function as needed
-    if (addedDelay > 0)
-      delay_us(addedDelay);
+    else if (k == 'D')
+      numberEntered(entry);
   }
 }
 
-// Function to calculate the lookup table based on frequency and amplitude
-// NOTE: It is poor practice to build in calibration using 'magic numbers' as is done below.
-// Normally, I would recommend that this be placed in some easily-modifiable location. In code
-// this could be done through defines, but in this case I would even recommend storing the
-// settings in EEPROM or on the SDCard (if present)
-void calculateLookupTable(unsigned long f, unsigned long a) 
+// Clears the LCD, shows the question and starts a new number
+void askNumber(unsigned char which, char *prompt) 
+{
+  clearLCD();
+  printLCDText(prompt);
+  entry = 0;
+  dialog = which;
+}
+
+// Acts on a number ended with 'D', depending on the question it answers
+void numberEntered(unsigned int value) 
 {
-  unsigned long i;
-  // For higher frequencies, we simply adjust the lookup table size
-  if (f >= 313) 
+  unsigned char which = dialog;
+  
+  dialog = DIALOG_NONE;
+  switch (which) 
   {
-    // Found through calculation, knowing the number of assembly instructions per loop iteration and CPU clock (24 MHz)
-    lookupTableDepth = (unsigned int)(150000/f);
-    addedDelay = 0;
-    for (i=0; i<lookupTableDepth; i++) 
-      lookupTable[i] = (unsigned int)(sinf((float)i*2*3.141592f/(float)lookupTableDepth) * (a/2500.0f * 255) + 512);
-  } 
-  // For lower frequencies, we fix the size and add a variable delay based on frequency
+    case DIALOG_FREQUENCY:
+      // 0 is not a frequency: use it to ask for a sweep instead
+      if (value == 0) 
+      {
+        askNumber(DIALOG_SWEEP_START, "Sweep from Hz:\n$");
+        return;
+      }
+      // Limits of generation: 1Hz-20KHz. Only the DDS step size changes; the table stays the same.
+      frequency = value > 20000 ? 20000 : value;
+      setDDSFrequency(frequency * 1000);
+      break;
+      
+    case DIALOG_AMPLITUDE:
+      // Limits of generation: 0-5000mV, always with DC offset = 2.5V
+      amplitude = value > 5000 ? 5000 : value;
+      calculateLookupTable(amplitude);
+      break;
+      
+    case DIALOG_WAVEFORM:
+      // The user waveform then asks for its WAVE_USER_POINTS levels, 0 (bottom of the swing) to 1000 (top),
+      // spread evenly over one cycle
+      if (value == WAVE_USER) 
+      {
+        userPoint = 0;
+        askUserPoint();
+        return;
+      }
+      if (value < WAVE_COUNT)
+        waveform = (unsigned char)value;
+      calculateLookupTable(amplitude);
+      break;
+      
+    case DIALOG_USER_POINT:
+      userLevels[userPoint++] = value;
+      if (userPoint < WAVE_USER_POINTS) 
+      {
+        askUserPoint();
+        return;
+      }
+      setUserWave(userLevels);
+      waveform = WAVE_USER;
+      calculateLookupTable(amplitude);
+      break;
+      
+    case DIALOG_SWEEP_START:
+      sweepStart = value > 20000 ? 20000 : value;
+      askNumber(DIALOG_SWEEP_END, "Sweep to Hz:\n$");
+      return;
+      
+    case DIALOG_SWEEP_END:
+      sweepEnd = value > 20000 ? 20000 : value;
+      askNumber(DIALOG_SWEEP_TIME, "Sweep time ms:\n$");
+      return;
+      
+    case DIALOG_SWEEP_TIME:
+      sweepTime = value;
+      askNumber(DIALOG_SWEEP_TYPE, "1 Linear 2 Log\n$");
+      return;
+      
+    case DIALOG_SWEEP_TYPE:
+      // The DDS interrupt runs the sweep on its own
+      startDDSSweep(sweepStart * 1000, sweepEnd * 1000, (unsigned int)sweepTime, value == 2 ? DDS_SWEEP_LOG : DDS_SWEEP_LINEAR);
+      break;
+  }
+  // Display new generator status
+  showStatus(frequency, amplitude);
+}
+
+// Function to calculate one cycle of the current waveform at amplitude 'a' (mV peak-to-peak) into the table
+// that is not being played, then hand it to the DDS. Integer arithmetic only (wavetable.c), so this takes a few
+// ms instead of the long float library run, and the change is heard from the next cycle on. It costs the same
+// for every waveform, including the ones stored in paged flash.
+void calculateLookupTable(unsigned long a) 
+{
+  unsigned int *table;
+  
+  setDDSTable(0);                     // cancel a switch that has not happened yet, so its table is free
+  table = (getDDSTable() == lookupTable[0]) ? lookupTable[1] : lookupTable[0];
+  buildWaveTable(table, waveform, (unsigned int)a);
+  setDDSTable(table);
+}
+
+// Shows the frequency (or the sweep) and waveform on the first line, the amplitude on the second
+void showStatus(unsigned long f, unsigned long a) 
+{
+  clearLCD();
+  if (getDDSSweepMode() == DDS_SWEEP_LINEAR)
+    printLCDText("Sweep Lin $");
+  else if (getDDSSweepMode() == DDS_SWEEP_LOG)
+    printLCDText("Sweep Log $");
   else 
   {
-    lookupTableDepth = 160;
-    for (i=0; i<lookupTableDepth; i++) 
-      lookupTable[i] = (unsigned int)(sinf((float)i*2*3.141592f/(float)lookupTableDepth) * (a/2500.0f * 255) + 512);
-    // Found through testing different values of delay vs. frequency and fitting a curve in Excel
-    addedDelay = (unsigned long)(5570.4 * powf(f , -1.12));
+    printLCDText("f = $"); printLCDNumber((int)f); printLCDText(" Hz $");
   }
+  printLCDText(waveNames[waveform]);
+  printLCDText("\nA = $"); printLCDNumber((int)a); printLCDText(" mV(P-P)$");
+}
+
+// Asks for the next level of the user waveform
+void askUserPoint(void) 
+{
+  clearLCD();
+  printLCDText("Point $"); printLCDNumber(userPoint + 1); printLCDText(" (0-1000)\n$");
+  entry = 0;
+  dialog = DIALOG_USER_POINT;
+}
+
+// Counts the words the SPI queue sends during one second of DDS samples and shows the rate, plus the number
+// of samples dropped because the queue was full and the deepest the queue has been. measureTask() looks at the
+// sample count from shortly before the second is up, and shows the result once it is.
+void showThroughput(void) 
+{
+  clearLCD();
+  printLCDText("Measuring...$");
+  dialog = DIALOG_MEASURE;
+  getSPIStats(&throughputBefore);
+  throughputStart = getDDSSampleCount();
+  startTaskTimer(measureTaskId, SCHEDULER_MS(1000 - MEASURE_POLL_MS), SCHEDULER_MS(MEASURE_POLL_MS));
+}
+
+void measureTask(unsigned char events) 
+{
+  struct spiStats after;
+  unsigned long sent;
+  
+  if (getDDSSampleCount() - throughputStart < DDS_SAMPLE_RATE)
+    return;
+  getSPIStats(&after);
+  stopTaskTimer(measureTaskId);
+  dialog = DIALOG_NONE;
+  
+  clearLCD();
+  // printLCDNumber() takes an int, so the rate is shown as thousands '.' units
+  sent = after.wordsSent - throughputBefore.wordsSent;
+  printLCDText("Sent: $"); printLCDNumber((int)(sent / 1000)); printLCDChar('.');
+  printLCDChar('0' + (sent / 100) % 10); printLCDChar('0' + (sent / 10) % 10); printLCDChar('0' + sent % 10);
+  printLCDText("k/s\n$");
+  printLCDText("Drop: $"); printLCDNumber((int)(after.wordsDropped - throughputBefore.wordsDropped));
+  printLCDText(" Q:$"); printLCDNumber(after.maxDepth);
 }
 
 ////////// Start SPI Physical Layer ////////// 
 
 void InitializeSPI() 
 {
-   // Your code from Part 1 goes here.
+  // SPI0 master at 6MHz, CS on PM6; transfers are done by the SPI0 interrupt (spi.c)
+  initializeSPIQueue();
 }
 
 ////////// End SPI Physical Layer ////////// 
@@ -171,12 +380,11 @@ void InitializeSPI()
 
 
 // Sends a double byte to the device connected to the SPI bus. The CS line
-// should be held high for the entire duration of the send. Could be improved
-// by replacing microcontroller-specific names (PTM_PTM6, SPI0DR, etc.) with
-// more generic inline functions or aliases in the physical layer.
+// is held low for the entire duration of the send. The bytes are queued and
+// this returns at once; SPI_ISR (spi.c) shifts them out and frames them.
 void SPI_Send(unsigned char data1, unsigned char data2) 
 {
-  // Your code from Part 2 goes here.
+  queueSPIWord(((unsigned int)data1 << 8) | data2);
 }
 
 ////////// End SPI Protocol Layer //////////
@@ -196,14 +404,10 @@ void InitializeDAC()
 // Sends the two data bytes formatted as expected by this specific chip.
 void DAC_SetOutputA(unsigned int output) 
 {
-  // Your code from Part 2 goes here.
+  // [  A3 A2 A1 A0   D9 D8 D7 D6 D5 D4 D3 D2 D1 D0 XX XX ]
+  // [ Control Code | Input code / DACA value      | Any  ]
+  // Control code 1001: load DAC A and update the outputs
+  SPI_Send(0x90 | ((output >> 6) & 0x0F), (unsigned char)(output << 2));
 }
 
 ////////// End Application Layer ////////// 
-
-
-
-
-
-
-
@@ -0,0 +1,262 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    scheduler.c                                    *
+*          Run-to-completion tasks, events and timers     *
+*---------------------------------------------------------*
+* Each event of each task has its own flag byte. Posting  *
+* only ever stores 1 and the scheduler stores 0 before it *
+* calls the task, so neither side needs to mask           *
+* interrupts: a post that lands while the flags are being *
+* taken is either taken with them or runs the task again. *
+* Timers and statistics belong to the main program only.  *
+**********************************************************/
+
+#include <hidef.h>
+#include "derivative.h"
+#include "timebase.h"
+#include "scheduler.h"
+
+#define TASK_EVENTS     8
+
+static void (*taskFunction[SCHEDULER_MAX_TASKS])(unsigned char events);
+static unsigned char taskCount = 0;
+
+// Written to 1 by postEvent(), to 0 by the scheduler
+static volatile unsigned char taskReady[SCHEDULER_MAX_TASKS];
+static volatile unsigned char taskFlags[SCHEDULER_MAX_TASKS][TASK_EVENTS];
+
+static unsigned char timerRunning[SCHEDULER_MAX_TASKS];
+static unsigned long timerDeadline[SCHEDULER_MAX_TASKS];
+static unsigned long timerPeriod[SCHEDULER_MAX_TASKS];
+static unsigned long timerFired[SCHEDULER_MAX_TASKS];     // deadline of the expiry not yet handled
+
+// Kept in timebase ticks, converted by getTaskStats()
+static unsigned long taskRuns[SCHEDULER_MAX_TASKS];
+static unsigned long worstRun[SCHEDULER_MAX_TASKS];
+static unsigned long totalRun[SCHEDULER_MAX_TASKS];
+static unsigned long worstLate[SCHEDULER_MAX_TASKS];
+static unsigned int skipped[SCHEDULER_MAX_TASKS];
+
+/************************************************
+*   initializeScheduler                         *
+*                                               *
+*   Desc.: Empties the task table and starts    *
+*          the timebase                         *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void initializeScheduler(void){
+    unsigned char t;
+
+    initializeTimebase();
+    taskCount = 0;
+    for (t = 0; t < SCHEDULER_MAX_TASKS; t++){
+        taskReady[t] = 0;
+        timerRunning[t] = 0;
+        clearTaskStats(t);
+    }
+}
+
+/************************************************
+*   addTask                                     *
+*                                               *
+*   Desc.: Adds a task after those already      *
+*          added, i.e. below them in priority   *
+*   Inputs:  function - Called with the events  *
+*            that woke it                       *
+*   Outputs: Task number, SCHEDULER_NO_TASK if  *
+*            the table is full                  *
+************************************************/
+
+unsigned char addTask(void (*function)(unsigned char events)){
+    unsigned char t = taskCount;
+    unsigned char n;
+
+    if (t >= SCHEDULER_MAX_TASKS)
+        return SCHEDULER_NO_TASK;
+    for (n = 0; n < TASK_EVENTS; n++)
+        taskFlags[t][n] = 0;
+    taskReady[t] = 0;
+    timerRunning[t] = 0;
+    clearTaskStats(t);
+    taskFunction[t] = function;
+    taskCount++;
+    return t;
+}
+
+/************************************************
+*   postEvent                                   *
+*                                               *
+*   Desc.: Wakes a task. Safe from interrupts.  *
+*          Events posted again before the task  *
+*          runs are seen once.                  *
+*   Inputs:  task - From addTask()              *
+*            events - Bits to set               *
+*   Outputs: None                               *
+************************************************/
+
+void postEvent(unsigned char task, unsigned char events){
+    unsigned char n;
+
+    if (task >= SCHEDULER_MAX_TASKS)
+        return;
+    for (n = 0; events != 0; n++, events >>= 1)
+        if (events & 1)
+            taskFlags[task][n] = 1;
+    taskReady[task] = 1;
+}
+
+/************************************************
+*   startTaskTimer                              *
+*                                               *
+*   Desc.: (Re)starts a task's timer, which     *
+*          posts SCHEDULER_EVENT_TIMER. Not     *
+*          from interrupts.                     *
+*   Inputs:  task - From addTask()              *
+*            delayUs - Until the first expiry   *
+*            periodUs - Between the next ones,  *
+*            0 to fire once                     *
+*   Outputs: None                               *
+************************************************/
+
+void startTaskTimer(unsigned char task, unsigned long delayUs, unsigned long periodUs){
+    if (task >= taskCount)
+        return;
+    timerDeadline[task] = getDeadline(delayUs);
+    timerPeriod[task] = TIMEBASE_US(periodUs);
+    timerRunning[task] = 1;
+}
+
+void stopTaskTimer(unsigned char task){
+    if (task < taskCount)
+        timerRunning[task] = 0;
+}
+
+/************************************************
+*   expireTimers                                *
+*                                               *
+*   Desc.: Posts the timer event of every task  *
+*          whose deadline has come, and moves   *
+*          periodic deadlines on by a period.   *
+*          A period that has already gone by    *
+*          too is skipped, not made up.         *
+*   Inputs:  now - getTimebaseTicks()           *
+*   Outputs: None                               *
+************************************************/
+
+static void expireTimers(unsigned long now){
+    unsigned char t;
+
+    for (t = 0; t < taskCount; t++){
+        if (!timerRunning[t] || (long)(now - timerDeadline[t]) < 0)
+            continue;
+        if (!taskFlags[t][0])
+            timerFired[t] = timerDeadline[t];
+        else
+            skipped[t]++;
+        taskFlags[t][0] = 1;
+        taskReady[t] = 1;
+
+        if (timerPeriod[t] == 0){
+            timerRunning[t] = 0;
+            continue;
+        }
+        timerDeadline[t] += timerPeriod[t];
+        while ((long)(now - timerDeadline[t]) >= 0){
+            timerDeadline[t] += timerPeriod[t];
+            skipped[t]++;
+        }
+    }
+}
+
+/************************************************
+*   runTask                                     *
+*                                               *
+*   Desc.: Takes a task's events and calls it,  *
+*          timing the run                       *
+*   Inputs:  t - Task number                    *
+*   Outputs: None                               *
+************************************************/
+
+static void runTask(unsigned char t){
+    unsigned char n, events = 0;
+    unsigned long start, elapsed;
+
+    taskReady[t] = 0;
+    for (n = 0; n < TASK_EVENTS; n++)
+        if (taskFlags[t][n]){
+            taskFlags[t][n] = 0;
+            events |= 1 << n;
+        }
+    if (events == 0)
+        return;                         // taken on the run before, see the top of this file
+
+    start = getTimebaseTicks();
+    if ((events & SCHEDULER_EVENT_TIMER) && start - timerFired[t] > worstLate[t])
+        worstLate[t] = start - timerFired[t];
+    taskFunction[t](events);
+    elapsed = getTimebaseTicks() - start;
+
+    taskRuns[t]++;
+    totalRun[t] += elapsed;
+    if (elapsed > worstRun[t])
+        worstRun[t] = elapsed;
+}
+
+/************************************************
+*   runScheduler                                *
+*                                               *
+*   Desc.: Runs tasks for good. After each run  *
+*          it starts again from the first task, *
+*          and waits for an interrupt when none *
+*          is ready.                            *
+*   Inputs:  None                               *
+*   Outputs: Does not return                    *
+************************************************/
+
+void runScheduler(void){
+    unsigned char t;
+
+    for (;;){
+        expireTimers(getTimebaseTicks());
+        for (t = 0; t < taskCount; t++)
+            if (taskReady[t])
+                break;
+        if (t < taskCount)
+            runTask(t);
+        else
+            __asm WAI;
+    }
+}
+
+/************************************************
+*   getTaskStats                                *
+*                                               *
+*   Desc.: Copies a task's counters             *
+*   Inputs:  task - From addTask()              *
+*            stats - Where to copy them         *
+*   Outputs: None                               *
+************************************************/
+
+void getTaskStats(unsigned char task, struct taskStats *stats){
+    if (task >= SCHEDULER_MAX_TASKS)
+        return;
+    stats->runs = taskRuns[task];
+    stats->worstRunUs = worstRun[task] / TIMEBASE_TICKS_PER_US;
+    stats->totalRunUs = totalRun[task] / TIMEBASE_TICKS_PER_US;
+    stats->worstLateUs = worstLate[task] / TIMEBASE_TICKS_PER_US;
+    stats->skipped = skipped[task];
+}
+
+// Starts a task's counters again, e.g. once start-up is over
+void clearTaskStats(unsigned char task){
+    if (task >= SCHEDULER_MAX_TASKS)
+        return;
+    taskRuns[task] = 0;
+    worstRun[task] = 0;
+    totalRun[task] = 0;
+    worstLate[task] = 0;
+    skipped[task] = 0;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    scheduler.h                                    *
+*          Run-to-completion tasks, events and timers     *
+*---------------------------------------------------------*
+* A task is a function that handles what it was woken     *
+* for and returns. It is woken by events, posted from an  *
+* interrupt or from another task, and by its own timer,   *
+* which fires once or every period. runScheduler() runs   *
+* the first task that is ready, in the order they were    *
+* added, so a task waits at most for the longest single   *
+* run of any task. getTaskStats() gives that run time,    *
+* measured on the timebase, for every task.               *
+*                                                         *
+* With nothing ready the CPU waits (WAI) for the next     *
+* interrupt, so a timer can be late by the longest gap    *
+* between interrupts: one keypad tick (1ms) in the labs.  *
+**********************************************************/
+
+#ifndef _SCHEDULER_H
+#define _SCHEDULER_H
+
+#define SCHEDULER_MAX_TASKS     6
+#define SCHEDULER_NO_TASK       0xFF    // addTask() with the table full
+
+// Events are bits of the byte a task is called with. The timer has the first; the others mean
+// whatever the task and the code posting to it agree on.
+#define SCHEDULER_EVENT_TIMER   0x01
+
+// Timer periods and delays, microseconds
+#define SCHEDULER_MS(ms)        ((unsigned long)(ms) * 1000UL)
+
+struct taskStats {
+    unsigned long runs;
+    unsigned long worstRunUs;   // longest single run
+    unsigned long totalRunUs;   // wraps after 23 minutes of run time
+    unsigned long worstLateUs;  // longest from a timer's deadline to the start of the run it caused
+    unsigned int skipped;       // periods missed because the task was still waiting for an earlier one
+};
+
+// Function prototypes - tell the compiler that these functions exist somewhere
+void initializeScheduler(void);
+unsigned char addTask(void (*function)(unsigned char events));
+void postEvent(unsigned char task, unsigned char events);
+void startTaskTimer(unsigned char task, unsigned long delayUs, unsigned long periodUs);
+void stopTaskTimer(unsigned char task);
+void runScheduler(void);
+void getTaskStats(unsigned char task, struct taskStats *stats);
+void clearTaskStats(unsigned char task);
+
+#endif
\ No newline at end of file
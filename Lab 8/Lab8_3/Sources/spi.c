@@ -0,0 +1,214 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    spi.c                                          *
+*          Interrupt-driven SPI0 transmit queue           *
+*---------------------------------------------------------*
+* The queue has one producer: either the main program or  *
+* an interrupt (e.g. DDS_ISR), not both at once. SPI_ISR  *
+* is the only consumer.                                   *
+**********************************************************/
+
+#include "derivative.h"
+#include "spi.h"
+
+#define SPI_CS      PTM_PTM6
+#define QUEUE_MASK  (SPI_QUEUE_SIZE - 1)
+
+static unsigned int spiQueue[SPI_QUEUE_SIZE];
+static volatile unsigned char spiHead = 0;          // next free slot, written by the producer
+static volatile unsigned char spiTail = 0;          // next word to send, written by SPI_ISR
+static volatile unsigned char spiActive = 0;        // a frame is on the bus
+static unsigned char spiLowByte;
+static unsigned char spiSecondByte = 0;
+static unsigned char spiBaud = SPI_BAUD;
+
+static volatile unsigned long wordsSent = 0, wordsDropped = 0;
+static volatile unsigned char maxDepth = 0;
+// Changes after every counter update, in SPI_ISR and in queueSPIWord() (also called from DDS_ISR), so the main
+// loop can copy the counters safely
+static volatile unsigned char spiSequence = 0;
+
+/************************************************
+*   startSPIWord                                *
+*                                               *
+*   Desc.: Opens a frame for the word at the    *
+*          tail of the queue and sends its high *
+*          byte. SPI_ISR sends the rest.        *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+static void startSPIWord(void){
+    unsigned int word = spiQueue[spiTail];
+
+    spiTail = (spiTail + 1) & QUEUE_MASK;
+    spiLowByte = (unsigned char)word;
+    spiSecondByte = 1;
+    spiActive = 1;
+    SPI_CS = 0;
+    SPI0DR = (unsigned char)(word >> 8);
+}
+
+/************************************************
+*   initializeSPIQueue                          *
+*                                               *
+*   Desc.: SPI0 master, mode 0, MSB first, with *
+*          the receive interrupt on. PS4-PS7    *
+*          carry SPI0; PM6 is the CS line.      *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void initializeSPIQueue(void){
+    SPI0CR1 = 0;
+    DDRS = DDRS | 0xE0;                 // MOSI, SCK and SS out, MISO in
+    DDRM_DDRM6 = 1;
+    SPI_CS = 1;                         // CS line idles high
+
+    SPI0BR = spiBaud;
+    SPI0CR2 = 0x00;                     // SS pin not used by the SPI, normal (not bidirectional) mode
+    SPI0CR1 = 0xD0;                     // SPIE | SPE | MSTR, CPOL = CPHA = 0
+
+    spiHead = 0;
+    spiTail = 0;
+    spiActive = 0;
+}
+
+/************************************************
+*   setSPIBusClock                              *
+*                                               *
+*   Desc.: Picks the fastest SCK, bus / 2^n,    *
+*          that is at most SPI_MAX_SCK_HZ for a *
+*          new bus clock. The byte on the wire  *
+*          when it changes may be garbled, as   *
+*          it is by the clock switch itself.    *
+*          Register it with addClockListener(). *
+*   Inputs:  busHz - The new bus clock          *
+*   Outputs: None                               *
+************************************************/
+
+void setSPIBusClock(unsigned long busHz){
+    unsigned char spr = 0;
+
+    while (spr < 7 && (busHz >> (spr + 1)) > SPI_MAX_SCK_HZ)
+        spr++;
+    spiBaud = spr;                      // SPPR = 0: SCK = bus / 2^(SPR + 1)
+    SPI0BR = spiBaud;
+}
+
+/************************************************
+*   queueSPIWord                                *
+*                                               *
+*   Desc.: Queues one 16-bit frame. Never       *
+*          waits: if the queue is full the word *
+*          is dropped and counted.              *
+*   Inputs:  word - Sent high byte first        *
+*   Outputs: 1 if queued, 0 if dropped          *
+************************************************/
+
+int queueSPIWord(unsigned int word){
+    unsigned char head = spiHead, depth;
+
+    depth = (head - spiTail) & QUEUE_MASK;
+    if (depth == QUEUE_MASK){
+        wordsDropped++;
+        spiSequence++;
+        return 0;
+    }
+    spiQueue[head] = word;
+    spiHead = (head + 1) & QUEUE_MASK;
+    if (depth + 1 > maxDepth){
+        maxDepth = depth + 1;
+        spiSequence++;
+    }
+
+    // Idle means no transfer is pending, so SPI_ISR cannot run until this starts one
+    if (!spiActive)
+        startSPIWord();
+    return 1;
+}
+
+/************************************************
+*   queueSPIBlock                               *
+*                                               *
+*   Desc.: Queues as many of 'count' words as   *
+*          fit and returns at once. The caller  *
+*          retries the rest later.              *
+*   Inputs:  words - Frames to send             *
+*            count - Number of frames           *
+*   Outputs: Number of words queued             *
+************************************************/
+
+unsigned char queueSPIBlock(const unsigned int *words, unsigned char count){
+    unsigned char n, space = getSPIQueueFree();
+
+    if (count > space)
+        count = space;
+    for (n = 0; n < count; n++)
+        queueSPIWord(words[n]);
+    return count;
+}
+
+unsigned char getSPIQueueFree(void){
+    return QUEUE_MASK - ((spiHead - spiTail) & QUEUE_MASK);
+}
+
+int isSPIBusy(void){
+    return spiActive;
+}
+
+/************************************************
+*   getSPIStats                                 *
+*                                               *
+*   Desc.: Copies the transfer counters. The    *
+*          copy is taken again if an interrupt  *
+*          changed them meanwhile, so a 32-bit  *
+*          count is never half updated.         *
+*   Inputs:  stats - Where to copy them         *
+*   Outputs: None                               *
+************************************************/
+
+void getSPIStats(struct spiStats *stats){
+    unsigned char sequence;
+
+    do {
+        sequence = spiSequence;
+        stats->wordsSent = wordsSent;
+        stats->wordsDropped = wordsDropped;
+        stats->maxDepth = maxDepth;
+    } while (sequence != spiSequence);
+}
+
+/************************************************
+*   SPI_ISR                                     *
+*                                               *
+*   Desc.: Runs when a byte has been shifted.   *
+*          Sends the low byte of the current    *
+*          frame, or ends the frame (CS high,   *
+*          the DAC latches) and starts the next *
+*          queued one.                          *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void interrupt VectorNumber_Vspi0 SPI_ISR(void){
+    unsigned char dummy;
+
+    dummy = SPI0SR;                     // reading SPI0SR then SPI0DR clears SPIF
+    dummy = SPI0DR;
+
+    if (spiSecondByte){
+        spiSecondByte = 0;
+        SPI0DR = spiLowByte;
+        return;
+    }
+
+    SPI_CS = 1;
+    wordsSent++;
+    spiSequence++;
+    if (spiTail != spiHead)
+        startSPIWord();
+    else
+        spiActive = 0;
+}
\ No newline at end of file
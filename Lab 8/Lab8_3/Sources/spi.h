@@ -0,0 +1,40 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    spi.h                                          *
+*          Interrupt-driven SPI0 transmit queue           *
+*---------------------------------------------------------*
+* Words are queued and sent in the background by the SPI0 *
+* interrupt. Each 16-bit word goes out MSB first as one   *
+* chip-select frame (CS on PM6 low for both bytes), which *
+* is what the LTC1661 DAC expects: it latches the word    *
+* when CS rises.                                          *
+**********************************************************/
+
+#ifndef _SPI_H
+#define _SPI_H
+
+// Must be a power of two, at most 128
+#define SPI_QUEUE_SIZE  64
+
+// SCK = bus / 4 = 6MHz with the 24MHz PLL (the LTC1661 allows 10MHz). setSPIBusClock() keeps SCK at
+// or below SPI_MAX_SCK_HZ when the bus changes.
+#define SPI_BAUD        0x01
+#define SPI_MAX_SCK_HZ  6000000L
+
+struct spiStats {
+    unsigned long wordsSent;
+    unsigned long wordsDropped;     // queueSPIWord() found the queue full
+    unsigned char maxDepth;         // most words ever waiting
+};
+
+// Function prototypes - tell the compiler that these functions exist somewhere
+void initializeSPIQueue(void);
+void setSPIBusClock(unsigned long busHz);
+int queueSPIWord(unsigned int word);
+unsigned char queueSPIBlock(const unsigned int *words, unsigned char count);
+unsigned char getSPIQueueFree(void);
+int isSPIBusy(void);
+void getSPIStats(struct spiStats *stats);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,55 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    timebase.h                                     *
+*          Monotonic time and delays from TCNT            *
+*---------------------------------------------------------*
+* TCNT gives the low 16 bits and Timebase_ISR counts its  *
+* overflows for the high 16, so time is kept in 32-bit    *
+* ticks. Delays wait for a deadline on that count rather  *
+* than spinning a loop, so they last the same whatever    *
+* the bus clock or the code around them.                  *
+*                                                         *
+* A deadline is a tick count. getDeadline() makes one a   *
+* number of microseconds from now and isDeadlinePassed()  *
+* tests it, which is all a timeout needs. Ticks wrap      *
+* after 23 minutes; a deadline works up to half that.     *
+*                                                         *
+* There is one TCNT overflow vector and Timebase_ISR has  *
+* it. Other drivers that count overflows add a listener   *
+* with addTimebaseListener() instead.                     *
+*                                                         *
+* TIMEBASE_TIMER_PRESCALE suits the bus the program       *
+* starts with. When the bus clock changes,                *
+* setTimebaseBusClock() picks the prescaler that keeps    *
+* the tick rate.                                          *
+**********************************************************/
+
+#ifndef _TIMEBASE_H
+#define _TIMEBASE_H
+
+// TCNT at 3MHz: setClock(CLOCK_24MHZ) sets the bus to 24MHz and setTimebaseBusClock() divides it by 8. Must be
+// a whole number of MHz.
+#define TIMEBASE_TIMER_PRESCALE 3
+#define TIMEBASE_TIMER_HZ       3000000L
+#define TIMEBASE_TICKS_PER_US   (TIMEBASE_TIMER_HZ / 1000000L)
+
+// Microseconds to ticks
+#define TIMEBASE_US(us)         ((unsigned long)(us) * TIMEBASE_TICKS_PER_US)
+
+// Other users of the TCNT overflow, called from Timebase_ISR
+#define TIMEBASE_MAX_LISTENERS  2
+
+// Function prototypes - tell the compiler that these functions exist somewhere
+void initializeTimebase(void);
+int addTimebaseListener(void (*listener)(void));
+void setTimebaseBusClock(unsigned long busHz);
+unsigned long getTimebaseTicks(void);
+unsigned long getMicros(void);
+unsigned long getDeadline(unsigned long us);
+unsigned char isDeadlinePassed(unsigned long deadline);
+void delayUntil(unsigned long deadline);
+void delayMicros(unsigned int us);
+void delayMillis(unsigned int ms);
+
+#endif
\ No newline at end of file
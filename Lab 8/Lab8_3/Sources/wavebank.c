@@ -0,0 +1,545 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    wavebank.c                                     *
+*          Stored waveforms, placed in paged flash        *
+*---------------------------------------------------------*
+* One cycle of 1024 signed Q15 samples per waveform, in   *
+* the order of WAVE_SQUARE..WAVE_NOISE. Generated values: *
+*   square   +32767 for the first half, -32767 after      *
+*   triangle in phase with the sine: 0, +1 at 1/4, 0 at   *
+*            1/2, -1 at 3/4                               *
+*   sawtooth -32767 to +32767 in equal steps              *
+*   noise    16-bit Galois LFSR (taps 0xB400, seed        *
+*            0xACE1) minus 32768, clamped to +/-32767     *
+* The linker places segment WAVE_BANK in PAGE_3D (prm).   *
+**********************************************************/
+
+#include "wavetable.h"
+
+#pragma CONST_SEG __PPAGE_SEG WAVE_BANK
+
+const int __far waveBank[WAVE_BANK_COUNT][DDS_TABLE_SIZE] = {
+    {   // square
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+         32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+        -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767
+    },
+    {   // triangle
+             0,    128,    256,    384,    512,    640,    768,    896,
+          1024,   1152,   1280,   1408,   1536,   1664,   1792,   1920,
+          2048,   2176,   2304,   2432,   2560,   2688,   2816,   2944,
+          3072,   3200,   3328,   3456,   3584,   3712,   3840,   3968,
+          4096,   4224,   4352,   4480,   4608,   4736,   4864,   4992,
+          5120,   5248,   5376,   5504,   5632,   5760,   5888,   6016,
+          6144,   6272,   6400,   6528,   6656,   6784,   6912,   7040,
+          7168,   7296,   7424,   7552,   7680,   7808,   7936,   8064,
+          8192,   8320,   8448,   8576,   8704,   8832,   8960,   9088,
+          9216,   9344,   9472,   9600,   9728,   9856,   9984,  10112,
+         10240,  10368,  10496,  10624,  10752,  10880,  11008,  11136,
+         11264,  11392,  11520,  11648,  11776,  11904,  12032,  12160,
+         12288,  12416,  12544,  12672,  12800,  12928,  13056,  13184,
+         13312,  13440,  13568,  13696,  13824,  13952,  14080,  14208,
+         14336,  14464,  14592,  14720,  14848,  14976,  15104,  15232,
+         15360,  15488,  15616,  15744,  15872,  16000,  16128,  16256,
+         16384,  16511,  16639,  16767,  16895,  17023,  17151,  17279,
+         17407,  17535,  17663,  17791,  17919,  18047,  18175,  18303,
+         18431,  18559,  18687,  18815,  18943,  19071,  19199,  19327,
+         19455,  19583,  19711,  19839,  19967,  20095,  20223,  20351,
+         20479,  20607,  20735,  20863,  20991,  21119,  21247,  21375,
+         21503,  21631,  21759,  21887,  22015,  22143,  22271,  22399,
+         22527,  22655,  22783,  22911,  23039,  23167,  23295,  23423,
+         23551,  23679,  23807,  23935,  24063,  24191,  24319,  24447,
+         24575,  24703,  24831,  24959,  25087,  25215,  25343,  25471,
+         25599,  25727,  25855,  25983,  26111,  26239,  26367,  26495,
+         26623,  26751,  26879,  27007,  27135,  27263,  27391,  27519,
+         27647,  27775,  27903,  28031,  28159,  28287,  28415,  28543,
+         28671,  28799,  28927,  29055,  29183,  29311,  29439,  29567,
+         29695,  29823,  29951,  30079,  30207,  30335,  30463,  30591,
+         30719,  30847,  30975,  31103,  31231,  31359,  31487,  31615,
+         31743,  31871,  31999,  32127,  32255,  32383,  32511,  32639,
+         32767,  32639,  32511,  32383,  32255,  32127,  31999,  31871,
+         31743,  31615,  31487,  31359,  31231,  31103,  30975,  30847,
+         30719,  30591,  30463,  30335,  30207,  30079,  29951,  29823,
+         29695,  29567,  29439,  29311,  29183,  29055,  28927,  28799,
+         28671,  28543,  28415,  28287,  28159,  28031,  27903,  27775,
+         27647,  27519,  27391,  27263,  27135,  27007,  26879,  26751,
+         26623,  26495,  26367,  26239,  26111,  25983,  25855,  25727,
+         25599,  25471,  25343,  25215,  25087,  24959,  24831,  24703,
+         24575,  24447,  24319,  24191,  24063,  23935,  23807,  23679,
+         23551,  23423,  23295,  23167,  23039,  22911,  22783,  22655,
+         22527,  22399,  22271,  22143,  22015,  21887,  21759,  21631,
+         21503,  21375,  21247,  21119,  20991,  20863,  20735,  20607,
+         20479,  20351,  20223,  20095,  19967,  19839,  19711,  19583,
+         19455,  19327,  19199,  19071,  18943,  18815,  18687,  18559,
+         18431,  18303,  18175,  18047,  17919,  17791,  17663,  17535,
+         17407,  17279,  17151,  17023,  16895,  16767,  16639,  16511,
+         16384,  16256,  16128,  16000,  15872,  15744,  15616,  15488,
+         15360,  15232,  15104,  14976,  14848,  14720,  14592,  14464,
+         14336,  14208,  14080,  13952,  13824,  13696,  13568,  13440,
+         13312,  13184,  13056,  12928,  12800,  12672,  12544,  12416,
+         12288,  12160,  12032,  11904,  11776,  11648,  11520,  11392,
+         11264,  11136,  11008,  10880,  10752,  10624,  10496,  10368,
+         10240,  10112,   9984,   9856,   9728,   9600,   9472,   9344,
+          9216,   9088,   8960,   8832,   8704,   8576,   8448,   8320,
+          8192,   8064,   7936,   7808,   7680,   7552,   7424,   7296,
+          7168,   7040,   6912,   6784,   6656,   6528,   6400,   6272,
+          6144,   6016,   5888,   5760,   5632,   5504,   5376,   5248,
+          5120,   4992,   4864,   4736,   4608,   4480,   4352,   4224,
+          4096,   3968,   3840,   3712,   3584,   3456,   3328,   3200,
+          3072,   2944,   2816,   2688,   2560,   2432,   2304,   2176,
+          2048,   1920,   1792,   1664,   1536,   1408,   1280,   1152,
+          1024,    896,    768,    640,    512,    384,    256,    128,
+             0,   -128,   -256,   -384,   -512,   -640,   -768,   -896,
+         -1024,  -1152,  -1280,  -1408,  -1536,  -1664,  -1792,  -1920,
+         -2048,  -2176,  -2304,  -2432,  -2560,  -2688,  -2816,  -2944,
+         -3072,  -3200,  -3328,  -3456,  -3584,  -3712,  -3840,  -3968,
+         -4096,  -4224,  -4352,  -4480,  -4608,  -4736,  -4864,  -4992,
+         -5120,  -5248,  -5376,  -5504,  -5632,  -5760,  -5888,  -6016,
+         -6144,  -6272,  -6400,  -6528,  -6656,  -6784,  -6912,  -7040,
+         -7168,  -7296,  -7424,  -7552,  -7680,  -7808,  -7936,  -8064,
+         -8192,  -8320,  -8448,  -8576,  -8704,  -8832,  -8960,  -9088,
+         -9216,  -9344,  -9472,  -9600,  -9728,  -9856,  -9984, -10112,
+        -10240, -10368, -10496, -10624, -10752, -10880, -11008, -11136,
+        -11264, -11392, -11520, -11648, -11776, -11904, -12032, -12160,
+        -12288, -12416, -12544, -12672, -12800, -12928, -13056, -13184,
+        -13312, -13440, -13568, -13696, -13824, -13952, -14080, -14208,
+        -14336, -14464, -14592, -14720, -14848, -14976, -15104, -15232,
+        -15360, -15488, -15616, -15744, -15872, -16000, -16128, -16256,
+        -16384, -16511, -16639, -16767, -16895, -17023, -17151, -17279,
+        -17407, -17535, -17663, -17791, -17919, -18047, -18175, -18303,
+        -18431, -18559, -18687, -18815, -18943, -19071, -19199, -19327,
+        -19455, -19583, -19711, -19839, -19967, -20095, -20223, -20351,
+        -20479, -20607, -20735, -20863, -20991, -21119, -21247, -21375,
+        -21503, -21631, -21759, -21887, -22015, -22143, -22271, -22399,
+        -22527, -22655, -22783, -22911, -23039, -23167, -23295, -23423,
+        -23551, -23679, -23807, -23935, -24063, -24191, -24319, -24447,
+        -24575, -24703, -24831, -24959, -25087, -25215, -25343, -25471,
+        -25599, -25727, -25855, -25983, -26111, -26239, -26367, -26495,
+        -26623, -26751, -26879, -27007, -27135, -27263, -27391, -27519,
+        -27647, -27775, -27903, -28031, -28159, -28287, -28415, -28543,
+        -28671, -28799, -28927, -29055, -29183, -29311, -29439, -29567,
+        -29695, -29823, -29951, -30079, -30207, -30335, -30463, -30591,
+        -30719, -30847, -30975, -31103, -31231, -31359, -31487, -31615,
+        -31743, -31871, -31999, -32127, -32255, -32383, -32511, -32639,
+        -32767, -32639, -32511, -32383, -32255, -32127, -31999, -31871,
+        -31743, -31615, -31487, -31359, -31231, -31103, -30975, -30847,
+        -30719, -30591, -30463, -30335, -30207, -30079, -29951, -29823,
+        -29695, -29567, -29439, -29311, -29183, -29055, -28927, -28799,
+        -28671, -28543, -28415, -28287, -28159, -28031, -27903, -27775,
+        -27647, -27519, -27391, -27263, -27135, -27007, -26879, -26751,
+        -26623, -26495, -26367, -26239, -26111, -25983, -25855, -25727,
+        -25599, -25471, -25343, -25215, -25087, -24959, -24831, -24703,
+        -24575, -24447, -24319, -24191, -24063, -23935, -23807, -23679,
+        -23551, -23423, -23295, -23167, -23039, -22911, -22783, -22655,
+        -22527, -22399, -22271, -22143, -22015, -21887, -21759, -21631,
+        -21503, -21375, -21247, -21119, -20991, -20863, -20735, -20607,
+        -20479, -20351, -20223, -20095, -19967, -19839, -19711, -19583,
+        -19455, -19327, -19199, -19071, -18943, -18815, -18687, -18559,
+        -18431, -18303, -18175, -18047, -17919, -17791, -17663, -17535,
+        -17407, -17279, -17151, -17023, -16895, -16767, -16639, -16511,
+        -16384, -16256, -16128, -16000, -15872, -15744, -15616, -15488,
+        -15360, -15232, -15104, -14976, -14848, -14720, -14592, -14464,
+        -14336, -14208, -14080, -13952, -13824, -13696, -13568, -13440,
+        -13312, -13184, -13056, -12928, -12800, -12672, -12544, -12416,
+        -12288, -12160, -12032, -11904, -11776, -11648, -11520, -11392,
+        -11264, -11136, -11008, -10880, -10752, -10624, -10496, -10368,
+        -10240, -10112,  -9984,  -9856,  -9728,  -9600,  -9472,  -9344,
+         -9216,  -9088,  -8960,  -8832,  -8704,  -8576,  -8448,  -8320,
+         -8192,  -8064,  -7936,  -7808,  -7680,  -7552,  -7424,  -7296,
+         -7168,  -7040,  -6912,  -6784,  -6656,  -6528,  -6400,  -6272,
+         -6144,  -6016,  -5888,  -5760,  -5632,  -5504,  -5376,  -5248,
+         -5120,  -4992,  -4864,  -4736,  -4608,  -4480,  -4352,  -4224,
+         -4096,  -3968,  -3840,  -3712,  -3584,  -3456,  -3328,  -3200,
+         -3072,  -2944,  -2816,  -2688,  -2560,  -2432,  -2304,  -2176,
+         -2048,  -1920,  -1792,  -1664,  -1536,  -1408,  -1280,  -1152,
+         -1024,   -896,   -768,   -640,   -512,   -384,   -256,   -128
+    },
+    {   // sawtooth
+        -32767, -32703, -32639, -32575, -32511, -32447, -32383, -32319,
+        -32255, -32190, -32126, -32062, -31998, -31934, -31870, -31806,
+        -31742, -31678, -31614, -31550, -31486, -31422, -31358, -31294,
+        -31230, -31165, -31101, -31037, -30973, -30909, -30845, -30781,
+        -30717, -30653, -30589, -30525, -30461, -30397, -30333, -30269,
+        -30205, -30141, -30076, -30012, -29948, -29884, -29820, -29756,
+        -29692, -29628, -29564, -29500, -29436, -29372, -29308, -29244,
+        -29180, -29116, -29051, -28987, -28923, -28859, -28795, -28731,
+        -28667, -28603, -28539, -28475, -28411, -28347, -28283, -28219,
+        -28155, -28091, -28027, -27962, -27898, -27834, -27770, -27706,
+        -27642, -27578, -27514, -27450, -27386, -27322, -27258, -27194,
+        -27130, -27066, -27002, -26937, -26873, -26809, -26745, -26681,
+        -26617, -26553, -26489, -26425, -26361, -26297, -26233, -26169,
+        -26105, -26041, -25977, -25913, -25848, -25784, -25720, -25656,
+        -25592, -25528, -25464, -25400, -25336, -25272, -25208, -25144,
+        -25080, -25016, -24952, -24888, -24823, -24759, -24695, -24631,
+        -24567, -24503, -24439, -24375, -24311, -24247, -24183, -24119,
+        -24055, -23991, -23927, -23863, -23799, -23734, -23670, -23606,
+        -23542, -23478, -23414, -23350, -23286, -23222, -23158, -23094,
+        -23030, -22966, -22902, -22838, -22774, -22709, -22645, -22581,
+        -22517, -22453, -22389, -22325, -22261, -22197, -22133, -22069,
+        -22005, -21941, -21877, -21813, -21749, -21685, -21620, -21556,
+        -21492, -21428, -21364, -21300, -21236, -21172, -21108, -21044,
+        -20980, -20916, -20852, -20788, -20724, -20660, -20595, -20531,
+        -20467, -20403, -20339, -20275, -20211, -20147, -20083, -20019,
+        -19955, -19891, -19827, -19763, -19699, -19635, -19571, -19506,
+        -19442, -19378, -19314, -19250, -19186, -19122, -19058, -18994,
+        -18930, -18866, -18802, -18738, -18674, -18610, -18546, -18481,
+        -18417, -18353, -18289, -18225, -18161, -18097, -18033, -17969,
+        -17905, -17841, -17777, -17713, -17649, -17585, -17521, -17457,
+        -17392, -17328, -17264, -17200, -17136, -17072, -17008, -16944,
+        -16880, -16816, -16752, -16688, -16624, -16560, -16496, -16432,
+        -16367, -16303, -16239, -16175, -16111, -16047, -15983, -15919,
+        -15855, -15791, -15727, -15663, -15599, -15535, -15471, -15407,
+        -15343, -15278, -15214, -15150, -15086, -15022, -14958, -14894,
+        -14830, -14766, -14702, -14638, -14574, -14510, -14446, -14382,
+        -14318, -14253, -14189, -14125, -14061, -13997, -13933, -13869,
+        -13805, -13741, -13677, -13613, -13549, -13485, -13421, -13357,
+        -13293, -13229, -13164, -13100, -13036, -12972, -12908, -12844,
+        -12780, -12716, -12652, -12588, -12524, -12460, -12396, -12332,
+        -12268, -12204, -12139, -12075, -12011, -11947, -11883, -11819,
+        -11755, -11691, -11627, -11563, -11499, -11435, -11371, -11307,
+        -11243, -11179, -11115, -11050, -10986, -10922, -10858, -10794,
+        -10730, -10666, -10602, -10538, -10474, -10410, -10346, -10282,
+        -10218, -10154, -10090, -10025,  -9961,  -9897,  -9833,  -9769,
+         -9705,  -9641,  -9577,  -9513,  -9449,  -9385,  -9321,  -9257,
+         -9193,  -9129,  -9065,  -9001,  -8936,  -8872,  -8808,  -8744,
+         -8680,  -8616,  -8552,  -8488,  -8424,  -8360,  -8296,  -8232,
+         -8168,  -8104,  -8040,  -7976,  -7911,  -7847,  -7783,  -7719,
+         -7655,  -7591,  -7527,  -7463,  -7399,  -7335,  -7271,  -7207,
+         -7143,  -7079,  -7015,  -6951,  -6887,  -6822,  -6758,  -6694,
+         -6630,  -6566,  -6502,  -6438,  -6374,  -6310,  -6246,  -6182,
+         -6118,  -6054,  -5990,  -5926,  -5862,  -5797,  -5733,  -5669,
+         -5605,  -5541,  -5477,  -5413,  -5349,  -5285,  -5221,  -5157,
+         -5093,  -5029,  -4965,  -4901,  -4837,  -4773,  -4708,  -4644,
+         -4580,  -4516,  -4452,  -4388,  -4324,  -4260,  -4196,  -4132,
+         -4068,  -4004,  -3940,  -3876,  -3812,  -3748,  -3683,  -3619,
+         -3555,  -3491,  -3427,  -3363,  -3299,  -3235,  -3171,  -3107,
+         -3043,  -2979,  -2915,  -2851,  -2787,  -2723,  -2659,  -2594,
+         -2530,  -2466,  -2402,  -2338,  -2274,  -2210,  -2146,  -2082,
+         -2018,  -1954,  -1890,  -1826,  -1762,  -1698,  -1634,  -1569,
+         -1505,  -1441,  -1377,  -1313,  -1249,  -1185,  -1121,  -1057,
+          -993,   -929,   -865,   -801,   -737,   -673,   -609,   -545,
+          -480,   -416,   -352,   -288,   -224,   -160,    -96,    -32,
+            32,     96,    160,    224,    288,    352,    416,    480,
+           545,    609,    673,    737,    801,    865,    929,    993,
+          1057,   1121,   1185,   1249,   1313,   1377,   1441,   1505,
+          1569,   1634,   1698,   1762,   1826,   1890,   1954,   2018,
+          2082,   2146,   2210,   2274,   2338,   2402,   2466,   2530,
+          2594,   2659,   2723,   2787,   2851,   2915,   2979,   3043,
+          3107,   3171,   3235,   3299,   3363,   3427,   3491,   3555,
+          3619,   3683,   3748,   3812,   3876,   3940,   4004,   4068,
+          4132,   4196,   4260,   4324,   4388,   4452,   4516,   4580,
+          4644,   4708,   4773,   4837,   4901,   4965,   5029,   5093,
+          5157,   5221,   5285,   5349,   5413,   5477,   5541,   5605,
+          5669,   5733,   5797,   5862,   5926,   5990,   6054,   6118,
+          6182,   6246,   6310,   6374,   6438,   6502,   6566,   6630,
+          6694,   6758,   6822,   6887,   6951,   7015,   7079,   7143,
+          7207,   7271,   7335,   7399,   7463,   7527,   7591,   7655,
+          7719,   7783,   7847,   7911,   7976,   8040,   8104,   8168,
+          8232,   8296,   8360,   8424,   8488,   8552,   8616,   8680,
+          8744,   8808,   8872,   8936,   9001,   9065,   9129,   9193,
+          9257,   9321,   9385,   9449,   9513,   9577,   9641,   9705,
+          9769,   9833,   9897,   9961,  10025,  10090,  10154,  10218,
+         10282,  10346,  10410,  10474,  10538,  10602,  10666,  10730,
+         10794,  10858,  10922,  10986,  11050,  11115,  11179,  11243,
+         11307,  11371,  11435,  11499,  11563,  11627,  11691,  11755,
+         11819,  11883,  11947,  12011,  12075,  12139,  12204,  12268,
+         12332,  12396,  12460,  12524,  12588,  12652,  12716,  12780,
+         12844,  12908,  12972,  13036,  13100,  13164,  13229,  13293,
+         13357,  13421,  13485,  13549,  13613,  13677,  13741,  13805,
+         13869,  13933,  13997,  14061,  14125,  14189,  14253,  14318,
+         14382,  14446,  14510,  14574,  14638,  14702,  14766,  14830,
+         14894,  14958,  15022,  15086,  15150,  15214,  15278,  15343,
+         15407,  15471,  15535,  15599,  15663,  15727,  15791,  15855,
+         15919,  15983,  16047,  16111,  16175,  16239,  16303,  16367,
+         16432,  16496,  16560,  16624,  16688,  16752,  16816,  16880,
+         16944,  17008,  17072,  17136,  17200,  17264,  17328,  17392,
+         17457,  17521,  17585,  17649,  17713,  17777,  17841,  17905,
+         17969,  18033,  18097,  18161,  18225,  18289,  18353,  18417,
+         18481,  18546,  18610,  18674,  18738,  18802,  18866,  18930,
+         18994,  19058,  19122,  19186,  19250,  19314,  19378,  19442,
+         19506,  19571,  19635,  19699,  19763,  19827,  19891,  19955,
+         20019,  20083,  20147,  20211,  20275,  20339,  20403,  20467,
+         20531,  20595,  20660,  20724,  20788,  20852,  20916,  20980,
+         21044,  21108,  21172,  21236,  21300,  21364,  21428,  21492,
+         21556,  21620,  21685,  21749,  21813,  21877,  21941,  22005,
+         22069,  22133,  22197,  22261,  22325,  22389,  22453,  22517,
+         22581,  22645,  22709,  22774,  22838,  22902,  22966,  23030,
+         23094,  23158,  23222,  23286,  23350,  23414,  23478,  23542,
+         23606,  23670,  23734,  23799,  23863,  23927,  23991,  24055,
+         24119,  24183,  24247,  24311,  24375,  24439,  24503,  24567,
+         24631,  24695,  24759,  24823,  24888,  24952,  25016,  25080,
+         25144,  25208,  25272,  25336,  25400,  25464,  25528,  25592,
+         25656,  25720,  25784,  25848,  25913,  25977,  26041,  26105,
+         26169,  26233,  26297,  26361,  26425,  26489,  26553,  26617,
+         26681,  26745,  26809,  26873,  26937,  27002,  27066,  27130,
+         27194,  27258,  27322,  27386,  27450,  27514,  27578,  27642,
+         27706,  27770,  27834,  27898,  27962,  28027,  28091,  28155,
+         28219,  28283,  28347,  28411,  28475,  28539,  28603,  28667,
+         28731,  28795,  28859,  28923,  28987,  29051,  29116,  29180,
+         29244,  29308,  29372,  29436,  29500,  29564,  29628,  29692,
+         29756,  29820,  29884,  29948,  30012,  30076,  30141,  30205,
+         30269,  30333,  30397,  30461,  30525,  30589,  30653,  30717,
+         30781,  30845,  30909,  30973,  31037,  31101,  31165,  31230,
+         31294,  31358,  31422,  31486,  31550,  31614,  31678,  31742,
+         31806,  31870,  31934,  31998,  32062,  32126,  32190,  32255,
+         32319,  32383,  32447,  32511,  32575,  32639,  32703,  32767
+    },
+    {   // noise
+         25200,  -3784, -18276, -25522, -29145,  13075,  28041,  17092,
+         -7838, -20303,  11352, -10708, -21738, -27253,  16069,  27490,
+         -2639,   3800, -14484, -23626, -28197,  15597,  27254,  -2757,
+          3741,  29518,  -1625,   2259,  28777,  19508,  -6630, -19699,
+         11654, -10557,   8033,  31664,   -552, -16660, -24714, -28741,
+         13277,  28142,  -2313,   3963,  29629,  19934,  -6417,   1911,
+         30651,  20445,  21486,  -5641,    251,  29821,  20030,  -6369,
+          1935,  30663,  20451,  21489,  24056,  -4356, -18562, -25665,
+         14815,  26863,  16503,  21563,  24093,  23310,  -4729,    707,
+         30049,  20144,  -6312, -19540, -26154, -29461,  12917,  27962,
+         -2403,   3918, -14425,   6099,  32745,  19444,  -6662, -19715,
+         11646, -10561,   8031,  31663,  18903,  20715,  23669,  23098,
+         -4835,    654, -16057,   5283,  32337,  19240,  -6764, -19766,
+        -26267,  14514,  -9127,   6700, -13034, -22901,  10053,  26530,
+         -3119,   3560, -14604, -23686, -28227,  15582,  -8593,   6967,
+         31131,  18637,  20582,  -6093,     25,  29708,  -1530, -17149,
+         10881,  24896,  -3936, -18352, -25560, -29164, -30966, -31867,
+         13762,  -9503,   6512, -13128, -22948, -27858, -30313,  12491,
+         27749,  16946,  -7911,   1164, -15802, -24285,   9361,  26184,
+         -3292, -18030, -25399,  14948,  -8910, -20839,   9036, -11866,
+        -22317,   8297,  25652,  -3558, -18163,  10374, -11197,   7713,
+         31504,   -632, -16700, -24734, -28751,  13272,  -9748, -21258,
+        -27013,  16189,  27550,  -2609,   3815,  29555,  19897,  21212,
+         -5778, -19273,  11867,  25389,  17814,  -7477,   1381,  30386,
+         -1191,   2476, -15146, -23957,   9525,  26266,  -3251,   3494,
+        -14637,   5993,  32692,    -38, -16403,  11254, -10757,   7933,
+         31614,   -577,   2783,  29039,  19639,  21083,  23853,  23190,
+         -4789,    677,  30034,  -1367,   2388, -15190, -23979,   9514,
+        -11627,   7498, -12635,   4946, -13911,   4308, -14230, -23499,
+          9754, -11507,   7558, -12605,   4961,  32176,   -296, -16532,
+        -24650, -28709,  13293,  28150,  -2309,   3965,  29630,  -1569,
+          2287,  28791,  19515,  21021,  23822,  -4473,    835,  30113,
+         20176,  -6296, -19532, -26150, -29459,  12918,  -9925,   6301,
+         30798,   -985,   2579,  28937,  19588,  -6590, -19679,  11664,
+        -10552, -21660, -27214, -29991,  12652, -10058, -21413,   8749,
+         25878,  -3445,   3397,  29346,  -1711,   2216, -15276, -24022,
+        -28395,  15498,  -8635,   6946, -12911,   4808, -13980, -23374,
+        -28071,  15660,  -8554, -20661,   9125,  26066,  -3351,   3444,
+        -14662, -23715,   9646, -11561,   7531,  31413,  18778,  -6995,
+          1622, -15573,   5525,  32458,   -155,   2994, -14887,   5868,
+        -13450, -23109,   9949,  26478,  -3145,   3547,  29421,  19830,
+         -6469,   1885,  30638,  -1065,   2539,  28917,  19578,  -6595,
+          1822, -15473,   5575,  32483,  19313,  20920,  -5924, -19346,
+        -26057,  14619,  26765,  16454,  -8157,   1041,  30216,  -1276,
+        -17022, -24895,  15200,  -8784, -20776, -26772, -29770, -31269,
+         14061,  28534,  -2117,   4061,  29678,  -1545,   2299,  28797,
+         19518,  -6625,   1807,  30599,  20419,  21473,  24048,  -4360,
+        -18564, -25666, -29217,  13039,  28023,  17083,  21853,  24238,
+         -4265,    939,  30165,  20202,  -6283,   1978, -15395,   5614,
+        -13577,   4475,  31933,  19038,  -6865,   1687,  30539,  20389,
+         21458,  -5655,    244, -16262, -24515,   9246, -11761,   7431,
+         31363,  18753,  20640,  -6064, -19416, -26092, -29430, -31099,
+         14146,  -9311,   6608, -13080, -22924, -27846, -30307,  12494,
+        -10137,   6195,  30745,  18444,  -7162, -19965,  11521,  25216,
+         -3776, -18272, -25520, -29144, -30956, -31862, -32315,  13538,
+         -9615,   6456, -13156, -22962, -27865,  15763,  27337,  16740,
+         -8014, -20391,  11308, -10730, -21749,   8581,  25794,  -3487,
+          3376, -14696, -23732, -28250, -30509,  12393,  27700,  -2534,
+        -17651,  10630, -11069,   7777,  31536,   -616, -16692, -24730,
+        -28749,  13273,  28140,  -2314, -17541,  10685,  24798,  -3985,
+          3127,  29211,  19725,  21126,  -5821,    161,  29776,  -1496,
+        -17132, -24950, -28859,  13218,  -9775,   6376, -13196, -22982,
+        -27875,  15758,  -8505,   7011,  31153,  18648,  -7060, -19914,
+        -26341,  14477,  26694,  -3037,   3601,  29448,  -1660, -17214,
+        -24991,  15152,  -8808, -20788, -26778, -29773,  12761,  27884,
+         -2442, -17605,  10653,  24782,  -3993,   3123,  29209,  19724,
+         -6522, -19645,  11681,  25296,  -3736, -18252, -25510, -29139,
+         13078,  -9845,   6341,  30818,   -975,   2584, -15092, -23930,
+        -28349,  15521,  27216,  -2776, -17772, -25270, -29019,  13138,
+         -9815,   6356, -13206, -22987,  10010, -11379,   7622, -12573,
+          4977,  32184,   -292, -16530, -24649,  15323,  27117,  16630,
+         -8069,   1085,  30238,  -1265,   2439,  28867,  19553,  21040,
+         -5864, -19316, -26042, -29405,  12945,  27976,  -2396, -17582,
+        -25175,  15060,  -8854, -20811,   9050, -11859,   7382, -12693,
+          4917,  32154,   -307,   2918, -14925,   5849,  32620,    -74,
+        -16421,  11245,  25078,  -3845,   3197,  29246,  -1761,   2191,
+         28743,  19491,  21009,  23816,  -4476, -18622, -25695,  14800,
+         -8984, -20876, -26822, -29795,  12750, -10009,   6259,  30777,
+         18460,  -7154, -19961,  11523,  25217,  17728,  -7520, -20144,
+        -26456, -29612, -31190, -31979,  13706,  -9531,   6498, -13135,
+          4696, -14036, -23402, -28085,  15653,  27282,  -2743,   3748,
+        -14510, -23639,   9684, -11542, -22155,   8378, -12195,   7214,
+        -12777,   4875,  32133,  19138,  -6815,   1712, -15528, -24148,
+        -28458, -30613,  12341,  27674,  -2547,   3846, -14461,   6081,
+         32736,    -16, -16392, -24580, -28674, -30721,  14335,  28671,
+         17407,  22015,  24319,  23423,  22975,  22751,  22639,  22583,
+         22555,  22541,  22534,  -5117,    513,  29952,  -1408, -17088,
+        -24928, -28848, -30808, -31788, -32278, -32523,  13434,  -9667,
+          6430, -13169,   4679,  32035,  19089,  20808,  -5980, -19374,
+        -26071,  14612,  -9078, -20923,   8994, -11887,   7368, -12700,
+        -22734, -27751,  15820,  -8474, -20621,   9145,  26076,  -3346,
+        -18057,  10427,  24669,  17454,  -7657,   1291,  30341,  20290,
+         -6239,   2000, -15384, -24076, -28422, -30595,  12350, -10209,
+          6159,  30727,  18435,  20481,  23552,  -4608, -18688, -25728,
+        -29248, -31008, -31888, -32328, -32548, -32658, -32713,  13339,
+         28173,  17158,  -7805,   1217,  30304,  -1232, -17000, -24884,
+        -28826, -30797,  14297,  28652,  -2058, -17413,  10749,  24830,
+         -3969,   3135,  29215,  19727,  21127,  23875,  23201,  22864,
+         -4952, -18860, -25814, -29291,  13002,  -9883,   6322, -13223,
+          4652, -14058, -23413,   9797,  26402,  -3183,   3528, -14620,
+        -23694, -28231,  15580,  -8594, -20681,   9115,  26061,  18150,
+         -7309,   1465,  30428,  -1170, -16969,  10971,  24941,  17590,
+         -7589,   1325,  30358,  -1205,   2469,  28882,  -1943,   2100,
+        -15334, -24051,   9478, -11645,   7489,  31392,   -688, -16728,
+        -24748, -28758, -30763,  14314,  -9227,   6650, -13059,   4734,
+        -14017,   4255,  31823,  18983,  20755,  23689,  23108,  -4830,
+        -18799,  12104, -10332, -21550, -27159,  16116,  -8326, -20547,
+          9182, -11793,   7415,  31355,  18749,  20638,  -6065,     39,
+         29715,  19977,  21252,  -5758, -19263,  11872, -10448, -21608,
+        -27188, -29978, -31373,  14009,  28508,  -2130, -17449,  10731,
+         24821,  17530,  -7619,   1310, -15729,   5447,  32419,  19281,
+         20904,  -5932, -19350, -26059,  14618,  -9075,   6726, -13021,
+          4753,  32072,   -348, -16558, -24663,  15316,  -8726, -20747,
+          9082, -11843,   7390, -12689,   4919,  32155,  19149,  20838,
+         -5965,     89,  29740,  -1514, -17141,  10885,  24898,  -3935,
+          3152, -14808, -23788, -28278, -30523,  12386, -10191,   6168,
+        -13300, -23034, -27901,  15745,  27328,  -2720, -17744, -25256,
+        -29012, -30890, -31829,  13781,  28394,  -2187,   4026, -14371,
+          6126, -13321,   4603,  31997,  19070,  -6849,   1695,  30543,
+         20391,  21459,  24041,  23284,  -4742, -18755,  12126, -10321,
+          8151,  31723,  18933,  20730,  -6019,     62, -16353,   5135,
+         32263,  19203,  20865,  23744,  -4512, -18640, -25704, -29236,
+        -31002, -31885,  13753,  28380,  -2194, -17481,  10715,  24813,
+         17526,  -7621,   1309,  30350,  -1209,   2467,  28881,  19560,
+         -6604, -19686, -26227,  14534,  -9117,   6705,  31000,   -884,
+        -16826, -24797,  15249,  27080,  -2844, -17806, -25287,  15004,
+         -8882, -20825,   9043,  26025,  18132,  -7318, -20043,  11482,
+        -10643,   7990, -12389,   5069,  32230,   -269,   2937,  29116
+    }
+};
+
+#pragma CONST_SEG DEFAULT
\ No newline at end of file
@@ -0,0 +1,54 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    wavetable.h                                    *
+*          Integer waveform tables for the DDS            *
+*---------------------------------------------------------*
+* Tables hold one cycle of DDS_TABLE_SIZE 10-bit DAC      *
+* codes centred on 512 (2.5V). They are built from        *
+* constants in ROM with integer arithmetic only, so no    *
+* float library code runs when a setting changes.         *
+*                                                         *
+* The sine comes from a quarter-wave table, the stored    *
+* shapes from the bank in paged flash (wavebank.c) and    *
+* the user waveform from points entered at run time.      *
+* Every waveform is expanded the same way, so switching   *
+* costs the same whichever one is chosen.                 *
+**********************************************************/
+
+#ifndef _WAVETABLE_H
+#define _WAVETABLE_H
+
+#include "dds.h"
+
+#define WAVE_MIDSCALE       512     // DAC code for 2.5V
+#define WAVE_MAX_MV         5000    // largest peak-to-peak amplitude
+
+// Waveforms for buildWaveTable()
+#define WAVE_SINE           0
+#define WAVE_SQUARE         1
+#define WAVE_TRIANGLE       2
+#define WAVE_SAWTOOTH       3
+#define WAVE_NOISE          4
+#define WAVE_USER           5
+#define WAVE_COUNT          6
+
+// sin(2*pi*i/DDS_TABLE_SIZE) for the first quarter cycle, Q15 (32767 = 1.0)
+#define SINE_QUARTER_SIZE   (DDS_TABLE_SIZE / 4)
+extern const int sineQuarter[SINE_QUARTER_SIZE + 1];
+
+// Stored waveforms WAVE_SQUARE to WAVE_NOISE, Q15, in paged flash
+#define WAVE_BANK_FIRST     WAVE_SQUARE
+#define WAVE_BANK_COUNT     4
+extern const int __far waveBank[WAVE_BANK_COUNT][DDS_TABLE_SIZE];
+
+// The user waveform: WAVE_USER_POINTS levels, spread evenly over one cycle and joined by straight lines.
+// Each level is 0 (bottom of the swing) to WAVE_USER_FULL (top).
+#define WAVE_USER_POINTS    8
+#define WAVE_USER_FULL      1000
+
+// Function prototypes - tell the compiler that these functions exist somewhere
+void buildWaveTable(unsigned int *table, unsigned char wave, unsigned int amplitude);
+void setUserWave(const unsigned int *levels);
+
+#endif
\ No newline at end of file
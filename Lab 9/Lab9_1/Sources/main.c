@@ -1,26 +1,22 @@
 #include <hidef.h>      /* common defines and macros */
 #include "derivative.h"      /* derivative-specific definitions */
 #include "advancedLCD.h"
-
-// Scan codes used to check for keypad key presses
-const char scanCode[4] = {0xF8, 0xF4, 0xF2, 0xF1};
+#include "keypad.h"
 
 // For this program, we mostly keep the original keypad mapping. All numbers return their literal number (0-9, not ASCII '0','1', etc.).
 const unsigned char keypadTable[16] = {0x00,0x00,0x00,0x00, 0x03,0x06,0x09,0x00, 0x02,0x05,0x08,0x0B, 0x01,0x04,0x07,0x0A};
 
 
 void setOutput(int output);
-char scanKeypad();
 
 
 void main(void)
 {
   int speed = 0;
-  unsigned char keyOld = 0, key = 0;
+  unsigned char key;
 
   // **************** Keypad Initilization ****************
-  DDRA = 0x0F;
-  PORTA = 0xFF;
+  initializeKeypad(keypadTable);    // scanned in Keypad_ISR once interrupts are on
   // **************** Keypad Initilization ****************
 
 
@@ -55,14 +51,16 @@ void main(void)
   printLCDText("Speed: $");
   // **************** LCD Initilization ****************
 
+  __asm CLI;
+
   for(;;)
   {
-    keyOld = key;
-    key = scanKeypad();
+    // A whole keystroke (press and release), zero if none has finished since the last pass
+    key = getKeypress();
 
-    if (keyOld != 0 && key == 0)
+    if (key != 0)
     {
-      if (keyOld == 0x0A)
+      if (key == 0x0A)
       {
         // Sets the motor speed
         setOutput(speed);
@@ -74,8 +72,8 @@ void main(void)
       {
         // Digit 0-9; build new speed setting until '*' pressed
         speed *= 10;
-        if (keyOld != 0x0B)
-          speed += keyOld;
+        if (key != 0x0B)
+          speed += key;
         moveLCDTo(8,1);
         printLCDNumber(speed);
 
@@ -84,41 +82,6 @@ void main(void)
   }
 }
 
-// Function which scans the keypad and returns keycode of any pressed key, zero if no key pressed
-char scanKeypad()
-{
-
-  int i, j = 0;
-
-	// Try each of four scan codes; this checks one row at a time
-	for (i=0; i<4; i++)
-	{
-		PORTA = scanCode[i];
-
-		// Check each column in this row, return ASCII code if pressed. Could be made shorter, but format shows function.
-		if (PORTA_BIT4 == 1)
-			return keypadTable[j];
-		else
-			j++;
-
-		if (PORTA_BIT5 == 1)
-			return keypadTable[j];
-		else
-			j++;
-
-		if (PORTA_BIT6 == 1)
-			return keypadTable[j];
-		else
-			j++;
-
-		if (PORTA_BIT7 == 1)
-			return keypadTable[j];
-		else
-			j++;
-	}
-	return 0;
-}
-
 // Function that sets the PWM output for Motor 1 on Port B motor driver; assume correct initialization
 //   * Direction is selected by sign of 'output'
 //   * Speed is selected by magnitude of 'output'
@@ -15,6 +15,8 @@
 
 #include "derivative.h"
 #include "advancedLCD.h"
+#include "lcdformat.h"
+#include "timebase.h"
 
 #define LCD_DATA PORTK
 #define LCD_CTRL PORTK
@@ -24,50 +26,110 @@
 int linePosition = 0;
 int lineNumber = 0;
 
+// LCD_MODE_BUFFERED state. The shadow holds what the screen should show; a cell is dirty until the timer
+// interrupt has sent it. Flags are bytes so the main loop and the ISR never race on a shared bit mask.
+static int lcdMode = LCD_MODE_BLOCKING;
+static char lcdShadow[LCD_HEIGHT][LCD_WIDTH];
+static volatile unsigned char lcdDirty[LCD_HEIGHT][LCD_WIDTH];
+static volatile unsigned char lcdLowNibble = 0;     // low nibble still to send, with LCD_NIBBLE_PENDING
+static unsigned char lcdCursorX = 0, lcdCursorY = 0; // where the LCD will write the next character
+static unsigned char lcdCursorValid = 0;
+
+#define LCD_NIBBLE_PENDING 0x80
+
 
 /************************************************
 *   shortWait	                                *
 *	                                            *
-*	Desc.: Waits roughly (ms) milliseconds	    *
+*	Desc.: Waits (ms) milliseconds on the       *
+*          timebase, whatever the bus clock     *
 *	Inputs:	 ms - Number of milliseconds	    *
 *	Outputs: None	                            *
 ************************************************/
 
 void shortWait(int ms){
-    int i, j;
-    for (i=0; i<ms; i++){
-        for (j=0; j<4000; j++);
-    }
+    delayMillis(ms);
 }
 
 /************************************************
-*	writeLCDValue	                            *
+*	writeLCDNibble	                            *
 *	                                            *
-*	Desc.: Writes a byte to the LCD	            *
-*	Inputs:	value - Byte to write	            *
+*	Desc.: Writes one nibble to the LCD and     *
+*          latches it with a pulse on EN. The   *
+*          caller waits for it to execute.      *
+*	Inputs:	nibble - value 0-15	                *
 *	        type - TYPE_CHAR or TYPE_INST	    *
 *	Outputs: None	                            *
 ************************************************/ 
 
-void writeLCDValue(char value, int type){
-    unsigned char x;
-
-    x = (value & 0xF0) >> 2;            //shift high nibble to center of byte for Pk5-Pk2
+static void writeLCDNibble(unsigned char nibble, int type){
     LCD_DATA =LCD_DATA & ~0x3C;         //clear bits Pk5-Pk2
-    LCD_DATA = LCD_DATA | x;            //sends high nibble to PORTK
+    LCD_DATA = LCD_DATA | (nibble << 2);    //nibble to the center of the byte, Pk5-Pk2
     LCD_CTRL = type ? (LCD_CTRL & ~RS) : (LCD_CTRL | RS);   //set RS to command (RS=0) if type = TYPE_INST
                                                             //                  (RS=1) if type = TYPE_CHAR
     LCD_CTRL = LCD_CTRL | EN;           //raise enable
-    shortWait(1);
+    delayMicros(LCD_ENABLE_US);
     LCD_CTRL = LCD_CTRL & ~EN;          //Drop enable to capture command
-    shortWait(1);                       //wait
-    x = (value & 0x0F)<< 2;             // shift low nibble to center of byte for Pk5-Pk2
-    LCD_DATA =LCD_DATA & ~0x3C;         //clear bits Pk5-Pk2
-    LCD_DATA =LCD_DATA | x;             //send low nibble to PORTK
-    LCD_CTRL = LCD_CTRL | EN;           //raise enable
-    shortWait(1);
-    LCD_CTRL = LCD_CTRL & ~EN;          //drop enable to capture command
-    shortWait(1);
+}
+
+/************************************************
+*	writeLCDValue	                            *
+*	                                            *
+*	Desc.: Writes a byte to the LCD	            *
+*	Inputs:	value - Byte to write	            *
+*	        type - TYPE_CHAR or TYPE_INST	    *
+*	Outputs: None	                            *
+************************************************/ 
+
+void writeLCDValue(char value, int type){
+    writeLCDNibble((value & 0xF0) >> 4, type);  //high nibble first
+    delayMicros(LCD_EXEC_US);           //wait
+    writeLCDNibble(value & 0x0F, type);
+    // Clear (0x01) and home (0x02, 0x03) take much longer than the other instructions
+    delayMicros(type == TYPE_INST && (unsigned char)value < 0x04 ? LCD_HOME_US : LCD_EXEC_US);
+}
+
+/************************************************
+*	putLCDChar  	                            *
+*	                                            *
+*	Desc.: Writes a character at the current    *
+*          position, directly or into the       *
+*          shadow buffer depending on the mode  *
+*	Inputs:	c - Character                       *
+*	Outputs: None	                            *
+************************************************/ 
+
+static void putLCDChar(char c){
+    if (lcdMode == LCD_MODE_BLOCKING){
+        writeLCDValue(c, TYPE_CHAR);
+        return;
+    }
+    if (linePosition < 0 || linePosition >= LCD_WIDTH)
+        return;
+    if (lcdShadow[lineNumber][linePosition] != c){
+        lcdShadow[lineNumber][linePosition] = c;
+        lcdDirty[lineNumber][linePosition] = 1;     // set after the character, see LCD_Timer_ISR
+        if (!TIE_C7I){
+            TC7 = TCNT + LCD_TICK_US;               // restart the flush
+            TFLG1 = TFLG1_C7F_MASK;
+            TIE_C7I = 1;
+        }
+    }
+}
+
+/************************************************
+*	putLCDCursor	                            *
+*	                                            *
+*	Desc.: Moves the LCD cursor to linePosition *
+*          and lineNumber. In buffered mode the *
+*          ISR addresses each cell itself.      *
+*	Inputs:	 None	                            *
+*	Outputs: None	                            *
+************************************************/ 
+
+static void putLCDCursor(void){
+    if (lcdMode == LCD_MODE_BLOCKING)
+        writeLCDValue((lineNumber == 0 ? 0x80 : 0xC0) + linePosition, TYPE_INST);
 }
 
 /************************************************
@@ -79,10 +141,17 @@ void writeLCDValue(char value, int type){
 ************************************************/ 
 
 void initializeLCD(){
-    writeLCDValue(0x33,TYPE_INST);      //reset sequence provided by data sheet
-    shortWait(160);
-    writeLCDValue(0x32,TYPE_INST);      //reset sequence provided by data sheet
-    shortWait(160);
+    initializeTimebase();
+    delayMillis(LCD_POWER_UP_MS);
+    // Reset sequence provided by data sheet: three 8 bit function sets, one nibble each, then 4 bit mode
+    writeLCDNibble(0x3,TYPE_INST);
+    delayMillis(LCD_RESET_MS);
+    writeLCDNibble(0x3,TYPE_INST);
+    delayMicros(LCD_RESET_US);
+    writeLCDNibble(0x3,TYPE_INST);
+    delayMicros(LCD_EXEC_US);
+    writeLCDNibble(0x2,TYPE_INST);
+    delayMicros(LCD_EXEC_US);
     writeLCDValue(0x28,TYPE_INST);      //Function set to four bit data length
                                         //2 line, 5 x 7 dot format
     writeLCDValue(0x08,TYPE_INST);      //Turn the display OFF 
@@ -111,21 +180,13 @@ void printLCDText(char *str){
 	{
 		if (str[i] == '\n')
 		{
-			if (lineNumber == 0)
-			{
-				writeLCDValue(0xC0, TYPE_INST);
-				lineNumber = 1;
-			}
-			else
-			{
-				writeLCDValue(0x80, TYPE_INST);
-				lineNumber = 0;
-			}
+			lineNumber = (lineNumber == 0) ? 1 : 0;
 			linePosition = 0;
+			putLCDCursor();
 		}
 		else if (linePosition < LCD_WIDTH)
 		{
-			writeLCDValue(str[i], TYPE_CHAR);
+			putLCDChar(str[i]);
 			linePosition++;
 		}
 		
@@ -136,39 +197,15 @@ void printLCDText(char *str){
 /************************************************
 *	printLCDNumber	                            *
 *	                                            *
-*	Desc.: Converts a int to a string, adds a   *
-*          '$' at the end, and call             *
-*          printLCDText function to print it.   *
-*	Inputs:	 unsigned int num                   *
+*	Desc.: Prints num as a sign and five        *
+*          digits, e.g. "+00123", through       *
+*          printLCDInt() in lcdformat.c         *
+*	Inputs:	 int num                            *
 *	Outputs: None	                            *
 ************************************************/ 
 
 void printLCDNumber(int num){
-	char dig0, dig1, dig2, dig3, dig4;
-	
-	if (num < 0) 
-	{
-	  writeLCDValue('-', TYPE_CHAR);
-	  num = -1*num;
-	} 
-	else 
-	{
-	  writeLCDValue('+', TYPE_CHAR);  
-	}
-	linePosition++;
-	
-	dig0 = (num % 10) + 48;
-	dig1 = (num % 100)/10 + 48;
-	dig2 = (num % 1000)/100 + 48;
-	dig3 = (num % 10000)/1000 + 48;
-	dig4 = (num/10000) + 48;
-	
-	writeLCDValue(dig4, TYPE_CHAR);
-	writeLCDValue(dig3, TYPE_CHAR);
-	writeLCDValue(dig2, TYPE_CHAR);
-	writeLCDValue(dig1, TYPE_CHAR);
-	writeLCDValue(dig0, TYPE_CHAR);
-	linePosition += 5;
+	printLCDInt(num, 6, LCD_FORMAT_SIGN | LCD_FORMAT_ZEROS);
 }
 
 /************************************************
@@ -182,9 +219,17 @@ void printLCDNumber(int num){
 ************************************************/ 
 
 void clearLCD(void){
+    if (lcdMode == LCD_MODE_BUFFERED){
+        // Blank the shadow; only cells that were showing something get rewritten
+        for (lineNumber = 0; lineNumber < LCD_HEIGHT; lineNumber++)
+            for (linePosition = 0; linePosition < LCD_WIDTH; linePosition++)
+                putLCDChar(' ');
+        linePosition = 0;
+        lineNumber = 0;
+        return;
+    }
     writeLCDValue(0x01,TYPE_INST);      //Clear the display
     writeLCDValue(0x02,TYPE_INST);      //Send cursor home
-    shortWait(1);    
     linePosition = 0;
 	  lineNumber = 0;
 }
@@ -196,14 +241,7 @@ void moveLCDBack(int space)
 	//if (space > 0 && space <= linePosition)
 	{
 		linePosition -= space;
-		if (lineNumber == 0)
-		{
-			writeLCDValue(0x80+linePosition, TYPE_INST);
-		}
-		else
-		{
-			writeLCDValue(0xC0+linePosition, TYPE_INST);
-		}
+		putLCDCursor();
 	}
 }
 
@@ -211,12 +249,9 @@ void moveLCDTo(int x, int y)
 {
 	if (y >= 0 && y < LCD_HEIGHT && x >= 0 && x < LCD_WIDTH)
 	{
-		if (y == 0)
-			writeLCDValue(0x80+x, TYPE_INST);
-		else
-			writeLCDValue(0xC0+x, TYPE_INST);
 		linePosition = x;
 		lineNumber = y;
+		putLCDCursor();
 	}
 }
 
@@ -224,7 +259,162 @@ void printLCDChar(unsigned char c)
 {
   if (linePosition < LCD_WIDTH) 
   {
-    writeLCDValue(c, TYPE_CHAR);
+    putLCDChar(c);
     linePosition++;  
   }
+}
+
+/************************************************
+*	printLCDChars	                            *
+*	                                            *
+*	Desc.: Prints count characters from chars,  *
+*          stopping at the end of the line.     *
+*          Unlike printLCDText there is no '$'  *
+*          or '\n' to look for.                 *
+*	Inputs:	 chars, count                       *
+*	Outputs: None	                            *
+************************************************/ 
+
+void printLCDChars(const char *chars, int count){
+    while (count-- > 0 && linePosition < LCD_WIDTH){
+        putLCDChar(*chars++);
+        linePosition++;
+    }
+}
+
+/************************************************
+*	setLCDMode  	                            *
+*	                                            *
+*	Desc.: Selects LCD_MODE_BLOCKING or         *
+*          LCD_MODE_BUFFERED. Call after        *
+*          initializeLCD(). Entering buffered   *
+*          mode clears the screen; the timer    *
+*          interrupt needs interrupts enabled   *
+*          (CLI) to run.                        *
+*	Inputs:	 mode                               *
+*	Outputs: None	                            *
+************************************************/ 
+
+void setLCDMode(int mode){
+    int x, y;
+
+    if (mode == lcdMode)
+        return;
+
+    if (mode == LCD_MODE_BLOCKING){
+        while (isLCDBusy());            // let the ISR finish what is already queued
+        TIE_C7I = 0;
+        lcdMode = LCD_MODE_BLOCKING;
+        putLCDCursor();
+        return;
+    }
+
+    clearLCD();
+    for (y = 0; y < LCD_HEIGHT; y++){
+        for (x = 0; x < LCD_WIDTH; x++){
+            lcdShadow[y][x] = ' ';
+            lcdDirty[y][x] = 0;
+        }
+    }
+    lcdLowNibble = 0;
+    lcdCursorX = 0;
+    lcdCursorY = 0;
+    lcdCursorValid = 1;                 // clearLCD() sent the cursor home
+
+    TSCR1_TEN = 1;
+    TSCR2 = (TSCR2 & ~0x07) | LCD_TIMER_PRESCALE;
+    TIOS_IOS7 = 1;                      // output compare, no pin action
+    TIE_C7I = 0;                        // enabled by the first change
+    lcdMode = LCD_MODE_BUFFERED;
+}
+
+/************************************************
+*	isLCDBusy   	                            *
+*	                                            *
+*	Desc.: Reports whether buffered changes are *
+*          still being sent to the LCD          *
+*	Inputs:	 None                               *
+*	Outputs: 1 while flushing, 0 when the LCD   *
+*            matches the shadow buffer          *
+************************************************/ 
+
+int isLCDBusy(void){
+    return lcdMode == LCD_MODE_BUFFERED && TIE_C7I;
+}
+
+/************************************************
+*	putLCDNibble	                            *
+*	                                            *
+*	Desc.: Puts one nibble on Pk5-Pk2 with RS   *
+*          and raises EN. The next tick drops   *
+*          EN, which latches it.                *
+*	Inputs:	 nibble - value 0-15                *
+*	         type - TYPE_CHAR or TYPE_INST      *
+*	Outputs: None	                            *
+************************************************/ 
+
+static void putLCDNibble(unsigned char nibble, unsigned char type){
+    LCD_DATA = (LCD_DATA & ~(0x3C | RS)) | (nibble << 2) | (type ? 0 : RS);
+    LCD_CTRL = LCD_CTRL | EN;
+}
+
+/************************************************
+*	LCD_Timer_ISR	                            *
+*	                                            *
+*	Desc.: Sends the shadow buffer to the LCD,  *
+*          one nibble per LCD_TICK_US. Cells    *
+*          are sent in order from the LCD's own *
+*          cursor so that consecutive changes   *
+*          need no addressing command. Disables *
+*          itself once nothing is dirty.        *
+*	Inputs:	 None                               *
+*	Outputs: None	                            *
+************************************************/ 
+
+void interrupt VectorNumber_Vtimch7 LCD_Timer_ISR(void){
+    unsigned char x, y, i, value;
+
+    TC7 = TC7 + LCD_TICK_US;
+    TFLG1 = TFLG1_C7F_MASK;
+    LCD_CTRL = LCD_CTRL & ~EN;          // latch the nibble presented on the last tick
+
+    if (lcdLowNibble & LCD_NIBBLE_PENDING){
+        putLCDNibble(lcdLowNibble & 0x0F, (lcdLowNibble & 0x10) ? TYPE_INST : TYPE_CHAR);
+        lcdLowNibble = 0;
+        return;
+    }
+
+    // Find the next dirty cell, starting where the LCD cursor already is
+    x = lcdCursorValid ? lcdCursorX : 0;
+    y = lcdCursorValid ? lcdCursorY : 0;
+    for (i = 0; i < LCD_WIDTH * LCD_HEIGHT; i++){
+        if (lcdDirty[y][x])
+            break;
+        if (++x == LCD_WIDTH){
+            x = 0;
+            y = (y + 1) % LCD_HEIGHT;
+        }
+    }
+    if (i == LCD_WIDTH * LCD_HEIGHT){
+        TIE_C7I = 0;                    // idle until putLCDChar() finds a change
+        return;
+    }
+
+    if (!lcdCursorValid || x != lcdCursorX || y != lcdCursorY){
+        value = (y == 0 ? 0x80 : 0xC0) + x;
+        putLCDNibble(value >> 4, TYPE_INST);
+        lcdLowNibble = LCD_NIBBLE_PENDING | 0x10 | (value & 0x0F);
+        lcdCursorX = x;
+        lcdCursorY = y;
+        lcdCursorValid = 1;
+        return;
+    }
+
+    // Clear the flag before reading the character: a change made after this point marks the cell again
+    lcdDirty[y][x] = 0;
+    value = lcdShadow[y][x];
+    putLCDNibble(value >> 4, TYPE_CHAR);
+    lcdLowNibble = LCD_NIBBLE_PENDING | (value & 0x0F);
+    if (++lcdCursorX == LCD_WIDTH)
+        lcdCursorValid = 0;             // DDRAM continues past the visible line
 }
\ No newline at end of file
@@ -0,0 +1,21 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    datapage.h                                     *
+*          Bulk reads from paged memory                   *
+*---------------------------------------------------------*
+* The compiler reaches __far data through the runtime     *
+* routines in datapage.c, one call per access. For a      *
+* whole table, e.g. a waveform in paged flash, copy it to *
+* RAM with readFarBlock(), which sets PPAGE only once.    *
+**********************************************************/
+
+#ifndef _DATAPAGE_H
+#define _DATAPAGE_H
+
+// datapage.c is placed in NON_BANKED, so it can switch PPAGE
+#pragma CODE_SEG __NEAR_SEG NON_BANKED
+void readFarBlock(void *dest, const void *__far source, unsigned int size);
+#pragma CODE_SEG DEFAULT
+
+#endif
\ No newline at end of file
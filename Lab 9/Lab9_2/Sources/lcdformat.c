@@ -0,0 +1,270 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    lcdformat.c                                    *
+*          Fixed-width numbers on the LCD                 *
+*---------------------------------------------------------*
+* The old printLCDNumber() spent eight signed divides on  *
+* five digits, one for each '%' and '/'. The CPU12's IDIV *
+* gives quotient and remainder together in 12 cycles, so  *
+* toDecimal() makes all five digits with four of them.    *
+* Tools/lcdbench measures the two against each other.     *
+**********************************************************/
+
+#include "advancedLCD.h"
+#include "lcdformat.h"
+
+#define DECIMAL_DIGITS  5           // 65535
+
+static const char hexDigits[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+
+/************************************************
+*   toDecimal                                   *
+*                                               *
+*   Desc.: Writes the five decimal digits of    *
+*          value, with leading zeros, as ASCII  *
+*   Inputs:  value                              *
+*            digits - 5 characters, most        *
+*            significant first                  *
+*   Outputs: None                               *
+************************************************/
+
+#pragma NO_ENTRY
+#pragma NO_EXIT
+#pragma NO_FRAME
+
+static void toDecimal(unsigned int value, char *digits){
+#ifdef __HC12__
+    asm {
+        TFR     D,Y             // digits, the last argument, comes in D
+        LDD     2,SP            // value, above the return address
+        LDX     #10
+        IDIV                    // X = value / 10, D = value % 10
+        ADDB    #0x30
+        STAB    4,Y
+        TFR     X,D
+        LDX     #10
+        IDIV
+        ADDB    #0x30
+        STAB    3,Y
+        TFR     X,D
+        LDX     #10
+        IDIV
+        ADDB    #0x30
+        STAB    2,Y
+        TFR     X,D
+        LDX     #10
+        IDIV
+        ADDB    #0x30
+        STAB    1,Y
+        TFR     X,D             // at most 6
+        ADDB    #0x30
+        STAB    0,Y
+        RTS
+    }
+#else
+    // Host builds (Tools/host)
+    unsigned char i;
+
+    for (i = DECIMAL_DIGITS; i-- > 0; ){
+        digits[i] = (char)('0' + value % 10);
+        value /= 10;
+    }
+#endif
+}
+
+/************************************************
+*   fillCells                                   *
+*                                               *
+*   Desc.: Writes count copies of c             *
+*   Inputs:  c - Character                      *
+*            count - Number of cells            *
+*   Outputs: None                               *
+************************************************/
+
+static void fillCells(char c, unsigned char count){
+    while (count-- > 0)
+        printLCDChar(c);
+}
+
+/************************************************
+*   emitNumber                                  *
+*                                               *
+*   Desc.: Writes the padding, the sign and the *
+*          digits of a field of width cells.    *
+*          tail cells are left for the caller   *
+*          to write after the digits. If the    *
+*          whole does not fit, the field is     *
+*          filled with '*' instead.             *
+*   Inputs:  sign - '+', '-' or 0 for none      *
+*            digits, count - Digits to write    *
+*            width - Field width, 0 to fit      *
+*            tail - Cells the caller adds       *
+*            flags - LCD_FORMAT_ZEROS           *
+*   Outputs: 1 if the caller should write its   *
+*            tail, 0 after an overflow          *
+************************************************/
+
+static unsigned char emitNumber(char sign, const char *digits, unsigned char count, unsigned char width,
+                                unsigned char tail, unsigned char flags){
+    unsigned char cells = count + tail + (sign ? 1 : 0);
+
+    if (width == 0)
+        width = cells;
+    if (cells > width){
+        fillCells('*', width);
+        return 0;
+    }
+    if (!(flags & LCD_FORMAT_ZEROS))
+        fillCells(' ', width - cells);
+    if (sign)
+        printLCDChar(sign);
+    if (flags & LCD_FORMAT_ZEROS)
+        fillCells('0', width - cells);
+    printLCDChars(digits, count);
+    return 1;
+}
+
+// Leading zeros of a toDecimal() result, keeping at least one digit
+static unsigned char leadingZeros(const char *digits){
+    unsigned char n = 0;
+
+    while (n < DECIMAL_DIGITS - 1 && digits[n] == '0')
+        n++;
+    return n;
+}
+
+/************************************************
+*   printLCDUnsigned                            *
+*                                               *
+*   Desc.: Prints value in decimal in a field   *
+*          of width cells                       *
+*   Inputs:  value                              *
+*            width - 0 to use as many cells as  *
+*            the value needs                    *
+*            flags - LCD_FORMAT_SIGN and/or     *
+*            LCD_FORMAT_ZEROS                   *
+*   Outputs: None                               *
+************************************************/
+
+void printLCDUnsigned(unsigned int value, unsigned char width, unsigned char flags){
+    char digits[DECIMAL_DIGITS];
+    unsigned char skip;
+
+    toDecimal(value, digits);
+    skip = leadingZeros(digits);
+    (void)emitNumber((flags & LCD_FORMAT_SIGN) ? '+' : 0, digits + skip, DECIMAL_DIGITS - skip, width, 0, flags);
+}
+
+/************************************************
+*   printLCDInt                                 *
+*                                               *
+*   Desc.: Prints value in decimal in a field   *
+*          of width cells. Negative values get  *
+*          a '-' whatever the flags.            *
+*   Inputs:  value                              *
+*            width - 0 to use as many cells as  *
+*            the value needs                    *
+*            flags - LCD_FORMAT_SIGN and/or     *
+*            LCD_FORMAT_ZEROS                   *
+*   Outputs: None                               *
+************************************************/
+
+void printLCDInt(int value, unsigned char width, unsigned char flags){
+    char digits[DECIMAL_DIGITS];
+    unsigned char skip;
+    char sign = (flags & LCD_FORMAT_SIGN) ? '+' : 0;
+    unsigned int magnitude = (unsigned int)value;
+
+    if (value < 0){
+        sign = '-';
+        magnitude = 0u - magnitude;     // also right for -32768
+    }
+    toDecimal(magnitude, digits);
+    skip = leadingZeros(digits);
+    (void)emitNumber(sign, digits + skip, DECIMAL_DIGITS - skip, width, 0, flags);
+}
+
+/************************************************
+*   printLCDHex                                 *
+*                                               *
+*   Desc.: Prints value as upper case hex,      *
+*          with leading zeros                   *
+*   Inputs:  value                              *
+*            digits - 1 to 4, or 0 to use as    *
+*            many as the value needs            *
+*   Outputs: None                               *
+************************************************/
+
+void printLCDHex(unsigned int value, unsigned char digits){
+    unsigned char need = 1;
+    unsigned int rest = value;
+
+    while (rest > 0x0F){
+        rest >>= 4;
+        need++;
+    }
+    if (digits == 0)
+        digits = need;
+    if (need > digits){
+        fillCells('*', digits);
+        return;
+    }
+    while (digits > need){
+        printLCDChar('0');
+        digits--;
+    }
+    while (need-- > 0)
+        printLCDChar(hexDigits[(value >> (need * 4)) & 0x0F]);
+}
+
+/************************************************
+*   printLCDFixed                               *
+*                                               *
+*   Desc.: Prints a fixed point value, e.g. a   *
+*          Q8 speed, as "-12.34". The fraction  *
+*          is truncated, not rounded.           *
+*   Inputs:  value - Signed, fracBits binary    *
+*            places (at most 12)                *
+*            decimals - Digits after the point, *
+*            0 to 4; 0 prints no point          *
+*            width - 0 to use as many cells as  *
+*            the value needs                    *
+*            flags - LCD_FORMAT_SIGN and/or     *
+*            LCD_FORMAT_ZEROS                   *
+*   Outputs: None                               *
+************************************************/
+
+void printLCDFixed(int value, unsigned char fracBits, unsigned char decimals, unsigned char width, unsigned char flags){
+    char digits[DECIMAL_DIGITS];
+    unsigned char skip;
+    char sign = (flags & LCD_FORMAT_SIGN) ? '+' : 0;
+    unsigned int magnitude = (unsigned int)value;
+    unsigned int mask, fraction;
+
+    if (fracBits > LCD_FIXED_MAX_FRAC_BITS)
+        fracBits = LCD_FIXED_MAX_FRAC_BITS;
+    if (decimals > LCD_FIXED_MAX_DECIMALS)
+        decimals = LCD_FIXED_MAX_DECIMALS;
+    if (value < 0){
+        sign = '-';
+        magnitude = 0u - magnitude;
+    }
+    mask = (1u << fracBits) - 1;
+
+    toDecimal(magnitude >> fracBits, digits);
+    skip = leadingZeros(digits);
+    if (!emitNumber(sign, digits + skip, DECIMAL_DIGITS - skip, width, decimals ? decimals + 1 : 0, flags))
+        return;
+    if (decimals == 0)
+        return;
+
+    // One digit per step: fraction * 10 stays below 10 << 12, so nothing overflows 16 bits
+    printLCDChar('.');
+    fraction = magnitude & mask;
+    while (decimals-- > 0){
+        fraction *= 10;
+        printLCDChar((char)('0' + (fraction >> fracBits)));
+        fraction &= mask;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    lcdformat.h                                    *
+*          Fixed-width numbers on the LCD                 *
+*---------------------------------------------------------*
+* Each function writes its field at the current LCD       *
+* position, one cell at a time through printLCDChar(),    *
+* so no string is built and no '$' is needed. A field     *
+* keeps its width whatever the value, so a number can be  *
+* rewritten in place without clearing the line. A value   *
+* that does not fit fills its field with '*'.             *
+**********************************************************/
+
+#ifndef _LCD_FORMAT_H
+#define _LCD_FORMAT_H
+
+// Flags for printLCDInt(), printLCDUnsigned() and printLCDFixed()
+#define LCD_FORMAT_SIGN     0x01    // '+' in front of positive values and zero
+#define LCD_FORMAT_ZEROS    0x02    // pad with '0' after the sign instead of ' ' before it
+
+// Limits of printLCDFixed()
+#define LCD_FIXED_MAX_FRAC_BITS 12
+#define LCD_FIXED_MAX_DECIMALS  4
+
+// Function prototypes - tell the compiler that these functions exist somewhere
+void printLCDInt(int value, unsigned char width, unsigned char flags);
+void printLCDUnsigned(unsigned int value, unsigned char width, unsigned char flags);
+void printLCDHex(unsigned int value, unsigned char digits);
+void printLCDFixed(int value, unsigned char fracBits, unsigned char decimals, unsigned char width, unsigned char flags);
+
+#endif
\ No newline at end of file
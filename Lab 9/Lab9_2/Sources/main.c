@@ -1,31 +1,33 @@
 #include <hidef.h>      /* common defines and macros */
 #include "derivative.h"      /* derivative-specific definitions */
 #include "advancedLCD.h"
-
-// Scan codes used to check for keypad key presses
-const char scanCode[4] = {0xF8, 0xF4, 0xF2, 0xF1};
+#include "keypad.h"
+#include "encoder.h"
+#include "timebase.h"
+#include "scheduler.h"
 
 // For this program, we mostly keep the original keypad mapping. All numbers return their literal number (0-9, not ASCII '0','1', etc.).
 const unsigned char keypadTable[16] = {0x00,0x00,0x00,0x00, 0x03,0x06,0x09,0x0C, 0x02,0x05,0x08,0x0B, 0x01,0x04,0x07,0x0A};
 
 
 void setOutput(int output);
-char scanKeypad();
 
-int pos;
+// The user interface is two scheduler tasks: keyTask runs when Keypad_ISR queues a keystroke, displayTask every
+// DISPLAY_PERIOD_MS
+#define DISPLAY_PERIOD_MS 50
+#define EVENT_KEY         0x02
+
+int speed = 0;
 
-unsigned char lastEncoderState = 0, currentEncoderState = 0;
+void keyTask(unsigned char events);
+void displayTask(unsigned char events);
 
 void main(void) 
 {
-  int speed = 0;
-  unsigned char keyOld = 0, key = 0;
-  
-  int displayUpdate = 0;
+  unsigned char keyTaskId, displayTaskId;
   
   // **************** Keypad Initilization ****************
-  DDRA = 0x0F;
-  PORTA = 0xFF;
+  initializeKeypad(keypadTable);    // scanned in Keypad_ISR once interrupts are on
   // **************** Keypad Initilization ****************
 
   
@@ -51,102 +53,73 @@ void main(void)
   
   // **************** LCD Initilization ****************
   DDRK = 0xFF;  
+  initializeTimebase();             // shortWait() and the LCD driver wait on it
   shortWait(160);
   initializeLCD();
   shortWait(160);
-  clearLCD();
+  setLCDMode(LCD_MODE_BUFFERED);    // clears the screen; from here on LCD calls never wait
   printLCDText("Servo Lab v1.0$");
   moveLCDTo(0,1);
   printLCDText("Speed: $");
   // **************** LCD Initilization ****************
   
   // **************** Port P Interrupt / Encoder Initilization ****************
-  DDRP = 0b11110011;
-  PERP = 0b00000000;
-  PPSP_PPSP2 = 1;
-  PPSP_PPSP3 = 1;
-  PIFP = 0b00001100;
-  PIEP = 0b00001100;
+  initializeEncoder();
   __asm CLI;     
-  pos = 0;         
   // **************** Port P Interrupt / Encoder Initilization ****************
     
-  for(;;) 
+  // **************** Scheduler Initilization ****************
+  initializeScheduler();
+  keyTaskId = addTask(keyTask);
+  displayTaskId = addTask(displayTask);
+  setKeypadTask(keyTaskId, EVENT_KEY);
+  startTaskTimer(displayTaskId, 0, SCHEDULER_MS(DISPLAY_PERIOD_MS));
+  // **************** Scheduler Initilization ****************
+  
+  // From here on only the tasks run; with none ready the CPU waits for the next interrupt
+  runScheduler();
+}
+
+// Updates the position on the top line. The LCD is buffered, so this costs only the formatting (the flush runs in
+// LCD_Timer_ISR).
+void displayTask(unsigned char events) 
+{
+  moveLCDTo(0,0);
+  printLCDText("Position: $");
+  printLCDNumber((int)getEncoderPosition());
+}
+
+// Acts on every whole keystroke (press and release) queued since the last run
+void keyTask(unsigned char events) 
+{
+  unsigned char key;
+  
+  while ((key = getKeypress()) != 0) 
   {
-    displayUpdate++;
-    if (displayUpdate % 10000 == 0) 
+    if (key == 0x0A) 
+    {
+      setOutput(speed);
+      moveLCDTo(8,1);
+      printLCDText("      $");
+      speed = 0;
+    } 
+    else if (key == 0x0C) 
     {
-      moveLCDTo(0,0);
-      printLCDText("Position: $");
-      printLCDNumber(pos);    
+      speed *= -1;  
+      moveLCDTo(8,1);
+      printLCDNumber(speed);
     }
-    
-    keyOld = key;
-    key = scanKeypad();
-    
-    if (keyOld != 0 && key == 0) 
+    else 
     {
-      if (keyOld == 0x0A) 
-      {
-        setOutput(speed);
-        moveLCDTo(8,1);
-        printLCDText("      $");
-        speed = 0;
-      } 
-      else if (keyOld == 0x0C) 
-      {
-        speed *= -1;  
-        moveLCDTo(8,1);
-        printLCDNumber(speed);
-      }
-      else 
-      {
-        speed *= 10;
-        if (keyOld != 0x0B && keyOld != 0x0C)
-          speed += keyOld;
-        moveLCDTo(8,1);
-        printLCDNumber(speed);
-          
-      }
+      speed *= 10;
+      if (key != 0x0B && key != 0x0C)
+        speed += key;
+      moveLCDTo(8,1);
+      printLCDNumber(speed);
     }
   }
 }
 
-// Function which scans the keypad and returns keycode of any pressed key, zero if no key pressed
-char scanKeypad()
-{
-  
-  int i, j = 0;
-  
-	// Try each of four scan codes; this checks one row at a time
-	for (i=0; i<4; i++)
-	{
-		PORTA = scanCode[i];
-		
-		// Check each column in this row, return ASCII code if pressed. Could be made shorter, but format shows function.
-		if (PORTA_BIT4 == 1)
-			return keypadTable[j];
-		else
-			j++;
-			
-		if (PORTA_BIT5 == 1)
-			return keypadTable[j];
-		else
-			j++;
-			
-		if (PORTA_BIT6 == 1)
-			return keypadTable[j];
-		else
-			j++;
-			
-		if (PORTA_BIT7 == 1)
-			return keypadTable[j];
-		else
-			j++;
-	}
-	return 0;
-}
-
 // Function that sets the PWM output for Motor 1 on Port B motor driver; assume correct initialization
 //   * Direction is selected by sign of 'output'
 //   * Speed is selected by magnitude of 'output'
@@ -164,24 +137,4 @@ void setOutput(int output)
         PWMDTY0 = (unsigned char)(output);
     }
   
-}
-
-void interrupt VectorNumber_Vportp Port_P_ISR(void) 
-{
-    // Record last encoder state
-    lastEncoderState = currentEncoderState;
-    // Record current state
-    currentEncoderState = (PTP & 0b00001100) >> 2;
-
-    // Update position based on movement    
-    if (currentEncoderState == 0x01 && lastEncoderState == 0x03)
-      pos++;
-    else if  (currentEncoderState == 0x03 && lastEncoderState == 0x02)
-      pos--; 
-    
-    // Clear interrupt flags to allow next interrupt
-    if (PIFP_PIFP2 == 1) 
-       PIFP = PIFP_PIFP2_MASK;
-    else if (PIFP_PIFP3 == 1) 
-       PIFP = PIFP_PIFP3_MASK;
 }
\ No newline at end of file
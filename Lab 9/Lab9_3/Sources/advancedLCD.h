@@ -23,6 +23,26 @@
 #define FORMAT_HEX  1
 #define FORMAT_CHR	2
 
+// Modes for setLCDMode()
+#define LCD_MODE_BLOCKING   0   // every call writes to the LCD and waits for it (default)
+#define LCD_MODE_BUFFERED   1   // calls only update a RAM copy of the screen, a timer interrupt sends the changes
+
+// LCD_MODE_BUFFERED uses ECT channel 7 with TCNT at 1MHz; setTimebaseBusClock() picks the prescaler for the current
+// bus. LCD_TIMER_PRESCALE is only the setting at start-up, on the 8MHz bus. One nibble is sent every LCD_TICK_US, so
+// changing a full screen takes about 7ms in the background.
+#define LCD_TIMER_PRESCALE  3
+#define LCD_TICK_US         100
+
+// LCD_MODE_BLOCKING waits, from the HD44780 datasheet: power up (40ms at 2.7V), the enable pulse, most
+// instructions (37us), clear and home (1.52ms), and the pauses after the first two nibbles of the reset
+// sequence (4.1ms, 100us)
+#define LCD_POWER_UP_MS     40
+#define LCD_ENABLE_US       1
+#define LCD_EXEC_US         40
+#define LCD_HOME_US         1600
+#define LCD_RESET_MS        5
+#define LCD_RESET_US        150
+
 // Function prototypes - tell the compiler that these functions exist somewhere
 void initializeLCD(void);
 void shortWait(int ms);
@@ -31,8 +51,12 @@ void printLCDText(char *str);
 void printLCDNumber(int num);
 void clearLCD(void);
 void printLCDChar(unsigned char);
+void printLCDChars(const char *chars, int count);
 
 void moveLCDBack(int space);
 void moveLCDTo(int x, int y);
 
+void setLCDMode(int mode);
+int isLCDBusy(void);
+
 #endif
\ No newline at end of file
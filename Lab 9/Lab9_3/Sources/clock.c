@@ -0,0 +1,150 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    clock.c                                        *
+*          Bus clock operating points                     *
+*---------------------------------------------------------*
+* SYNR and REFDV must not change while the PLL clocks the *
+* bus, so every switch goes through the crystal: PLLSEL   *
+* off, new divider, lock, PLLSEL on. The listeners hear   *
+* of both steps. The lock wait is timed on the timebase,  *
+* which the timebase listener has already moved onto the  *
+* crystal rate by then. Not for use from interrupts.      *
+**********************************************************/
+
+#include "derivative.h"
+#include "timebase.h"
+#include "clock.h"
+
+// bus = CLOCK_OSC_HZ * (SYNR + 1) / (REFDV + 1)
+struct clockPoint {
+    unsigned char synr, refdv;      // CLOCK_NO_PLL for the crystal
+    unsigned long busHz;
+};
+
+#define CLOCK_NO_PLL    0xFF
+
+static const struct clockPoint clockPoints[CLOCK_POINTS] = {
+    { 0x00, 0x03, 4000000L },
+    { CLOCK_NO_PLL, CLOCK_NO_PLL, CLOCK_OSC_HZ / 2 },
+    { 0x01, 0x01, 16000000L }
+};
+
+static unsigned char clockPoint = CLOCK_CRYSTAL;
+static void (*clockListener[CLOCK_MAX_LISTENERS])(unsigned long busHz);
+static unsigned char listenerCount = 0;
+static unsigned int changes = 0, lockFailures = 0, worstLock = 0;
+
+/************************************************
+*   busChanged                                  *
+*                                               *
+*   Desc.: Calls every listener, in the order   *
+*          they were added                      *
+*   Inputs:  busHz - The bus clock now          *
+*   Outputs: None                               *
+************************************************/
+
+static void busChanged(unsigned long busHz){
+    unsigned char n;
+
+    for (n = 0; n < listenerCount; n++)
+        clockListener[n](busHz);
+}
+
+/************************************************
+*   addClockListener                            *
+*                                               *
+*   Desc.: Adds a function to call after every  *
+*          change of the bus clock              *
+*   Inputs:  listener - Called with the new bus *
+*            clock in Hz                        *
+*   Outputs: 1 if added, 0 if the table is full *
+************************************************/
+
+int addClockListener(void (*listener)(unsigned long busHz)){
+    if (listenerCount >= CLOCK_MAX_LISTENERS)
+        return 0;
+    clockListener[listenerCount++] = listener;
+    return 1;
+}
+
+/************************************************
+*   setClock                                    *
+*                                               *
+*   Desc.: Moves the bus to an operating point. *
+*          Interrupts keep running; they see    *
+*          the crystal rate while the PLL       *
+*          locks. If it does not lock in        *
+*          CLOCK_LOCK_TIMEOUT_US the PLL is     *
+*          turned off and the bus stays on the  *
+*          crystal.                             *
+*   Inputs:  point - CLOCK_4MHZ, CLOCK_8MHZ...  *
+*   Outputs: The point the bus is at now        *
+************************************************/
+
+unsigned char setClock(unsigned char point){
+    const struct clockPoint *p;
+    unsigned long start, waited;
+
+    if (point >= CLOCK_POINTS || point == clockPoint)
+        return clockPoint;
+    p = &clockPoints[point];
+    initializeTimebase();
+
+    // Also when PLLSEL was already off: after reset the listeners may be set up for another bus, and the
+    // lock wait below is timed on the timebase
+    CLKSEL_PLLSEL = 0;
+    PLLCTL_PLLON = 0;
+    clockPoint = CLOCK_CRYSTAL;
+    busChanged(CLOCK_OSC_HZ / 2);
+    if (p->synr == CLOCK_NO_PLL){
+        changes++;
+        return clockPoint;
+    }
+
+    SYNR = p->synr;
+    REFDV = p->refdv;
+    PLLCTL = 0xD1;                      // CME | PLLON | ACQ | SCME
+    start = getTimebaseTicks();
+    while (!CRGFLG_LOCK){
+        waited = getTimebaseTicks() - start;
+        if (waited >= TIMEBASE_US(CLOCK_LOCK_TIMEOUT_US)){
+            PLLCTL_PLLON = 0;
+            lockFailures++;
+            return clockPoint;
+        }
+    }
+    waited = (getTimebaseTicks() - start) / TIMEBASE_TICKS_PER_US;
+    if (waited > worstLock)
+        worstLock = (unsigned int)waited;
+
+    CLKSEL_PLLSEL = 1;
+    clockPoint = point;
+    changes++;
+    busChanged(p->busHz);
+    return clockPoint;
+}
+
+// The operating point the bus is at
+unsigned char getClock(void){
+    return clockPoint;
+}
+
+// The bus clock in Hz
+unsigned long getBusClock(void){
+    return clockPoints[clockPoint].busHz;
+}
+
+/************************************************
+*   getClockStats                               *
+*                                               *
+*   Desc.: Copies the switch counters           *
+*   Inputs:  stats - Where to copy them         *
+*   Outputs: None                               *
+************************************************/
+
+void getClockStats(struct clockStats *stats){
+    stats->changes = changes;
+    stats->lockFailures = lockFailures;
+    stats->worstLockUs = worstLock;
+}
\ No newline at end of file
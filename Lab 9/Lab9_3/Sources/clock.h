@@ -0,0 +1,48 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    clock.h                                        *
+*          Bus clock operating points                     *
+*---------------------------------------------------------*
+* The bus runs from the 16MHz crystal / 2 after reset, or *
+* from the PLL at one of the points below. setClock()     *
+* moves between them: it waits for the PLL to lock for at *
+* most CLOCK_LOCK_TIMEOUT_US and stays on the crystal if  *
+* it does not. Drivers whose rates depend on the bus      *
+* (timer prescaler, PWM clock) are told of every change   *
+* through the listeners added with addClockListener().    *
+*                                                         *
+* Every point is a whole number of MHz times a power of   *
+* two, so the timer keeps its 1MHz tick at all of them.   *
+**********************************************************/
+
+#ifndef _CLOCK_H
+#define _CLOCK_H
+
+#define CLOCK_OSC_HZ            16000000L
+
+// Operating points
+#define CLOCK_4MHZ              0       // PLL, idle
+#define CLOCK_8MHZ              1       // crystal / 2, PLL off, as after reset
+#define CLOCK_16MHZ             2       // PLL, control bursts
+#define CLOCK_POINTS            3
+#define CLOCK_CRYSTAL           CLOCK_8MHZ
+
+// The PLL locks in well under 1ms with the Dragon12 loop filter
+#define CLOCK_LOCK_TIMEOUT_US   3000
+#define CLOCK_MAX_LISTENERS     4
+
+struct clockStats {
+    unsigned int changes;
+    unsigned int lockFailures;      // setClock() gave up and stayed on the crystal
+    unsigned int worstLockUs;       // longest wait for the PLL
+};
+
+// Function prototypes - tell the compiler that these functions exist somewhere
+unsigned char setClock(unsigned char point);
+unsigned char getClock(void);
+unsigned long getBusClock(void);
+int addClockListener(void (*listener)(unsigned long busHz));
+void getClockStats(struct clockStats *stats);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,309 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    control.c                                      *
+*          Fixed-rate PID position loop for Motor 1       *
+*---------------------------------------------------------*
+* Control_ISR reads the encoder, runs the PID and sets    *
+* the PWM duty every CONTROL_PERIOD_TICKS. The error is   *
+* position - reference: on the lab rig a positive output  *
+* drives the position down. With a motion profile set,    *
+* the reference moves toward the target one sample at a   *
+* time (profile.c) instead of jumping there.              *
+**********************************************************/
+
+#include "derivative.h"
+#include "control.h"
+#include "encoder.h"
+#include "fixmath.h"
+#include "profile.h"
+
+// Limits that keep every product inside 32 bits. The arithmetic below is fixmath's: EMULS for the products and
+// saturating sums, instead of the compiler's long runtime.
+#define ERROR_LIMIT     32767L
+#define INTEGRAL_LIMIT  ((long)CONTROL_OUTPUT_LIMIT << CONTROL_I_SHIFT)
+
+static int kp = 0, ki = 0, kd = 0;
+static volatile long controlReference = 0;
+static long integral = 0;                   // I term, Q16
+static long lastPosition = 0;
+static volatile int controlOutput = 0;
+
+// Written by Control_ISR; controlSequence changes on every run so the main loop can copy them safely
+static volatile unsigned char controlSequence = 0;
+static unsigned int lastRun = 0;
+static volatile unsigned int minPeriod, maxPeriod, overruns;
+static volatile unsigned long totalPeriod, samples;
+
+/************************************************
+*   setOutput                                   *
+*                                               *
+*   Desc.: Sets the PWM output for Motor 1 on   *
+*          the Port B motor driver; assumes the *
+*          PWM is initialized                   *
+*   Inputs:  output - Direction by sign, speed  *
+*            by magnitude (116 = 100% duty)     *
+*   Outputs: None                               *
+************************************************/
+
+void setOutput(int output){
+    if (output < 0){
+        PORTB = 0b00000010;
+        PWMDTY0 = (unsigned char)(-1*output);
+    }
+    else{
+        PORTB = 0b00000001;
+        PWMDTY0 = (unsigned char)(output);
+    }
+}
+
+/************************************************
+*   initializeControl                           *
+*                                               *
+*   Desc.: Sets the gains and prepares ECT      *
+*          channel 6. The loop does not run     *
+*          until startControl().                *
+*   Inputs:  kp, ki, kd - Gains, see control.h  *
+*   Outputs: None                               *
+************************************************/
+
+void initializeControl(int p, int i, int d){
+    TIE_C6I = 0;
+    kp = p;
+    ki = i;
+    kd = d;
+
+    TSCR1_TEN = 1;
+    TSCR2 = (TSCR2 & ~0x07) | CONTROL_TIMER_PRESCALE;
+    TIOS_IOS6 = 1;                      // output compare, no pin action
+    resetControlStats();
+}
+
+/************************************************
+*   startControl                                *
+*                                               *
+*   Desc.: Starts the loop from the current     *
+*          position with a cleared integrator.  *
+*          Needs interrupts enabled (CLI).      *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void startControl(void){
+    TIE_C6I = 0;
+    integral = 0;
+    lastPosition = getEncoderPosition();
+    lastRun = TCNT;
+    TC6 = lastRun + CONTROL_PERIOD_TICKS;
+    TFLG1 = TFLG1_C6F_MASK;
+    resetControlStats();                // the first period is measured from here
+    TIE_C6I = 1;
+}
+
+/************************************************
+*   stopControl                                 *
+*                                               *
+*   Desc.: Stops the loop and the motor         *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void stopControl(void){
+    TIE_C6I = 0;
+    controlOutput = 0;
+    setOutput(0);
+}
+
+/************************************************
+*   setControlReference                         *
+*                                               *
+*   Desc.: Sets the target position in one      *
+*          step: the reference jumps there and  *
+*          any move stops. Interrupts from      *
+*          channel 6 are held off for the       *
+*          four-byte write.                     *
+*   Inputs:  reference - Position in counts     *
+*   Outputs: None                               *
+************************************************/
+
+void setControlReference(long reference){
+    unsigned char enabled = TIE_C6I;
+
+    TIE_C6I = 0;
+    resetProfile(reference);
+    controlReference = reference;
+    TIE_C6I = enabled;
+}
+
+/************************************************
+*   moveControlTo                               *
+*                                               *
+*   Desc.: Sets the target position. The        *
+*          reference gets there within the      *
+*          limits of setControlProfile(),       *
+*          starting from where it is now, even  *
+*          in the middle of a move.             *
+*   Inputs:  target - Position in counts        *
+*   Outputs: None                               *
+************************************************/
+
+void moveControlTo(long target){
+    unsigned char enabled = TIE_C6I;
+
+    TIE_C6I = 0;
+    setProfileTarget(target);
+    TIE_C6I = enabled;
+}
+
+/************************************************
+*   setControlProfile                           *
+*                                               *
+*   Desc.: Sets the limits of moveControlTo()   *
+*          and stops the reference where it is. *
+*          All zero makes every move a step.    *
+*   Inputs:  velocity - counts/s                *
+*            acceleration - counts/s^2          *
+*            jerk - counts/s^3, 0 for a         *
+*            trapezoidal profile                *
+*   Outputs: None                               *
+************************************************/
+
+void setControlProfile(long velocity, long acceleration, long jerk){
+    unsigned char enabled = TIE_C6I;
+
+    TIE_C6I = 0;
+    setProfileLimits(velocity, acceleration, jerk, CONTROL_RATE_HZ);
+    TIE_C6I = enabled;
+}
+
+// The reference the loop follows now, on its way to the target
+long getControlReference(void){
+    unsigned char enabled = TIE_C6I;
+    long reference;
+
+    TIE_C6I = 0;
+    reference = controlReference;
+    TIE_C6I = enabled;
+    return reference;
+}
+
+// Whether a move through moveControlTo() is still under way
+int isControlMoving(void){
+    unsigned char enabled = TIE_C6I;
+    int moving;
+
+    TIE_C6I = 0;
+    moving = isProfileMoving();
+    TIE_C6I = enabled;
+    return moving;
+}
+
+int getControlOutput(void){
+    return controlOutput;
+}
+
+/************************************************
+*   getControlStats                             *
+*                                               *
+*   Desc.: Copies the period statistics since   *
+*          the last reset                       *
+*   Inputs:  stats - Where to copy them         *
+*   Outputs: None                               *
+************************************************/
+
+void getControlStats(struct controlStats *stats){
+    unsigned char sequence;
+    unsigned long total;
+
+    do {
+        sequence = controlSequence;
+        stats->minPeriod = minPeriod;
+        stats->maxPeriod = maxPeriod;
+        stats->samples = samples;
+        stats->overruns = overruns;
+        total = totalPeriod;
+    } while (sequence != controlSequence);
+
+    stats->meanPeriod = stats->samples ? (unsigned int)(total / stats->samples) : 0;
+}
+
+void resetControlStats(void){
+    unsigned char enabled = TIE_C6I;
+
+    TIE_C6I = 0;
+    minPeriod = 0xFFFF;
+    maxPeriod = 0;
+    totalPeriod = 0;
+    samples = 0;
+    overruns = 0;
+    controlSequence++;
+    TIE_C6I = enabled;
+}
+
+/************************************************
+*   Control_ISR                                 *
+*                                               *
+*   Desc.: One PID step. The D term acts on the *
+*          measured motion, so a new reference  *
+*          gives no derivative kick. The        *
+*          integrator is clamped to the output  *
+*          range and stops integrating while    *
+*          the output is saturated in the same  *
+*          direction (anti-windup).             *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void interrupt VectorNumber_Vtimch6 Control_ISR(void){
+    unsigned int now, period;
+    long position, error, motion, candidate, output, total;
+
+    now = TCNT;
+    TC6 = TC6 + CONTROL_PERIOD_TICKS;
+    TFLG1 = TFLG1_C6F_MASK;
+
+    period = (unsigned short)(now - lastRun);
+    lastRun = now;
+    if (period < minPeriod)
+        minPeriod = period;
+    if (period > maxPeriod)
+        maxPeriod = period;
+    totalPeriod += period;
+    samples++;
+
+    controlReference = stepProfile();
+
+    // Encoder_ISR cannot run in here, so a direct copy is consistent
+    position = getEncoderPosition();
+    error = fixClamp(fixSub(position, controlReference), ERROR_LIMIT);
+    motion = fixClamp(fixSub(position, lastPosition), ERROR_LIMIT);
+    lastPosition = position;
+
+    candidate = fixClamp(fixAdd(integral, fixMul(ki, (int)error)), INTEGRAL_LIMIT);
+    output = fixAdd(fixMulQ8(kp, (int)error), fixMulQ8(kd, (int)motion));
+    total = fixAdd(output, candidate >> CONTROL_I_SHIFT);
+    if (total > CONTROL_OUTPUT_LIMIT){
+        if (candidate < integral)
+            integral = candidate;       // only unwind while saturated
+        output = CONTROL_OUTPUT_LIMIT;
+    }
+    else if (total < -CONTROL_OUTPUT_LIMIT){
+        if (candidate > integral)
+            integral = candidate;
+        output = -CONTROL_OUTPUT_LIMIT;
+    }
+    else{
+        integral = candidate;
+        output = total;
+    }
+
+    controlOutput = (int)output;
+    setOutput((int)output);
+
+    // If this run was so late that the next compare is already behind TCNT, skip to the next period
+    if ((short)(TC6 - TCNT) <= 0){
+        TC6 = TCNT + CONTROL_PERIOD_TICKS;
+        overruns++;
+    }
+    controlSequence++;
+}
\ No newline at end of file
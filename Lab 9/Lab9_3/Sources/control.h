@@ -0,0 +1,56 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    control.h                                      *
+*          Fixed-rate PID position loop for Motor 1       *
+*---------------------------------------------------------*
+* The loop runs in the ECT channel 6 interrupt, so its    *
+* sample rate does not depend on what main() is doing.    *
+**********************************************************/
+
+#ifndef _CONTROL_H
+#define _CONTROL_H
+
+// Sample rate. TCNT at 1MHz, shared with the encoder and the buffered LCD; setTimebaseBusClock() picks the prescaler
+// for the current bus. The prescaler below is only the setting at start-up, on the 8MHz bus.
+#define CONTROL_RATE_HZ         1000
+#define CONTROL_TIMER_PRESCALE  3
+#define CONTROL_TIMER_HZ        1000000L
+#define CONTROL_PERIOD_TICKS    ((unsigned int)(CONTROL_TIMER_HZ / CONTROL_RATE_HZ))
+
+// Gains are fixed point:
+//   kp - output per count of error, Q8 (256 = 1.0)
+//   ki - output per count of error per sample, Q16
+//   kd - output per count moved in one sample, Q8
+// The Q8 products are fixMulQ8(), which rounds down like the shifts below.
+#define CONTROL_P_SHIFT         8
+#define CONTROL_I_SHIFT         16
+#define CONTROL_D_SHIFT         8
+
+// Under the original PWM settings, 116 is 100% duty cycle
+#define CONTROL_OUTPUT_LIMIT    116
+
+// Jitter statistics, in TCNT ticks (microseconds) between successive runs of the loop
+struct controlStats {
+    unsigned int minPeriod;
+    unsigned int maxPeriod;
+    unsigned int meanPeriod;
+    unsigned long samples;
+    unsigned int overruns;      // the loop took longer than a period and a sample was skipped
+};
+
+// Function prototypes - tell the compiler that these functions exist somewhere
+void setOutput(int output);
+void initializeControl(int kp, int ki, int kd);
+void startControl(void);
+void stopControl(void);
+void setControlReference(long reference);
+void moveControlTo(long target);
+void setControlProfile(long velocity, long acceleration, long jerk);
+long getControlReference(void);
+int isControlMoving(void);
+int getControlOutput(void);
+void getControlStats(struct controlStats *stats);
+void resetControlStats(void);
+
+#endif
\ No newline at end of file
@@ -787,6 +787,10 @@ done:
   - all page register still contain the same value as before the call
   - the function returns after the constant defining the number of bytes to be copied
 
+  With only the PPAGE register, the page is switched for every byte only if both areas
+  reach into the page window 0x8000..0xBFFF with different pages. Otherwise one page
+  serves the whole copy, so it is set once and the bytes are moved a word at a time.
+
 
   stack-structure at the loop-label:
      0,SP : destination offset
@@ -847,13 +851,34 @@ loop:
 #else
   asm {
         PSHD                      ;/* store page registers */
+        PSHX                      ;/* save source offset */
+        LDX     4,SP              ;/* load return address */
+        LDD     2,X+              ;/* load size to copy. Increment return address */
+        STX     4,SP
+        PULX
+        PSHD                      ;/* store size */
+        LDD     2,SP              ;/* reload both pages */
+        CBA
+        BEQ     FAST_SRC          ;/* same page: set it once */
+        TFR     Y,D
+        ADDD    0,SP              ;/* calculate destination end address */
+        BCS     CHECK_SRC
+        CPD     #0x8000
+        BLS     FAST_SRC          ;/* destination ends below the page window */
+        CPY     #0xC000
+        BHS     FAST_SRC          ;/* destination starts above the page window */
+CHECK_SRC:
         TFR     X,D
-        PSHY                      ;/* temporary space */
-        LDY     4,SP              ;/* load return address */
-        ADDD    2,Y+              ;/* calculate source end address. Increment return address */
-        STY     4,SP
-        PULY
-        PSHD                      ;/* store src end address */
+        ADDD    0,SP              ;/* calculate source end address */
+        BCS     SLOW
+        CPD     #0x8000
+        BLS     FAST_DST          ;/* source ends below the page window */
+        CPX     #0xC000
+        BHS     FAST_DST          ;/* source starts above the page window */
+SLOW:
+        TFR     X,D
+        ADDD    0,SP              ;/* calculate source end address */
+        STD     0,SP
         LDAB    2,SP              ;/* reload source page */
         LDAA    PAGE_ADDR         ;/* save page register */
         PSHA
@@ -869,6 +894,30 @@ loop:
         STAA    PAGE_ADDR         ;/* store it into page register */
         _SRET                     ;/* debug info only: This is the last instr of a function with a special return */
         RTS
+
+FAST_DST:
+        LDAA    3,SP              ;/* only the destination page matters */
+        BRA     FAST
+FAST_SRC:
+        LDAA    2,SP              ;/* only the source page matters */
+FAST:
+        LDAB    PAGE_ADDR         ;/* save page register */
+        STAA    PAGE_ADDR         ;/* set page register once */
+        STAB    3,SP              ;/* keep old page value */
+        PULD                      ;/* reload size */
+        LSRD                      ;/* number of words, odd byte in carry */
+        BCC     FAST_WORDS
+        MOVB    1,X+, 1,Y+        ;/* odd byte */
+FAST_WORDS:
+        TBEQ    D,FAST_DONE
+FAST_LOOP:
+        MOVW    2,X+, 2,Y+
+        DBNE    D,FAST_LOOP
+FAST_DONE:
+        PULD                      ;/* old page value in B, release stack */
+        STAB    PAGE_ADDR         ;/* store it into page register */
+        _SRET                     ;/* debug info only: This is the last instr of a function with a special return */
+        RTS
   }
 #endif
 }
@@ -883,6 +932,7 @@ loop:
   larger runtime routine and it is slightly slower.
   The _FAR_COPY routine is here now mainly for compatibility with previous releases. 
   The current compiler does not use it. 
+  It takes the same fast path as _FAR_COPY_RC.
   
 --------------------------- _FAR_COPY ----------------------------------*/
 
@@ -923,6 +973,24 @@ loop:
 #else
   asm {
         PSHD                      ;/* store page registers */
+        CBA
+        BEQ     FAST_SRC          ;/* same page: set it once */
+        TFR     Y,D
+        ADDD    4,SP              ;/* calculate destination end address */
+        BCS     CHECK_SRC
+        CPD     #0x8000
+        BLS     FAST_SRC          ;/* destination ends below the page window */
+        CPY     #0xC000
+        BHS     FAST_SRC          ;/* destination starts above the page window */
+CHECK_SRC:
+        TFR     X,D
+        ADDD    4,SP              ;/* calculate source end address */
+        BCS     SLOW
+        CPD     #0x8000
+        BLS     FAST_DST          ;/* source ends below the page window */
+        CPX     #0xC000
+        BHS     FAST_DST          ;/* source starts above the page window */
+SLOW:
         TFR     X,D
         ADDD    4,SP              ;/* calculate source end address */
         STD     4,SP
@@ -941,10 +1009,66 @@ loop:
         STAA    PAGE_ADDR         ;/* store it into page register */
         LDX     4,SP+             ;/* release stack and load return address */
         JMP     0,X               ;/* return */
+
+FAST_DST:
+        LDAA    1,SP              ;/* only the destination page matters */
+        BRA     FAST
+FAST_SRC:
+        LDAA    0,SP              ;/* only the source page matters */
+FAST:
+        LDAB    PAGE_ADDR         ;/* save page register */
+        STAA    PAGE_ADDR         ;/* set page register once */
+        STAB    1,SP              ;/* keep old page value */
+        LDD     4,SP              ;/* load size */
+        LSRD                      ;/* number of words, odd byte in carry */
+        BCC     FAST_WORDS
+        MOVB    1,X+, 1,Y+        ;/* odd byte */
+FAST_WORDS:
+        TBEQ    D,FAST_DONE
+FAST_LOOP:
+        MOVW    2,X+, 2,Y+
+        DBNE    D,FAST_LOOP
+FAST_DONE:
+        PULD                      ;/* old page value in B, release stack */
+        STAB    PAGE_ADDR         ;/* store it into page register */
+        LDX     4,SP+             ;/* release stack and load return address */
+        JMP     0,X               ;/* return */
   }
 #endif
 }
 
+/*--------------------------- readFarBlock --------------------------------
+  Copies a block from paged memory into RAM with the page register set once, e.g. to fetch
+  a waveform table from paged flash. Unlike the runtime routines above it is meant to be
+  called from C; see datapage.h.
+
+  Arguments :
+  - dest: non paged destination, i.e. not in the window 0x8000..0xBFFF
+  - source: far address of the block
+  - size: number of bytes to be copied
+
+  Result :
+  - memory area copied
+  - the page register still contains the same value as before the call
+  --------------------------- readFarBlock ----------------------------------*/
+
+void NEAR readFarBlock(void *dest, const void *__far source, unsigned int size) {
+  unsigned char *d = (unsigned char *)dest;
+  const unsigned char *s = (const unsigned char *)(unsigned int)(unsigned long)source;
+  unsigned char page = *(volatile unsigned char *)PAGE_ADDR;
+
+  *(volatile unsigned char *)PAGE_ADDR = (unsigned char)((unsigned long)source >> 16);
+  if (size & 1) {
+    *d++ = *s++;
+  }
+  for (size >>= 1; size != 0; size--) {
+    *(unsigned int *)d = *(const unsigned int *)s;
+    d += 2;
+    s += 2;
+  }
+  *(volatile unsigned char *)PAGE_ADDR = page;
+}
+
 #else  /* __HCS12X__  */
 
 /*
@@ -0,0 +1,222 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    encoder.c                                      *
+*          Quadrature encoder on PP2 (A) and PP3 (B)      *
+*---------------------------------------------------------*
+* Port P interrupts on one edge polarity only, so the ISR *
+* flips PPSP after every edge to catch the next one. The  *
+* state is the pair (B,A) = (PP3,PP2); the table below    *
+* turns (last state, new state) into a step.              *
+**********************************************************/
+
+#include "derivative.h"
+#include "encoder.h"
+
+#define STEP_ILLEGAL 2      // both channels changed: an edge was missed
+
+// Index: (last state << 2) | new state. Counting up follows 0 -> 1 -> 3 -> 2 -> 0.
+static const signed char encoderTable[16] = {
+     0, +1, -1, STEP_ILLEGAL,
+    -1,  0, STEP_ILLEGAL, +1,
+    +1, STEP_ILLEGAL,  0, -1,
+    STEP_ILLEGAL, -1, +1,  0
+};
+
+#define EDGE_MASK   (ENCODER_AVERAGE_EDGES - 1)
+#define STOP_TICKS  (ENCODER_STOP_US * (ENCODER_TIMER_HZ / 1000000L))
+
+// Written only by Encoder_ISR (except at initialization). The ISR bumps encoderSequence after
+// every update so the main loop can copy multi-byte values without disabling interrupts.
+static volatile unsigned char encoderSequence = 0;
+static unsigned char encoderState = 0;
+static volatile long encoderPosition = 0;
+static volatile unsigned int encoderErrors = 0;
+
+// Velocity: timestamps of the last edges in the current direction
+static volatile unsigned int edgeTime[ENCODER_AVERAGE_EDGES];
+static volatile unsigned char edgeHead = 0;
+static unsigned char edgeHistory = 0;
+static volatile signed char edgeDirection = 0;
+static volatile unsigned int spanTicks = 0;         // time across the last spanEdges edges
+static volatile unsigned char spanEdges = 0;        // 0 while there is no measurement
+static volatile unsigned char encoderStopped = 1;   // set by the main loop, restarts the averaging
+
+/************************************************
+*   initializeEncoder                           *
+*                                               *
+*   Desc.: Sets PP2/PP3 as interrupt inputs,    *
+*          starts TCNT and zeroes the count.    *
+*          Needs interrupts enabled (CLI).      *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void initializeEncoder(void){
+    unsigned char pins;
+
+    PIEP = PIEP & ~ENCODER_PINS;
+    DDRP = DDRP & ~ENCODER_PINS;
+    PERP = PERP & ~ENCODER_PINS;
+
+    TSCR1_TEN = 1;
+    TSCR2 = (TSCR2 & ~0x07) | ENCODER_TIMER_PRESCALE;
+
+    pins = PTP & ENCODER_PINS;
+    encoderState = pins >> 2;
+    PPSP = (PPSP & ~ENCODER_PINS) | (~pins & ENCODER_PINS);   // low pin: wait for rising edge
+    encoderPosition = 0;
+    encoderErrors = 0;
+    edgeHistory = 0;
+    spanEdges = 0;
+    encoderStopped = 1;
+
+    PIFP = ENCODER_PINS;
+    PIEP = PIEP | ENCODER_PINS;
+}
+
+/************************************************
+*   getEncoderPosition                          *
+*                                               *
+*   Desc.: Reads the 32-bit count. The copy is  *
+*          retried if an edge interrupted it.   *
+*   Inputs:  None                               *
+*   Outputs: Position in counts                 *
+************************************************/
+
+long getEncoderPosition(void){
+    unsigned char sequence;
+    long position;
+
+    do {
+        sequence = encoderSequence;
+        position = encoderPosition;
+    } while (sequence != encoderSequence);
+    return position;
+}
+
+/************************************************
+*   setEncoderPosition                          *
+*                                               *
+*   Desc.: Presets the count, e.g. at a homing  *
+*          switch                               *
+*   Inputs:  position - New count               *
+*   Outputs: None                               *
+************************************************/
+
+void setEncoderPosition(long position){
+    PIEP = PIEP & ~ENCODER_PINS;
+    encoderPosition = position;
+    encoderSequence++;
+    PIEP = PIEP | ENCODER_PINS;         // an edge meanwhile stays flagged and is taken now
+}
+
+/************************************************
+*   getEncoderVelocity                          *
+*                                               *
+*   Desc.: Speed from the time between the     *
+*          last edges. While no new edge comes, *
+*          the time since the last one bounds   *
+*          the speed, so it falls smoothly to 0 *
+*          when the shaft stops. Call at least  *
+*          every 40ms so a stop is noticed      *
+*          before TCNT wraps.                   *
+*   Inputs:  None                               *
+*   Outputs: Counts per second, signed          *
+************************************************/
+
+long getEncoderVelocity(void){
+    unsigned char sequence, edges;
+    unsigned int ticks, elapsed;
+    signed char direction;
+
+    do {
+        sequence = encoderSequence;
+        edges = spanEdges;
+        ticks = spanTicks;
+        direction = edgeDirection;
+        elapsed = (unsigned short)(TCNT - edgeTime[(edgeHead - 1) & EDGE_MASK]);
+    } while (sequence != encoderSequence);
+
+    if (edges == 0)
+        return 0;
+    if (elapsed > STOP_TICKS){
+        encoderStopped = 1;
+        return 0;
+    }
+
+    // Slower than the last measurement: a new edge is overdue
+    if ((unsigned long)elapsed * edges > ticks){
+        ticks = elapsed;
+        edges = 1;
+    }
+    if (ticks == 0)
+        ticks = 1;                      // two edges inside one timer tick
+    return direction * (long)edges * ENCODER_TIMER_HZ / ticks;
+}
+
+/************************************************
+*   getEncoderErrors                            *
+*                                               *
+*   Desc.: Number of illegal transitions (both  *
+*          channels changed between two reads), *
+*          i.e. counts that may have been lost  *
+*   Inputs:  None                               *
+*   Outputs: Error count, wraps at 65535        *
+************************************************/
+
+unsigned int getEncoderErrors(void){
+    return encoderErrors;
+}
+
+/************************************************
+*   Encoder_ISR                                 *
+*                                               *
+*   Desc.: Decodes every A/B edge and           *
+*          timestamps it. If a pin changes      *
+*          while the polarity is being set, the *
+*          loop decodes that edge too.          *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void interrupt VectorNumber_Vportp Encoder_ISR(void){
+    unsigned char pins, state;
+    unsigned int now;
+    signed char step;
+
+    PIFP = ENCODER_PINS;                // clear first: a later edge raises the flag again
+    do {
+        now = TCNT;
+        pins = PTP & ENCODER_PINS;
+        PPSP = (PPSP & ~ENCODER_PINS) | (~pins & ENCODER_PINS);
+        state = pins >> 2;
+        step = encoderTable[(encoderState << 2) | state];
+        encoderState = state;
+
+        if (step == STEP_ILLEGAL){
+            encoderErrors++;
+            edgeHistory = 0;            // the edge times no longer match the count
+            spanEdges = 0;
+        }
+        else if (step != 0){
+            encoderPosition += step;
+            if (step != edgeDirection || encoderStopped
+                || (edgeHistory && (unsigned short)(now - edgeTime[(edgeHead - 1) & EDGE_MASK]) > STOP_TICKS)){
+                edgeDirection = step;
+                edgeHistory = 0;
+                spanEdges = 0;
+                encoderStopped = 0;
+            }
+            if (edgeHistory){
+                spanTicks = (unsigned short)(now - edgeTime[(edgeHead - edgeHistory) & EDGE_MASK]);
+                spanEdges = edgeHistory;
+            }
+            edgeTime[edgeHead] = now;
+            edgeHead = (edgeHead + 1) & EDGE_MASK;
+            if (edgeHistory < ENCODER_AVERAGE_EDGES)
+                edgeHistory++;
+        }
+        encoderSequence++;
+    } while ((PTP & ENCODER_PINS) != pins);
+}
\ No newline at end of file
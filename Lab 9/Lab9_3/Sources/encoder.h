@@ -0,0 +1,37 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    encoder.h                                      *
+*          Quadrature encoder on PP2 (A) and PP3 (B)      *
+*---------------------------------------------------------*
+* Every edge of both channels is decoded (4 counts per    *
+* encoder cycle). Counting up means A leads B.            *
+**********************************************************/
+
+#ifndef _ENCODER_H
+#define _ENCODER_H
+
+#define ENCODER_PIN_A           0x04    // PP2
+#define ENCODER_PIN_B           0x08    // PP3
+#define ENCODER_PINS            (ENCODER_PIN_A | ENCODER_PIN_B)
+#define ENCODER_COUNTS_PER_CYCLE 4
+
+// Edge timestamps come from TCNT at 1MHz, as for the buffered LCD; setTimebaseBusClock() picks the prescaler for the
+// current bus. The prescaler below is only the setting at start-up, on the 8MHz bus.
+#define ENCODER_TIMER_PRESCALE  3
+#define ENCODER_TIMER_HZ        1000000L
+
+// The velocity is averaged over the last ENCODER_AVERAGE_EDGES edges (one full cycle, so the
+// uneven spacing of the A and B edges cancels out). With no edge for ENCODER_STOP_US the shaft
+// counts as stopped; this keeps the averaging span inside the 16-bit timer.
+#define ENCODER_AVERAGE_EDGES   4
+#define ENCODER_STOP_US         16000
+
+// Function prototypes - tell the compiler that these functions exist somewhere
+void initializeEncoder(void);
+long getEncoderPosition(void);
+void setEncoderPosition(long position);
+long getEncoderVelocity(void);
+unsigned int getEncoderErrors(void);
+
+#endif
\ No newline at end of file
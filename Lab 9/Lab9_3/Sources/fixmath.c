@@ -0,0 +1,530 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    fixmath.c                                      *
+*          Saturating fixed-point arithmetic              *
+*---------------------------------------------------------*
+* Each routine is inline asm on the board and C in host   *
+* builds. The C is the reference: Tools/fixbench runs the *
+* asm on the sim12 core against it, and they must agree   *
+* on every bit. The last argument and the result come in  *
+* D, or X:D (X high) for a long; the argument before it   *
+* is on the stack above the return address.               *
+* The routines only use the stack, so the control         *
+* interrupt and the main program can both call them.      *
+**********************************************************/
+
+#include "fixmath.h"
+
+#ifndef __HC12__
+// p >> n rounded down, whatever the host does with a negative >>
+static long shiftDown(long p, unsigned char n){
+    return p >= 0 ? p >> n : ~(~p >> n);
+}
+
+static long saturate(long long x){
+    if (x > FIX_MAX)
+        return FIX_MAX;
+    if (x < FIX_MIN)
+        return FIX_MIN;
+    return (long)x;
+}
+#endif
+
+/************************************************
+*   fixMul                                      *
+*                                               *
+*   Desc.: Full product of two ints; it always  *
+*          fits, so nothing saturates           *
+*   Inputs:  a, b                               *
+*   Outputs: a * b                              *
+************************************************/
+
+#pragma NO_ENTRY
+#pragma NO_EXIT
+#pragma NO_FRAME
+
+long fixMul(int a, int b){
+#ifdef __HC12__
+    asm {
+        TFR     D,Y             // b
+        LDD     2,SP            // a
+        EMULS                   // Y:D = a * b
+        TFR     Y,X
+        RTS
+    }
+#else
+    return (long)a * b;
+#endif
+}
+
+/************************************************
+*   fixMulQ8                                    *
+*                                               *
+*   Desc.: Product of a Q8 gain and an int,     *
+*          rounded down to an integer           *
+*   Inputs:  a - Q8 (256 = 1.0)                 *
+*            b                                  *
+*   Outputs: (a * b) >> 8                       *
+************************************************/
+
+#pragma NO_ENTRY
+#pragma NO_EXIT
+#pragma NO_FRAME
+
+long fixMulQ8(int a, int b){
+#ifdef __HC12__
+    asm {
+        TFR     D,Y
+        LDD     2,SP
+        EMULS                   // Y:D = a * b
+        PSHY                    // 0,SP = bits 24-31, 1,SP = bits 16-23
+        TFR     A,B
+        LDAA    1,SP            // D = bits 8-23
+        PSHD
+        LDAB    2,SP
+        SEX     B,X             // X = bits 24-31, sign extended
+        PULD
+        LEAS    2,SP
+        RTS
+    }
+#else
+    return shiftDown((long)a * b, 8);
+#endif
+}
+
+/************************************************
+*   fixMulQ15                                   *
+*                                               *
+*   Desc.: Q15 product, rounded down. Only      *
+*          -1.0 * -1.0 overflows; it gives the  *
+*          largest Q15 value.                   *
+*   Inputs:  a, b - Q15                         *
+*   Outputs: (a * b) >> 15                      *
+************************************************/
+
+#pragma NO_ENTRY
+#pragma NO_EXIT
+#pragma NO_FRAME
+
+int fixMulQ15(int a, int b){
+#ifdef __HC12__
+    asm {
+        TFR     D,Y
+        LDD     2,SP
+        EMULS                   // Y:D = a * b
+        LSLD                    // C = bit 15
+        TFR     Y,D
+        ROLB
+        ROLA                    // D = bits 15-30
+        CPD     #0x8000
+        BNE     done            // 0x8000 only comes from 0x8000 * 0x8000
+        LDD     #0x7FFF
+    done:
+        RTS
+    }
+#else
+    long p = shiftDown((long)a * b, 15);
+
+    return p > 32767 ? 32767 : (int)p;
+#endif
+}
+
+/************************************************
+*   fixMulQ16                                   *
+*                                               *
+*   Desc.: Q16.16 product. The 64-bit product   *
+*          of the magnitudes is built from four *
+*          EMULs; bits 16-47 are the result,    *
+*          which is rounded toward zero and     *
+*          saturated.                           *
+*   Inputs:  a, b - Q16.16                      *
+*   Outputs: a * b / 65536                      *
+************************************************/
+
+#pragma NO_ENTRY
+#pragma NO_EXIT
+#pragma NO_FRAME
+
+long fixMulQ16(long a, long b){
+#ifdef __HC12__
+    asm {
+        PSHX                    // b
+        PSHD
+        LDAA    6,SP            // a high byte
+        EORA    2,SP            // b high byte
+        LEAS    -6,SP           // result bits 16-63, 16 bits a word
+        PSHA                    // sign of the result
+        // From here: 0,SP sign, 1,SP bits 48-63, 3,SP bits 32-47, 5,SP bits 16-31,
+        // 7,SP b low, 9,SP b high, 11,SP return, 13,SP a high, 15,SP a low
+        TST     13,SP
+        BPL     aPositive
+        LDD     #0
+        SUBD    15,SP
+        STD     15,SP
+        LDD     #0
+        SBCB    14,SP
+        SBCA    13,SP
+        STD     13,SP
+    aPositive:
+        TST     9,SP
+        BPL     bPositive
+        LDD     #0
+        SUBD    7,SP
+        STD     7,SP
+        LDD     #0
+        SBCB    10,SP
+        SBCA    9,SP
+        STD     9,SP
+    bPositive:
+        LDD     15,SP
+        LDY     7,SP
+        EMUL                    // a low * b low: only its high word counts
+        STY     5,SP
+        LDX     #0
+        STX     3,SP
+        STX     1,SP
+        LDD     13,SP
+        LDY     7,SP
+        EMUL                    // a high * b low
+        ADDD    5,SP
+        STD     5,SP
+        TFR     Y,D
+        ADCB    4,SP
+        ADCA    3,SP
+        STD     3,SP
+        LDD     1,SP
+        ADCB    #0
+        ADCA    #0
+        STD     1,SP
+        LDD     15,SP
+        LDY     9,SP
+        EMUL                    // a low * b high
+        ADDD    5,SP
+        STD     5,SP
+        TFR     Y,D
+        ADCB    4,SP
+        ADCA    3,SP
+        STD     3,SP
+        LDD     1,SP
+        ADCB    #0
+        ADCA    #0
+        STD     1,SP
+        LDD     13,SP
+        LDY     9,SP
+        EMUL                    // a high * b high, into bits 32-63
+        ADDD    3,SP
+        STD     3,SP
+        TFR     Y,D
+        ADCB    2,SP
+        ADCA    1,SP
+        BNE     overflow        // bits 48-63 of the magnitude must be 0
+        TSTB
+        BNE     overflow
+        LDD     3,SP
+        BMI     large           // 0x80000000 or more
+        TFR     D,X
+        LDD     5,SP
+        TST     0,SP
+        BPL     done
+    negate:
+        COMA
+        COMB
+        EXG     D,X
+        COMA
+        COMB
+        EXG     D,X
+        IBNE    D,done
+        INX
+    done:
+        LEAS    11,SP
+        RTS
+    large:
+        TST     0,SP
+        BPL     overflow
+        CPD     #0x8000
+        BNE     overflow
+        LDD     5,SP
+        BNE     overflow
+        LDX     #0x8000         // exactly -32768.0
+        BRA     done
+    overflow:
+        TST     0,SP
+        BMI     negative
+        LDX     #0x7FFF
+        LDD     #0xFFFF
+        BRA     done
+    negative:
+        LDX     #0x8000
+        LDD     #0
+        BRA     done
+    }
+#else
+    return saturate((long long)a * b / 65536);
+#endif
+}
+
+// acc + a * b, saturated
+long fixMac(long acc, int a, int b){
+    return fixAdd(acc, fixMul(a, b));
+}
+
+/************************************************
+*   fixDiv                                      *
+*                                               *
+*   Desc.: Divides a long by an int with one    *
+*          EDIVS, rounding toward zero. A       *
+*          quotient past the int range, or a    *
+*          divide by 0, saturates by sign.      *
+*          (a << 15) / b is a Q15 divide.       *
+*   Inputs:  n - Dividend                       *
+*            d - Divisor                        *
+*   Outputs: n / d                              *
+************************************************/
+
+#pragma NO_ENTRY
+#pragma NO_EXIT
+#pragma NO_FRAME
+
+int fixDiv(long n, int d){
+#ifdef __HC12__
+    asm {
+        TFR     D,X             // d
+        PSHD                    // n is now at 4,SP
+        LDY     4,SP
+        LDD     6,SP
+        EDIVS                   // Y = Y:D / X, D = remainder
+        BVS     saturate
+        BCS     byZero
+        TFR     Y,D
+        LEAS    2,SP
+        RTS
+    byZero:
+        CLR     0,SP            // the sign of n alone decides
+    saturate:
+        LDAA    0,SP
+        EORA    4,SP
+        LEAS    2,SP
+        BMI     negative
+        LDD     #0x7FFF
+        RTS
+    negative:
+        LDD     #0x8000
+        RTS
+    }
+#else
+    long q;
+
+    if (d == 0)
+        return n < 0 ? -32768 : 32767;
+    q = n / d;
+    if (q > 32767)
+        return 32767;
+    if (q < -32768)
+        return -32768;
+    return (int)q;
+#endif
+}
+
+/************************************************
+*   fixAdd                                      *
+*                                               *
+*   Desc.: Saturating 32-bit add                *
+*   Inputs:  a, b                               *
+*   Outputs: a + b                              *
+************************************************/
+
+#pragma NO_ENTRY
+#pragma NO_EXIT
+#pragma NO_FRAME
+
+long fixAdd(long a, long b){
+#ifdef __HC12__
+    asm {
+        ADDD    4,SP            // low words
+        PSHD                    // a is now at 4,SP
+        TFR     X,D
+        ADCB    5,SP
+        ADCA    4,SP            // V: the signed sum overflowed
+        BVS     overflow
+        TFR     D,X
+        PULD
+        RTS
+    overflow:
+        LEAS    2,SP
+        TST     2,SP            // both had the sign of a
+        BMI     negative
+        LDX     #0x7FFF
+        LDD     #0xFFFF
+        RTS
+    negative:
+        LDX     #0x8000
+        LDD     #0
+        RTS
+    }
+#else
+    if (b > 0 && a > FIX_MAX - b)
+        return FIX_MAX;
+    if (b < 0 && a < FIX_MIN - b)
+        return FIX_MIN;
+    return a + b;
+#endif
+}
+
+/************************************************
+*   fixSub                                      *
+*                                               *
+*   Desc.: Saturating 32-bit subtract           *
+*   Inputs:  a, b                               *
+*   Outputs: a - b                              *
+************************************************/
+
+#pragma NO_ENTRY
+#pragma NO_EXIT
+#pragma NO_FRAME
+
+long fixSub(long a, long b){
+#ifdef __HC12__
+    asm {
+        PSHX                    // b
+        PSHD                    // a is now at 6,SP
+        LDD     8,SP
+        SUBD    0,SP            // low words
+        STD     0,SP
+        LDD     6,SP
+        SBCB    3,SP
+        SBCA    2,SP            // V: the signed difference overflowed
+        BVS     overflow
+        TFR     D,X
+        PULD
+        LEAS    2,SP
+        RTS
+    overflow:
+        LEAS    4,SP
+        TST     2,SP            // it went past the end on the side of a
+        BMI     negative
+        LDX     #0x7FFF
+        LDD     #0xFFFF
+        RTS
+    negative:
+        LDX     #0x8000
+        LDD     #0
+        RTS
+    }
+#else
+    if (b < 0 && a > FIX_MAX + b)
+        return FIX_MAX;
+    if (b > 0 && a < FIX_MIN + b)
+        return FIX_MIN;
+    return a - b;
+#endif
+}
+
+/************************************************
+*   fixClamp                                    *
+*                                               *
+*   Desc.: Limits x to -limit..limit. The two   *
+*          compares are 32-bit subtracts that   *
+*          branch on the signed result.         *
+*   Inputs:  x                                  *
+*            limit - 0 or more                  *
+*   Outputs: x, limit or -limit                 *
+************************************************/
+
+#pragma NO_ENTRY
+#pragma NO_EXIT
+#pragma NO_FRAME
+
+long fixClamp(long x, long limit){
+#ifdef __HC12__
+    asm {
+        PSHX                    // limit
+        PSHD                    // x is now at 6,SP
+        LDD     0,SP
+        SUBD    8,SP
+        LDD     2,SP
+        SBCB    7,SP
+        SBCA    6,SP            // limit - x
+        BLT     high
+        LDD     8,SP
+        ADDD    0,SP
+        LDD     6,SP
+        ADCB    3,SP
+        ADCA    2,SP            // x + limit
+        BLT     low
+        LDX     6,SP
+        LDD     8,SP
+        LEAS    4,SP
+        RTS
+    high:
+        PULD
+        PULX
+        RTS
+    low:
+        LDD     #0
+        SUBD    0,SP
+        TFR     D,Y
+        LDD     #0
+        SBCB    3,SP
+        SBCA    2,SP
+        TFR     D,X
+        TFR     Y,D             // -limit
+        LEAS    4,SP
+        RTS
+    }
+#else
+    if (x > limit)
+        return limit;
+    if (x < -limit)
+        return -limit;
+    return x;
+#endif
+}
+
+/************************************************
+*   fixToInt                                    *
+*                                               *
+*   Desc.: Saturates a long to the int range.   *
+*          It fits when the high word is the    *
+*          sign extension of the low one.       *
+*   Inputs:  x                                  *
+*   Outputs: x, 32767 or -32768                 *
+************************************************/
+
+#pragma NO_ENTRY
+#pragma NO_EXIT
+#pragma NO_FRAME
+
+int fixToInt(long x){
+#ifdef __HC12__
+    asm {
+        CPX     #0
+        BEQ     positive
+        CPX     #0xFFFF
+        BEQ     negative
+        TFR     X,D
+        TSTA
+        BMI     minimum
+    maximum:
+        LDD     #0x7FFF
+        RTS
+    positive:
+        TSTA
+        BMI     maximum
+        RTS
+    negative:
+        TSTA
+        BPL     minimum
+        RTS
+    minimum:
+        LDD     #0x8000
+        RTS
+    }
+#else
+    if (x > 32767)
+        return 32767;
+    if (x < -32768)
+        return -32768;
+    return (int)x;
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    fixmath.h                                      *
+*          Saturating fixed-point arithmetic              *
+*---------------------------------------------------------*
+* 32-bit arithmetic on the 16-bit CPU12 otherwise goes    *
+* through CodeWarrior's runtime (_LMULS16x32, _LCMP...).  *
+* These routines use EMULS for the products and EDIVS for *
+* the divide, and saturate instead of wrapping: a result  *
+* past the range of its type comes back as the nearest    *
+* end of the range.                                       *
+*                                                         *
+* Formats: an int is Q15 (32767 = 1.0 - 2^-15) or a plain *
+* integer, a long is Q16.16 (65536 = 1.0) or a plain      *
+* integer; the Q8 product is for the control gains.       *
+**********************************************************/
+
+#ifndef _FIXMATH_H
+#define _FIXMATH_H
+
+#define FIX_MAX         0x7FFFFFFFL
+#define FIX_MIN         (-FIX_MAX - 1)
+#define FIX_Q16_ONE     65536L
+
+// Constants only: the conversion is done by the compiler
+#define FIX_Q15(x)      ((int)((x) * 32768.0))
+#define FIX_Q16(x)      ((long)((x) * 65536.0))
+
+// Function prototypes - tell the compiler that these functions exist somewhere
+long fixMul(int a, int b);
+long fixMulQ8(int a, int b);
+int fixMulQ15(int a, int b);
+long fixMulQ16(long a, long b);
+long fixMac(long acc, int a, int b);
+int fixDiv(long n, int d);
+long fixAdd(long a, long b);
+long fixSub(long a, long b);
+long fixClamp(long x, long limit);
+int fixToInt(long x);
+
+#endif
\ No newline at end of file
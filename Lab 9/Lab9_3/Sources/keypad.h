@@ -0,0 +1,59 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    keypad.h                                       *
+*          Interrupt-scanned 4x4 keypad on Port A         *
+*---------------------------------------------------------*
+* Keypad_ISR (ECT channel 5) reads one row per tick, so   *
+* the main loop never scans the matrix itself. Each key   *
+* is debounced on its own and every press and release is  *
+* queued as an event; the main loop takes them out with   *
+* getKeyEvent() or getKeypress(), which never wait.       *
+* setKeypadTask() also wakes a scheduler task for each.   *
+*                                                         *
+* Rows are driven on PA3-PA0, columns read on PA4-PA7.    *
+* Key numbers 0-15 follow that scan order, the order of   *
+* the keypadTable[] arrays in the labs.                   *
+**********************************************************/
+
+#ifndef _KEYPAD_H
+#define _KEYPAD_H
+
+// Row ticks come from TCNT at 1MHz, as for the other timer users; setTimebaseBusClock() picks the prescaler for the
+// current bus. The prescaler below is only the setting at start-up, on the 8MHz bus.
+#define KEYPAD_TIMER_PRESCALE   3
+#define KEYPAD_TIMER_HZ         1000000L
+
+// One row every KEYPAD_TICK_US, so all four every 4ms. A key changes state once it has read the
+// same for KEYPAD_DEBOUNCE_SCANS scans in a row (8-12ms), which outlasts the contact bounce.
+#define KEYPAD_TICK_US          1000
+#define KEYPAD_DEBOUNCE_SCANS   3
+
+// Events waiting for the main loop. Must be a power of two, at most 128.
+#define KEYPAD_QUEUE_SIZE       16
+
+struct keyEvent {
+    unsigned char key;          // 0-15, in scan order
+    unsigned char code;         // keypadTable[key], as given to initializeKeypad()
+    unsigned char down;         // 1 for a press, 0 for a release
+    unsigned int ticks;         // getKeypadTicks() when the change was confirmed
+};
+
+struct keypadStats {
+    unsigned long events;
+    unsigned int dropped;       // the queue was full; the key state is still right
+    unsigned int bounces;       // changes that did not last KEYPAD_DEBOUNCE_SCANS scans
+    unsigned int ghosts;        // times new presses were held back, see keypad.c
+    unsigned char queueMax;
+};
+
+// Function prototypes - tell the compiler that these functions exist somewhere
+void initializeKeypad(const unsigned char *table);
+void setKeypadTask(unsigned char task, unsigned char events);
+unsigned char getKeyEvent(struct keyEvent *event);
+unsigned char getKeypress(void);
+unsigned int getKeysDown(void);
+unsigned int getKeypadTicks(void);
+void getKeypadStats(struct keypadStats *stats);
+
+#endif
\ No newline at end of file
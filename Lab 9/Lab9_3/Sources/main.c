@@ -1,41 +1,64 @@
 #include <hidef.h>      /* common defines and macros */
 #include "derivative.h"      /* derivative-specific definitions */
 #include "advancedLCD.h"
-
-// Scan codes used to check for keypad key presses
-const char scanCode[4] = {0xF8, 0xF4, 0xF2, 0xF1};
+#include "keypad.h"
+#include "encoder.h"
+#include "control.h"
+#include "timebase.h"
+#include "scheduler.h"
+#include "clock.h"
+#include "fixmath.h"
 
 // For this program, we mostly keep the original keypad mapping. All numbers return their literal number (0-9, not ASCII '0','1', etc.).
 const unsigned char keypadTable[16] = {0x00,0x00,0x00,0x00, 0x03,0x06,0x09,0x0C, 0x02,0x05,0x08,0x0B, 0x01,0x04,0x07,0x0A};
 
 
-void setOutput(int output);
-char scanKeypad();
 int limitMagnitude(long a, unsigned int mag);
 
-int position;
+// The user interface is two scheduler tasks: keyTask runs when Keypad_ISR queues a keystroke, displayTask every
+// DISPLAY_PERIOD_MS. The control loop itself stays in Control_ISR.
+#define DISPLAY_PERIOD_MS 50
+#define EVENT_KEY         0x02
+
+long reference = 0, newReference = 0;
+
+// The bus runs at CLOCK_16MHZ from a new reference until the position has stayed within SETTLE_COUNTS of it for
+// SETTLE_MS, and at CLOCK_4MHZ while the motor holds still. Every timer keeps its rate through setTimebaseBusClock(),
+// and PWMSCLA follows the bus so the PWM frequency does not change either.
+#define SETTLE_COUNTS     4
+#define SETTLE_MS         500
+#define PWM_SCALE_HZ      2000000L    // bus per PWMSCLA step: clock SA = bus / 128 / (2 * PWMSCLA) = 7.8kHz
 
-unsigned char lastEncoderState = 0, currentEncoderState = 0;
+unsigned int settledMs = 0;
 
-// Try different KP values with P-control only:
-//  * 50 - Fast response, oscillates near final value, jump due to slow LCD update is noticeable
-//  * 10 - Mod. to Fast response, minimal oscillation
-//  * 1  - Slow response, no oscillation, some absolute position error
+void keyTask(unsigned char events);
+void displayTask(unsigned char events);
+void setPWMBusClock(unsigned long busHz);
 
-#define KP 10
-#define KI 1
-#define KD 1
+// Try different KP values with P-control only (KI = KD = 0):
+//  * 3200 - Fast response, oscillates near final value
+//  * 640  - Mod. to Fast response, minimal oscillation
+//  * 64   - Slow response, no oscillation, some absolute position error
+// Gains are fixed point, see control.h. KP 640 is 2.5 per count, i.e. 10 per encoder cycle.
+// KI removes the remaining position error; KD damps the oscillation at high KP.
+
+#define KP 640
+#define KI 16
+#define KD 1280
+
+// A new reference is reached through a motion profile rather than as a step, so the loop spends less time
+// saturated and barely overshoots. Limits in counts/s, counts/s^2 and counts/s^3; VMAX 0 goes back to
+// steps.
+#define VMAX 6000L
+#define AMAX 50000L
+#define JMAX 1000000L
 
 void main(void) 
 {
-  long reference = 0, newReference = 0, error, lastError, control;
-  unsigned char keyOld = 0, key = 0;
-  
-  int update = 0;
+  unsigned char keyTaskId, displayTaskId;
   
   // **************** Keypad Initilization ****************
-  DDRA = 0x0F;
-  PORTA = 0xFF;
+  initializeKeypad(keypadTable);    // scanned in Keypad_ISR once interrupts are on
   // **************** Keypad Initilization ****************
 
   
@@ -61,172 +84,110 @@ void main(void)
   
   // **************** LCD Initilization ****************
   DDRK = 0xFF;  
+  initializeTimebase();             // shortWait() and the LCD driver wait on it
   shortWait(160);
   initializeLCD();
   shortWait(160);
-  clearLCD();
+  setLCDMode(LCD_MODE_BUFFERED);    // clears the screen; from here on LCD calls never wait
   printLCDText("Servo Lab v1.0$");
   moveLCDTo(0,1);
   printLCDText("Refer: $");
   // **************** LCD Initilization ****************
   
   // **************** Port P Interrupt / Encoder Initilization ****************
-  DDRP = 0b11110011;
-  PERP = 0b00000000;
-  PPSP_PPSP2 = 1;
-  PPSP_PPSP3 = 1;
-  PIFP = 0b00001100;
-  PIEP = 0b00001100;
+  initializeEncoder();
   __asm CLI;     
-  position = 0;         
   // **************** Port P Interrupt / Encoder Initilization ****************
-    
-  for(;;) 
-  {
-    update++;
-    if (update % 60000 == 0) 
-    {
-      moveLCDTo(0,0);
-      printLCDText("Actual:   $");
-      printLCDNumber(position);    
-    }
-    
-    
-    if (update % 100 == 0) 
-    {
-      keyOld = key;
-      key = scanKeypad();
-      
-      if (keyOld != 0 && key == 0) 
-      {
-        if (keyOld == 0x0A) 
-        {
-          reference = newReference;
-          newReference = 0;
-          
-          moveLCDTo(10,1);
-          printLCDNumber(limitMagnitude(reference,32766));
-        } 
-        else if (keyOld == 0x0C) 
-        {
-          newReference *= -1;  
-          
-          moveLCDTo(10,1);
-          printLCDNumber(limitMagnitude(newReference,32766));
-        }
-        else 
-        {
-          newReference *= 10;
-          if (keyOld != 0x0B && keyOld != 0x0C)
-            newReference += keyOld;
-          
-          moveLCDTo(10,1);
-          printLCDNumber(limitMagnitude(newReference,32766));
-        }
-      }
-    }
-    
-    
-    lastError = error;
-    error = position - reference;
-    
-    control = KP*lastError;
-    control = limitMagnitude(control, 116);
-    
-    setOutput(control);
-  }
-}
-
-// Function which scans the keypad and returns keycode of any pressed key, zero if no key pressed
-char scanKeypad()
-{
   
-  int i, j = 0;
+  // **************** Control Loop Initilization ****************
+  initializeControl(KP, KI, KD);
+  setControlProfile(VMAX, AMAX, JMAX);
+  setControlReference(0);
+  startControl();      // from here the PID runs in Control_ISR at CONTROL_RATE_HZ
+  // **************** Control Loop Initilization ****************
+  
+  // **************** Clock Initilization ****************
+  addClockListener(setTimebaseBusClock);
+  addClockListener(setPWMBusClock);
+  setClock(CLOCK_4MHZ);             // nothing to move to yet
+  // **************** Clock Initilization ****************
+    
+  // **************** Scheduler Initilization ****************
+  initializeScheduler();
+  keyTaskId = addTask(keyTask);
+  displayTaskId = addTask(displayTask);
+  setKeypadTask(keyTaskId, EVENT_KEY);
+  startTaskTimer(displayTaskId, 0, SCHEDULER_MS(DISPLAY_PERIOD_MS));
+  // **************** Scheduler Initilization ****************
   
-	// Try each of four scan codes; this checks one row at a time
-	for (i=0; i<4; i++)
-	{
-		PORTA = scanCode[i];
-		
-		// Check each column in this row, return ASCII code if pressed. Could be made shorter, but format shows function.
-		if (PORTA_BIT4 == 1)
-			return keypadTable[j];
-		else
-			j++;
-			
-		if (PORTA_BIT5 == 1)
-			return keypadTable[j];
-		else
-			j++;
-			
-		if (PORTA_BIT6 == 1)
-			return keypadTable[j];
-		else
-			j++;
-			
-		if (PORTA_BIT7 == 1)
-			return keypadTable[j];
-		else
-			j++;
-	}
-	return 0;
+  // From here on only the tasks run; with none ready the CPU waits for the next interrupt
+  runScheduler();
 }
 
-// Function that sets the PWM output for Motor 1 on Port B motor driver; assume correct initialization
-//   * Direction is selected by sign of 'output'
-//   * Speed is selected by magnitude of 'output'
-//   * Under original PWM settings, 116 is maximum speed (100% duty cycle)
-void setOutput(int output) 
+// Updates the position on the top line. The LCD is buffered, so this costs only the formatting (the flush runs in
+// LCD_Timer_ISR). Also drops the clock once the motor has settled.
+void displayTask(unsigned char events) 
 {
-    if (output < 0) 
-    {
-        PORTB = 0b00000010;
-        PWMDTY0 = (unsigned char)(-1*output);
-    } 
-    else 
-    {
-        PORTB = 0b00000001;
-        PWMDTY0 = (unsigned char)(output);
-    }
+  long position = getEncoderPosition();
   
+  moveLCDTo(0,0);
+  printLCDText("Actual:   $");
+  printLCDNumber(limitMagnitude(position,32766));
+  
+  if (position - reference > SETTLE_COUNTS || reference - position > SETTLE_COUNTS)
+    settledMs = 0;
+  else if (settledMs < SETTLE_MS) 
+  {
+    settledMs += DISPLAY_PERIOD_MS;
+    if (settledMs >= SETTLE_MS)
+      setClock(CLOCK_4MHZ);         // once per settle: if the PLL does not lock, the crystal will do
+  }
 }
 
-void interrupt VectorNumber_Vportp Port_P_ISR(void) 
+// Clock listener: keeps clock SA, and so the PWM frequency, the same at every bus clock
+void setPWMBusClock(unsigned long busHz) 
 {
-    lastEncoderState = currentEncoderState;
-    currentEncoderState = (PTP & 0b00001100) >> 2;
-    
-    if (currentEncoderState == 0x01 && lastEncoderState == 0x03)
-      position++;
-    else if  (currentEncoderState == 0x03 && lastEncoderState == 0x02)
-      position--; 
-    
-    if (PIFP_PIFP2 == 1) 
-       PIFP = PIFP_PIFP2_MASK;
-    else if (PIFP_PIFP3 == 1) 
-       PIFP = PIFP_PIFP3_MASK;
+  PWMSCLA = (unsigned char)(busHz / PWM_SCALE_HZ);
 }
 
-int limitMagnitude(long a, unsigned int mag) 
+// Acts on every whole keystroke (press and release) queued since the last run
+void keyTask(unsigned char events) 
 {
-  if (a > 0) 
-  {
-    if(a>mag)
-      return mag;
-    else
-      return a;
-  } else 
+  unsigned char key;
+  
+  while ((key = getKeypress()) != 0) 
   {
-    if((-1*a)>mag) 
+    if (key == 0x0A) 
     {
-      return -1*mag;
+      reference = newReference;
+      newReference = 0;
+      setClock(CLOCK_16MHZ);
+      settledMs = 0;
+      moveControlTo(reference);
+      
+      moveLCDTo(10,1);
+      printLCDNumber(limitMagnitude(reference,32766));
     } 
-    else 
+    else if (key == 0x0C) 
     {
-      return a;
+      newReference *= -1;  
+      
+      moveLCDTo(10,1);
+      printLCDNumber(limitMagnitude(newReference,32766));
     }
+    else 
+    {
+      newReference *= 10;
+      if (key != 0x0B && key != 0x0C)
+        newReference += key;
       
+      moveLCDTo(10,1);
+      printLCDNumber(limitMagnitude(newReference,32766));
+    }
   }
 }
 
-
+int limitMagnitude(long a, unsigned int mag) 
+{
+  return (int)fixClamp(a, mag);
+}
@@ -0,0 +1,222 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    profile.c                                      *
+*          Motion profiles for the position loop          *
+*---------------------------------------------------------*
+* The trapezoid is worked out afresh every sample from    *
+* its speed and the distance left, so a new target can    *
+* come at any time. Each sample it takes the fastest of   *
+* speeding up, holding and slowing down that can still    *
+* stop in the distance left. Speeds are Q16 counts per    *
+* sample, and the last step is cut to land on the target  *
+* exactly.                                                *
+*                                                         *
+* The S-curve keeps the last 'window' trapezoid speeds    *
+* and moves by their sum / window. The division is kept   *
+* exact by carrying the remainder, so both curves cover   *
+* the same distance.                                      *
+**********************************************************/
+
+#include "fixmath.h"
+#include "profile.h"
+
+// Limits that keep the braking distance inside a long
+#define MAX_STEP_DISTANCE   32767L          // counts, larger distances are worked out as this
+#define MAX_BRAKE_PRODUCT   0x20000000L     // limitV * samples to rest
+
+static long limitV = 0, limitA = 0;         // Q16 counts per sample, per sample squared; 0 for no profile
+static unsigned char window = 1;
+
+static long profileTarget = 0;
+static long rampPosition = 0;               // trapezoid: counts + Q16 fraction
+static unsigned int rampFraction = 0;
+static long rampVelocity = 0;
+
+static long history[PROFILE_WINDOW_MAX];    // the last 'window' values of rampVelocity
+static unsigned char head = 0;
+static long historySum = 0;
+static long outPosition = 0;                // S-curve: counts + outFraction / (window << 16)
+static long outFraction = 0;
+
+/************************************************
+*   perSample                                   *
+*                                               *
+*   Desc.: Converts a rate per second to Q16    *
+*          per sample without overflow          *
+*   Inputs:  x - Per second, 0 or more          *
+*            rateHz - Samples per second        *
+*   Outputs: x * 65536 / rateHz                 *
+************************************************/
+
+static long perSample(long x, unsigned int rateHz){
+    long whole = x / rateHz;
+
+    if (whole > 0x7FFF)
+        return FIX_MAX;
+    return (whole << 16) + ((x % rateHz) << 16) / rateHz;
+}
+
+/************************************************
+*   brakeDistance                               *
+*                                               *
+*   Desc.: Distance covered while slowing from  *
+*          a speed to rest at limitA per        *
+*          sample: v - A, v - 2A... down to 0   *
+*   Inputs:  v - Q16 counts per sample, 0 to    *
+*            limitV                             *
+*   Outputs: Q16 counts                         *
+************************************************/
+
+static long brakeDistance(long v){
+    int m = fixDiv(v, (int)limitA);         // samples to rest
+
+    return m * v - (fixMul(m, m + 1) >> 1) * (int)limitA;
+}
+
+/************************************************
+*   setProfileLimits                            *
+*                                               *
+*   Desc.: Sets the limits of later moves and   *
+*          stops at the current reference. The  *
+*          speed is lowered if braking from it  *
+*          would not fit in a long.             *
+*   Inputs:  velocity - counts/s, 0 for steps   *
+*            acceleration - counts/s^2          *
+*            jerk - counts/s^3, 0 for none      *
+*            rateHz - Samples per second        *
+*   Outputs: None                               *
+************************************************/
+
+void setProfileLimits(long velocity, long acceleration, long jerk, unsigned int rateHz){
+    long samples;
+
+    resetProfile(outPosition);
+    limitV = 0;
+    window = 1;
+    if (velocity <= 0 || acceleration <= 0)
+        return;
+
+    limitV = perSample(velocity, rateHz);
+    limitA = perSample(acceleration, rateHz) / rateHz;
+    if (limitA < 1)
+        limitA = 1;
+    else if (limitA > 0x7FFF)
+        limitA = 0x7FFF;                    // fixDiv() takes an int
+    while (limitV / limitA >= MAX_BRAKE_PRODUCT / limitV)
+        limitV -= limitV >> 4;
+
+    if (jerk > 0){
+        samples = acceleration / jerk * rateHz + ((acceleration % jerk) * rateHz + jerk - 1) / jerk;
+        if (samples < 1)
+            samples = 1;
+        else if (samples > PROFILE_WINDOW_MAX)
+            samples = PROFILE_WINDOW_MAX;
+        window = (unsigned char)samples;
+    }
+}
+
+/************************************************
+*   resetProfile                                *
+*                                               *
+*   Desc.: Puts the reference at rest on a      *
+*          position, with no move pending       *
+*   Inputs:  position - Counts                  *
+*   Outputs: None                               *
+************************************************/
+
+void resetProfile(long position){
+    unsigned char n;
+
+    profileTarget = position;
+    rampPosition = position;
+    rampFraction = 0;
+    rampVelocity = 0;
+    for (n = 0; n < PROFILE_WINDOW_MAX; n++)
+        history[n] = 0;
+    head = 0;
+    historySum = 0;
+    outPosition = position;
+    outFraction = 0;
+}
+
+// Starts a move from wherever the reference is, at the speed it has
+void setProfileTarget(long target){
+    if (limitV)
+        profileTarget = target;
+    else
+        resetProfile(target);
+}
+
+// Whether the reference is still on its way to the target
+int isProfileMoving(void){
+    return rampVelocity != 0 || historySum != 0 || rampPosition != profileTarget || outFraction != 0;
+}
+
+/************************************************
+*   stepProfile                                 *
+*                                               *
+*   Desc.: Moves the reference one sample on    *
+*   Inputs:  None                               *
+*   Outputs: The reference, in counts           *
+************************************************/
+
+long stepProfile(void){
+    long left, distance, speed, up, down, next, span, whole;
+    unsigned char forward;
+
+    if (!limitV)
+        return profileTarget;
+
+    // Distance to the target, positive in the direction of travel
+    left = fixClamp(profileTarget - rampPosition, MAX_STEP_DISTANCE);
+    left = left < 0 ? -(-left << 16) - rampFraction : (left << 16) - rampFraction;
+    forward = left > 0 || (left == 0 && rampVelocity > 0);
+    if (forward){
+        distance = left;
+        speed = rampVelocity;
+    }
+    else{
+        distance = -left;
+        speed = -rampVelocity;
+    }
+
+    if (speed < 0)
+        next = speed + limitA;              // heading away: slow down first
+    else{
+        up = speed + limitA;
+        if (up > limitV)
+            up = limitV;
+        down = speed > limitA ? speed - limitA : 0;
+        if (up + brakeDistance(up) <= distance)
+            next = up;
+        else if (speed <= limitV && speed + brakeDistance(speed) <= distance)
+            next = speed;
+        else
+            next = down;
+        if (next == 0)
+            next = distance;                // less than limitA to go: land on it
+    }
+    rampVelocity = forward ? next : -next;
+
+    left = (long)rampFraction + rampVelocity;
+    rampPosition += left >> 16;
+    rampFraction = (unsigned int)(left & 0xFFFF);
+
+    // S-curve: average the trapezoid's speed over the window
+    historySum += rampVelocity - history[head];
+    history[head] = rampVelocity;
+    if (++head >= window)
+        head = 0;
+    // One division whatever the speed; it rounds towards zero, so a negative remainder borrows a count
+    span = (long)window << 16;
+    outFraction += historySum;
+    whole = outFraction / span;
+    outFraction -= whole * span;
+    if (outFraction < 0){
+        outFraction += span;
+        whole--;
+    }
+    outPosition += whole;
+    return outPosition;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    profile.h                                      *
+*          Motion profiles for the position loop          *
+*---------------------------------------------------------*
+* Turns a change of target into a reference that moves    *
+* one control sample at a time, within a speed, an        *
+* acceleration and a jerk limit. stepProfile() is called  *
+* once per sample from Control_ISR; the rest only from    *
+* main with the channel 6 interrupt held off.             *
+*                                                         *
+* Without a jerk limit the reference follows a trapezoid  *
+* of speed. With one, the trapezoid's speed is averaged   *
+* over acceleration / jerk samples, which rounds its      *
+* corners into an S-curve: the move takes that many       *
+* samples longer and ends on the same count.              *
+**********************************************************/
+
+#ifndef _PROFILE_H
+#define _PROFILE_H
+
+// Longest jerk filter, in samples. A jerk limit below acceleration / PROFILE_WINDOW_MAX samples is not met.
+#define PROFILE_WINDOW_MAX  64
+
+// Function prototypes - tell the compiler that these functions exist somewhere
+void setProfileLimits(long velocity, long acceleration, long jerk, unsigned int rateHz);
+void resetProfile(long position);
+void setProfileTarget(long target);
+long stepProfile(void);
+int isProfileMoving(void);
+
+#endif
\ No newline at end of file
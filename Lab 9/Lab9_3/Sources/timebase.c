@@ -0,0 +1,210 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    timebase.c                                     *
+*          Monotonic time and delays from TCNT            *
+*---------------------------------------------------------*
+* Delays are often needed before interrupts are enabled,  *
+* e.g. while the LCD starts up. getTimebaseTicks() then   *
+* counts a pending overflow itself, so time keeps going   *
+* as long as it is read at least once per TCNT wrap.      *
+**********************************************************/
+
+#include "derivative.h"
+#include "timebase.h"
+
+static volatile unsigned int timebaseHigh = 0;      // TCNT overflows, written with TOI masked
+static unsigned char timebaseRunning = 0;
+static unsigned char timebasePrescale = TIMEBASE_TIMER_PRESCALE;
+static void (*overflowListener[TIMEBASE_MAX_LISTENERS])(void);
+static unsigned char listenerCount = 0;
+
+/************************************************
+*   initializeTimebase                          *
+*                                               *
+*   Desc.: Starts TCNT and the overflow count.  *
+*          Later calls do nothing, so every     *
+*          driver that waits can call it.       *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void initializeTimebase(void){
+    if (timebaseRunning)
+        return;
+    TSCR1_TEN = 1;
+    TSCR2 = (TSCR2 & ~0x07) | timebasePrescale;
+    TFLG2 = TFLG2_TOF_MASK;
+    timebaseHigh = 0;
+    timebaseRunning = 1;
+    TSCR2_TOI = 1;
+}
+
+/************************************************
+*   addTimebaseListener                         *
+*                                               *
+*   Desc.: Adds a function for Timebase_ISR to  *
+*          call on every TCNT overflow, for     *
+*          drivers that need the overflow too.  *
+*          There is one vector for it, and      *
+*          this module owns it.                 *
+*   Inputs:  listener - Called from the         *
+*            interrupt, with the flag cleared   *
+*   Outputs: 1 if added, 0 if the table is full *
+************************************************/
+
+int addTimebaseListener(void (*listener)(void)){
+    if (listenerCount >= TIMEBASE_MAX_LISTENERS)
+        return 0;
+    overflowListener[listenerCount++] = listener;
+    return 1;
+}
+
+/************************************************
+*   setTimebaseBusClock                         *
+*                                               *
+*   Desc.: Sets the prescaler for a new bus     *
+*          clock so that TCNT, and every timer  *
+*          user with it, stays at               *
+*          TIMEBASE_TIMER_HZ. A bus that is not *
+*          that times a power of two gets the   *
+*          next slower rate, and time runs      *
+*          slow. Register it with               *
+*          addClockListener().                  *
+*   Inputs:  busHz - The new bus clock          *
+*   Outputs: None                               *
+************************************************/
+
+void setTimebaseBusClock(unsigned long busHz){
+    unsigned char prescale = 0;
+
+    while (prescale < 7 && (busHz >> prescale) > TIMEBASE_TIMER_HZ)
+        prescale++;
+    timebasePrescale = prescale;
+    if (timebaseRunning)
+        TSCR2 = (TSCR2 & ~0x07) | prescale;
+}
+
+/************************************************
+*   getTimebaseTicks                            *
+*                                               *
+*   Desc.: Reads the 32-bit tick count. The     *
+*          overflow interrupt is held off while *
+*          TCNT and the high word are read, and *
+*          an overflow it has not taken yet is  *
+*          counted here.                        *
+*   Inputs:  None                               *
+*   Outputs: Ticks since initializeTimebase()   *
+************************************************/
+
+unsigned long getTimebaseTicks(void){
+    unsigned int high, low;
+    unsigned char enabled = TSCR2_TOI;
+
+    TSCR2_TOI = 0;
+    low = TCNT;
+    if (TFLG2_TOF){
+        TFLG2 = TFLG2_TOF_MASK;
+        timebaseHigh++;
+        low = TCNT;                     // the wrap may have come after the first read
+    }
+    high = timebaseHigh;
+    TSCR2_TOI = enabled;
+    return ((unsigned long)high << 16) | low;
+}
+
+/************************************************
+*   getMicros                                   *
+*                                               *
+*   Desc.: Microseconds since                   *
+*          initializeTimebase()                 *
+*   Inputs:  None                               *
+*   Outputs: Time in microseconds               *
+************************************************/
+
+unsigned long getMicros(void){
+    return getTimebaseTicks() / TIMEBASE_TICKS_PER_US;
+}
+
+/************************************************
+*   getDeadline                                 *
+*                                               *
+*   Desc.: Makes a deadline us microseconds     *
+*          from now                             *
+*   Inputs:  us - Up to half the tick range     *
+*   Outputs: Deadline for delayUntil() and      *
+*            isDeadlinePassed()                 *
+************************************************/
+
+unsigned long getDeadline(unsigned long us){
+    return getTimebaseTicks() + us * TIMEBASE_TICKS_PER_US;
+}
+
+/************************************************
+*   isDeadlinePassed                            *
+*                                               *
+*   Desc.: Tells whether a deadline has come.   *
+*          The difference is taken as signed,   *
+*          so it stays right across a wrap.     *
+*   Inputs:  deadline                           *
+*   Outputs: 1 once the deadline is reached     *
+************************************************/
+
+unsigned char isDeadlinePassed(unsigned long deadline){
+    return (long)(getTimebaseTicks() - deadline) >= 0;
+}
+
+/************************************************
+*   delayUntil                                  *
+*                                               *
+*   Desc.: Waits for a deadline. Interrupts are *
+*          still taken meanwhile.               *
+*   Inputs:  deadline                           *
+*   Outputs: None                               *
+************************************************/
+
+void delayUntil(unsigned long deadline){
+    while (!isDeadlinePassed(deadline));
+}
+
+/************************************************
+*   delayMicros                                 *
+*                                               *
+*   Desc.: Waits at least us microseconds       *
+*   Inputs:  us                                 *
+*   Outputs: None                               *
+************************************************/
+
+void delayMicros(unsigned int us){
+    delayUntil(getDeadline(us));
+}
+
+/************************************************
+*   delayMillis                                 *
+*                                               *
+*   Desc.: Waits at least ms milliseconds       *
+*   Inputs:  ms                                 *
+*   Outputs: None                               *
+************************************************/
+
+void delayMillis(unsigned int ms){
+    delayUntil(getDeadline(ms * 1000UL));
+}
+
+/************************************************
+*   Timebase_ISR                                *
+*                                               *
+*   Desc.: TCNT overflow, every 65536 ticks.    *
+*          Passes it on to the listeners.       *
+*   Inputs:  None                               *
+*   Outputs: None                               *
+************************************************/
+
+void interrupt VectorNumber_Vtimovf Timebase_ISR(void){
+    unsigned char n;
+
+    TFLG2 = TFLG2_TOF_MASK;
+    timebaseHigh++;
+    for (n = 0; n < listenerCount; n++)
+        overflowListener[n]();
+}
\ No newline at end of file
@@ -0,0 +1,723 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    dpbench.c                                      *
+*          Cycle cost of the banked data helpers in       *
+*          datapage.c, run on the sim12 CPU core          *
+*---------------------------------------------------------*
+* Usage: dpbench [options] datapage.c                     *
+*   -c           print the results as CSV                 *
+*   -r file.csv  compare against an earlier CSV and fail  *
+*                if any case got slower                   *
+*   -e count     random copies checked per copy helper    *
+*   -l           list the assembled helpers               *
+*                                                         *
+* The inline asm of each helper is taken from datapage.c  *
+* as the compiler would for the MC9S12DG256 (PPAGE only,  *
+* so USE_SEVERAL_PAGES is 0) and assembled into fixed     *
+* flash. Each case calls one helper from RAM and counts   *
+* the bus cycles from its JSR to its return, with the     *
+* arguments already in place. The result is checked       *
+* against the helper's contract, including PPAGE and SP.  *
+**********************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include "../sim12/cpu12.h"
+#include "../lib/asm12.h"
+
+#define MAX_HELPERS     32
+#define MAX_LINES       128
+#define MAX_CASES       128
+#define MAX_DEPTH       16
+
+#define HELPER_ORIGIN   0xC000          // fixed flash: the helpers write PPAGE, so they cannot be banked
+#define STUB_ADDR       0x2000          // caller in RAM
+#define STACK_TOP       0x3F80
+#define RAM_DATA        0x1800          // destination of stores and copies
+#define DATA_PAGE       0x34            // source page of loads and copies
+#define OTHER_PAGE      0x30            // PPAGE at the call when it is not DATA_PAGE
+#define DATA_OFFSET     0x9000
+#define MAX_STEPS       200000
+#define DEFAULT_COPIES  1000            // random copies per copy helper
+
+// Where the bytes of a case lie
+#define SAME_PAGE       0               // PPAGE already holds the data page at the call
+#define OTHER           1               // PPAGE holds another page
+#define WINDOW_END      2               // the access runs past 0xBFFF
+
+typedef struct helper
+{
+	char name[ASM12_NAME_LEN];
+	char *lines[MAX_LINES];
+	int lineNumbers[MAX_LINES];         // in datapage.c, for error messages
+	int lineCount;
+	unsigned int addr, size;
+} helper_t;
+
+typedef struct result
+{
+	char helper[ASM12_NAME_LEN];
+	char name[32];
+	int bytes;
+	unsigned long cycles;
+	int ok;
+} result_t;
+
+static helper_t helpers[MAX_HELPERS];
+static int helperCount;
+static unsigned char image[0x10000];
+static cpu12_t cpu;
+static result_t results[MAX_CASES];
+static int resultCount;
+
+static const char *caseNames[] = {"same page", "other page", "window end"};
+
+/************************************************
+*   readHelpers                                 *
+*                                               *
+*   Desc.: Collects the asm block of every      *
+*          function in datapage.c. Only the     *
+*          conditionals that choose the code    *
+*          are evaluated: USE_SEVERAL_PAGES is  *
+*          0 and __HCS12X__ is not defined.     *
+*          The others take both branches, and   *
+*          asm found under one is an error.     *
+*   Outputs: 0, or -1 on error                  *
+************************************************/
+
+static int readHelpers(const char *path)
+{
+	struct { int active, known; } stack[MAX_DEPTH];
+	char line[256], *p, *q;
+	int depth = 0, inAsm = 0, lineNumber = 0, active = 1, known = 1;
+	helper_t *h = NULL;
+	FILE *f = fopen(path, "r");
+
+	if (!f)
+	{
+		fprintf(stderr, "%s: cannot open\n", path);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f))
+	{
+		lineNumber++;
+		line[strcspn(line, "\r\n")] = '\0';
+		for (p = line; isspace((unsigned char)*p); p++)
+			;
+
+		if (*p == '#')
+		{
+			int isIf = strncmp(p, "#if", 3) == 0, value = -1;
+
+			if (isIf)
+			{
+				if (strncmp(p, "#if USE_SEVERAL_PAGES", 21) == 0)
+					value = 0;
+				else if (strncmp(p, "#ifndef __HCS12X__", 18) == 0)
+					value = 1;
+				if (depth == MAX_DEPTH)
+					break;
+				stack[depth].active = active;
+				stack[depth].known = known;
+				depth++;
+				known = known && value >= 0;
+				active = active && value != 0;
+			}
+			else if (strncmp(p, "#else", 5) == 0 || strncmp(p, "#elif", 5) == 0)
+			{
+				if (depth == 0)
+					break;
+				// A known condition flips; an unknown one keeps taking lines
+				if (known && stack[depth - 1].known)
+					active = stack[depth - 1].active && !active;
+			}
+			else if (strncmp(p, "#endif", 6) == 0)
+			{
+				if (depth == 0)
+					break;
+				depth--;
+				active = stack[depth].active;
+				known = stack[depth].known;
+			}
+			continue;
+		}
+		if (!active)
+			continue;
+
+		if (!inAsm)
+		{
+			if ((q = strstr(p, "void NEAR ")) != NULL && strstr(p, "(void)"))
+			{
+				if (helperCount == MAX_HELPERS)
+					break;
+				h = &helpers[helperCount++];
+				sscanf(q + 10, "%31[A-Za-z0-9_]", h->name);
+			}
+			else if (strncmp(p, "asm", 3) == 0 && strchr(p, '{'))
+			{
+				if (!h || !known)
+				{
+					fprintf(stderr, "%s:%d: asm outside a function or under an unknown #if\n", path, lineNumber);
+					fclose(f);
+					return -1;
+				}
+				inAsm = 1;
+			}
+			continue;
+		}
+
+		if (*p == '}')
+		{
+			inAsm = 0;
+			continue;
+		}
+		if ((q = strstr(p, "/*")) != NULL)
+			*q = '\0';
+		if ((q = strstr(p, "__PIC_JSR(")) != NULL)
+		{
+			// Only position independent code jumps differently
+			memcpy(q, "JSR      ", 10);
+			if ((q = strchr(q, ')')) != NULL)
+				*q = ' ';
+		}
+		if (strncmp(p, "_SRET", 5) == 0)
+			continue;                   // debug information only
+		if (h->lineCount == MAX_LINES)
+		{
+			fprintf(stderr, "%s: %s is too long\n", path, h->name);
+			fclose(f);
+			return -1;
+		}
+		h->lineNumbers[h->lineCount] = lineNumber;
+		h->lines[h->lineCount++] = strdup(p);
+	}
+	fclose(f);
+	if (depth != 0 || inAsm)
+	{
+		fprintf(stderr, "%s:%d: unbalanced #if or asm block\n", path, lineNumber);
+		return -1;
+	}
+	return 0;
+}
+
+static int assembleHelpers(const char *path)
+{
+	asm12_t as;
+	int pass, i, j;
+
+	asm12_init(&as, image);
+	as.file = path;
+	asm12_define(&as, "PAGE_ADDR", CPU12_PPAGE_ADDR);
+	for (pass = 1; pass <= 2; pass++)
+	{
+		asm12_pass(&as, pass, HELPER_ORIGIN);
+		for (i = 0; i < helperCount; i++)
+		{
+			helpers[i].addr = as.pc;
+			asm12_scope(&as, helpers[i].name);
+			for (j = 0; j < helpers[i].lineCount; j++)
+			{
+				as.line = helpers[i].lineNumbers[j] - 1;
+				asm12_line(&as, helpers[i].lines[j]);
+			}
+			helpers[i].size = as.pc - helpers[i].addr;
+		}
+	}
+	return as.errors ? -1 : 0;
+}
+
+static const helper_t *findHelper(const char *name)
+{
+	int i;
+
+	for (i = 0; i < helperCount; i++)
+		if (strcmp(helpers[i].name, name) == 0)
+			return &helpers[i];
+	return NULL;
+}
+
+// Recognisable contents for every paged flash byte
+static unsigned char pattern(unsigned int page, unsigned int offset)
+{
+	return (unsigned char)(page * 37 + offset * 7 + (offset >> 8) * 3 + 1);
+}
+
+// A fresh board: helpers in fixed flash, patterned pages, cleared RAM
+static void resetBoard(unsigned char ppage)
+{
+	unsigned int page, offset;
+
+	cpu12_init(&cpu);
+	for (page = 0; page < CPU12_PAGE_COUNT - 2; page++)
+		for (offset = 0; offset < CPU12_PAGE_SIZE; offset++)
+			cpu.flash[page][offset] = pattern(CPU12_PAGE_FIRST + page, offset);
+	for (offset = HELPER_ORIGIN; offset <= 0xFFFF; offset++)
+		cpu12_load(&cpu, offset, image[offset]);
+	cpu.mem[CPU12_PPAGE_ADDR] = ppage;
+	cpu.sp = STACK_TOP;
+	cpu.ccr = CCR_S | CCR_X | CCR_I;
+}
+
+// Byte 'offset' as the CPU sees it with 'page' in PPAGE
+static unsigned char visible(unsigned char page, unsigned int offset)
+{
+	unsigned char saved = cpu.mem[CPU12_PPAGE_ADDR], value;
+
+	cpu.mem[CPU12_PPAGE_ADDR] = page;
+	value = cpu12_read8(&cpu, offset);
+	cpu.mem[CPU12_PPAGE_ADDR] = saved;
+	return value;
+}
+
+static void push8(unsigned char value)
+{
+	cpu.sp = (cpu.sp - 1) & 0xFFFF;
+	cpu.mem[cpu.sp] = value;
+}
+
+static void push16(unsigned int value)
+{
+	push8(value & 0xFF);
+	push8((value >> 8) & 0xFF);
+}
+
+/************************************************
+*   call                                        *
+*                                               *
+*   Desc.: Runs "JSR helper" (and an inline     *
+*          DC.W when 'inlineWord' is not -1)    *
+*          from RAM until the helper returns    *
+*          past it                              *
+*   Outputs: Bus cycles, or 0 if the helper     *
+*            never came back                    *
+************************************************/
+
+static unsigned long call(const helper_t *h, long inlineWord)
+{
+	unsigned int end = STUB_ADDR + 3;
+	long steps;
+
+	cpu.mem[STUB_ADDR] = 0x16;
+	cpu.mem[STUB_ADDR + 1] = (unsigned char)(h->addr >> 8);
+	cpu.mem[STUB_ADDR + 2] = (unsigned char)h->addr;
+	if (inlineWord >= 0)
+	{
+		cpu.mem[end++] = (unsigned char)(inlineWord >> 8);
+		cpu.mem[end++] = (unsigned char)inlineWord;
+	}
+	cpu.pc = STUB_ADDR;
+	cpu.cycles = 0;
+	for (steps = 0; steps < MAX_STEPS && cpu.pc != end; steps++)
+		if (cpu12_step(&cpu) != CPU12_OK)
+			return 0;
+	return cpu.pc == end ? (unsigned long)cpu.cycles : 0;
+}
+
+static void record(const char *helper, const char *name, int bytes, unsigned long cycles, int ok)
+{
+	result_t *r;
+
+	if (resultCount == MAX_CASES)
+		return;
+	r = &results[resultCount++];
+	snprintf(r->helper, sizeof(r->helper), "%s", helper);
+	snprintf(r->name, sizeof(r->name), "%s", name);
+	r->bytes = bytes;
+	r->cycles = cycles;
+	r->ok = ok && cycles != 0;
+}
+
+static void benchSetPage(void)
+{
+	const helper_t *h = findHelper("_SET_PAGE");
+	unsigned long cycles;
+
+	if (!h)
+		return;
+	resetBoard(OTHER_PAGE);
+	cpu.b = DATA_PAGE;
+	cpu.y = DATA_OFFSET;
+	cycles = call(h, -1);
+	record(h->name, "", 0, cycles, cpu.mem[CPU12_PPAGE_ADDR] == DATA_PAGE && cpu.sp == STACK_TOP && cpu.y == DATA_OFFSET);
+}
+
+/************************************************
+*   benchLoad                                   *
+*                                               *
+*   Desc.: _LOAD_FAR_8/16/24/32: page in B,     *
+*          offset in Y; the value comes back    *
+*          in B, Y, Y:B or Y:D. Every register  *
+*          not holding the result is kept.      *
+************************************************/
+
+static void benchLoad(int bytes, int where)
+{
+	char name[16];
+	const helper_t *h;
+	unsigned int offset = where == WINDOW_END ? CPU12_WINDOW_END - bytes / 2 - 1 : DATA_OFFSET;
+	unsigned long cycles, expected = 0, got;
+	unsigned char ppage = where == SAME_PAGE ? DATA_PAGE : OTHER_PAGE;
+	int i, ok;
+
+	snprintf(name, sizeof(name), "_LOAD_FAR_%d", bytes * 8);
+	h = findHelper(name);
+	if (!h || (where == WINDOW_END && bytes == 1))
+		return;
+	resetBoard(ppage);
+	for (i = 0; i < bytes; i++)
+		expected = (expected << 8) | visible(DATA_PAGE, offset + i);
+	cpu.a = 0x5A;
+	cpu.b = DATA_PAGE;
+	cpu.x = 0x1234;
+	cpu.y = offset;
+	cycles = call(h, -1);
+
+	ok = cpu.mem[CPU12_PPAGE_ADDR] == ppage && cpu.sp == STACK_TOP && cpu.x == 0x1234;
+	switch (bytes)
+	{
+		case 1: got = cpu.b; ok = ok && cpu.a == 0x5A && cpu.y == offset; break;
+		case 2: got = cpu.y; ok = ok && cpu.a == 0x5A; break;
+		case 3: got = ((unsigned long)cpu.b << 16) | cpu.y; ok = ok && cpu.a == 0x5A; break;
+		default: got = ((unsigned long)cpu.y << 16) | cpu12_d(&cpu); break;
+	}
+	record(name, caseNames[where], bytes, cycles, ok && got == expected);
+}
+
+/************************************************
+*   benchStore                                  *
+*                                               *
+*   Desc.: _STORE_FAR_8/16/24/32: page in B     *
+*          (on the stack for 32 bits, popped by *
+*          the helper), offset in Y, value in   *
+*          A, X, A:X or X:D. The target is RAM  *
+*          so the stored bytes can be checked;  *
+*          the helper sets PPAGE all the same.  *
+************************************************/
+
+static void benchStore(int bytes, int where)
+{
+	static const unsigned char value[4] = {0xC3, 0x5A, 0x96, 0x3C};
+	char name[16];
+	const helper_t *h;
+	unsigned char ppage = where == SAME_PAGE ? DATA_PAGE : OTHER_PAGE;
+	unsigned long cycles;
+	int i, ok;
+
+	snprintf(name, sizeof(name), "_STORE_FAR_%d", bytes * 8);
+	h = findHelper(name);
+	if (!h || where == WINDOW_END)
+		return;
+	resetBoard(ppage);
+	cpu.y = RAM_DATA;
+	cpu.b = DATA_PAGE;
+	switch (bytes)
+	{
+		case 1: cpu.a = value[0]; break;
+		case 2: cpu.x = (value[0] << 8) | value[1]; cpu.a = 0x11; break;
+		case 3: cpu.a = value[0]; cpu.x = (value[1] << 8) | value[2]; break;
+		default:
+			push8(DATA_PAGE);
+			cpu.x = (value[0] << 8) | value[1];
+			cpu12_set_d(&cpu, (value[2] << 8) | value[3]);
+			break;
+	}
+	cycles = call(h, -1);
+
+	ok = cpu.mem[CPU12_PPAGE_ADDR] == ppage && cpu.sp == STACK_TOP && cpu.y == RAM_DATA;
+	for (i = 0; i < bytes; i++)
+		ok = ok && cpu.mem[RAM_DATA + i] == value[i];
+	ok = ok && cpu.mem[RAM_DATA + bytes] == 0;
+	if (bytes == 4)
+		ok = ok && cpu12_d(&cpu) == (unsigned int)((value[2] << 8) | value[3]);
+	else
+		ok = ok && cpu.b == DATA_PAGE;
+	record(name, caseNames[where], bytes, cycles, ok);
+}
+
+/************************************************
+*   copy                                        *
+*                                               *
+*   Desc.: One call of _FAR_COPY or             *
+*          _FAR_COPY_RC. Source offset and page *
+*          in X and A, destination in Y and B;  *
+*          the length is pushed before the      *
+*          call, or follows the JSR as a DC.W   *
+*          for _FAR_COPY_RC. The result must be *
+*          what the byte loop of the original   *
+*          helper gives: each byte read with    *
+*          the source page and written with the *
+*          destination page. Writes to flash    *
+*          are only counted. The areas must not *
+*          overlap.                             *
+*   Outputs: Bus cycles; '*ok' is cleared if    *
+*            the result differs                 *
+************************************************/
+
+static unsigned long copy(const helper_t *h, unsigned int source, unsigned char sourcePage,
+	unsigned int dest, unsigned char destPage, unsigned char ppage, int bytes, int *ok)
+{
+	static unsigned char expected[0x10000];
+	unsigned long cycles;
+	int rc = strcmp(h->name, "_FAR_COPY_RC") == 0, romWrites = 0, i;
+
+	cpu.mem[CPU12_PPAGE_ADDR] = ppage;
+	cpu.sp = STACK_TOP;
+	cpu.romWriteCount = 0;
+	for (i = 0; i < bytes; i++)
+	{
+		expected[i] = visible(sourcePage, (source + i) & 0xFFFF);
+		if (((dest + i) & 0xFFFF) >= CPU12_RAM_END)
+			romWrites++;
+	}
+	if (!rc)
+		push16((unsigned int)bytes);
+	cpu.x = source;
+	cpu.a = sourcePage;
+	cpu.y = dest;
+	cpu.b = destPage;
+	cycles = call(h, rc ? bytes : -1);
+
+	*ok = cycles != 0 && cpu.mem[CPU12_PPAGE_ADDR] == ppage && cpu.sp == STACK_TOP && cpu.romWriteCount == romWrites;
+	for (i = 0; i < bytes; i++)
+		if (((dest + i) & 0xFFFF) < CPU12_RAM_END && cpu.mem[(dest + i) & 0xFFFF] != expected[i])
+			*ok = 0;
+	return cycles;
+}
+
+// Copies from a flash page into RAM, and one between two flash pages
+static void benchCopy(const char *helperName, int bytes, int where)
+{
+	char name[32];
+	const helper_t *h = findHelper(helperName);
+	unsigned char ppage = where == SAME_PAGE ? DATA_PAGE : OTHER_PAGE;
+	unsigned int source = where == WINDOW_END ? CPU12_WINDOW_END - bytes / 2 : DATA_OFFSET;
+	unsigned long cycles;
+	int ok;
+
+	if (!h || (where == WINDOW_END && bytes < 2))
+		return;
+	resetBoard(ppage);
+	cycles = copy(h, source, DATA_PAGE, RAM_DATA, DATA_PAGE, ppage, bytes, &ok);
+	ok = ok && cpu.mem[RAM_DATA + bytes] == 0;
+	snprintf(name, sizeof(name), "%s %d", caseNames[where], bytes);
+	record(helperName, name, bytes, cycles, ok);
+
+	if (where == OTHER)
+	{
+		resetBoard(ppage);
+		cycles = copy(h, DATA_OFFSET, DATA_PAGE, DATA_OFFSET, DATA_PAGE + 1, ppage, bytes, &ok);
+		snprintf(name, sizeof(name), "page to page %d", bytes);
+		record(helperName, name, bytes, cycles, ok);
+	}
+}
+
+// An offset in RAM, unpaged flash or the page window
+static unsigned int randomOffset(int bytes)
+{
+	static const unsigned int start[3] = {CPU12_RAM_START, 0x4000, CPU12_WINDOW_START};
+
+	return start[rand() % 3] + (unsigned int)(rand() % (0x4000 - bytes));
+}
+
+/************************************************
+*   equivalence                                 *
+*                                               *
+*   Desc.: Copies 'count' random blocks of 1 to *
+*          300 bytes between RAM, unpaged flash *
+*          and random pages, and checks each    *
+*          against the byte loop               *
+*   Outputs: Number of copies that differed     *
+************************************************/
+
+static int equivalence(const char *helperName, int count)
+{
+	const helper_t *h = findHelper(helperName);
+	unsigned int source, dest, i;
+	int bytes, ok, failed = 0, n;
+
+	if (!h)
+		return 0;
+	resetBoard(OTHER_PAGE);
+	for (i = CPU12_RAM_START; i < STUB_ADDR; i++)
+		cpu.mem[i] = pattern(0, i);
+	for (n = 0; n < count; n++)
+	{
+		bytes = 1 + rand() % 300;
+		// Sources and destinations in RAM are kept apart, below and above the stub
+		source = randomOffset(bytes);
+		if (source < CPU12_RAM_END)
+			source = CPU12_RAM_START + (source - CPU12_RAM_START) % (STUB_ADDR - CPU12_RAM_START - bytes);
+		dest = randomOffset(bytes);
+		if (dest < CPU12_RAM_END)
+			dest = STUB_ADDR + 0x100 + (dest - CPU12_RAM_START) % (STACK_TOP - 0x100 - STUB_ADDR - 0x100 - bytes);
+		copy(h, source, (unsigned char)(CPU12_PAGE_FIRST + rand() % 14), dest,
+			(unsigned char)(CPU12_PAGE_FIRST + rand() % 14), (unsigned char)(CPU12_PAGE_FIRST + rand() % 14), bytes, &ok);
+		if (!ok)
+		{
+			fprintf(stderr, "%s: %d bytes from %04X to %04X differ\n", helperName, bytes, source, dest);
+			failed++;
+		}
+	}
+	return failed;
+}
+
+static void listHelpers(void)
+{
+	cpu12_insn_t insn;
+	unsigned int addr;
+	int i;
+
+	resetBoard(OTHER_PAGE);
+	for (i = 0; i < helperCount; i++)
+	{
+		printf("%s: %u bytes at %04X\n", helpers[i].name, helpers[i].size, helpers[i].addr);
+		for (addr = helpers[i].addr; addr < helpers[i].addr + helpers[i].size; )
+		{
+			int length = cpu12_decode(&cpu, addr, &insn);
+			printf("    %04X  %-28s %2d cycles\n", addr, insn.text, insn.cycles);
+			addr += length > 0 ? (unsigned int)length : 1;
+		}
+	}
+	printf("\n");
+}
+
+static const result_t *findResult(const char *helper, const char *name)
+{
+	int i;
+
+	for (i = 0; i < resultCount; i++)
+		if (strcmp(results[i].helper, helper) == 0 && strcmp(results[i].name, name) == 0)
+			return &results[i];
+	return NULL;
+}
+
+/************************************************
+*   compare                                     *
+*                                               *
+*   Desc.: Reads a CSV written by 'dpbench -c'  *
+*          and reports every case whose cycle   *
+*          count changed                        *
+*   Outputs: Number of cases that got slower or *
+*            stopped passing, -1 on error       *
+************************************************/
+
+static int compare(const char *path)
+{
+	char line[256], helper[ASM12_NAME_LEN], name[32], check[8];
+	unsigned long cycles;
+	int bytes, worse = 0, lineNumber = 0;
+	double perByte;
+	const result_t *r;
+	FILE *f = fopen(path, "r");
+
+	if (!f)
+	{
+		fprintf(stderr, "%s: cannot open\n", path);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f))
+	{
+		if (++lineNumber == 1)
+			continue;                   // header
+		name[0] = '\0';
+		if (sscanf(line, "%31[^,],%31[^,],%d,%lu,%lf,%7s", helper, name, &bytes, &cycles, &perByte, check) != 6 &&
+			sscanf(line, "%31[^,],,%d,%lu,%lf,%7s", helper, &bytes, &cycles, &perByte, check) != 5)
+		{
+			fprintf(stderr, "%s:%d: not a dpbench result\n", path, lineNumber);
+			fclose(f);
+			return -1;
+		}
+		r = findResult(helper, name);
+		if (!r)
+			continue;
+		if (r->cycles > cycles || (!r->ok && strcmp(check, "ok") == 0))
+		{
+			fprintf(stderr, "%s %s: %lu cycles, was %lu%s\n", helper, name, r->cycles, cycles, r->ok ? "" : ", check failed");
+			worse++;
+		}
+		else if (r->cycles < cycles)
+			fprintf(stderr, "%s %s: %lu cycles, was %lu (%.2fx faster)\n", helper, name, r->cycles, cycles,
+				(double)cycles / r->cycles);
+	}
+	fclose(f);
+	return worse;
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "usage: dpbench [-c] [-r reference.csv] [-e count] [-l] datapage.c\n");
+	exit(2);
+}
+
+int main(int argc, char **argv)
+{
+	static const int copySizes[] = {1, 4, 16, 64, 256};
+	const char *referencePath = NULL;
+	int opt, csv = 0, list = 0, failed = 0, bytes, where, i, worse = 0, copies = DEFAULT_COPIES;
+
+	while ((opt = getopt(argc, argv, "cr:e:l")) != -1)
+	{
+		switch (opt)
+		{
+			case 'c': csv = 1; break;
+			case 'r': referencePath = optarg; break;
+			case 'e': copies = atoi(optarg); break;
+			case 'l': list = 1; break;
+			default: usage();
+		}
+	}
+	if (optind != argc - 1)
+		usage();
+
+	if (readHelpers(argv[optind]) < 0 || assembleHelpers(argv[optind]) < 0)
+		return 1;
+	if (list)
+		listHelpers();
+
+	benchSetPage();
+	for (bytes = 1; bytes <= 4; bytes++)
+		for (where = SAME_PAGE; where <= WINDOW_END; where++)
+			benchLoad(bytes, where);
+	for (bytes = 1; bytes <= 4; bytes++)
+		for (where = SAME_PAGE; where <= OTHER; where++)
+			benchStore(bytes, where);
+	for (i = 0; i < (int)(sizeof(copySizes) / sizeof(copySizes[0])); i++)
+		for (where = SAME_PAGE; where <= WINDOW_END; where++)
+			benchCopy("_FAR_COPY", copySizes[i], where);
+	for (i = 0; i < (int)(sizeof(copySizes) / sizeof(copySizes[0])); i++)
+		for (where = SAME_PAGE; where <= WINDOW_END; where++)
+			benchCopy("_FAR_COPY_RC", copySizes[i], where);
+
+	if (csv)
+		printf("helper,case,bytes,cycles,cycles_per_byte,check\n");
+	else
+		printf("%-16s %-16s %6s %8s %12s  %s\n", "Helper", "Case", "Bytes", "Cycles", "Cycles/byte", "Check");
+	for (i = 0; i < resultCount; i++)
+	{
+		const result_t *r = &results[i];
+		double perByte = r->bytes ? (double)r->cycles / r->bytes : 0.0;
+
+		if (csv)
+			printf("%s,%s,%d,%lu,%.2f,%s\n", r->helper, r->name, r->bytes, r->cycles, perByte, r->ok ? "ok" : "FAIL");
+		else
+			printf("%-16s %-16s %6d %8lu %12.2f  %s\n", r->helper, r->name, r->bytes, r->cycles, perByte, r->ok ? "ok" : "FAIL");
+		failed += !r->ok;
+	}
+
+	srand(1);
+	failed += equivalence("_FAR_COPY", copies) + equivalence("_FAR_COPY_RC", copies);
+	if (!csv)
+		printf("\nRandom copies: %d per helper, checked against the byte loop\n", copies);
+
+	if (referencePath)
+	{
+		worse = compare(referencePath);
+		if (worse < 0)
+			return 1;
+	}
+	return failed || worse ? 1 : 0;
+}
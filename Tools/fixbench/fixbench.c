@@ -0,0 +1,633 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    fixbench.c                                     *
+*          Checks the fixmath.c asm against its C         *
+*          reference and counts its cycles on the sim12   *
+*          CPU core                                       *
+*---------------------------------------------------------*
+* Usage: fixbench [options] fixmath.c                     *
+*   -s file.s19  image holding CodeWarrior's runtime      *
+*   -m file.map  its linker map                           *
+*   -n count     random cases per routine (default 20000) *
+*   -c           print the results as CSV                 *
+*   -r file.csv  compare against an earlier CSV and fail  *
+*                if any routine got slower                *
+*   -l           list the assembled routines              *
+*                                                         *
+* Every asm block of fixmath.c is assembled into fixed    *
+* flash. The same file, built for the host, is linked in  *
+* as the reference. Each routine is called with the       *
+* corner cases of its argument types, then with random    *
+* arguments of every size, and its result must match the  *
+* host's bit for bit. With an image, _LMULS16x32, the     *
+* runtime multiply the compiler called before, is timed   *
+* next to them.                                           *
+**********************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include "../sim12/cpu12.h"
+#include "../lib/asm12.h"
+#include "../lib/mapfile.h"
+#include "../lib/s19.h"
+#include "fixmath.h"
+
+#define MAX_ROUTINES    16
+#define MAX_LINES       160
+
+#define ROUTINE_ORIGIN  0xC000
+#define STUB_ADDR       0x2000          // caller in RAM
+#define STACK_TOP       0x3F80
+#define MAX_STEPS       10000
+
+// How a routine takes its arguments and gives its result
+#define KIND_INT_INT    0               // long or int f(int a, int b): a pushed, b in D
+#define KIND_LONG_LONG  1               // long f(long a, long b): a pushed, b in X:D
+#define KIND_LONG_INT   2               // int f(long n, int d): n pushed, d in D
+#define KIND_LONG       3               // int f(long x): x in X:D
+#define KIND_RUNTIME    4               // _LMULS16x32: X:D * Y, low 32 bits in X:D
+
+typedef struct routine
+{
+	char name[ASM12_NAME_LEN];
+	char *lines[MAX_LINES];
+	int lineNumbers[MAX_LINES];
+	int lineCount;
+	unsigned int addr, size;
+} routine_t;
+
+typedef struct check
+{
+	const char *name;
+	int kind;
+	int longResult;
+	long (*reference)(long a, long b);
+	int clampLimit;                     // the second argument must be 0 or more
+} check_t;
+
+typedef struct result
+{
+	char routine[ASM12_NAME_LEN];
+	unsigned long cases, failed;
+	unsigned long minCycles, maxCycles;
+	double meanCycles;
+} result_t;
+
+static long refMul(long a, long b) { return fixMul((int)a, (int)b); }
+static long refMulQ8(long a, long b) { return fixMulQ8((int)a, (int)b); }
+static long refMulQ15(long a, long b) { return fixMulQ15((int)a, (int)b); }
+static long refMulQ16(long a, long b) { return fixMulQ16(a, b); }
+static long refDiv(long a, long b) { return fixDiv(a, (int)b); }
+static long refAdd(long a, long b) { return fixAdd(a, b); }
+static long refSub(long a, long b) { return fixSub(a, b); }
+static long refClamp(long a, long b) { return fixClamp(a, b); }
+static long refToInt(long a, long b) { (void)b; return fixToInt(a); }
+
+static long refRuntime(long a, long b)
+{
+	unsigned long p = ((unsigned long)a * (unsigned long)b) & 0xFFFFFFFFUL;
+
+	return (p & 0x80000000UL) ? (long)p - 0x100000000L : (long)p;
+}
+
+static const check_t checks[] =
+{
+	{"fixMul",      KIND_INT_INT,   1, refMul,     0},
+	{"fixMulQ8",    KIND_INT_INT,   1, refMulQ8,   0},
+	{"fixMulQ15",   KIND_INT_INT,   0, refMulQ15,  0},
+	{"fixMulQ16",   KIND_LONG_LONG, 1, refMulQ16,  0},
+	{"fixDiv",      KIND_LONG_INT,  0, refDiv,     0},
+	{"fixAdd",      KIND_LONG_LONG, 1, refAdd,     0},
+	{"fixSub",      KIND_LONG_LONG, 1, refSub,     0},
+	{"fixClamp",    KIND_LONG_LONG, 1, refClamp,   1},
+	{"fixToInt",    KIND_LONG,      0, refToInt,   0},
+};
+static const check_t runtimeCheck = {"_LMULS16x32", KIND_RUNTIME, 1, refRuntime, 0};
+
+static const long corners16[] = {0, 1, -1, 2, -2, 255, 256, -256, 1000, -1000, 32766, 32767, -32767, -32768};
+static const long corners32[] =
+{
+	0, 1, -1, 0x7FFF, 0x8000, -0x8000, 0xFFFF, 0x10000, -0x10000, 0x12345678L, -0x12345678L,
+	0x7FFFFFFFL, -0x7FFFFFFFL, -0x7FFFFFFFL - 1,
+};
+
+static routine_t routines[MAX_ROUTINES];
+static int routineCount;
+static unsigned char image[0x10000];
+static cpu12_t cpu;
+static result_t results[MAX_ROUTINES + 1];
+static int resultCount;
+
+static unsigned char runtimeImage[0x10000];
+static unsigned long runtimeAddr;
+static int haveRuntime;
+
+static unsigned long seed;
+
+/************************************************
+*   readRoutines                                *
+*                                               *
+*   Desc.: Collects the asm block of every      *
+*          function in fixmath.c. A function is *
+*          a line at the left margin with '('   *
+*          that ends in '{'.                    *
+*   Outputs: 0, or -1 on error                  *
+************************************************/
+
+static int readRoutines(const char *path)
+{
+	char line[256], *p, *q, *name;
+	int lineNumber = 0, inAsm = 0;
+	routine_t *r = NULL;
+	FILE *f = fopen(path, "r");
+
+	if (!f)
+	{
+		fprintf(stderr, "%s: cannot open\n", path);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f))
+	{
+		lineNumber++;
+		line[strcspn(line, "\r\n")] = '\0';
+		for (p = line; isspace((unsigned char)*p); p++)
+			;
+
+		if (p == line && (q = strchr(line, '(')) != NULL && line[strlen(line) - 1] == '{')
+		{
+			for (name = q; name > line && (isalnum((unsigned char)name[-1]) || name[-1] == '_'); name--)
+				;
+			if (routineCount == MAX_ROUTINES)
+			{
+				fprintf(stderr, "%s: too many functions\n", path);
+				fclose(f);
+				return -1;
+			}
+			r = &routines[routineCount];
+			memset(r, 0, sizeof(*r));
+			snprintf(r->name, sizeof(r->name), "%.*s", (int)(q - name), name);
+			continue;
+		}
+		if (!r)
+			continue;
+		if (!inAsm)
+		{
+			if (strncmp(p, "asm", 3) == 0 && strchr(p, '{'))
+				inAsm = 1;
+			else if (p == line && *p == '}')
+				r = NULL;               // a function without asm
+			continue;
+		}
+		if (*p == '}')
+		{
+			inAsm = 0;
+			routineCount++;
+			r = NULL;
+			continue;
+		}
+		if ((q = strstr(p, "//")) != NULL)
+			*q = '\0';
+		if (r->lineCount == MAX_LINES)
+		{
+			fprintf(stderr, "%s: %s is too long\n", path, r->name);
+			fclose(f);
+			return -1;
+		}
+		r->lineNumbers[r->lineCount] = lineNumber;
+		r->lines[r->lineCount++] = strdup(p);
+	}
+	fclose(f);
+	if (routineCount == 0)
+	{
+		fprintf(stderr, "%s: no asm blocks\n", path);
+		return -1;
+	}
+	return 0;
+}
+
+static int assembleRoutines(const char *path)
+{
+	asm12_t as;
+	int pass, i, j;
+
+	asm12_init(&as, image);
+	as.file = path;
+	for (pass = 1; pass <= 2; pass++)
+	{
+		asm12_pass(&as, pass, ROUTINE_ORIGIN);
+		for (i = 0; i < routineCount; i++)
+		{
+			routines[i].addr = as.pc;
+			asm12_scope(&as, routines[i].name);
+			for (j = 0; j < routines[i].lineCount; j++)
+			{
+				as.line = routines[i].lineNumbers[j] - 1;
+				asm12_line(&as, routines[i].lines[j]);
+			}
+			routines[i].size = as.pc - routines[i].addr;
+		}
+	}
+	return as.errors ? -1 : 0;
+}
+
+static void loadRuntime(void *context, unsigned long addr, unsigned char value)
+{
+	(void)context;
+	if (addr < 0x10000)
+		runtimeImage[addr] = value;
+}
+
+// Loads the image and finds _LMULS16x32, which must be in unbanked flash
+static int readRuntime(const char *s19Path, const char *mapPath)
+{
+	map_file_t map;
+	const map_symbol_t *symbol;
+
+	if (s19_load(s19Path, loadRuntime, NULL, NULL) < 0)
+		return -1;
+	if (map_load(mapPath, &map) < 0)
+	{
+		fprintf(stderr, "%s: cannot read\n", mapPath);
+		return -1;
+	}
+	symbol = map_find(&map, "_LMULS16x32");
+	if (!symbol || symbol->addr > 0xFFFF)
+	{
+		fprintf(stderr, "%s: _LMULS16x32 missing or banked\n", mapPath);
+		map_free(&map);
+		return -1;
+	}
+	runtimeAddr = symbol->addr;
+	map_free(&map);
+	haveRuntime = 1;
+	return 0;
+}
+
+static void resetBoard(const unsigned char *from)
+{
+	unsigned int addr;
+
+	cpu12_init(&cpu);
+	for (addr = 0x4000; addr < 0x8000; addr++)
+		cpu12_load(&cpu, addr, from[addr]);
+	for (addr = CPU12_WINDOW_END; addr <= 0xFFFF; addr++)
+		cpu12_load(&cpu, addr, from[addr]);
+	cpu.ccr = CCR_S | CCR_X | CCR_I;
+}
+
+static void push16(unsigned int value)
+{
+	cpu.sp = (cpu.sp - 2) & 0xFFFF;
+	cpu12_write16(&cpu, cpu.sp, value & 0xFFFF);
+}
+
+// Stacked longs have their high word at the lower address
+static void push32(long value)
+{
+	push16((unsigned int)value);
+	push16((unsigned int)(value >> 16));
+}
+
+static void setLong(long value)
+{
+	cpu.x = (unsigned int)(value >> 16) & 0xFFFF;
+	cpu12_set_d(&cpu, (unsigned int)value & 0xFFFF);
+}
+
+// Runs "JSR addr" from RAM until it returns. Returns the bus cycles, or 0 if it never came back.
+static unsigned long call(unsigned int addr)
+{
+	unsigned int end = STUB_ADDR + 3;
+	long steps;
+
+	cpu.mem[STUB_ADDR] = 0x16;
+	cpu.mem[STUB_ADDR + 1] = (unsigned char)(addr >> 8);
+	cpu.mem[STUB_ADDR + 2] = (unsigned char)addr;
+	cpu.pc = STUB_ADDR;
+	cpu.cycles = 0;
+	for (steps = 0; steps < MAX_STEPS && cpu.pc != end; steps++)
+		if (cpu12_step(&cpu) != CPU12_OK)
+			return 0;
+	return cpu.pc == end ? (unsigned long)cpu.cycles : 0;
+}
+
+static long signExtend(unsigned long value, int bits)
+{
+	unsigned long sign = 1UL << (bits - 1);
+
+	value &= (sign << 1) - 1;
+	return (value & sign) ? (long)value - (long)(sign << 1) : (long)value;
+}
+
+/************************************************
+*   runCase                                     *
+*                                               *
+*   Desc.: One call of a routine, set up the    *
+*          way CodeWarrior calls it             *
+*   Outputs: Bus cycles; '*ok' is set if the    *
+*            result matches the reference and   *
+*            SP came back to the caller's       *
+************************************************/
+
+static unsigned long runCase(const check_t *c, unsigned int addr, long a, long b, int *ok)
+{
+	unsigned int sp;
+	unsigned long cycles;
+	long got, expected = c->reference(a, b);
+
+	cpu.sp = STACK_TOP;
+	switch (c->kind)
+	{
+		case KIND_INT_INT:
+			push16((unsigned int)a);
+			cpu12_set_d(&cpu, (unsigned int)b & 0xFFFF);
+			break;
+		case KIND_LONG_LONG:
+			push32(a);
+			setLong(b);
+			break;
+		case KIND_LONG_INT:
+			push32(a);
+			cpu12_set_d(&cpu, (unsigned int)b & 0xFFFF);
+			break;
+		case KIND_LONG:
+			setLong(a);
+			break;
+		case KIND_RUNTIME:
+			setLong(a);
+			cpu.y = (unsigned int)b & 0xFFFF;
+			break;
+	}
+	sp = cpu.sp;
+	cycles = call(addr);
+
+	if (c->longResult)
+		got = signExtend(((unsigned long)cpu.x << 16) | cpu12_d(&cpu), 32);
+	else
+		got = signExtend(cpu12_d(&cpu), 16);
+	*ok = cycles != 0 && cpu.sp == sp && got == expected;
+	if (!*ok && cycles != 0)
+		fprintf(stderr, "%s(%ld, %ld): %ld, should be %ld%s\n", c->name, a, b, got, expected,
+			cpu.sp == sp ? "" : ", SP moved");
+	else if (!*ok)
+		fprintf(stderr, "%s(%ld, %ld): did not return\n", c->name, a, b);
+	return cycles;
+}
+
+static unsigned long nextRandom(void)
+{
+	seed = seed * 1103515245UL + 12345UL;
+	return (seed >> 16) & 0xFFFF;
+}
+
+// A random value of 1 to 'bits' bits and either sign, the size spread evenly so small values come up as often as large ones
+static long randomValue(int bits)
+{
+	unsigned long v = (nextRandom() << 16) | nextRandom();
+	int size = (int)(nextRandom() % (unsigned long)bits) + 1;
+	long value;
+
+	if (size < 32)
+		v &= (1UL << size) - 1;
+	value = signExtend(v, bits);
+	if (nextRandom() & 1)
+		value = -value;
+	return signExtend((unsigned long)value, bits);
+}
+
+static long fitArgument(long value, int bits, int nonNegative)
+{
+	value = signExtend((unsigned long)value, bits);
+	if (nonNegative && value < 0)
+		value = value == -0x7FFFFFFFL - 1 ? 0x7FFFFFFFL : -value;
+	return value;
+}
+
+/************************************************
+*   benchRoutine                                *
+*                                               *
+*   Desc.: Every pair of corner cases, then     *
+*          'count' random pairs                 *
+*   Outputs: None, adds a result                *
+************************************************/
+
+static void benchRoutine(const check_t *c, unsigned int addr, const unsigned char *from, long count)
+{
+	int bitsA = c->kind == KIND_INT_INT ? 16 : 32;
+	int bitsB = c->kind == KIND_LONG_LONG ? 32 : 16;
+	const long *cornersA = bitsA == 16 ? corners16 : corners32;
+	const long *cornersB = bitsB == 16 ? corners16 : corners32;
+	int countA = bitsA == 16 ? (int)(sizeof(corners16) / sizeof(corners16[0])) : (int)(sizeof(corners32) / sizeof(corners32[0]));
+	int countB = bitsB == 16 ? (int)(sizeof(corners16) / sizeof(corners16[0])) : (int)(sizeof(corners32) / sizeof(corners32[0]));
+	result_t *r = &results[resultCount++];
+	unsigned long cycles, total = 0;
+	long n, a, b;
+	int i, j, ok;
+
+	if (c->kind == KIND_LONG)
+		countB = 1;
+	if (c->kind == KIND_RUNTIME)
+	{
+		bitsA = 32;
+		cornersA = corners32;
+		countA = (int)(sizeof(corners32) / sizeof(corners32[0]));
+	}
+	memset(r, 0, sizeof(*r));
+	snprintf(r->routine, sizeof(r->routine), "%s", c->name);
+	r->minCycles = ~0UL;
+	seed = 12345;                       // the same cases whichever routines run
+	resetBoard(from);
+	for (n = 0; n < (long)countA * countB + count; n++)
+	{
+		if (n < (long)countA * countB)
+		{
+			i = (int)(n / countB);
+			j = (int)(n % countB);
+			a = cornersA[i];
+			b = cornersB[j];
+		}
+		else
+		{
+			a = randomValue(bitsA);
+			b = randomValue(bitsB);
+		}
+		b = fitArgument(b, bitsB, c->clampLimit);
+		cycles = runCase(c, addr, a, b, &ok);
+		r->cases++;
+		if (!ok)
+		{
+			if (++r->failed >= 10)
+				break;
+			continue;
+		}
+		total += cycles;
+		if (cycles < r->minCycles)
+			r->minCycles = cycles;
+		if (cycles > r->maxCycles)
+			r->maxCycles = cycles;
+	}
+	if (r->cases > r->failed)
+		r->meanCycles = (double)total / (r->cases - r->failed);
+	else
+		r->minCycles = 0;
+}
+
+static void listRoutines(void)
+{
+	cpu12_insn_t insn;
+	unsigned int addr;
+	int i;
+
+	resetBoard(image);
+	for (i = 0; i < routineCount; i++)
+	{
+		printf("%s: %u bytes at %04X\n", routines[i].name, routines[i].size, routines[i].addr);
+		for (addr = routines[i].addr; addr < routines[i].addr + routines[i].size; )
+		{
+			int length = cpu12_decode(&cpu, addr, &insn);
+			printf("    %04X  %-28s %2d cycles\n", addr, insn.text, insn.cycles);
+			addr += length > 0 ? (unsigned int)length : 1;
+		}
+	}
+	printf("\n");
+}
+
+static const result_t *findResult(const char *routine)
+{
+	int i;
+
+	for (i = 0; i < resultCount; i++)
+		if (strcmp(results[i].routine, routine) == 0)
+			return &results[i];
+	return NULL;
+}
+
+/************************************************
+*   compare                                     *
+*                                               *
+*   Desc.: Reads a CSV written by 'fixbench -c' *
+*          and reports every routine whose mean *
+*          or worst case changed                *
+*   Outputs: Number of routines that got slower *
+*            or stopped passing, -1 on error    *
+************************************************/
+
+static int compare(const char *path)
+{
+	char line[256], routine[ASM12_NAME_LEN], check[8];
+	unsigned long cases, minCycles, maxCycles;
+	double meanCycles;
+	int worse = 0, lineNumber = 0;
+	const result_t *r;
+	FILE *f = fopen(path, "r");
+
+	if (!f)
+	{
+		fprintf(stderr, "%s: cannot open\n", path);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f))
+	{
+		if (++lineNumber == 1)
+			continue;                   // header
+		if (sscanf(line, "%31[^,],%lu,%lu,%lf,%lu,%7s", routine, &cases, &minCycles, &meanCycles, &maxCycles, check) != 6)
+		{
+			fprintf(stderr, "%s:%d: not a fixbench result\n", path, lineNumber);
+			fclose(f);
+			return -1;
+		}
+		r = findResult(routine);
+		if (!r)
+			continue;
+		if (r->maxCycles > maxCycles || r->meanCycles > meanCycles + 0.05 || (r->failed && strcmp(check, "ok") == 0))
+		{
+			fprintf(stderr, "%s: mean %.1f, worst %lu cycles, was %.1f, %lu%s\n", routine, r->meanCycles, r->maxCycles,
+				meanCycles, maxCycles, r->failed ? ", check failed" : "");
+			worse++;
+		}
+		else if (r->maxCycles < maxCycles || r->meanCycles < meanCycles - 0.05)
+			fprintf(stderr, "%s: mean %.1f, worst %lu cycles, was %.1f, %lu\n", routine, r->meanCycles, r->maxCycles,
+				meanCycles, maxCycles);
+	}
+	fclose(f);
+	return worse;
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "usage: fixbench [-s image.s19 -m image.map] [-n count] [-c] [-r reference.csv] [-l] fixmath.c\n");
+	exit(2);
+}
+
+int main(int argc, char **argv)
+{
+	const char *referencePath = NULL, *s19Path = NULL, *mapPath = NULL;
+	int opt, csv = 0, list = 0, failed = 0, i, j, worse = 0;
+	long count = 20000;
+
+	while ((opt = getopt(argc, argv, "s:m:n:cr:l")) != -1)
+	{
+		switch (opt)
+		{
+			case 's': s19Path = optarg; break;
+			case 'm': mapPath = optarg; break;
+			case 'n': count = atol(optarg); break;
+			case 'c': csv = 1; break;
+			case 'r': referencePath = optarg; break;
+			case 'l': list = 1; break;
+			default: usage();
+		}
+	}
+	if (optind != argc - 1 || !s19Path != !mapPath || count < 0)
+		usage();
+
+	if (readRoutines(argv[optind]) < 0 || assembleRoutines(argv[optind]) < 0)
+		return 1;
+	if (s19Path && readRuntime(s19Path, mapPath) < 0)
+		return 1;
+	if (list)
+		listRoutines();
+
+	if (haveRuntime)
+		benchRoutine(&runtimeCheck, (unsigned int)runtimeAddr, runtimeImage, count);
+	for (i = 0; i < (int)(sizeof(checks) / sizeof(checks[0])); i++)
+	{
+		for (j = 0; j < routineCount && strcmp(routines[j].name, checks[i].name) != 0; j++)
+			;
+		if (j == routineCount)
+		{
+			fprintf(stderr, "%s: no asm block for %s\n", argv[optind], checks[i].name);
+			return 1;
+		}
+		benchRoutine(&checks[i], routines[j].addr, image, count);
+	}
+
+	if (csv)
+		printf("routine,cases,min_cycles,mean_cycles,max_cycles,check\n");
+	else
+		printf("%-12s %7s %6s %7s %6s  %s\n", "Routine", "Cases", "Min", "Mean", "Max", "Check");
+	for (i = 0; i < resultCount; i++)
+	{
+		const result_t *r = &results[i];
+
+		if (csv)
+			printf("%s,%lu,%lu,%.1f,%lu,%s\n", r->routine, r->cases, r->minCycles, r->meanCycles, r->maxCycles,
+				r->failed ? "FAIL" : "ok");
+		else
+			printf("%-12s %7lu %6lu %7.1f %6lu  %s\n", r->routine, r->cases, r->minCycles, r->meanCycles, r->maxCycles,
+				r->failed ? "FAIL" : "ok");
+		failed += r->failed != 0;
+	}
+
+	if (referencePath)
+	{
+		worse = compare(referencePath);
+		if (worse < 0)
+			return 1;
+	}
+	return failed || worse ? 1 : 0;
+}
@@ -0,0 +1,848 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    hal.c                                          *
+*          Peripheral models behind the host register     *
+*          names                                          *
+*---------------------------------------------------------*
+* hal_io() hands the firmware a cell holding the value    *
+* the register reads as, and remembers it. At the next    *
+* access the cell is compared again: if the firmware      *
+* stored something else, that is the write. The models    *
+* follow periph.c in sim12: ECT counter, output compare,  *
+* input capture and overflow, SPI0, CRG lock and bus      *
+* clock, Port P/H edge flags, plus the keypad, LCD and    *
+* motor the labs are wired to. Every other register reads *
+* back what was last written.                             *
+**********************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hal.h"
+
+#define REG_SPACE       0x0400
+
+// Register addresses (see mc9s12dg256.h)
+#define REG_PORTA       0x0000
+#define REG_PORTB       0x0001
+#define REG_DDRA        0x0002
+#define REG_DDRB        0x0003
+#define REG_PORTK       0x0032
+#define REG_DDRK        0x0033
+#define REG_SYNR        0x0034
+#define REG_REFDV       0x0035
+#define REG_CRGFLG      0x0037
+#define REG_CLKSEL      0x0039
+#define REG_PLLCTL      0x003A
+#define REG_TIOS        0x0040
+#define REG_TCNT        0x0044
+#define REG_TSCR1       0x0046
+#define REG_TCTL3       0x004A
+#define REG_TCTL4       0x004B
+#define REG_TIE         0x004C
+#define REG_TSCR2       0x004D
+#define REG_TFLG1       0x004E
+#define REG_TFLG2       0x004F
+#define REG_TC0         0x0050
+#define REG_PWME        0x00A0
+#define REG_PWMPOL      0x00A1
+#define REG_PWMPER0     0x00B4
+#define REG_PWMDTY0     0x00BC
+#define REG_SPI0CR1     0x00D8
+#define REG_SPI0BR      0x00DA
+#define REG_SPI0SR      0x00DB
+#define REG_SPI0DR      0x00DD
+#define REG_PPSP        0x025D
+#define REG_PIEP        0x025E
+#define REG_PIFP        0x025F
+#define REG_PPSH        0x0265
+#define REG_PIEH        0x0266
+#define REG_PIFH        0x0267
+
+#define SPIF            0x80
+#define SPTEF           0x20
+
+#define OPEN_MAX        4       // accesses whose cells are still compared; covers "PORTB = PORTB | PTT"
+#define IDLE_CYCLES     4       // hal_run() step
+#define ENTRY_CYCLES    9       // stacking the registers and fetching the vector
+#define RTI_CYCLES      8
+
+#define MOTOR_PINS      0x0C    // PP2 (A) and PP3 (B)
+
+typedef struct port_regs
+{
+	unsigned int data, input, ddr;
+} port_regs_t;
+
+// Indexed by HAL_PORT_*
+static const port_regs_t portRegs[HAL_PORT_COUNT] =
+{
+	{ 0x0000, 0x0000, 0x0002 },     // A (no separate input register)
+	{ 0x0001, 0x0001, 0x0003 },     // B
+	{ 0x0260, 0x0261, 0x0262 },     // H
+	{ 0x0268, 0x0269, 0x026A },     // J
+	{ 0x0032, 0x0032, 0x0033 },     // K
+	{ 0x0250, 0x0251, 0x0252 },     // M
+	{ 0x0258, 0x0259, 0x025A },     // P
+	{ 0x0248, 0x0249, 0x024A },     // S
+	{ 0x0240, 0x0241, 0x0242 }      // T
+};
+
+// Keypad legends by row line (PA0-PA3) and column line (PA4-PA7), as keypad.c scans them
+static const char keypadKeys[4][5] = { "147*", "2580", "369#", "ABCD" };
+
+// Encoder A/B levels for each count modulo 4; counting up means A leads B
+static const unsigned char motorPhase[4] = { 0x00, 0x04, 0x0C, 0x08 };
+
+typedef struct access
+{
+	unsigned int addr;
+	int kind;
+	unsigned int preset;
+} access_t;
+
+struct hal_board
+{
+	unsigned char mem[REG_SPACE];       // plain registers, and the cells of byte and bit accesses
+	unsigned short wide[REG_SPACE];     // cells of word and data accesses, by address
+	access_t open[OPEN_MAX];
+	int openCount;
+
+	unsigned long long cycles, timePs;
+	unsigned long busHz, busPs;
+	unsigned int accessCycles;
+	int pllOn;
+	long pllLockUs;                     // from PLLON to LOCK, negative for never
+	unsigned long long pllOnPs;
+	int iBit;
+	unsigned long long deadlinePs;
+	hal_yield_t deadlineFn;
+	void *deadlineContext;
+	hal_isr_t vectors[HAL_VECTOR_COUNT];
+	unsigned long interruptCount[HAL_VECTOR_COUNT];
+
+	// Pins
+	unsigned char latch[HAL_PORT_COUNT], pins[HAL_PORT_COUNT], outputs[HAL_PORT_COUNT];
+	hal_watch_t watch[HAL_PORT_COUNT];
+	void *watchContext[HAL_PORT_COUNT];
+	unsigned char pifp, pifh;
+
+	// ECT
+	unsigned int tcnt, prescaleCount;
+	unsigned char tflg1, tflg2;
+
+	// SPI0: one byte in the shifter plus one waiting in the data register
+	unsigned char spiStatus, spiNext, spiRx;
+	int spiShifting, spiPending, spifRead;
+	unsigned long spiRemaining, spiBytes;
+	unsigned char spiShift;
+	hal_spi_t spiWatch;
+	void *spiContext;
+
+	// Keypad: bit c of keys[r] closes row line PAr onto column line PA(4+c)
+	unsigned char keys[4];
+
+	// LCD (HD44780 in 4-bit mode on PK2-PK5, RS on PK0, EN on PK1)
+	char ddram[0x80];
+	char text[HAL_LCD_HEIGHT][HAL_LCD_WIDTH + 1];
+	unsigned char lcdAddr, lcdHigh;
+	int lcdFourBit, lcdHalf, lcdCgram;
+
+	// Motor
+	int motorOn;
+	double motorMax, motorTau, motorSpeed, motorPosition;
+	long motorCount;
+};
+
+static hal_board_t *selected;
+
+static void advance(hal_board_t *b, unsigned long cycles);
+static void dispatch(hal_board_t *b);
+
+static void fail(const char *message, unsigned int value)
+{
+	fprintf(stderr, "hal: ");
+	fprintf(stderr, message, value);
+	fprintf(stderr, "\n");
+	exit(1);
+}
+
+static void busClock(hal_board_t *b)
+{
+	if ((b->mem[REG_CLKSEL] & 0x80) && (b->mem[REG_PLLCTL] & 0x40))
+		b->busHz = HAL_OSC_HZ * ((b->mem[REG_SYNR] & 0x3F) + 1UL) / ((b->mem[REG_REFDV] & 0x0F) + 1UL);
+	else
+		b->busHz = HAL_OSC_HZ / 2;
+	b->busPs = (1000000000000UL + b->busHz / 2) / b->busHz;
+}
+
+static int pllLocked(const hal_board_t *b)
+{
+	if (!b->pllOn || b->pllLockUs < 0)
+		return 0;
+	return b->timePs - b->pllOnPs >= (unsigned long long)b->pllLockUs * 1000000ULL;
+}
+
+/* ---- Pins ---- */
+
+static int portOf(unsigned int addr, int *isDdr)
+{
+	int p;
+
+	for (p = 0; p < HAL_PORT_COUNT; p++)
+	{
+		if (addr == portRegs[p].data || addr == portRegs[p].input)
+		{
+			*isDdr = 0;
+			return p;
+		}
+		if (addr == portRegs[p].ddr)
+		{
+			*isDdr = 1;
+			return p;
+		}
+	}
+	return -1;
+}
+
+static unsigned char ddrOf(const hal_board_t *b, int p)
+{
+	return b->mem[portRegs[p].ddr];
+}
+
+// Levels on the input pins. On Port A the column lines read high where a pressed key meets a driven row.
+static unsigned char inputLevels(const hal_board_t *b, int p)
+{
+	unsigned char rows, columns = 0;
+	int r;
+
+	if (p != HAL_PORT_A)
+		return b->pins[p];
+	rows = b->latch[p] & ddrOf(b, p);
+	for (r = 0; r < 4; r++)
+		if (rows & (1 << r))
+			columns |= b->keys[r];
+	return (unsigned char)((b->pins[p] & 0x0F) | (columns << 4));
+}
+
+static unsigned char portLevels(const hal_board_t *b, int p)
+{
+	unsigned char ddr = ddrOf(b, p);
+
+	return (unsigned char)((b->latch[p] & ddr) | (inputLevels(b, p) & ~ddr));
+}
+
+static void lcdCommand(hal_board_t *b, unsigned char v)
+{
+	if (v & 0x80)
+	{
+		b->lcdAddr = v & 0x7F;
+		b->lcdCgram = 0;
+	}
+	else if (v & 0x40)
+		b->lcdCgram = 1;
+	else if (v & 0x20)
+		b->lcdFourBit = !(v & 0x10);
+	else if (v & 0x02)
+		b->lcdAddr = 0;
+	else if (v & 0x01)
+	{
+		memset(b->ddram, ' ', sizeof(b->ddram));
+		b->lcdAddr = 0;
+	}
+}
+
+// Falling EN latches PK2-PK5. Until a function set selects 4 bits, each nibble is a whole instruction.
+static void lcdPort(hal_board_t *b, unsigned char old, unsigned char out)
+{
+	unsigned char nibble = (out >> 2) & 0x0F;
+	unsigned char v;
+
+	if (!(old & 0x02) || (out & 0x02))
+		return;
+	if (!b->lcdFourBit)
+	{
+		if (!(out & 0x01))
+			lcdCommand(b, (unsigned char)(nibble << 4));
+		return;
+	}
+	if (!b->lcdHalf)
+	{
+		b->lcdHigh = nibble;
+		b->lcdHalf = 1;
+		return;
+	}
+	b->lcdHalf = 0;
+	v = (unsigned char)((b->lcdHigh << 4) | nibble);
+	if (!(out & 0x01))
+		lcdCommand(b, v);
+	else if (!b->lcdCgram)
+	{
+		b->ddram[b->lcdAddr] = (char)v;
+		b->lcdAddr = (b->lcdAddr + 1) & 0x7F;
+	}
+}
+
+static void outputsChanged(hal_board_t *b, int p)
+{
+	unsigned char out = b->latch[p] & ddrOf(b, p);
+	unsigned char old = b->outputs[p];
+
+	if (out == old)
+		return;
+	b->outputs[p] = out;
+	if (p == HAL_PORT_K)
+		lcdPort(b, old, out);
+	if (b->watch[p])
+		b->watch[p](b->watchContext[p], b, p, out);
+}
+
+static void capture(hal_board_t *b, unsigned char rising, unsigned char falling)
+{
+	unsigned int edges;
+	int n;
+
+	if (!(b->mem[REG_TSCR1] & 0x80))
+		return;
+	for (n = 0; n < 8; n++)
+	{
+		if (b->mem[REG_TIOS] & (1 << n))
+			continue;
+		edges = n < 4 ? b->mem[REG_TCTL4] >> (2 * n) : b->mem[REG_TCTL3] >> (2 * (n - 4));
+		if (((edges & 1) && (rising & (1 << n))) || ((edges & 2) && (falling & (1 << n))))
+		{
+			b->wide[REG_TC0 + 2 * n] = (unsigned short)b->tcnt;
+			b->tflg1 |= 1 << n;
+		}
+	}
+}
+
+void hal_set_inputs(hal_board_t *b, int p, unsigned char mask, unsigned char levels)
+{
+	unsigned char old = inputLevels(b, p), now, rising, falling, inputs = ~ddrOf(b, p);
+
+	b->pins[p] = (unsigned char)((b->pins[p] & ~mask) | (levels & mask));
+	now = inputLevels(b, p);
+	rising = now & ~old & inputs;
+	falling = old & ~now & inputs;
+	if (p == HAL_PORT_P)
+		b->pifp |= (rising & b->mem[REG_PPSP]) | (falling & ~b->mem[REG_PPSP]);
+	else if (p == HAL_PORT_H)
+		b->pifh |= (rising & b->mem[REG_PPSH]) | (falling & ~b->mem[REG_PPSH]);
+	else if (p == HAL_PORT_T)
+		capture(b, rising, falling);
+}
+
+/* ---- Timer, SPI and motor ---- */
+
+static void ectTick(hal_board_t *b, unsigned long cycles)
+{
+	unsigned int shift = b->mem[REG_TSCR2] & 0x07;
+	unsigned long count, ticks;
+	int n;
+
+	if (!(b->mem[REG_TSCR1] & 0x80))
+		return;
+	count = b->prescaleCount + cycles;
+	ticks = count >> shift;
+	b->prescaleCount = (unsigned int)(count & ((1UL << shift) - 1));
+	while (ticks--)
+	{
+		b->tcnt = (b->tcnt + 1) & 0xFFFF;
+		if (b->tcnt == 0)
+			b->tflg2 |= 0x80;
+		for (n = 0; n < 8; n++)
+			if ((b->mem[REG_TIOS] & (1 << n)) && b->wide[REG_TC0 + 2 * n] == b->tcnt)
+				b->tflg1 |= 1 << n;
+		// TCRE: channel 7 compare resets the counter
+		if ((b->mem[REG_TSCR2] & 0x08) && (b->mem[REG_TIOS] & 0x80) && b->wide[REG_TC0 + 14] == b->tcnt)
+			b->tcnt = 0;
+	}
+}
+
+static unsigned long spiByteCycles(const hal_board_t *b)
+{
+	unsigned int sppr = (b->mem[REG_SPI0BR] >> 4) & 0x07, spr = b->mem[REG_SPI0BR] & 0x07;
+
+	return 8UL * ((sppr + 1UL) << (spr + 1));
+}
+
+static void spiStart(hal_board_t *b)
+{
+	b->spiShift = b->spiNext;
+	b->spiShifting = 1;
+	b->spiPending = 0;
+	b->spiRemaining = spiByteCycles(b);
+	b->spiStatus |= SPTEF;
+}
+
+static void spiWrite(hal_board_t *b, unsigned char value)
+{
+	if (!(b->mem[REG_SPI0CR1] & 0x40) || !(b->spiStatus & SPTEF))
+		return;
+	b->spiNext = value;
+	b->spiPending = 1;
+	b->spiStatus &= ~SPTEF;
+	if (!b->spiShifting)
+		spiStart(b);
+}
+
+static void spiTick(hal_board_t *b, unsigned long cycles)
+{
+	while (b->spiShifting)
+	{
+		if (b->spiRemaining > cycles)
+		{
+			b->spiRemaining -= cycles;
+			return;
+		}
+		cycles -= b->spiRemaining;
+		b->spiShifting = 0;
+		b->spiBytes++;
+		b->spiRx = 0xFF;                // nothing drives MISO on the Dragon12
+		b->spiStatus |= SPIF;
+		if (b->spiWatch)
+			b->spiWatch(b->spiContext, b, b->spiShift);
+		if (b->spiPending)
+			spiStart(b);
+	}
+}
+
+static void motorTick(hal_board_t *b, unsigned long cycles)
+{
+	double dt = (double)cycles * b->busPs * 1e-12, duty = 0, drive = 0;
+	unsigned char period = b->mem[REG_PWMPER0], direction = b->outputs[HAL_PORT_B] & 0x03;
+	long count;
+
+	if (!b->motorOn)
+		return;
+	if ((b->mem[REG_PWME] & 0x01) && period)
+	{
+		duty = b->mem[REG_PWMDTY0] >= period ? 1.0 : (double)b->mem[REG_PWMDTY0] / period;
+		if (!(b->mem[REG_PWMPOL] & 0x01))
+			duty = 1.0 - duty;          // PWMDTY0 sets the low time
+	}
+	// PB1 drives the count up and PB0 down, as control.c expects (a positive error selects PB0)
+	if (direction == 0x02)
+		drive = duty;
+	else if (direction == 0x01)
+		drive = -duty;
+	b->motorSpeed += (drive * b->motorMax - b->motorSpeed) * (dt < b->motorTau ? dt / b->motorTau : 1.0);
+	b->motorPosition += b->motorSpeed * dt;
+
+	count = (long)(b->motorPosition < 0 ? b->motorPosition - 1 : b->motorPosition);
+	while (b->motorCount != count)
+	{
+		b->motorCount += b->motorCount < count ? 1 : -1;
+		hal_set_inputs(b, HAL_PORT_P, MOTOR_PINS, motorPhase[b->motorCount & 3]);
+	}
+}
+
+static void advance(hal_board_t *b, unsigned long cycles)
+{
+	b->cycles += cycles;
+	b->timePs += (unsigned long long)cycles * b->busPs;
+	ectTick(b, cycles);
+	spiTick(b, cycles);
+	motorTick(b, cycles);
+}
+
+/* ---- Register accesses ---- */
+
+static unsigned int readRegister(hal_board_t *b, unsigned int addr, int kind)
+{
+	int p, isDdr;
+
+	switch (addr)
+	{
+		case REG_TCNT:
+			return b->tcnt;
+		case REG_TFLG1:
+			return kind == HAL_ACCESS_BYTE ? 0 : b->tflg1;
+		case REG_TFLG2:
+			return kind == HAL_ACCESS_BYTE ? 0 : b->tflg2;
+		case REG_PIFP:
+			return kind == HAL_ACCESS_BYTE ? 0 : b->pifp;
+		case REG_PIFH:
+			return kind == HAL_ACCESS_BYTE ? 0 : b->pifh;
+		case REG_CRGFLG:
+			return (b->mem[REG_CRGFLG] & ~0x08) | (pllLocked(b) ? 0x08 : 0);
+		case REG_SPI0SR:
+			if (b->spiStatus & SPIF)
+				b->spifRead = 1;
+			return b->spiStatus;
+		case REG_SPI0DR:
+			// Reading SPI0SR with SPIF set, then accessing SPI0DR, clears SPIF
+			if (b->spifRead)
+				b->spiStatus &= ~SPIF;
+			b->spifRead = 0;
+			return 0x100 | b->spiRx;
+	}
+	p = portOf(addr, &isDdr);
+	if (p >= 0 && !isDdr)
+		return portLevels(b, p);
+	return kind == HAL_ACCESS_WORD ? b->wide[addr] : b->mem[addr];
+}
+
+static void writeRegister(hal_board_t *b, unsigned int addr, int kind, unsigned int value)
+{
+	int p, isDdr;
+
+	switch (addr)
+	{
+		case REG_TCNT:
+			return;
+		case REG_TFLG1:
+			if (kind == HAL_ACCESS_BYTE)
+				b->tflg1 &= ~value;
+			return;
+		case REG_TFLG2:
+			if (kind == HAL_ACCESS_BYTE)
+				b->tflg2 &= ~value;
+			return;
+		case REG_PIFP:
+			if (kind == HAL_ACCESS_BYTE)
+				b->pifp &= ~value;
+			return;
+		case REG_PIFH:
+			if (kind == HAL_ACCESS_BYTE)
+				b->pifh &= ~value;
+			return;
+		case REG_SPI0DR:
+			spiWrite(b, (unsigned char)value);
+			return;
+		case REG_PLLCTL:
+			if ((b->mem[REG_PLLCTL] & 0x40) && !b->pllOn)
+				b->pllOnPs = b->timePs;
+			b->pllOn = (b->mem[REG_PLLCTL] & 0x40) != 0;
+			busClock(b);
+			return;
+		case REG_SYNR:
+		case REG_REFDV:
+		case REG_CLKSEL:
+			busClock(b);
+			return;
+	}
+	p = portOf(addr, &isDdr);
+	if (p < 0)
+		return;
+	if (!isDdr)
+		b->latch[p] = (unsigned char)value;
+	outputsChanged(b, p);
+}
+
+static unsigned int cellValue(const hal_board_t *b, const access_t *a)
+{
+	if (a->kind == HAL_ACCESS_WORD || a->kind == HAL_ACCESS_DATA)
+		return b->wide[a->addr];
+	return b->mem[a->addr];
+}
+
+// Applies whatever the firmware stored through the cells handed out so far
+static void checkOpen(hal_board_t *b)
+{
+	unsigned int value;
+	int i;
+
+	for (i = 0; i < b->openCount; i++)
+	{
+		value = cellValue(b, &b->open[i]);
+		if (value != b->open[i].preset)
+		{
+			b->open[i].preset = value;
+			writeRegister(b, b->open[i].addr, b->open[i].kind, value);
+		}
+	}
+}
+
+static void *openAccess(hal_board_t *b, unsigned int addr, int kind)
+{
+	access_t *a = NULL;
+	unsigned int value;
+	int i;
+
+	if (addr >= REG_SPACE)
+		fail("register address %04X out of range", addr);
+	for (i = 0; i < b->openCount && !a; i++)
+		if (b->open[i].addr == addr)
+			a = &b->open[i];
+	if (!a)
+	{
+		if (b->openCount == OPEN_MAX)
+			memmove(&b->open[0], &b->open[1], sizeof(b->open[0]) * --b->openCount);
+		a = &b->open[b->openCount++];
+		a->addr = addr;
+	}
+	a->kind = kind;
+	value = readRegister(b, addr, kind);
+	a->preset = value;
+	if (kind == HAL_ACCESS_WORD || kind == HAL_ACCESS_DATA)
+	{
+		b->wide[addr] = (unsigned short)value;
+		return &b->wide[addr];
+	}
+	b->mem[addr] = (unsigned char)value;
+	return &b->mem[addr];
+}
+
+// Vector of the highest priority enabled and pending interrupt, or 0
+static unsigned int pending(const hal_board_t *b)
+{
+	int n;
+
+	for (n = 0; n < 8; n++)
+		if (b->tflg1 & b->mem[REG_TIE] & (1 << n))
+			return HAL_VECTOR_ECT(n);
+	if ((b->tflg2 & 0x80) && (b->mem[REG_TSCR2] & 0x80))
+		return HAL_VECTOR_TOF;
+	if (((b->spiStatus & SPIF) && (b->mem[REG_SPI0CR1] & 0x80))
+		|| ((b->spiStatus & SPTEF) && (b->mem[REG_SPI0CR1] & 0x20)))
+		return HAL_VECTOR_SPI0;
+	if (b->pifh & b->mem[REG_PIEH])
+		return HAL_VECTOR_PORTH;
+	if (b->pifp & b->mem[REG_PIEP])
+		return HAL_VECTOR_PORTP;
+	return 0;
+}
+
+static void dispatch(hal_board_t *b)
+{
+	unsigned int vector, index;
+
+	while (!b->iBit && (vector = pending(b)) != 0)
+	{
+		index = (vector - 0xFF80) / 2;
+		if (!b->vectors[index])
+			fail("interrupt through vector %04X has no handler", vector);
+		b->interruptCount[index]++;
+		b->iBit = 1;
+		advance(b, ENTRY_CYCLES);
+		b->vectors[index]();
+		checkOpen(b);
+		advance(b, RTI_CYCLES);
+		b->iBit = 0;
+	}
+}
+
+static void checkDeadline(hal_board_t *b)
+{
+	hal_yield_t fn = b->deadlineFn;
+
+	if (fn && b->timePs >= b->deadlinePs)
+	{
+		b->deadlineFn = NULL;
+		fn(b->deadlineContext, b);
+	}
+}
+
+void *hal_io(unsigned int addr, int kind)
+{
+	hal_board_t *b = selected;
+
+	if (!b)
+		fail("register %04X accessed with no board selected", addr);
+	checkOpen(b);
+	advance(b, b->accessCycles);
+	dispatch(b);
+	checkDeadline(b);
+	return openAccess(b, addr, kind);
+}
+
+void hal_cli(void)
+{
+	if (!selected)
+		fail("CLI with no board selected", 0);
+	checkOpen(selected);
+	selected->iBit = 0;
+	dispatch(selected);
+}
+
+void hal_sei(void)
+{
+	if (!selected)
+		fail("SEI with no board selected", 0);
+	selected->iBit = 1;
+}
+
+void hal_wait(void)
+{
+	hal_board_t *b = selected;
+
+	if (!b)
+		fail("WAI with no board selected", 0);
+	if (b->iBit)
+		fail("WAI with interrupts masked would never return", 0);
+	checkOpen(b);
+	while (!pending(b))
+	{
+		advance(b, IDLE_CYCLES);
+		checkDeadline(b);
+	}
+	dispatch(b);
+}
+
+/* ---- Host side ---- */
+
+hal_board_t *hal_create(void)
+{
+	hal_board_t *b = calloc(1, sizeof(*b));
+	int p;
+
+	if (!b)
+		fail("out of memory", 0);
+	b->iBit = 1;
+	b->accessCycles = HAL_ACCESS_CYCLES;
+	b->mem[REG_PLLCTL] = 0xF1;
+	b->pllOn = 1;
+	b->spiStatus = SPTEF;
+	for (p = 0; p < HAL_PORT_COUNT; p++)
+		b->pins[p] = 0xFF;
+	b->pins[HAL_PORT_A] = 0x0F;
+	memset(b->ddram, ' ', sizeof(b->ddram));
+	busClock(b);
+	return b;
+}
+
+void hal_destroy(hal_board_t *b)
+{
+	if (selected == b)
+		selected = NULL;
+	free(b);
+}
+
+void hal_select(hal_board_t *b)
+{
+	selected = b;
+}
+
+hal_board_t *hal_selected(void)
+{
+	return selected;
+}
+
+void hal_set_vector(hal_board_t *b, unsigned int vector, hal_isr_t isr)
+{
+	if (vector < 0xFF80 || vector > 0xFFFE || (vector & 1))
+		fail("no vector at %04X", vector);
+	b->vectors[(vector - 0xFF80) / 2] = isr;
+}
+
+void hal_run(hal_board_t *b, unsigned long us)
+{
+	hal_board_t *previous = selected;
+	unsigned long long end = b->timePs + us * 1000000ULL;
+
+	selected = b;
+	checkOpen(b);
+	dispatch(b);
+	while (b->timePs < end)
+	{
+		advance(b, IDLE_CYCLES);
+		dispatch(b);
+	}
+	selected = previous;
+}
+
+void hal_set_access_cycles(hal_board_t *b, unsigned int cycles)
+{
+	b->accessCycles = cycles;
+}
+
+void hal_set_pll_lock(hal_board_t *b, long us)
+{
+	b->pllLockUs = us;
+}
+
+void hal_set_deadline(hal_board_t *b, unsigned long long micros, hal_yield_t fn, void *context)
+{
+	b->deadlinePs = micros * 1000000ULL;
+	b->deadlineFn = fn;
+	b->deadlineContext = context;
+}
+
+unsigned long long hal_cycles(const hal_board_t *b)
+{
+	return b->cycles;
+}
+
+unsigned long long hal_micros(const hal_board_t *b)
+{
+	return b->timePs / 1000000ULL;
+}
+
+unsigned long hal_bus_hz(const hal_board_t *b)
+{
+	return b->busHz;
+}
+
+unsigned long hal_interrupt_count(const hal_board_t *b, unsigned int vector)
+{
+	return b->interruptCount[(vector - 0xFF80) / 2];
+}
+
+unsigned char hal_outputs(const hal_board_t *b, int port)
+{
+	return b->outputs[port];
+}
+
+void hal_watch(hal_board_t *b, int port, hal_watch_t fn, void *context)
+{
+	b->watch[port] = fn;
+	b->watchContext[port] = context;
+}
+
+void hal_key(hal_board_t *b, char key, int down)
+{
+	const char *at;
+	int r;
+
+	for (r = 0; r < 4; r++)
+	{
+		at = strchr(keypadKeys[r], key);
+		if (key && at)
+		{
+			if (down)
+				b->keys[r] |= (unsigned char)(1 << (at - keypadKeys[r]));
+			else
+				b->keys[r] &= (unsigned char)~(1 << (at - keypadKeys[r]));
+			return;
+		}
+	}
+	fail("no key '%c' on the keypad", (unsigned char)key);
+}
+
+const char *hal_lcd_line(hal_board_t *b, int line)
+{
+	line = line ? 1 : 0;
+	memcpy(b->text[line], &b->ddram[line * 0x40], HAL_LCD_WIDTH);
+	b->text[line][HAL_LCD_WIDTH] = '\0';
+	return b->text[line];
+}
+
+void hal_motor(hal_board_t *b, double countsPerSecond, double timeConstant)
+{
+	b->motorOn = 1;
+	b->motorMax = countsPerSecond;
+	b->motorTau = timeConstant > 0 ? timeConstant : 1e-6;
+	b->motorSpeed = 0;
+	b->motorPosition = 0.5;             // in the middle of count 0
+	b->motorCount = 0;
+	hal_set_inputs(b, HAL_PORT_P, MOTOR_PINS, motorPhase[0]);
+}
+
+double hal_motor_position(const hal_board_t *b)
+{
+	return b->motorPosition;
+}
+
+void hal_spi_watch(hal_board_t *b, hal_spi_t fn, void *context)
+{
+	b->spiWatch = fn;
+	b->spiContext = context;
+}
+
+unsigned long hal_spi_bytes(const hal_board_t *b)
+{
+	return b->spiBytes;
+}
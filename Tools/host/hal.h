@@ -0,0 +1,142 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    hal.h                                          *
+*          Simulated Dragon12 board for host builds of    *
+*          the lab firmware                               *
+*---------------------------------------------------------*
+* The firmware reaches the hardware only through the      *
+* register names of mc9s12dg256.h. On the board those are *
+* CodeWarrior's fixed addresses. In a host build          *
+* (-I Tools/host) each name calls hal_io(), so this model *
+* sees every access, charges it bus cycles and takes any  *
+* interrupt that has become due, as the CPU would between *
+* two instructions.                                       *
+*                                                         *
+* A host program creates a board, installs the lab's      *
+* interrupt handlers, selects the board, calls the lab's  *
+* functions and lets time pass with hal_run().            *
+**********************************************************/
+
+#ifndef _HAL_H
+#define _HAL_H
+
+#define HAL_OSC_HZ          16000000UL  // Dragon12-Plus crystal; the bus runs at half this without the PLL
+#define HAL_ACCESS_CYCLES   3           // default bus cycles per register access, as LDAA/STAA extended
+
+// Access kinds, chosen by the register name the firmware uses (see mc9s12dg256.h):
+//   BYTE - the whole register. A write to a flag register (TFLG1, TFLG2, PIFP, PIFH) clears the flags
+//          written as 1, and reading one this way returns 0; read flags through their bit names.
+//   BITS - one bit, e.g. TIE_C3I or TFLG2_TOF. Writes to flag bits are ignored.
+//   WORD - a 16-bit register (TCNT, TC0-TC7).
+//   DATA - SPI0DR. The register is read through a wider cell so that writing the byte it already
+//          holds still starts a transfer.
+#define HAL_ACCESS_BYTE     0
+#define HAL_ACCESS_BITS     1
+#define HAL_ACCESS_WORD     2
+#define HAL_ACCESS_DATA     3
+
+// Ports with pins
+#define HAL_PORT_A          0
+#define HAL_PORT_B          1
+#define HAL_PORT_H          2
+#define HAL_PORT_J          3
+#define HAL_PORT_K          4
+#define HAL_PORT_M          5
+#define HAL_PORT_P          6
+#define HAL_PORT_S          7
+#define HAL_PORT_T          8
+#define HAL_PORT_COUNT      9
+
+// Interrupt vectors, by address as in the MC9S12DG256 vector table
+#define HAL_VECTOR_ECT(n)   (0xFFEE - 2 * (n))
+#define HAL_VECTOR_TOF      0xFFDE
+#define HAL_VECTOR_SPI0     0xFFD8
+#define HAL_VECTOR_PORTH    0xFFCC
+#define HAL_VECTOR_PORTP    0xFF8E
+#define HAL_VECTOR_COUNT    64          // 0xFF80-0xFFFF
+
+#define HAL_LCD_WIDTH       16
+#define HAL_LCD_HEIGHT      2
+
+typedef struct hal_bits
+{
+	unsigned char BIT0 : 1;
+	unsigned char BIT1 : 1;
+	unsigned char BIT2 : 1;
+	unsigned char BIT3 : 1;
+	unsigned char BIT4 : 1;
+	unsigned char BIT5 : 1;
+	unsigned char BIT6 : 1;
+	unsigned char BIT7 : 1;
+} hal_bits_t;
+
+typedef struct hal_board hal_board_t;
+typedef void (*hal_isr_t)(void);
+
+// Called when the levels a port drives change (bits set as inputs read 0)
+typedef void (*hal_watch_t)(void *context, hal_board_t *b, int port, unsigned char outputs);
+
+// Called with each byte SPI0 has finished sending
+typedef void (*hal_spi_t)(void *context, hal_board_t *b, unsigned char value);
+
+// Called from inside a register access once the board's time has reached a deadline
+typedef void (*hal_yield_t)(void *context, hal_board_t *b);
+
+// Board life cycle. A new board is in its reset state: I bit set, all pins pulled high, no key pressed.
+hal_board_t *hal_create(void);
+void hal_destroy(hal_board_t *b);
+
+// Board the firmware's register accesses go to. Select it before calling any lab function.
+void hal_select(hal_board_t *b);
+hal_board_t *hal_selected(void);
+
+// Installs an interrupt handler; a pending interrupt without one stops the program
+void hal_set_vector(hal_board_t *b, unsigned int vector, hal_isr_t isr);
+
+// Lets 'us' microseconds pass with the CPU idle, taking interrupts as they come
+void hal_run(hal_board_t *b, unsigned long us);
+
+// Bus cycles charged per register access. Raise it to stand for the instructions between accesses,
+// which are otherwise free.
+void hal_set_access_cycles(hal_board_t *b, unsigned int cycles);
+
+// Time the PLL takes to lock after PLLON is set, 0 (the default) for at once and negative for never
+void hal_set_pll_lock(hal_board_t *b, long us);
+
+// Calls fn once, from the first register access at or after 'micros'. A host program that runs the
+// main() of several boards as coroutines switches to the next board in fn (see Tools/ringsim).
+void hal_set_deadline(hal_board_t *b, unsigned long long micros, hal_yield_t fn, void *context);
+
+// Time since hal_create()
+unsigned long long hal_cycles(const hal_board_t *b);
+unsigned long long hal_micros(const hal_board_t *b);
+unsigned long hal_bus_hz(const hal_board_t *b);
+unsigned long hal_interrupt_count(const hal_board_t *b, unsigned int vector);
+
+// Pins: drive inputs from outside (edges reach Port P/H flags and the ECT input capture) and watch outputs
+void hal_set_inputs(hal_board_t *b, int port, unsigned char mask, unsigned char levels);
+unsigned char hal_outputs(const hal_board_t *b, int port);
+void hal_watch(hal_board_t *b, int port, hal_watch_t fn, void *context);
+
+// Keypad on Port A: presses or releases a key by its legend ('0'-'9', 'A'-'D', '*', '#')
+void hal_key(hal_board_t *b, char key, int down);
+
+// LCD on Port K: one line of the 16x2 display, as text
+const char *hal_lcd_line(hal_board_t *b, int line);
+
+// Motor 1 on the PWM0/PB0/PB1 driver with its encoder on PP2/PP3: first order response to the duty
+// cycle, reaching 'countsPerSecond' at 100% with time constant 'timeConstant' (seconds)
+void hal_motor(hal_board_t *b, double countsPerSecond, double timeConstant);
+double hal_motor_position(const hal_board_t *b);
+
+void hal_spi_watch(hal_board_t *b, hal_spi_t fn, void *context);
+unsigned long hal_spi_bytes(const hal_board_t *b);
+
+// Used by mc9s12dg256.h and hidef.h
+void *hal_io(unsigned int addr, int kind);
+void hal_cli(void);
+void hal_sei(void);
+void hal_wait(void);
+
+#endif
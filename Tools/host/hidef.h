@@ -0,0 +1,29 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    hidef.h                                        *
+*          CodeWarrior's common defines for host builds   *
+*---------------------------------------------------------*
+* The interrupt mask instructions and WAI become calls    *
+* into the simulated board, so "EnableInterrupts;" and    *
+* "__asm CLI;" work as on the target.                     *
+**********************************************************/
+
+#ifndef _HIDEF_H
+#define _HIDEF_H
+
+#include "hal.h"
+
+#define EnableInterrupts    hal_cli()
+#define DisableInterrupts   hal_sei()
+
+// Only CLI, SEI and WAI are used from inline assembly outside the startup code (Start12.c, datapage.c)
+#define __asm
+#define CLI                 hal_cli()
+#define SEI                 hal_sei()
+#define WAI                 hal_wait()
+
+#define __RESET_WATCHDOG()
+#define _FEED_COP()
+
+#endif
@@ -0,0 +1,456 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    mc9s12dg256.h                                  *
+*          Register names for host builds of the labs     *
+*---------------------------------------------------------*
+* Stands in for CodeWarrior's mc9s12dg256.h when a lab    *
+* is built with -I Tools/host. Each name is an access to  *
+* the simulated board (hal.h) instead of a fixed address, *
+* so derivative.h and the lab sources compile unchanged.  *
+* Only the registers the labs use are listed.             *
+**********************************************************/
+
+#ifndef _MC9S12DG256_H
+#define _MC9S12DG256_H
+
+#include "hal.h"
+
+// Register access. Which macro a name uses decides what the model sees (hal.h)
+#define HAL_REG(addr)       (*(volatile unsigned char *)hal_io(addr, HAL_ACCESS_BYTE))
+#define HAL_BIT(addr, n)    (((volatile hal_bits_t *)hal_io(addr, HAL_ACCESS_BITS))->BIT##n)
+#define HAL_REG16(addr)     (*(volatile unsigned short *)hal_io(addr, HAL_ACCESS_WORD))
+#define HAL_DATA(addr)      (*(volatile unsigned short *)hal_io(addr, HAL_ACCESS_DATA))
+
+// CodeWarrior keywords. Interrupt handlers are ordinary functions, installed with hal_set_vector().
+#define interrupt
+#define __far
+#define VectorNumber_Vtimch0
+#define VectorNumber_Vtimch1
+#define VectorNumber_Vtimch2
+#define VectorNumber_Vtimch3
+#define VectorNumber_Vtimch4
+#define VectorNumber_Vtimch5
+#define VectorNumber_Vtimch6
+#define VectorNumber_Vtimch7
+#define VectorNumber_Vtimovf
+#define VectorNumber_Vspi0
+#define VectorNumber_Vporth
+#define VectorNumber_Vportp
+
+// Ports A, B, E and K
+#define PORTA           HAL_REG(0x0000)
+#define PORTA_BIT0      HAL_BIT(0x0000, 0)
+#define PORTA_BIT1      HAL_BIT(0x0000, 1)
+#define PORTA_BIT2      HAL_BIT(0x0000, 2)
+#define PORTA_BIT3      HAL_BIT(0x0000, 3)
+#define PORTA_BIT4      HAL_BIT(0x0000, 4)
+#define PORTA_BIT5      HAL_BIT(0x0000, 5)
+#define PORTA_BIT6      HAL_BIT(0x0000, 6)
+#define PORTA_BIT7      HAL_BIT(0x0000, 7)
+#define PORTA_BIT0_MASK 1U
+#define PORTA_BIT1_MASK 2U
+#define PORTA_BIT2_MASK 4U
+#define PORTA_BIT3_MASK 8U
+#define PORTA_BIT4_MASK 16U
+#define PORTA_BIT5_MASK 32U
+#define PORTA_BIT6_MASK 64U
+#define PORTA_BIT7_MASK 128U
+#define PORTB           HAL_REG(0x0001)
+#define PORTB_BIT0      HAL_BIT(0x0001, 0)
+#define PORTB_BIT1      HAL_BIT(0x0001, 1)
+#define PORTB_BIT2      HAL_BIT(0x0001, 2)
+#define PORTB_BIT3      HAL_BIT(0x0001, 3)
+#define PORTB_BIT4      HAL_BIT(0x0001, 4)
+#define PORTB_BIT5      HAL_BIT(0x0001, 5)
+#define PORTB_BIT6      HAL_BIT(0x0001, 6)
+#define PORTB_BIT7      HAL_BIT(0x0001, 7)
+#define PORTB_BIT0_MASK 1U
+#define PORTB_BIT1_MASK 2U
+#define PORTB_BIT2_MASK 4U
+#define PORTB_BIT3_MASK 8U
+#define PORTB_BIT4_MASK 16U
+#define PORTB_BIT5_MASK 32U
+#define PORTB_BIT6_MASK 64U
+#define PORTB_BIT7_MASK 128U
+#define DDRA            HAL_REG(0x0002)
+#define DDRB            HAL_REG(0x0003)
+#define PORTE           HAL_REG(0x0008)
+#define DDRE            HAL_REG(0x0009)
+#define PEAR            HAL_REG(0x000A)
+#define PPAGE           HAL_REG(0x0030)
+#define PORTK           HAL_REG(0x0032)
+#define PORTK_BIT0      HAL_BIT(0x0032, 0)
+#define PORTK_BIT1      HAL_BIT(0x0032, 1)
+#define PORTK_BIT2      HAL_BIT(0x0032, 2)
+#define PORTK_BIT3      HAL_BIT(0x0032, 3)
+#define PORTK_BIT4      HAL_BIT(0x0032, 4)
+#define PORTK_BIT5      HAL_BIT(0x0032, 5)
+#define PORTK_BIT6      HAL_BIT(0x0032, 6)
+#define PORTK_BIT7      HAL_BIT(0x0032, 7)
+#define PORTK_BIT0_MASK 1U
+#define PORTK_BIT1_MASK 2U
+#define PORTK_BIT2_MASK 4U
+#define PORTK_BIT3_MASK 8U
+#define PORTK_BIT4_MASK 16U
+#define PORTK_BIT5_MASK 32U
+#define PORTK_BIT6_MASK 64U
+#define PORTK_BIT7_MASK 128U
+#define DDRK            HAL_REG(0x0033)
+
+// CRG
+#define SYNR            HAL_REG(0x0034)
+#define REFDV           HAL_REG(0x0035)
+#define CRGFLG          HAL_REG(0x0037)
+#define CRGFLG_SCM      HAL_BIT(0x0037, 0)
+#define CRGFLG_SCMIF    HAL_BIT(0x0037, 1)
+#define CRGFLG_TRACK    HAL_BIT(0x0037, 2)
+#define CRGFLG_LOCK     HAL_BIT(0x0037, 3)
+#define CRGFLG_LOCKIF   HAL_BIT(0x0037, 4)
+#define CRGFLG_LVRF     HAL_BIT(0x0037, 5)
+#define CRGFLG_PORF     HAL_BIT(0x0037, 6)
+#define CRGFLG_RTIF     HAL_BIT(0x0037, 7)
+#define CRGFLG_SCM_MASK 1U
+#define CRGFLG_SCMIF_MASK 2U
+#define CRGFLG_TRACK_MASK 4U
+#define CRGFLG_LOCK_MASK 8U
+#define CRGFLG_LOCKIF_MASK 16U
+#define CRGFLG_LVRF_MASK 32U
+#define CRGFLG_PORF_MASK 64U
+#define CRGFLG_RTIF_MASK 128U
+#define CRGINT          HAL_REG(0x0038)
+#define CLKSEL          HAL_REG(0x0039)
+#define CLKSEL_COPWAI   HAL_BIT(0x0039, 0)
+#define CLKSEL_RTIWAI   HAL_BIT(0x0039, 1)
+#define CLKSEL_CWAI     HAL_BIT(0x0039, 2)
+#define CLKSEL_PLLWAI   HAL_BIT(0x0039, 3)
+#define CLKSEL_ROAWAI   HAL_BIT(0x0039, 4)
+#define CLKSEL_SYSWAI   HAL_BIT(0x0039, 5)
+#define CLKSEL_PSTP     HAL_BIT(0x0039, 6)
+#define CLKSEL_PLLSEL   HAL_BIT(0x0039, 7)
+#define CLKSEL_COPWAI_MASK 1U
+#define CLKSEL_RTIWAI_MASK 2U
+#define CLKSEL_CWAI_MASK 4U
+#define CLKSEL_PLLWAI_MASK 8U
+#define CLKSEL_ROAWAI_MASK 16U
+#define CLKSEL_SYSWAI_MASK 32U
+#define CLKSEL_PSTP_MASK 64U
+#define CLKSEL_PLLSEL_MASK 128U
+#define PLLCTL          HAL_REG(0x003A)
+#define PLLCTL_SCME     HAL_BIT(0x003A, 0)
+#define PLLCTL_PCE      HAL_BIT(0x003A, 1)
+#define PLLCTL_PRE      HAL_BIT(0x003A, 2)
+#define PLLCTL_ACQ      HAL_BIT(0x003A, 4)
+#define PLLCTL_AUTO     HAL_BIT(0x003A, 5)
+#define PLLCTL_PLLON    HAL_BIT(0x003A, 6)
+#define PLLCTL_CME      HAL_BIT(0x003A, 7)
+#define PLLCTL_SCME_MASK 1U
+#define PLLCTL_PCE_MASK 2U
+#define PLLCTL_PRE_MASK 4U
+#define PLLCTL_ACQ_MASK 16U
+#define PLLCTL_AUTO_MASK 32U
+#define PLLCTL_PLLON_MASK 64U
+#define PLLCTL_CME_MASK 128U
+#define RTICTL          HAL_REG(0x003B)
+#define COPCTL          HAL_REG(0x003C)
+#define ARMCOP          HAL_REG(0x003F)
+
+// ECT
+#define TIOS            HAL_REG(0x0040)
+#define TIOS_IOS0       HAL_BIT(0x0040, 0)
+#define TIOS_IOS1       HAL_BIT(0x0040, 1)
+#define TIOS_IOS2       HAL_BIT(0x0040, 2)
+#define TIOS_IOS3       HAL_BIT(0x0040, 3)
+#define TIOS_IOS4       HAL_BIT(0x0040, 4)
+#define TIOS_IOS5       HAL_BIT(0x0040, 5)
+#define TIOS_IOS6       HAL_BIT(0x0040, 6)
+#define TIOS_IOS7       HAL_BIT(0x0040, 7)
+#define TIOS_IOS0_MASK  1U
+#define TIOS_IOS1_MASK  2U
+#define TIOS_IOS2_MASK  4U
+#define TIOS_IOS3_MASK  8U
+#define TIOS_IOS4_MASK  16U
+#define TIOS_IOS5_MASK  32U
+#define TIOS_IOS6_MASK  64U
+#define TIOS_IOS7_MASK  128U
+#define CFORC           HAL_REG(0x0041)
+#define OC7M            HAL_REG(0x0042)
+#define OC7D            HAL_REG(0x0043)
+#define TCNT            HAL_REG16(0x0044)
+#define TSCR1           HAL_REG(0x0046)
+#define TSCR1_TFFCA     HAL_BIT(0x0046, 4)
+#define TSCR1_TSFRZ     HAL_BIT(0x0046, 5)
+#define TSCR1_TSWAI     HAL_BIT(0x0046, 6)
+#define TSCR1_TEN       HAL_BIT(0x0046, 7)
+#define TSCR1_TFFCA_MASK 16U
+#define TSCR1_TSFRZ_MASK 32U
+#define TSCR1_TSWAI_MASK 64U
+#define TSCR1_TEN_MASK  128U
+#define TTOV            HAL_REG(0x0047)
+#define TCTL1           HAL_REG(0x0048)
+#define TCTL2           HAL_REG(0x0049)
+#define TCTL3           HAL_REG(0x004A)
+#define TCTL4           HAL_REG(0x004B)
+#define TIE             HAL_REG(0x004C)
+#define TIE_C0I         HAL_BIT(0x004C, 0)
+#define TIE_C1I         HAL_BIT(0x004C, 1)
+#define TIE_C2I         HAL_BIT(0x004C, 2)
+#define TIE_C3I         HAL_BIT(0x004C, 3)
+#define TIE_C4I         HAL_BIT(0x004C, 4)
+#define TIE_C5I         HAL_BIT(0x004C, 5)
+#define TIE_C6I         HAL_BIT(0x004C, 6)
+#define TIE_C7I         HAL_BIT(0x004C, 7)
+#define TIE_C0I_MASK    1U
+#define TIE_C1I_MASK    2U
+#define TIE_C2I_MASK    4U
+#define TIE_C3I_MASK    8U
+#define TIE_C4I_MASK    16U
+#define TIE_C5I_MASK    32U
+#define TIE_C6I_MASK    64U
+#define TIE_C7I_MASK    128U
+#define TSCR2           HAL_REG(0x004D)
+#define TSCR2_PR0       HAL_BIT(0x004D, 0)
+#define TSCR2_PR1       HAL_BIT(0x004D, 1)
+#define TSCR2_PR2       HAL_BIT(0x004D, 2)
+#define TSCR2_TCRE      HAL_BIT(0x004D, 3)
+#define TSCR2_TOI       HAL_BIT(0x004D, 7)
+#define TSCR2_PR0_MASK  1U
+#define TSCR2_PR1_MASK  2U
+#define TSCR2_PR2_MASK  4U
+#define TSCR2_TCRE_MASK 8U
+#define TSCR2_TOI_MASK  128U
+#define TFLG1           HAL_REG(0x004E)
+#define TFLG1_C0F       HAL_BIT(0x004E, 0)
+#define TFLG1_C1F       HAL_BIT(0x004E, 1)
+#define TFLG1_C2F       HAL_BIT(0x004E, 2)
+#define TFLG1_C3F       HAL_BIT(0x004E, 3)
+#define TFLG1_C4F       HAL_BIT(0x004E, 4)
+#define TFLG1_C5F       HAL_BIT(0x004E, 5)
+#define TFLG1_C6F       HAL_BIT(0x004E, 6)
+#define TFLG1_C7F       HAL_BIT(0x004E, 7)
+#define TFLG1_C0F_MASK  1U
+#define TFLG1_C1F_MASK  2U
+#define TFLG1_C2F_MASK  4U
+#define TFLG1_C3F_MASK  8U
+#define TFLG1_C4F_MASK  16U
+#define TFLG1_C5F_MASK  32U
+#define TFLG1_C6F_MASK  64U
+#define TFLG1_C7F_MASK  128U
+#define TFLG2           HAL_REG(0x004F)
+#define TFLG2_TOF       HAL_BIT(0x004F, 7)
+#define TFLG2_TOF_MASK  128U
+#define TC0             HAL_REG16(0x0050)
+#define TC1             HAL_REG16(0x0052)
+#define TC2             HAL_REG16(0x0054)
+#define TC3             HAL_REG16(0x0056)
+#define TC4             HAL_REG16(0x0058)
+#define TC5             HAL_REG16(0x005A)
+#define TC6             HAL_REG16(0x005C)
+#define TC7             HAL_REG16(0x005E)
+#define PACTL           HAL_REG(0x0060)
+#define PAFLG           HAL_REG(0x0061)
+
+// PWM
+#define PWME            HAL_REG(0x00A0)
+#define PWMPOL          HAL_REG(0x00A1)
+#define PWMCLK          HAL_REG(0x00A2)
+#define PWMPRCLK        HAL_REG(0x00A3)
+#define PWMCAE          HAL_REG(0x00A4)
+#define PWMCTL          HAL_REG(0x00A5)
+#define PWMSCLA         HAL_REG(0x00A8)
+#define PWMSCLB         HAL_REG(0x00A9)
+#define PWMCNT0         HAL_REG(0x00AC)
+#define PWMCNT1         HAL_REG(0x00AD)
+#define PWMCNT2         HAL_REG(0x00AE)
+#define PWMCNT3         HAL_REG(0x00AF)
+#define PWMCNT4         HAL_REG(0x00B0)
+#define PWMCNT5         HAL_REG(0x00B1)
+#define PWMCNT6         HAL_REG(0x00B2)
+#define PWMCNT7         HAL_REG(0x00B3)
+#define PWMPER0         HAL_REG(0x00B4)
+#define PWMPER1         HAL_REG(0x00B5)
+#define PWMPER2         HAL_REG(0x00B6)
+#define PWMPER3         HAL_REG(0x00B7)
+#define PWMPER4         HAL_REG(0x00B8)
+#define PWMPER5         HAL_REG(0x00B9)
+#define PWMPER6         HAL_REG(0x00BA)
+#define PWMPER7         HAL_REG(0x00BB)
+#define PWMDTY0         HAL_REG(0x00BC)
+#define PWMDTY1         HAL_REG(0x00BD)
+#define PWMDTY2         HAL_REG(0x00BE)
+#define PWMDTY3         HAL_REG(0x00BF)
+#define PWMDTY4         HAL_REG(0x00C0)
+#define PWMDTY5         HAL_REG(0x00C1)
+#define PWMDTY6         HAL_REG(0x00C2)
+#define PWMDTY7         HAL_REG(0x00C3)
+
+// SPI0
+#define SPI0CR1         HAL_REG(0x00D8)
+#define SPI0CR1_LSBFE   HAL_BIT(0x00D8, 0)
+#define SPI0CR1_SSOE    HAL_BIT(0x00D8, 1)
+#define SPI0CR1_CPHA    HAL_BIT(0x00D8, 2)
+#define SPI0CR1_CPOL    HAL_BIT(0x00D8, 3)
+#define SPI0CR1_MSTR    HAL_BIT(0x00D8, 4)
+#define SPI0CR1_SPTIE   HAL_BIT(0x00D8, 5)
+#define SPI0CR1_SPE     HAL_BIT(0x00D8, 6)
+#define SPI0CR1_SPIE    HAL_BIT(0x00D8, 7)
+#define SPI0CR1_LSBFE_MASK 1U
+#define SPI0CR1_SSOE_MASK 2U
+#define SPI0CR1_CPHA_MASK 4U
+#define SPI0CR1_CPOL_MASK 8U
+#define SPI0CR1_MSTR_MASK 16U
+#define SPI0CR1_SPTIE_MASK 32U
+#define SPI0CR1_SPE_MASK 64U
+#define SPI0CR1_SPIE_MASK 128U
+#define SPI0CR2         HAL_REG(0x00D9)
+#define SPI0BR          HAL_REG(0x00DA)
+#define SPI0SR          HAL_REG(0x00DB)
+#define SPI0SR_MODF     HAL_BIT(0x00DB, 4)
+#define SPI0SR_SPTEF    HAL_BIT(0x00DB, 5)
+#define SPI0SR_SPIF     HAL_BIT(0x00DB, 7)
+#define SPI0SR_MODF_MASK 16U
+#define SPI0SR_SPTEF_MASK 32U
+#define SPI0SR_SPIF_MASK 128U
+#define SPI0DR          HAL_DATA(0x00DD)
+
+// Ports T, S, M, P, H and J
+#define PTT             HAL_REG(0x0240)
+#define PTT_PTT0        HAL_BIT(0x0240, 0)
+#define PTT_PTT1        HAL_BIT(0x0240, 1)
+#define PTT_PTT2        HAL_BIT(0x0240, 2)
+#define PTT_PTT3        HAL_BIT(0x0240, 3)
+#define PTT_PTT4        HAL_BIT(0x0240, 4)
+#define PTT_PTT5        HAL_BIT(0x0240, 5)
+#define PTT_PTT6        HAL_BIT(0x0240, 6)
+#define PTT_PTT7        HAL_BIT(0x0240, 7)
+#define PTIT            HAL_REG(0x0241)
+#define DDRT            HAL_REG(0x0242)
+#define DDRT_DDRT0      HAL_BIT(0x0242, 0)
+#define DDRT_DDRT1      HAL_BIT(0x0242, 1)
+#define DDRT_DDRT2      HAL_BIT(0x0242, 2)
+#define DDRT_DDRT3      HAL_BIT(0x0242, 3)
+#define DDRT_DDRT4      HAL_BIT(0x0242, 4)
+#define DDRT_DDRT5      HAL_BIT(0x0242, 5)
+#define DDRT_DDRT6      HAL_BIT(0x0242, 6)
+#define DDRT_DDRT7      HAL_BIT(0x0242, 7)
+#define RDRT            HAL_REG(0x0243)
+#define PERT            HAL_REG(0x0244)
+#define PPST            HAL_REG(0x0245)
+#define PTS             HAL_REG(0x0248)
+#define PTS_PTS0        HAL_BIT(0x0248, 0)
+#define PTS_PTS1        HAL_BIT(0x0248, 1)
+#define PTS_PTS2        HAL_BIT(0x0248, 2)
+#define PTS_PTS3        HAL_BIT(0x0248, 3)
+#define PTS_PTS4        HAL_BIT(0x0248, 4)
+#define PTS_PTS5        HAL_BIT(0x0248, 5)
+#define PTS_PTS6        HAL_BIT(0x0248, 6)
+#define PTS_PTS7        HAL_BIT(0x0248, 7)
+#define PTIS            HAL_REG(0x0249)
+#define DDRS            HAL_REG(0x024A)
+#define DDRS_DDRS0      HAL_BIT(0x024A, 0)
+#define DDRS_DDRS1      HAL_BIT(0x024A, 1)
+#define DDRS_DDRS2      HAL_BIT(0x024A, 2)
+#define DDRS_DDRS3      HAL_BIT(0x024A, 3)
+#define DDRS_DDRS4      HAL_BIT(0x024A, 4)
+#define DDRS_DDRS5      HAL_BIT(0x024A, 5)
+#define DDRS_DDRS6      HAL_BIT(0x024A, 6)
+#define DDRS_DDRS7      HAL_BIT(0x024A, 7)
+#define RDRS            HAL_REG(0x024B)
+#define PERS            HAL_REG(0x024C)
+#define PPSS            HAL_REG(0x024D)
+#define PTM             HAL_REG(0x0250)
+#define PTM_PTM0        HAL_BIT(0x0250, 0)
+#define PTM_PTM1        HAL_BIT(0x0250, 1)
+#define PTM_PTM2        HAL_BIT(0x0250, 2)
+#define PTM_PTM3        HAL_BIT(0x0250, 3)
+#define PTM_PTM4        HAL_BIT(0x0250, 4)
+#define PTM_PTM5        HAL_BIT(0x0250, 5)
+#define PTM_PTM6        HAL_BIT(0x0250, 6)
+#define PTM_PTM7        HAL_BIT(0x0250, 7)
+#define PTIM            HAL_REG(0x0251)
+#define DDRM            HAL_REG(0x0252)
+#define DDRM_DDRM0      HAL_BIT(0x0252, 0)
+#define DDRM_DDRM1      HAL_BIT(0x0252, 1)
+#define DDRM_DDRM2      HAL_BIT(0x0252, 2)
+#define DDRM_DDRM3      HAL_BIT(0x0252, 3)
+#define DDRM_DDRM4      HAL_BIT(0x0252, 4)
+#define DDRM_DDRM5      HAL_BIT(0x0252, 5)
+#define DDRM_DDRM6      HAL_BIT(0x0252, 6)
+#define DDRM_DDRM7      HAL_BIT(0x0252, 7)
+#define RDRM            HAL_REG(0x0253)
+#define PERM            HAL_REG(0x0254)
+#define PPSM            HAL_REG(0x0255)
+#define PTP             HAL_REG(0x0258)
+#define PTP_PTP0        HAL_BIT(0x0258, 0)
+#define PTP_PTP1        HAL_BIT(0x0258, 1)
+#define PTP_PTP2        HAL_BIT(0x0258, 2)
+#define PTP_PTP3        HAL_BIT(0x0258, 3)
+#define PTP_PTP4        HAL_BIT(0x0258, 4)
+#define PTP_PTP5        HAL_BIT(0x0258, 5)
+#define PTP_PTP6        HAL_BIT(0x0258, 6)
+#define PTP_PTP7        HAL_BIT(0x0258, 7)
+#define PTIP            HAL_REG(0x0259)
+#define DDRP            HAL_REG(0x025A)
+#define DDRP_DDRP0      HAL_BIT(0x025A, 0)
+#define DDRP_DDRP1      HAL_BIT(0x025A, 1)
+#define DDRP_DDRP2      HAL_BIT(0x025A, 2)
+#define DDRP_DDRP3      HAL_BIT(0x025A, 3)
+#define DDRP_DDRP4      HAL_BIT(0x025A, 4)
+#define DDRP_DDRP5      HAL_BIT(0x025A, 5)
+#define DDRP_DDRP6      HAL_BIT(0x025A, 6)
+#define DDRP_DDRP7      HAL_BIT(0x025A, 7)
+#define RDRP            HAL_REG(0x025B)
+#define PERP            HAL_REG(0x025C)
+#define PPSP            HAL_REG(0x025D)
+#define PIEP            HAL_REG(0x025E)
+#define PIFP            HAL_REG(0x025F)
+#define PTH             HAL_REG(0x0260)
+#define PTH_PTH0        HAL_BIT(0x0260, 0)
+#define PTH_PTH1        HAL_BIT(0x0260, 1)
+#define PTH_PTH2        HAL_BIT(0x0260, 2)
+#define PTH_PTH3        HAL_BIT(0x0260, 3)
+#define PTH_PTH4        HAL_BIT(0x0260, 4)
+#define PTH_PTH5        HAL_BIT(0x0260, 5)
+#define PTH_PTH6        HAL_BIT(0x0260, 6)
+#define PTH_PTH7        HAL_BIT(0x0260, 7)
+#define PTIH            HAL_REG(0x0261)
+#define DDRH            HAL_REG(0x0262)
+#define DDRH_DDRH0      HAL_BIT(0x0262, 0)
+#define DDRH_DDRH1      HAL_BIT(0x0262, 1)
+#define DDRH_DDRH2      HAL_BIT(0x0262, 2)
+#define DDRH_DDRH3      HAL_BIT(0x0262, 3)
+#define DDRH_DDRH4      HAL_BIT(0x0262, 4)
+#define DDRH_DDRH5      HAL_BIT(0x0262, 5)
+#define DDRH_DDRH6      HAL_BIT(0x0262, 6)
+#define DDRH_DDRH7      HAL_BIT(0x0262, 7)
+#define RDRH            HAL_REG(0x0263)
+#define PERH            HAL_REG(0x0264)
+#define PPSH            HAL_REG(0x0265)
+#define PIEH            HAL_REG(0x0266)
+#define PIFH            HAL_REG(0x0267)
+#define PTJ             HAL_REG(0x0268)
+#define PTJ_PTJ0        HAL_BIT(0x0268, 0)
+#define PTJ_PTJ1        HAL_BIT(0x0268, 1)
+#define PTJ_PTJ2        HAL_BIT(0x0268, 2)
+#define PTJ_PTJ3        HAL_BIT(0x0268, 3)
+#define PTJ_PTJ4        HAL_BIT(0x0268, 4)
+#define PTJ_PTJ5        HAL_BIT(0x0268, 5)
+#define PTJ_PTJ6        HAL_BIT(0x0268, 6)
+#define PTJ_PTJ7        HAL_BIT(0x0268, 7)
+#define PTIJ            HAL_REG(0x0269)
+#define DDRJ            HAL_REG(0x026A)
+#define DDRJ_DDRJ0      HAL_BIT(0x026A, 0)
+#define DDRJ_DDRJ1      HAL_BIT(0x026A, 1)
+#define DDRJ_DDRJ2      HAL_BIT(0x026A, 2)
+#define DDRJ_DDRJ3      HAL_BIT(0x026A, 3)
+#define DDRJ_DDRJ4      HAL_BIT(0x026A, 4)
+#define DDRJ_DDRJ5      HAL_BIT(0x026A, 5)
+#define DDRJ_DDRJ6      HAL_BIT(0x026A, 6)
+#define DDRJ_DDRJ7      HAL_BIT(0x026A, 7)
+#define RDRJ            HAL_REG(0x026B)
+#define PERJ            HAL_REG(0x026C)
+#define PPSJ            HAL_REG(0x026D)
+#define PIEJ            HAL_REG(0x026E)
+#define PIFJ            HAL_REG(0x026F)
+
+#endif
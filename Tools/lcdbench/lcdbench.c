@@ -0,0 +1,613 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    lcdbench.c                                     *
+*          Cycle cost of the LCD number conversion, run   *
+*          on the sim12 CPU core                          *
+*---------------------------------------------------------*
+* Usage: lcdbench [options] lcdformat.c                   *
+*   -s file.s19  image holding the old printLCDNumber()   *
+*   -m file.map  its linker map                           *
+*   -c           print the results as CSV                 *
+*   -r file.csv  compare against an earlier CSV and fail  *
+*                if any case got slower                   *
+*   -l           list the assembled routines              *
+*                                                         *
+* The inline asm of toDecimal() is taken from lcdformat.c *
+* and assembled into fixed flash, next to a reciprocal    *
+* multiply version kept here for reference. The old       *
+* printLCDNumber() is run from the image CodeWarrior      *
+* built; each call of writeLCDValue() is caught at its    *
+* entry, its character recorded and the call returned     *
+* from at no cost, so only the conversion is counted.     *
+**********************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include "../sim12/cpu12.h"
+#include "../lib/asm12.h"
+#include "../lib/mapfile.h"
+#include "../lib/s19.h"
+
+#define MAX_LINES       128
+#define MAX_CASES       64
+
+#define ROUTINE_ORIGIN  0xC000
+#define STUB_ADDR       0x2000          // caller in RAM
+#define STACK_TOP       0x3F80
+#define DIGITS_ADDR     0x1800          // the digits[] argument
+#define MAX_STEPS       100000
+
+typedef struct routine
+{
+	char name[ASM12_NAME_LEN];
+	char *lines[MAX_LINES];
+	int lineNumbers[MAX_LINES];         // in the source, for error messages
+	int lineCount;
+	unsigned int addr, size;
+} routine_t;
+
+typedef struct result
+{
+	char routine[ASM12_NAME_LEN];
+	int value;
+	unsigned long cycles;
+	unsigned long divideCycles;         // spent in IDIV, IDIVS and EDIV
+	int ok;
+} result_t;
+
+// n / 10 is (n * 0xCCCD) >> 19 for every 16-bit n. The remainder only needs the low bytes of n - 10q.
+static const char *reciprocalSource[] =
+{
+	"PSHD                   ; digits; value is now at 4,SP",
+	"LDD     4,SP",
+	"TFR     D,X            ; n",
+	"LDY     #0xCCCD",
+	"EMUL                   ; Y:D = n * 0xCCCD",
+	"TFR     Y,D",
+	"LSRD",
+	"LSRD",
+	"LSRD                   ; q = n / 10",
+	"PSHD",
+	"LDAA    #10",
+	"MUL                    ; B = low byte of 10q",
+	"TFR     X,A            ; low byte of n",
+	"SBA",
+	"ADDA    #0x30",
+	"LDY     2,SP",
+	"STAA    4,Y",
+	"PULD",
+	"TFR     D,X",
+	"LDY     #0xCCCD",
+	"EMUL",
+	"TFR     Y,D",
+	"LSRD",
+	"LSRD",
+	"LSRD",
+	"PSHD",
+	"LDAA    #10",
+	"MUL",
+	"TFR     X,A",
+	"SBA",
+	"ADDA    #0x30",
+	"LDY     2,SP",
+	"STAA    3,Y",
+	"PULD",
+	"TFR     D,X",
+	"LDY     #0xCCCD",
+	"EMUL",
+	"TFR     Y,D",
+	"LSRD",
+	"LSRD",
+	"LSRD",
+	"PSHD",
+	"LDAA    #10",
+	"MUL",
+	"TFR     X,A",
+	"SBA",
+	"ADDA    #0x30",
+	"LDY     2,SP",
+	"STAA    2,Y",
+	"PULD",
+	"TFR     D,X",
+	"LDY     #0xCCCD",
+	"EMUL",
+	"TFR     Y,D",
+	"LSRD",
+	"LSRD",
+	"LSRD",
+	"PSHD",
+	"LDAA    #10",
+	"MUL",
+	"TFR     X,A",
+	"SBA",
+	"ADDA    #0x30",
+	"LDY     2,SP",
+	"STAA    1,Y",
+	"PULD                   ; at most 6",
+	"ADDB    #0x30",
+	"PULY",
+	"STAB    0,Y",
+	"RTS",
+};
+
+static routine_t routines[2];           // toDecimal, reciprocal
+static unsigned char image[0x10000];
+static cpu12_t cpu;
+static result_t results[MAX_CASES];
+static int resultCount;
+
+// The old printLCDNumber(), when an image was given
+static unsigned char oldImage[0x10000];
+static unsigned long oldNumber, oldWrite;
+static int haveOld;
+
+static const int values[] = {0, 7, 123, 4567, 32767, -1000, -32767};
+
+/************************************************
+*   readRoutine                                 *
+*                                               *
+*   Desc.: Collects the asm block of toDecimal  *
+*          from lcdformat.c. The host build's C *
+*          version under #else is skipped, as   *
+*          it comes after the block.            *
+*   Outputs: 0, or -1 on error                  *
+************************************************/
+
+static int readRoutine(const char *path, routine_t *r)
+{
+	char line[256], *p, *q;
+	int lineNumber = 0, inFunction = 0, inAsm = 0;
+	FILE *f = fopen(path, "r");
+
+	if (!f)
+	{
+		fprintf(stderr, "%s: cannot open\n", path);
+		return -1;
+	}
+	snprintf(r->name, sizeof(r->name), "toDecimal");
+	while (fgets(line, sizeof(line), f))
+	{
+		lineNumber++;
+		line[strcspn(line, "\r\n")] = '\0';
+		for (p = line; isspace((unsigned char)*p); p++)
+			;
+
+		if (!inFunction)
+		{
+			inFunction = strstr(p, "void toDecimal(") != NULL && strchr(p, '{') != NULL;
+			continue;
+		}
+		if (!inAsm)
+		{
+			if (strncmp(p, "asm", 3) == 0 && strchr(p, '{'))
+				inAsm = 1;
+			else if (*p == '}')
+				break;                  // end of the function without an asm block
+			continue;
+		}
+		if (*p == '}')
+			break;
+		if ((q = strstr(p, "//")) != NULL)
+			*q = '\0';
+		if (r->lineCount == MAX_LINES)
+		{
+			fprintf(stderr, "%s: %s is too long\n", path, r->name);
+			fclose(f);
+			return -1;
+		}
+		r->lineNumbers[r->lineCount] = lineNumber;
+		r->lines[r->lineCount++] = strdup(p);
+	}
+	fclose(f);
+	if (r->lineCount == 0)
+	{
+		fprintf(stderr, "%s: no asm block in toDecimal()\n", path);
+		return -1;
+	}
+	return 0;
+}
+
+static int assembleRoutines(const char *path)
+{
+	asm12_t as;
+	int pass, i, j;
+
+	asm12_init(&as, image);
+	for (pass = 1; pass <= 2; pass++)
+	{
+		asm12_pass(&as, pass, ROUTINE_ORIGIN);
+		for (i = 0; i < 2; i++)
+		{
+			routines[i].addr = as.pc;
+			asm12_scope(&as, routines[i].name);
+			as.file = i == 0 ? path : "lcdbench.c";
+			for (j = 0; j < routines[i].lineCount; j++)
+			{
+				as.line = routines[i].lineNumbers[j] - 1;
+				asm12_line(&as, routines[i].lines[j]);
+			}
+			routines[i].size = as.pc - routines[i].addr;
+		}
+	}
+	return as.errors ? -1 : 0;
+}
+
+static void loadOld(void *context, unsigned long addr, unsigned char value)
+{
+	(void)context;
+	if (addr < 0x10000)
+		oldImage[addr] = value;
+}
+
+/************************************************
+*   readOld                                     *
+*                                               *
+*   Desc.: Loads the image and finds            *
+*          printLCDNumber and writeLCDValue in  *
+*          its map. Both must be in unbanked    *
+*          flash.                               *
+*   Outputs: 0, or -1 on error                  *
+************************************************/
+
+static int readOld(const char *s19Path, const char *mapPath)
+{
+	map_file_t map;
+	const map_symbol_t *number, *write;
+
+	if (s19_load(s19Path, loadOld, NULL, NULL) < 0)
+		return -1;
+	if (map_load(mapPath, &map) < 0)
+	{
+		fprintf(stderr, "%s: cannot read\n", mapPath);
+		return -1;
+	}
+	number = map_find(&map, "printLCDNumber");
+	write = map_find(&map, "writeLCDValue");
+	if (!number || !write || number->addr > 0xFFFF || write->addr > 0xFFFF)
+	{
+		fprintf(stderr, "%s: printLCDNumber or writeLCDValue missing or banked\n", mapPath);
+		map_free(&map);
+		return -1;
+	}
+	oldNumber = number->addr;
+	oldWrite = write->addr;
+	map_free(&map);
+	haveOld = 1;
+	return 0;
+}
+
+static void resetBoard(const unsigned char *from)
+{
+	unsigned int addr;
+
+	cpu12_init(&cpu);
+	for (addr = 0x4000; addr < 0x8000; addr++)
+		cpu12_load(&cpu, addr, from[addr]);
+	for (addr = CPU12_WINDOW_END; addr <= 0xFFFF; addr++)
+		cpu12_load(&cpu, addr, from[addr]);
+	cpu.sp = STACK_TOP;
+	cpu.ccr = CCR_S | CCR_X | CCR_I;
+}
+
+static void push16(unsigned int value)
+{
+	cpu.sp = (cpu.sp - 2) & 0xFFFF;
+	cpu12_write16(&cpu, cpu.sp, value);
+}
+
+// Whether the instruction at the PC divides, so its cycles can be put aside
+static int isDivide(void)
+{
+	unsigned char op = cpu12_read8(&cpu, cpu.pc);
+
+	if (op == 0x11)
+		return 1;                       // EDIV
+	return op == 0x18 && (cpu12_read8(&cpu, cpu.pc + 1) == 0x10 || cpu12_read8(&cpu, cpu.pc + 1) == 0x15);
+}
+
+/************************************************
+*   call                                        *
+*                                               *
+*   Desc.: Runs "JSR addr" from RAM until it    *
+*          returns. With 'output', calls to     *
+*          writeLCDValue() are taken at entry:  *
+*          their character is appended and the  *
+*          return is made without running it.   *
+*   Outputs: Bus cycles, or 0 if the routine    *
+*            never came back                    *
+************************************************/
+
+static unsigned long call(unsigned int addr, unsigned long *divideCycles, char *output)
+{
+	unsigned int end = STUB_ADDR + 3;
+	unsigned long before;
+	int n = 0, divide;
+	long steps;
+
+	cpu.mem[STUB_ADDR] = 0x16;
+	cpu.mem[STUB_ADDR + 1] = (unsigned char)(addr >> 8);
+	cpu.mem[STUB_ADDR + 2] = (unsigned char)addr;
+	cpu.pc = STUB_ADDR;
+	cpu.cycles = 0;
+	*divideCycles = 0;
+	for (steps = 0; steps < MAX_STEPS && cpu.pc != end; steps++)
+	{
+		if (output && cpu.pc == oldWrite)
+		{
+			// writeLCDValue(char value, int type): type in D, value pushed as a byte above the return address
+			if (n < 15)
+				output[n++] = (char)cpu12_read8(&cpu, cpu.sp + 2);
+			cpu.pc = cpu12_read16(&cpu, cpu.sp);
+			cpu.sp += 2;
+			continue;
+		}
+		divide = isDivide();
+		before = cpu.cycles;
+		if (cpu12_step(&cpu) != CPU12_OK)
+			return 0;
+		if (divide)
+			*divideCycles += cpu.cycles - before;
+	}
+	if (output)
+		output[n] = '\0';
+	return cpu.pc == end ? (unsigned long)cpu.cycles : 0;
+}
+
+// The five digits toDecimal() should give
+static void expectedDigits(unsigned int value, char *digits)
+{
+	int i;
+
+	for (i = 4; i >= 0; i--)
+	{
+		digits[i] = (char)('0' + value % 10);
+		value /= 10;
+	}
+	digits[5] = '\0';
+}
+
+/************************************************
+*   convert                                     *
+*                                               *
+*   Desc.: One call of a conversion routine,    *
+*          toDecimal(value, digits): value      *
+*          pushed, digits in D                  *
+*   Outputs: Bus cycles; '*ok' is set if the    *
+*            digits, SP and the bytes around    *
+*            the digits are right               *
+************************************************/
+
+static unsigned long convert(const routine_t *r, unsigned int value, unsigned long *divideCycles, int *ok)
+{
+	char expected[6];
+	unsigned long cycles;
+	int i;
+
+	cpu.sp = STACK_TOP;
+	push16(value);
+	cpu12_set_d(&cpu, DIGITS_ADDR);
+	for (i = -1; i <= 5; i++)
+		cpu.mem[DIGITS_ADDR + i] = 0xEE;
+	cycles = call(r->addr, divideCycles, NULL);
+
+	expectedDigits(value, expected);
+	*ok = cycles != 0 && cpu.sp == STACK_TOP - 2 && cpu.mem[DIGITS_ADDR - 1] == 0xEE && cpu.mem[DIGITS_ADDR + 5] == 0xEE;
+	for (i = 0; i < 5; i++)
+		*ok = *ok && cpu.mem[DIGITS_ADDR + i] == (unsigned char)expected[i];
+	return cycles;
+}
+
+static void record(const char *routine, int value, unsigned long cycles, unsigned long divideCycles, int ok)
+{
+	result_t *r;
+
+	if (resultCount == MAX_CASES)
+		return;
+	r = &results[resultCount++];
+	snprintf(r->routine, sizeof(r->routine), "%s", routine);
+	r->value = value;
+	r->cycles = cycles;
+	r->divideCycles = divideCycles;
+	r->ok = ok && cycles != 0;
+}
+
+static void benchRoutine(const routine_t *r, int value)
+{
+	unsigned long cycles, divideCycles;
+	int ok;
+
+	resetBoard(image);
+	cycles = convert(r, value < 0 ? 0u - (unsigned int)value : (unsigned int)value, &divideCycles, &ok);
+	record(r->name, value, cycles, divideCycles, ok);
+}
+
+// The old printLCDNumber(int num): num in D. It writes the sign and then the five digits.
+static void benchOld(int value)
+{
+	char output[16], expected[8];
+	unsigned long cycles, divideCycles;
+
+	resetBoard(oldImage);
+	cpu12_set_d(&cpu, (unsigned int)value & 0xFFFF);
+	cycles = call((unsigned int)oldNumber, &divideCycles, output);
+	expected[0] = value < 0 ? '-' : '+';
+	expectedDigits(value < 0 ? 0u - (unsigned int)value : (unsigned int)value, expected + 1);
+	record("printLCDNumber", value, cycles, divideCycles, strcmp(output, expected) == 0 && cpu.sp == STACK_TOP);
+}
+
+// Every 16-bit value through one routine
+static int equivalence(const routine_t *r)
+{
+	unsigned long divideCycles;
+	long value;
+	int ok, failed = 0;
+
+	resetBoard(image);
+	for (value = 0; value <= 0xFFFF; value++)
+	{
+		convert(r, (unsigned int)value, &divideCycles, &ok);
+		if (!ok && failed++ < 10)
+			fprintf(stderr, "%s: wrong digits for %ld\n", r->name, value);
+	}
+	return failed;
+}
+
+static void listRoutines(void)
+{
+	cpu12_insn_t insn;
+	unsigned int addr;
+	int i;
+
+	resetBoard(image);
+	for (i = 0; i < 2; i++)
+	{
+		printf("%s: %u bytes at %04X\n", routines[i].name, routines[i].size, routines[i].addr);
+		for (addr = routines[i].addr; addr < routines[i].addr + routines[i].size; )
+		{
+			int length = cpu12_decode(&cpu, addr, &insn);
+			printf("    %04X  %-28s %2d cycles\n", addr, insn.text, insn.cycles);
+			addr += length > 0 ? (unsigned int)length : 1;
+		}
+	}
+	printf("\n");
+}
+
+static const result_t *findResult(const char *routine, int value)
+{
+	int i;
+
+	for (i = 0; i < resultCount; i++)
+		if (strcmp(results[i].routine, routine) == 0 && results[i].value == value)
+			return &results[i];
+	return NULL;
+}
+
+/************************************************
+*   compare                                     *
+*                                               *
+*   Desc.: Reads a CSV written by 'lcdbench -c' *
+*          and reports every case whose cycle   *
+*          count changed                        *
+*   Outputs: Number of cases that got slower or *
+*            stopped passing, -1 on error       *
+************************************************/
+
+static int compare(const char *path)
+{
+	char line[256], routine[ASM12_NAME_LEN], check[8];
+	unsigned long cycles, divideCycles;
+	int value, worse = 0, lineNumber = 0;
+	const result_t *r;
+	FILE *f = fopen(path, "r");
+
+	if (!f)
+	{
+		fprintf(stderr, "%s: cannot open\n", path);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f))
+	{
+		if (++lineNumber == 1)
+			continue;                   // header
+		if (sscanf(line, "%31[^,],%d,%lu,%lu,%7s", routine, &value, &cycles, &divideCycles, check) != 5)
+		{
+			fprintf(stderr, "%s:%d: not a lcdbench result\n", path, lineNumber);
+			fclose(f);
+			return -1;
+		}
+		r = findResult(routine, value);
+		if (!r)
+			continue;
+		if (r->cycles > cycles || (!r->ok && strcmp(check, "ok") == 0))
+		{
+			fprintf(stderr, "%s %d: %lu cycles, was %lu%s\n", routine, value, r->cycles, cycles, r->ok ? "" : ", check failed");
+			worse++;
+		}
+		else if (r->cycles < cycles)
+			fprintf(stderr, "%s %d: %lu cycles, was %lu (%.2fx faster)\n", routine, value, r->cycles, cycles,
+				(double)cycles / r->cycles);
+	}
+	fclose(f);
+	return worse;
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "usage: lcdbench [-s image.s19 -m image.map] [-c] [-r reference.csv] [-l] lcdformat.c\n");
+	exit(2);
+}
+
+int main(int argc, char **argv)
+{
+	const char *referencePath = NULL, *s19Path = NULL, *mapPath = NULL;
+	int opt, csv = 0, list = 0, failed = 0, i, j, worse = 0;
+
+	while ((opt = getopt(argc, argv, "s:m:cr:l")) != -1)
+	{
+		switch (opt)
+		{
+			case 's': s19Path = optarg; break;
+			case 'm': mapPath = optarg; break;
+			case 'c': csv = 1; break;
+			case 'r': referencePath = optarg; break;
+			case 'l': list = 1; break;
+			default: usage();
+		}
+	}
+	if (optind != argc - 1 || !s19Path != !mapPath)
+		usage();
+
+	routines[1].lineCount = (int)(sizeof(reciprocalSource) / sizeof(reciprocalSource[0]));
+	snprintf(routines[1].name, sizeof(routines[1].name), "reciprocal");
+	for (i = 0; i < routines[1].lineCount; i++)
+	{
+		routines[1].lines[i] = (char *)reciprocalSource[i];
+		routines[1].lineNumbers[i] = i + 1;
+	}
+	if (readRoutine(argv[optind], &routines[0]) < 0 || assembleRoutines(argv[optind]) < 0)
+		return 1;
+	if (s19Path && readOld(s19Path, mapPath) < 0)
+		return 1;
+	if (list)
+		listRoutines();
+
+	for (i = 0; i < (int)(sizeof(values) / sizeof(values[0])); i++)
+	{
+		if (haveOld)
+			benchOld(values[i]);
+		for (j = 0; j < 2; j++)
+			benchRoutine(&routines[j], values[i]);
+	}
+
+	if (csv)
+		printf("routine,value,cycles,divide_cycles,check\n");
+	else
+		printf("%-16s %7s %8s %8s  %s\n", "Routine", "Value", "Cycles", "Divides", "Check");
+	for (i = 0; i < resultCount; i++)
+	{
+		const result_t *r = &results[i];
+
+		if (csv)
+			printf("%s,%d,%lu,%lu,%s\n", r->routine, r->value, r->cycles, r->divideCycles, r->ok ? "ok" : "FAIL");
+		else
+			printf("%-16s %7d %8lu %8lu  %s\n", r->routine, r->value, r->cycles, r->divideCycles, r->ok ? "ok" : "FAIL");
+		failed += !r->ok;
+	}
+
+	for (j = 0; j < 2; j++)
+		failed += equivalence(&routines[j]);
+	if (!csv)
+		printf("\nAll 65536 values checked through toDecimal and reciprocal\n");
+
+	if (referencePath)
+	{
+		worse = compare(referencePath);
+		if (worse < 0)
+			return 1;
+	}
+	return failed || worse ? 1 : 0;
+}
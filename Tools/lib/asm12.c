@@ -0,0 +1,702 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    asm12.c                                        *
+*          Small two-pass CPU12 assembler                 *
+*---------------------------------------------------------*
+* Encodings follow "MIE438 - CPU12RM.pdf", Appendix A.    *
+* Pass 1 only sizes instructions; a symbol that is not    *
+* yet defined is taken as a 16-bit address, so forward    *
+* references never shrink an instruction on pass 2.       *
+**********************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include "asm12.h"
+
+#define NONE    -1
+
+// Instructions with immediate, direct, extended and indexed forms
+typedef struct general
+{
+	const char *name;
+	int imm, dir, ext, idx;
+	int immSize;
+} general_t;
+
+static const general_t generals[] =
+{
+	{"LDAA", 0x86, 0x96, 0xB6, 0xA6, 1}, {"LDAB", 0xC6, 0xD6, 0xF6, 0xE6, 1},
+	{"LDD",  0xCC, 0xDC, 0xFC, 0xEC, 2}, {"LDX",  0xCE, 0xDE, 0xFE, 0xEE, 2},
+	{"LDY",  0xCD, 0xDD, 0xFD, 0xED, 2}, {"LDS",  0xCF, 0xDF, 0xFF, 0xEF, 2},
+	{"STAA", NONE, 0x5A, 0x7A, 0x6A, 0}, {"STAB", NONE, 0x5B, 0x7B, 0x6B, 0},
+	{"STD",  NONE, 0x5C, 0x7C, 0x6C, 0}, {"STX",  NONE, 0x5E, 0x7E, 0x6E, 0},
+	{"STY",  NONE, 0x5D, 0x7D, 0x6D, 0}, {"STS",  NONE, 0x5F, 0x7F, 0x6F, 0},
+	{"ADDA", 0x8B, 0x9B, 0xBB, 0xAB, 1}, {"ADDB", 0xCB, 0xDB, 0xFB, 0xEB, 1},
+	{"ADDD", 0xC3, 0xD3, 0xF3, 0xE3, 2}, {"SUBA", 0x80, 0x90, 0xB0, 0xA0, 1},
+	{"SUBB", 0xC0, 0xD0, 0xF0, 0xE0, 1}, {"SUBD", 0x83, 0x93, 0xB3, 0xA3, 2},
+	{"ADCA", 0x89, 0x99, 0xB9, 0xA9, 1}, {"ADCB", 0xC9, 0xD9, 0xF9, 0xE9, 1},
+	{"SBCA", 0x82, 0x92, 0xB2, 0xA2, 1}, {"SBCB", 0xC2, 0xD2, 0xF2, 0xE2, 1},
+	{"ANDA", 0x84, 0x94, 0xB4, 0xA4, 1}, {"ANDB", 0xC4, 0xD4, 0xF4, 0xE4, 1},
+	{"ORAA", 0x8A, 0x9A, 0xBA, 0xAA, 1}, {"ORAB", 0xCA, 0xDA, 0xFA, 0xEA, 1},
+	{"EORA", 0x88, 0x98, 0xB8, 0xA8, 1}, {"EORB", 0xC8, 0xD8, 0xF8, 0xE8, 1},
+	{"CMPA", 0x81, 0x91, 0xB1, 0xA1, 1}, {"CMPB", 0xC1, 0xD1, 0xF1, 0xE1, 1},
+	{"CPD",  0x8C, 0x9C, 0xBC, 0xAC, 2}, {"CPX",  0x8E, 0x9E, 0xBE, 0xAE, 2},
+	{"CPY",  0x8D, 0x9D, 0xBD, 0xAD, 2}, {"CPS",  0x8F, 0x9F, 0xBF, 0xAF, 2},
+	{"BITA", 0x85, 0x95, 0xB5, 0xA5, 1}, {"BITB", 0xC5, 0xD5, 0xF5, 0xE5, 1},
+	{"JSR",  NONE, 0x17, 0x16, 0x15, 0}, {"JMP",  NONE, NONE, 0x06, 0x05, 0},
+	{"CLR",  NONE, NONE, 0x79, 0x69, 0}, {"INC",  NONE, NONE, 0x72, 0x62, 0},
+	{"DEC",  NONE, NONE, 0x73, 0x63, 0}, {"TST",  NONE, NONE, 0xF7, 0xE7, 0},
+	{"NEG",  NONE, NONE, 0x70, 0x60, 0}, {"COM",  NONE, NONE, 0x71, 0x61, 0},
+	{"LEAX", NONE, NONE, NONE, 0x1A, 0}, {"LEAY", NONE, NONE, NONE, 0x19, 0},
+	{"LEAS", NONE, NONE, NONE, 0x1B, 0},
+};
+
+typedef struct inherent
+{
+	const char *name;
+	int opcode;                         // a 0x18 prefix is in bits 8-15
+} inherent_t;
+
+static const inherent_t inherents[] =
+{
+	{"PSHA", 0x36}, {"PSHB", 0x37}, {"PSHC", 0x39}, {"PSHD", 0x3B}, {"PSHX", 0x34}, {"PSHY", 0x35},
+	{"PULA", 0x32}, {"PULB", 0x33}, {"PULC", 0x38}, {"PULD", 0x3A}, {"PULX", 0x30}, {"PULY", 0x31},
+	{"INX", 0x08}, {"DEX", 0x09}, {"INY", 0x02}, {"DEY", 0x03},
+	{"INCA", 0x42}, {"INCB", 0x52}, {"DECA", 0x43}, {"DECB", 0x53}, {"CLRA", 0x87}, {"CLRB", 0xC7},
+	{"NEGA", 0x40}, {"NEGB", 0x50}, {"COMA", 0x41}, {"COMB", 0x51},
+	{"TSTA", 0x97}, {"TSTB", 0xD7}, {"ABX", 0x1AE5}, {"ABY", 0x19ED}, {"ABA", 0x1806},
+	{"RTS", 0x3D}, {"RTI", 0x0B}, {"NOP", 0xA7}, {"BGND", 0x00}, {"SWI", 0x3F}, {"WAI", 0x3E},
+	{"SEI", 0x1410}, {"CLI", 0x10EF}, {"SEC", 0x1401}, {"CLC", 0x10FE},
+	{"TAB", 0x180E}, {"TBA", 0x180F}, {"CBA", 0x1817}, {"MUL", 0x12}, {"EMUL", 0x13},
+	{"IDIV", 0x1810}, {"FDIV", 0x1811}, {"IDIVS", 0x1815}, {"EDIV", 0x11}, {"SBA", 0x1816},
+	{"EMULS", 0x1813}, {"EDIVS", 0x1814},
+	{"LSLD", 0x59}, {"LSRD", 0x49}, {"ASLD", 0x59}, {"LSRA", 0x44}, {"LSRB", 0x54}, {"LSLA", 0x48}, {"LSLB", 0x58},
+	{"ASLA", 0x48}, {"ASLB", 0x58}, {"ASRA", 0x47}, {"ASRB", 0x57}, {"ROLA", 0x45}, {"ROLB", 0x55},
+	{"RORA", 0x46}, {"RORB", 0x56},
+};
+
+// Short branches; the long forms are 0x18 followed by the same opcode
+static const struct { const char *name; int opcode; } branches[] =
+{
+	{"BRA", 0x20}, {"BRN", 0x21}, {"BHI", 0x22}, {"BLS", 0x23}, {"BCC", 0x24}, {"BHS", 0x24},
+	{"BCS", 0x25}, {"BLO", 0x25}, {"BNE", 0x26}, {"BEQ", 0x27}, {"BVC", 0x28}, {"BVS", 0x29},
+	{"BPL", 0x2A}, {"BMI", 0x2B}, {"BGE", 0x2C}, {"BLT", 0x2D}, {"BGT", 0x2E}, {"BLE", 0x2F},
+	{"BSR", 0x07},
+};
+
+// DBEQ etc.: 0x04, a postbyte with the kind in bits 5-7, and an offset
+static const struct { const char *name; int kind; } loops[] =
+{
+	{"DBEQ", 0x00}, {"DBNE", 0x20}, {"TBEQ", 0x40}, {"TBNE", 0x60}, {"IBEQ", 0x80}, {"IBNE", 0xA0},
+};
+
+static const char *registerNames[] = {"A", "B", "CCR", "", "D", "X", "Y", "SP"};
+
+static int error(asm12_t *as, const char *format, ...)
+{
+	va_list args;
+
+	if (as->pass == 2)
+	{
+		fprintf(stderr, "%s:%d: ", as->file ? as->file : "asm", as->line);
+		va_start(args, format);
+		vfprintf(stderr, format, args);
+		va_end(args);
+		fputc('\n', stderr);
+		as->errors++;
+	}
+	return -1;
+}
+
+void asm12_init(asm12_t *as, unsigned char *image)
+{
+	memset(as, 0, sizeof(*as));
+	as->image = image;
+}
+
+void asm12_pass(asm12_t *as, int pass, unsigned int origin)
+{
+	as->pass = pass;
+	as->pc = origin;
+	as->scope = 0;
+	as->scopeCount = 0;
+}
+
+static asm12_symbol_t *findSymbol(asm12_t *as, const char *name, int scope)
+{
+	int i;
+
+	for (i = 0; i < as->symbolCount; i++)
+		if (as->symbols[i].scope == scope && strcasecmp(as->symbols[i].name, name) == 0)
+			return &as->symbols[i];
+	return NULL;
+}
+
+static void defineIn(asm12_t *as, const char *name, unsigned int value, int scope)
+{
+	asm12_symbol_t *s = findSymbol(as, name, scope);
+
+	if (!s)
+	{
+		if (as->symbolCount == ASM12_MAX_SYMBOLS || strlen(name) >= ASM12_NAME_LEN)
+		{
+			error(as, "cannot define %s", name);
+			return;
+		}
+		s = &as->symbols[as->symbolCount++];
+		strcpy(s->name, name);
+		s->scope = scope;
+	}
+	else if (as->pass == 2 && s->value != value && scope != 0)
+		error(as, "%s moved between passes", name);
+	s->value = value;
+}
+
+void asm12_define(asm12_t *as, const char *name, unsigned int value)
+{
+	defineIn(as, name, value, 0);
+}
+
+int asm12_lookup(const asm12_t *as, const char *name, unsigned int *value)
+{
+	const asm12_symbol_t *s = findSymbol((asm12_t *)as, name, as->scope);
+
+	if (!s && as->scope != 0)
+		s = findSymbol((asm12_t *)as, name, 0);
+	if (!s)
+		return 0;
+	*value = s->value;
+	return 1;
+}
+
+void asm12_scope(asm12_t *as, const char *name)
+{
+	as->scope = ++as->scopeCount;
+	defineIn(as, name, as->pc, 0);
+}
+
+static void emit(asm12_t *as, int value)
+{
+	if (as->pass == 2)
+		as->image[as->pc & 0xFFFF] = (unsigned char)value;
+	as->pc++;
+}
+
+static void emit16(asm12_t *as, unsigned int value)
+{
+	emit(as, (value >> 8) & 0xFF);
+	emit(as, value & 0xFF);
+}
+
+static char *trim(char *s)
+{
+	char *end;
+
+	while (isspace((unsigned char)*s))
+		s++;
+	end = s + strlen(s);
+	while (end > s && isspace((unsigned char)end[-1]))
+		*--end = '\0';
+	return s;
+}
+
+static int isSymbolChar(int c)
+{
+	return isalnum(c) || c == '_' || c == '.';
+}
+
+/************************************************
+*   evaluate                                    *
+*                                               *
+*   Desc.: Sums numbers and symbols joined by   *
+*          + and -. Numbers are decimal, 0x..   *
+*          or $.. hexadecimal.                  *
+*   Outputs: 0 if valid, -1 if not. '*known' is *
+*            cleared for an undefined symbol on *
+*            pass 1.                            *
+************************************************/
+
+static int evaluate(asm12_t *as, const char *text, long *value, int *known)
+{
+	const char *p = text;
+	char name[ASM12_NAME_LEN];
+	unsigned int symbol;
+	long sum = 0, term;
+	int sign = 1, n;
+
+	*known = 1;
+	for (;;)
+	{
+		while (isspace((unsigned char)*p))
+			p++;
+		if (*p == '-')
+		{
+			sign = -sign;
+			p++;
+			continue;
+		}
+		if (*p == '+')
+		{
+			p++;
+			continue;
+		}
+		if (*p == '$')
+			term = strtol(p + 1, (char **)&p, 16);
+		else if (isdigit((unsigned char)*p))
+			term = strtol(p, (char **)&p, 0);
+		else if (isSymbolChar((unsigned char)*p))
+		{
+			for (n = 0; isSymbolChar((unsigned char)*p); p++)
+				if (n < ASM12_NAME_LEN - 1)
+					name[n++] = *p;
+			name[n] = '\0';
+			if (asm12_lookup(as, name, &symbol))
+				term = symbol;
+			else if (as->pass == 1)
+			{
+				term = 0;
+				*known = 0;
+			}
+			else
+				return error(as, "undefined symbol %s", name);
+		}
+		else
+			return error(as, "bad expression '%s'", text);
+		sum += sign * term;
+		sign = 1;
+
+		while (isspace((unsigned char)*p))
+			p++;
+		if (*p == '\0')
+			break;
+		if (*p != '+' && *p != '-')
+			return error(as, "bad expression '%s'", text);
+	}
+	*value = sum;
+	return 0;
+}
+
+static int registerNumber(const char *name)
+{
+	int i;
+
+	for (i = 0; i < 8; i++)
+		if (registerNames[i][0] && strcmp(name, registerNames[i]) == 0)
+			return i;
+	return -1;
+}
+
+// X, Y, SP, PC as the rr field of an indexed postbyte
+static int indexRegister(const char *name)
+{
+	static const char *names[] = {"X", "Y", "SP", "PC"};
+	int i;
+
+	for (i = 0; i < 4; i++)
+		if (strcmp(name, names[i]) == 0)
+			return i;
+	return -1;
+}
+
+// Whether 'text' names an index register, possibly with auto increment/decrement
+static int isIndexSpec(const char *text)
+{
+	char name[8];
+	size_t n;
+
+	while (*text == '+' || *text == '-')
+		text++;
+	n = strspn(text, "XYSPC");
+	if (n == 0 || n >= sizeof(name))
+		return 0;
+	memcpy(name, text, n);
+	name[n] = '\0';
+	text += n;
+	while (*text == '+' || *text == '-')
+		text++;
+	return *text == '\0' && indexRegister(name) >= 0;
+}
+
+/************************************************
+*   encodeIndexed                               *
+*                                               *
+*   Desc.: Builds the postbyte and offset bytes *
+*          of an indexed operand 'offset,spec', *
+*          e.g. "2,SP", "1,X+", "D,Y", ",X".    *
+*   Inputs:  shortOnly - 1 for MOVB/MOVW, which *
+*            take no 9 or 16-bit offsets        *
+*   Outputs: Number of bytes in 'out', or -1    *
+************************************************/
+
+static int encodeIndexed(asm12_t *as, const char *offsetText, const char *spec, int shortOnly, unsigned char *out)
+{
+	char name[8];
+	const char *p = spec;
+	int pre = 0, post = 0, rr, acc, known;
+	size_t n;
+	long offset = 0;
+
+	if (*p == '+' || *p == '-')
+		pre = *p++;
+	n = strspn(p, "XYSPC");
+	if (n == 0 || n >= sizeof(name))
+		return error(as, "bad index register '%s'", spec);
+	memcpy(name, p, n);
+	name[n] = '\0';
+	if (p[n] == '+' || p[n] == '-')
+		post = p[n];
+	rr = indexRegister(name);
+	if (rr < 0)
+		return error(as, "bad index register '%s'", spec);
+
+	acc = (strcmp(offsetText, "A") == 0) ? 0 : (strcmp(offsetText, "B") == 0) ? 1 : (strcmp(offsetText, "D") == 0) ? 2 : -1;
+	if (acc >= 0)
+	{
+		if (pre || post)
+			return error(as, "accumulator offset with auto increment");
+		out[0] = (unsigned char)(0xE4 | (rr << 3) | acc);
+		return 1;
+	}
+
+	if (*offsetText && evaluate(as, offsetText, &offset, &known) < 0)
+		return -1;
+
+	if (pre || post)
+	{
+		if (rr == 3 || offset < 1 || offset > 8)
+			return error(as, "auto increment/decrement must be 1 to 8 on X, Y or SP");
+		if ((pre ? pre : post) == '-')
+			offset = -offset;
+		out[0] = (unsigned char)((rr << 6) | 0x20 | (post ? 0x10 : 0) | (offset > 0 ? offset - 1 : offset & 0x0F));
+		return 1;
+	}
+	if (offset >= -16 && offset <= 15)
+	{
+		out[0] = (unsigned char)((rr << 6) | (offset & 0x1F));
+		return 1;
+	}
+	if (shortOnly)
+		return error(as, "offset %ld too large for MOVB/MOVW", offset);
+	if (offset >= -256 && offset <= 255)
+	{
+		out[0] = (unsigned char)(0xE0 | (rr << 3) | (offset < 0 ? 1 : 0));
+		out[1] = (unsigned char)(offset & 0xFF);
+		return 2;
+	}
+	out[0] = (unsigned char)(0xE2 | (rr << 3));
+	out[1] = (unsigned char)((offset >> 8) & 0xFF);
+	out[2] = (unsigned char)(offset & 0xFF);
+	return 3;
+}
+
+// Splits operands at commas, upper-casing and trimming each one
+static int splitOperands(char *text, char **parts, int max)
+{
+	int n = 0;
+	char *p;
+
+	for (p = text; *p; p++)
+		*p = (char)toupper((unsigned char)*p);
+	if (*trim(text) == '\0')
+		return 0;
+	for (;;)
+	{
+		char *comma = strchr(text, ',');
+		if (n == max)
+			return -1;
+		if (comma)
+			*comma = '\0';
+		parts[n++] = trim(text);
+		if (!comma)
+			return n;
+		text = comma + 1;
+	}
+}
+
+static int branchOffset(asm12_t *as, const char *target, unsigned int next, long min, long max, long *offset)
+{
+	long value;
+	int known;
+
+	if (evaluate(as, target, &value, &known) < 0)
+		return -1;
+	*offset = known ? value - (long)next : 0;
+	if (as->pass == 2 && (*offset < min || *offset > max))
+		return error(as, "branch to %s out of range", target);
+	return 0;
+}
+
+/************************************************
+*   moveOperand                                 *
+*                                               *
+*   Desc.: Reads one side of MOVB/MOVW from the *
+*          operand list                         *
+*   Outputs: 0 immediate, 1 extended, 2         *
+*            indexed, -1 on error. Advances     *
+*            '*i' past the tokens used.         *
+************************************************/
+
+static int moveOperand(asm12_t *as, char **parts, int count, int *i, long *value, unsigned char *xb)
+{
+	int known;
+
+	if (*i >= count)
+		return error(as, "missing MOVB/MOVW operand");
+	if (parts[*i][0] == '#')
+	{
+		if (evaluate(as, parts[*i] + 1, value, &known) < 0)
+			return -1;
+		(*i)++;
+		return 0;
+	}
+	if (*i + 1 < count && isIndexSpec(parts[*i + 1]))
+	{
+		if (encodeIndexed(as, parts[*i], parts[*i + 1], 1, xb) < 0)
+			return -1;
+		*i += 2;
+		return 2;
+	}
+	if (evaluate(as, parts[*i], value, &known) < 0)
+		return -1;
+	(*i)++;
+	return 1;
+}
+
+static int assembleMove(asm12_t *as, int word, char **parts, int count)
+{
+	// Opcode after 0x18 by [source][destination] mode, immediate/extended/indexed
+	static const int movb[2][3] = {{NONE, 0x0B, 0x08}, {NONE, 0x0C, 0x09}};
+	static const int movw[2][3] = {{NONE, 0x03, 0x00}, {NONE, 0x04, 0x01}};
+	unsigned char srcXb, dstXb;
+	long src = 0, dst = 0;
+	int i = 0, from, to, opcode;
+
+	from = moveOperand(as, parts, count, &i, &src, &srcXb);
+	if (from < 0)
+		return -1;
+	to = moveOperand(as, parts, count, &i, &dst, &dstXb);
+	if (to < 0)
+		return -1;
+	if (i != count || to == 0)
+		return error(as, "bad MOVB/MOVW operands");
+
+	if (from == 2)
+		opcode = word ? (to == 1 ? 0x05 : 0x02) : (to == 1 ? 0x0D : 0x0A);
+	else
+		opcode = word ? movw[from][to] : movb[from][to];
+
+	emit(as, 0x18);
+	emit(as, opcode);
+	// The destination postbyte comes first when only the destination is indexed
+	if (to == 2 && from != 2)
+		emit(as, dstXb);
+	if (from == 0 && word)
+		emit16(as, (unsigned int)src);
+	else if (from == 0)
+		emit(as, (int)(src & 0xFF));
+	else if (from == 1)
+		emit16(as, (unsigned int)src);
+	else
+		emit(as, srcXb);
+	if (to == 1)
+		emit16(as, (unsigned int)dst);
+	else if (from == 2)
+		emit(as, dstXb);
+	return 0;
+}
+
+static int assembleGeneral(asm12_t *as, const general_t *g, char **parts, int count)
+{
+	unsigned char xb[3];
+	long value;
+	int known, n, i;
+
+	if (count == 1 && parts[0][0] == '#')
+	{
+		if (g->imm == NONE)
+			return error(as, "%s has no immediate mode", g->name);
+		if (evaluate(as, parts[0] + 1, &value, &known) < 0)
+			return -1;
+		emit(as, g->imm);
+		if (g->immSize == 2)
+			emit16(as, (unsigned int)value);
+		else
+			emit(as, (int)(value & 0xFF));
+		return 0;
+	}
+	if (count == 2)
+	{
+		if (g->idx == NONE)
+			return error(as, "%s has no indexed mode", g->name);
+		n = encodeIndexed(as, parts[0], parts[1], 0, xb);
+		if (n < 0)
+			return -1;
+		emit(as, g->idx);
+		for (i = 0; i < n; i++)
+			emit(as, xb[i]);
+		return 0;
+	}
+	if (count != 1)
+		return error(as, "bad operands for %s", g->name);
+	if (evaluate(as, parts[0], &value, &known) < 0)
+		return -1;
+	if (known && value >= 0 && value < 0x100 && g->dir != NONE)
+	{
+		emit(as, g->dir);
+		emit(as, (int)value);
+	}
+	else if (g->ext != NONE)
+	{
+		emit(as, g->ext);
+		emit16(as, (unsigned int)value);
+	}
+	else
+		return error(as, "%s has no extended mode", g->name);
+	return 0;
+}
+
+static int assembleTransfer(asm12_t *as, int exchange, char **parts, int count)
+{
+	int from, to;
+
+	if (count != 2)
+		return error(as, "TFR/EXG take two registers");
+	from = registerNumber(parts[0]);
+	to = registerNumber(parts[1]);
+	if (from < 0 || to < 0)
+		return error(as, "bad register in TFR/EXG");
+	emit(as, 0xB7);
+	emit(as, (exchange ? 0x80 : 0) | (from << 4) | to);
+	return 0;
+}
+
+static int assembleLoop(asm12_t *as, int kind, char **parts, int count)
+{
+	long offset;
+	int reg;
+
+	if (count != 2)
+		return error(as, "loop primitives take a register and a label");
+	reg = registerNumber(parts[0]);
+	if (reg < 0 || reg == 2 || reg == 3)
+		return error(as, "bad loop register %s", parts[0]);
+	if (branchOffset(as, parts[1], as->pc + 3, -256, 255, &offset) < 0)
+		return -1;
+	emit(as, 0x04);
+	emit(as, kind | (offset < 0 ? 0x10 : 0) | reg);
+	emit(as, (int)(offset & 0xFF));
+	return 0;
+}
+
+static int assembleData(asm12_t *as, int word, char **parts, int count)
+{
+	long value;
+	int known, i;
+
+	for (i = 0; i < count; i++)
+	{
+		if (evaluate(as, parts[i], &value, &known) < 0)
+			return -1;
+		if (word)
+			emit16(as, (unsigned int)value);
+		else
+			emit(as, (int)(value & 0xFF));
+	}
+	return 0;
+}
+
+int asm12_line(asm12_t *as, const char *text)
+{
+	char buffer[256], mnemonic[16], *line, *p, *parts[8];
+	unsigned int start = as->pc;
+	size_t n;
+	long offset;
+	int count, i, status = -1;
+
+	as->line++;
+	strncpy(buffer, text, sizeof(buffer) - 1);
+	buffer[sizeof(buffer) - 1] = '\0';
+	if ((p = strchr(buffer, ';')) != NULL)
+		*p = '\0';
+	line = trim(buffer);
+
+	// Label
+	for (p = line; isSymbolChar((unsigned char)*p); p++)
+		;
+	if (*p == ':' && p > line)
+	{
+		*p = '\0';
+		defineIn(as, line, as->pc, as->scope);
+		line = trim(p + 1);
+	}
+	if (*line == '\0')
+		return 0;
+
+	n = strcspn(line, " \t");
+	if (n >= sizeof(mnemonic))
+		return error(as, "bad mnemonic '%s'", line);
+	for (i = 0; i < (int)n; i++)
+		mnemonic[i] = (char)toupper((unsigned char)line[i]);
+	mnemonic[n] = '\0';
+	count = splitOperands(line + n, parts, 8);
+	if (count < 0)
+		return error(as, "too many operands");
+
+	if (strcmp(mnemonic, "MOVB") == 0 || strcmp(mnemonic, "MOVW") == 0)
+		status = assembleMove(as, mnemonic[3] == 'W', parts, count);
+	else if (strcmp(mnemonic, "TFR") == 0 || strcmp(mnemonic, "EXG") == 0 || strcmp(mnemonic, "SEX") == 0)
+		status = assembleTransfer(as, mnemonic[0] == 'E', parts, count);
+	else if (strcmp(mnemonic, "DC.B") == 0 || strcmp(mnemonic, "DC.W") == 0)
+		status = assembleData(as, mnemonic[3] == 'W', parts, count);
+	else
+	{
+		for (i = 0; i < (int)(sizeof(inherents) / sizeof(inherents[0])); i++)
+			if (strcmp(mnemonic, inherents[i].name) == 0)
+			{
+				if (count != 0)
+					return error(as, "%s takes no operands", mnemonic);
+				if (inherents[i].opcode > 0xFF)
+					emit(as, inherents[i].opcode >> 8);
+				emit(as, inherents[i].opcode & 0xFF);
+				return (int)(as->pc - start);
+			}
+		for (i = 0; i < (int)(sizeof(branches) / sizeof(branches[0])); i++)
+		{
+			int isLong = mnemonic[0] == 'L' && strcmp(mnemonic + 1, branches[i].name) == 0 && branches[i].opcode != 0x07;
+
+			if (!isLong && strcmp(mnemonic, branches[i].name) != 0)
+				continue;
+			if (count != 1)
+				return error(as, "%s takes one label", mnemonic);
+			if (isLong)
+			{
+				if (branchOffset(as, parts[0], as->pc + 4, -32768, 32767, &offset) < 0)
+					return -1;
+				emit(as, 0x18);
+				emit(as, branches[i].opcode);
+				emit16(as, (unsigned int)(offset & 0xFFFF));
+			}
+			else
+			{
+				if (branchOffset(as, parts[0], as->pc + 2, -128, 127, &offset) < 0)
+					return -1;
+				emit(as, branches[i].opcode);
+				emit(as, (int)(offset & 0xFF));
+			}
+			return (int)(as->pc - start);
+		}
+		for (i = 0; i < (int)(sizeof(loops) / sizeof(loops[0])); i++)
+			if (strcmp(mnemonic, loops[i].name) == 0)
+				return assembleLoop(as, loops[i].kind, parts, count) < 0 ? -1 : (int)(as->pc - start);
+		for (i = 0; i < (int)(sizeof(generals) / sizeof(generals[0])); i++)
+			if (strcmp(mnemonic, generals[i].name) == 0)
+				return assembleGeneral(as, &generals[i], parts, count) < 0 ? -1 : (int)(as->pc - start);
+		return error(as, "unsupported instruction %s", mnemonic);
+	}
+	return status < 0 ? -1 : (int)(as->pc - start);
+}
@@ -0,0 +1,63 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    asm12.h                                        *
+*          Small two-pass CPU12 assembler                 *
+*---------------------------------------------------------*
+* Covers the instructions CodeWarrior's runtime helpers   *
+* use in their inline asm: loads, stores, arithmetic and  *
+* compares with carry, multiplies and divides (including  *
+* EMULS/EDIVS), negates, shifts and rotates, pushes and   *
+* pulls, branches and loop primitives, MOVB/MOVW,         *
+* TFR/EXG/SEX, LEAx, JMP/JSR, and DC.B/DC.W. Addresses    *
+* below 0x100 use direct mode, as the CodeWarrior         *
+* assembler does. Nothing is case sensitive, and comments *
+* start at ';'.                                           *
+**********************************************************/
+
+#ifndef _ASM12_H
+#define _ASM12_H
+
+#define ASM12_MAX_SYMBOLS   256
+#define ASM12_NAME_LEN      32
+
+typedef struct asm12_symbol
+{
+	char name[ASM12_NAME_LEN];
+	unsigned int value;
+	int scope;                          // 0 for global symbols, else the asm12_scope() it was defined in
+} asm12_symbol_t;
+
+typedef struct asm12
+{
+	unsigned char *image;               // 64K, written on the second pass only
+	unsigned int pc;
+	int pass;                           // 1 or 2
+	int scope;
+	int scopeCount;
+	asm12_symbol_t symbols[ASM12_MAX_SYMBOLS];
+	int symbolCount;
+	int errors;
+	const char *file;                   // for error messages
+	int line;                           // counted up by asm12_line()
+} asm12_t;
+
+// Starts an assembler writing into 'image' (0x10000 bytes)
+void asm12_init(asm12_t *as, unsigned char *image);
+
+// Starts a pass at 'origin'. Run every line through pass 1, then through pass 2.
+void asm12_pass(asm12_t *as, int pass, unsigned int origin);
+
+// Defines a global symbol, e.g. a register address or a function entry point
+void asm12_define(asm12_t *as, const char *name, unsigned int value);
+
+// Looks a symbol up in the current scope, then globally. Returns 0 if it is not defined.
+int asm12_lookup(const asm12_t *as, const char *name, unsigned int *value);
+
+// Starts a new scope for labels, e.g. one per asm block, and defines 'name' globally at the current address
+void asm12_scope(asm12_t *as, const char *name);
+
+// Assembles one line. Returns the number of bytes emitted, or -1 after reporting an error on stderr.
+int asm12_line(asm12_t *as, const char *text);
+
+#endif
@@ -0,0 +1,232 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    mapfile.c                                      *
+*          Reader for SmartLinker .map files              *
+**********************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "mapfile.h"
+
+#define PART_NONE       0
+#define PART_SECTIONS   1
+#define PART_OBJECTS    2
+#define PART_MODULES    3
+#define PART_VECTORS    4
+
+static void copyName(char *dst, const char *src)
+{
+	snprintf(dst, MAP_NAME_LEN, "%s", src);
+}
+
+// Parses a hexadecimal address, accepting "0xC000", "C000" and banked "30'8000"
+static int parseHex(const char *s, unsigned long *value)
+{
+	char digits[32];
+	int n = 0;
+
+	if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X'))
+		s += 2;
+	for (; *s && n < (int)sizeof(digits) - 1; s++)
+		if (*s != '\'')
+			digits[n++] = *s;
+	digits[n] = 0;
+	if (n == 0 || !isxdigit((unsigned char)digits[0]))
+		return 0;
+	*value = strtoul(digits, NULL, 16);
+	return 1;
+}
+
+static void *grow(void *array, int count, int *capacity, size_t size)
+{
+	if (count < *capacity)
+		return array;
+	*capacity = *capacity ? *capacity * 2 : 64;
+	return realloc(array, (size_t)*capacity * size);
+}
+
+int map_load(const char *path, map_file_t *map)
+{
+	FILE *f = fopen(path, "r");
+	char line[512], module[MAP_NAME_LEN] = "";
+	int part = PART_NONE, kind = MAP_PROCEDURE;
+	int symbolCap = 0, sectionCap = 0, moduleCap = 0, vectorCap = 0;
+
+	memset(map, 0, sizeof(*map));
+	if (!f)
+	{
+		fprintf(stderr, "%s: cannot open\n", path);
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), f))
+	{
+		char a[MAP_NAME_LEN], b[MAP_NAME_LEN], c[MAP_NAME_LEN], d[MAP_NAME_LEN], e[MAP_NAME_LEN], g[MAP_NAME_LEN];
+		char *p;
+		int n;
+
+		line[strcspn(line, "\r\n")] = 0;
+		if (strncmp(line, "SECTION-ALLOCATION SECTION", 26) == 0)
+			part = PART_SECTIONS;
+		else if (strncmp(line, "OBJECT-ALLOCATION SECTION", 25) == 0)
+			part = PART_OBJECTS;
+		else if (strncmp(line, "MODULE STATISTIC", 16) == 0)
+			part = PART_MODULES;
+		else if (strncmp(line, "VECTOR-ALLOCATION SECTION", 25) == 0)
+			part = PART_VECTORS;
+		else if (line[0] >= 'A' && line[0] <= 'Z' && strstr(line, " SECTION"))
+			part = PART_NONE;               // any other top level part of the map
+		else if (strncmp(line, "Entry point:", 12) == 0)
+			parseHex(line + 13, &map->entry);
+		if (line[0] == '*' || line[0] == '-')
+			continue;
+
+		switch (part)
+		{
+			case PART_SECTIONS:
+			{
+				map_section_t *s;
+				unsigned long size;
+				n = sscanf(line, "%63s %lu %7s %63s %63s %63s", a, &size, b, c, d, e);
+				// Most names start with a dot, but the runtime library links into "RUNTIME"
+				if (n != 6 || a[0] == '-' || (strcmp(b, "R") != 0 && strcmp(b, "R/W") != 0 && strcmp(b, "N/I") != 0))
+					break;
+				map->sections = grow(map->sections, map->sectionCount, &sectionCap, sizeof(*map->sections));
+				s = &map->sections[map->sectionCount++];
+				copyName(s->name, a);
+				copyName(s->segment, e);
+				snprintf(s->type, sizeof(s->type), "%s", b);
+				s->size = size;
+				parseHex(c, &s->from);
+				parseHex(d, &s->to);
+				break;
+			}
+
+			case PART_VECTORS:
+			{
+				map_vector_t *v;
+				// Address InitValue InitFunction
+				n = sscanf(line, "%63s %63s %63s", a, b, c);
+				if (n != 3 || strncmp(a, "0x", 2) != 0)
+					break;
+				map->vectors = grow(map->vectors, map->vectorCount, &vectorCap, sizeof(*map->vectors));
+				v = &map->vectors[map->vectorCount];
+				if (!parseHex(a, &v->addr) || !parseHex(b, &v->value))
+					break;
+				copyName(v->name, c);
+				map->vectorCount++;
+				break;
+			}
+
+			case PART_OBJECTS:
+			{
+				map_symbol_t *s;
+				int refs;
+				if (strncmp(line, "MODULE:", 7) == 0)
+				{
+					p = strstr(line, "-- ");
+					copyName(module, p ? p + 3 : "");
+					p = strstr(module, " --");
+					if (p)
+						*p = 0;
+					break;
+				}
+				if (strncmp(line, "- PROCEDURES:", 13) == 0)
+					kind = MAP_PROCEDURE;
+				else if (strncmp(line, "- VARIABLES:", 12) == 0)
+					kind = MAP_VARIABLE;
+				else if (strncmp(line, "- LABELS:", 9) == 0)
+					kind = MAP_LABEL;
+				if (line[0] != ' ')
+					break;
+				// Name Addr hSize dSize Ref Section; labels have no section
+				g[0] = 0;
+				n = sscanf(line, "%63s %63s %63s %63s %d %63s", a, b, c, d, &refs, g);
+				if (n < 5)
+					break;
+				map->symbols = grow(map->symbols, map->symbolCount, &symbolCap, sizeof(*map->symbols));
+				s = &map->symbols[map->symbolCount];
+				memset(s, 0, sizeof(*s));
+				if (!parseHex(b, &s->addr))
+					break;
+				copyName(s->name, a);
+				copyName(s->module, module);
+				copyName(s->section, n >= 6 ? g : "");
+				s->kind = kind;
+				s->size = strtoul(d, NULL, 10);
+				s->refs = refs;
+				map->symbolCount++;
+				break;
+			}
+
+			case PART_MODULES:
+			{
+				map_module_t *m;
+				unsigned long data, code, constant;
+				char *last;
+				// Module names may contain blanks, e.g. "rtshc12.c.o (ansisi.lib)": take the last three fields
+				if (line[0] != ' ' || strstr(line, "Data   Code"))
+					break;
+				last = line + strlen(line);
+				while (last > line && last[-1] == ' ')
+					last--;
+				*last = 0;
+				for (n = 0, p = last; p > line && n < 3; n++)
+				{
+					while (p > line && p[-1] != ' ')
+						p--;
+					while (p > line && p[-1] == ' ')
+						p--;
+				}
+				if (n < 3 || sscanf(p, "%lu %lu %lu", &data, &code, &constant) != 3)
+					break;
+				*p = 0;
+				map->modules = grow(map->modules, map->moduleCount, &moduleCap, sizeof(*map->modules));
+				m = &map->modules[map->moduleCount++];
+				copyName(m->name, line + strspn(line, " "));
+				m->data = data;
+				m->code = code;
+				m->constant = constant;
+				break;
+			}
+		}
+	}
+
+	fclose(f);
+	return 0;
+}
+
+void map_free(map_file_t *map)
+{
+	free(map->symbols);
+	free(map->sections);
+	free(map->modules);
+	free(map->vectors);
+	memset(map, 0, sizeof(*map));
+}
+
+const map_symbol_t *map_find(const map_file_t *map, const char *name)
+{
+	int i;
+
+	for (i = 0; i < map->symbolCount; i++)
+		if (strcmp(map->symbols[i].name, name) == 0)
+			return &map->symbols[i];
+	return NULL;
+}
+
+const map_symbol_t *map_procedure_at(const map_file_t *map, unsigned long addr)
+{
+	int i;
+
+	for (i = 0; i < map->symbolCount; i++)
+	{
+		const map_symbol_t *s = &map->symbols[i];
+		if (s->kind == MAP_PROCEDURE && addr >= s->addr && addr < s->addr + s->size)
+			return s;
+	}
+	return NULL;
+}
@@ -0,0 +1,78 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    mapfile.h                                      *
+*          Reader for SmartLinker .map files              *
+*---------------------------------------------------------*
+* Reads the SECTION-ALLOCATION, VECTOR-ALLOCATION,        *
+* OBJECT-ALLOCATION and MODULE STATISTIC parts of the map *
+* CodeWarrior writes next to the .abs/.s19 in each        *
+* project's bin folder.                                   *
+**********************************************************/
+
+#ifndef _MAPFILE_H
+#define _MAPFILE_H
+
+#define MAP_NAME_LEN    64
+
+// Kinds of objects listed under each module
+#define MAP_PROCEDURE   0
+#define MAP_VARIABLE    1
+#define MAP_LABEL       2
+
+typedef struct map_symbol
+{
+	char name[MAP_NAME_LEN];
+	char module[MAP_NAME_LEN];
+	char section[MAP_NAME_LEN];
+	int kind;                           // MAP_PROCEDURE, MAP_VARIABLE or MAP_LABEL
+	unsigned long addr;                 // banked objects keep their page in bits 16-23
+	unsigned long size;
+	int refs;
+} map_symbol_t;
+
+typedef struct map_section
+{
+	char name[MAP_NAME_LEN];
+	char segment[MAP_NAME_LEN];
+	char type[MAP_NAME_LEN];            // "R", "R/W" or "N/I"
+	unsigned long from, to, size;
+} map_section_t;
+
+typedef struct map_vector
+{
+	char name[MAP_NAME_LEN];            // function the vector points to
+	unsigned long addr;                 // of the vector, e.g. 0xFFFE
+	unsigned long value;
+} map_vector_t;
+
+typedef struct map_module
+{
+	char name[MAP_NAME_LEN];
+	unsigned long data, code, constant;
+} map_module_t;
+
+typedef struct map_file
+{
+	map_symbol_t *symbols;
+	int symbolCount;
+	map_section_t *sections;
+	int sectionCount;
+	map_module_t *modules;
+	int moduleCount;
+	map_vector_t *vectors;
+	int vectorCount;
+	unsigned long entry;
+} map_file_t;
+
+// Returns 0 on success, -1 if the file cannot be read
+int map_load(const char *path, map_file_t *map);
+void map_free(map_file_t *map);
+
+// Exact name lookup, NULL if absent
+const map_symbol_t *map_find(const map_file_t *map, const char *name);
+
+// Procedure containing 'addr', NULL if none
+const map_symbol_t *map_procedure_at(const map_file_t *map, unsigned long addr);
+
+#endif
@@ -0,0 +1,105 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    s19.c                                          *
+*          Motorola S-record loader                       *
+**********************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "s19.h"
+
+static int hexDigit(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	return -1;
+}
+
+static int hexByte(const char *s)
+{
+	int hi = hexDigit(s[0]), lo = hexDigit(s[1]);
+
+	if (hi < 0 || lo < 0)
+		return -1;
+	return (hi << 4) | lo;
+}
+
+long s19_load(const char *path, s19_sink_t sink, void *context, unsigned long *entry)
+{
+	FILE *f = fopen(path, "r");
+	char line[600];
+	unsigned char bytes[256];
+	long total = 0;
+	int lineNumber = 0;
+
+	if (!f)
+	{
+		fprintf(stderr, "%s: cannot open\n", path);
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), f))
+	{
+		int count, addrLen, i, sum = 0, v;
+		unsigned long addr = 0;
+		char type;
+
+		lineNumber++;
+		if (line[0] != 'S')
+			continue;
+		type = line[1];
+		count = hexByte(line + 2);
+		if (count < 3 || (int)strlen(line) < 4 + 2 * count)
+			goto bad;
+		for (i = 0; i < count; i++)
+		{
+			v = hexByte(line + 4 + 2 * i);
+			if (v < 0)
+				goto bad;
+			bytes[i] = (unsigned char)v;
+			sum += v;
+		}
+		sum += count;
+		if ((sum & 0xFF) != 0xFF)
+		{
+			fprintf(stderr, "%s:%d: checksum error\n", path, lineNumber);
+			fclose(f);
+			return -1;
+		}
+
+		switch (type)
+		{
+			case '1': case '9': addrLen = 2; break;
+			case '2': case '8': addrLen = 3; break;
+			case '3': case '7': addrLen = 4; break;
+			default: continue;              // S0 header, S5 record count
+		}
+		for (i = 0; i < addrLen; i++)
+			addr = (addr << 8) | bytes[i];
+
+		if (type >= '7')
+		{
+			if (entry)
+				*entry = addr;
+			continue;
+		}
+		for (i = addrLen; i < count - 1; i++)
+		{
+			sink(context, addr + (unsigned long)(i - addrLen), bytes[i]);
+			total++;
+		}
+	}
+
+	fclose(f);
+	return total;
+
+bad:
+	fprintf(stderr, "%s:%d: malformed record\n", path, lineNumber);
+	fclose(f);
+	return -1;
+}
@@ -0,0 +1,19 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    s19.h                                          *
+*          Motorola S-record loader                       *
+**********************************************************/
+
+#ifndef _S19_H
+#define _S19_H
+
+// Receives every data byte of the file. Addresses of S2 records keep the linker's page in bits 16-23.
+typedef void (*s19_sink_t)(void *context, unsigned long addr, unsigned char value);
+
+// Loads an S19 file. Returns the number of data bytes loaded, or -1 on a missing file, malformed record
+// or checksum error (the offending line is reported on stderr). The S9/S8 entry address is stored in
+// 'entry' when it is not NULL.
+long s19_load(const char *path, s19_sink_t sink, void *context, unsigned long *entry);
+
+#endif
@@ -0,0 +1,1042 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    mapstat.c                                      *
+*          Memory footprint of the linked projects, from  *
+*          their .map, .s19 and .prm files                *
+*---------------------------------------------------------*
+* Usage: mapstat [options] [project or .map ...]          *
+*   -t target    link target, HCS12_Serial_Monitor by     *
+*                default; "Project" for Project.map       *
+*   -n count     largest objects listed per project       *
+*   -s           summary table only                       *
+*   -c           print the results as CSV                 *
+*   -r file      compare against an earlier CSV or build  *
+*                and fail if a segment or the stack grew  *
+*                                                         *
+* Without arguments every project under "Lab 8" and       *
+* "Lab 9" is read. For each one the segments of its prm   *
+* file are filled from the map's sections and checked     *
+* against the bytes of the S19. The stack need is found   *
+* by decoding every procedure the reset and interrupt     *
+* vectors reach, following the calls the map resolves.    *
+**********************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <glob.h>
+#include <unistd.h>
+#include "../sim12/cpu12.h"
+#include "../lib/mapfile.h"
+#include "../lib/s19.h"
+
+#define MAX_SEGMENTS    48
+#define MAX_PROJECTS    64
+#define MAX_NOTES       8
+#define PATH_LEN        512
+#define LABEL_LEN       128
+#define DEFAULT_TARGET  "HCS12_Serial_Monitor"
+#define DEFAULT_OBJECTS 10
+#define DEFAULT_STACK   0x100           // STACKSIZE of every prm in the labs
+#define IRQ_FRAME       9               // CCR, D, X, Y and the return address stacked by an interrupt
+#define VECTORS_START   0xFF80          // vector table, up to the reset vector at 0xFFFE
+
+// Why a stack figure is only a lower bound
+#define STK_INDIRECT    0x01            // call or jump through a register or memory
+#define STK_RECURSIVE   0x02
+#define STK_SWITCH      0x04            // switch through a runtime helper whose table is not decoded
+#define STK_UNKNOWN     0x08            // call to an address the map does not list
+#define STK_UNBALANCED  0x10            // an instruction is reached with two stack depths
+
+typedef struct segment
+{
+	char name[MAP_NAME_LEN];
+	char type[16];                      // READ_ONLY, READ_WRITE or NO_INIT
+	unsigned long from, to;             // pages keep their number in bits 16-23, as in the prm
+	unsigned long mapBytes;             // sections the map places in it
+	unsigned long s19Bytes;
+} segment_t;
+
+typedef struct proc
+{
+	int state;                          // 0 not yet seen, 1 being decoded, 2 done
+	long depth;                         // stack bytes it needs below its return address, callees included
+	int via;                            // callee on the deepest path, or -1
+	int flags;                          // STK_* of it and its callees
+	long pops;                          // bytes it takes off the caller's stack, as _LCMP does, or leaves there if negative
+	int returns;                        // returns seen so far
+	int enables;                        // clears the I bit, itself or through a callee
+	int handler;                        // reached through the vector table
+} proc_t;
+
+typedef struct project
+{
+	char label[LABEL_LEN];              // e.g. "Lab 8/Lab8_3"
+	char mapPath[PATH_LEN], s19Path[PATH_LEN], prmPath[PATH_LEN];
+	map_file_t map;
+	segment_t segments[MAX_SEGMENTS];
+	int segmentCount;
+	unsigned long stackSize;
+	unsigned long otherBytes;           // S19 bytes outside every segment, e.g. the vector table
+	unsigned char vectorBytes[0x10000 - VECTORS_START];    // vector table bytes the S19 sets
+	long s19Total;
+	proc_t *procs;                      // one per map symbol
+	long stackWorst;
+	int stackRoot, stackIrq;            // symbols of the reset path and of the deepest interrupt, or -1
+	long irqSum;                        // every handler's need, counted when they can nest
+	int irqNesting;                     // a handler clears the I bit, so others can land on top of it
+	int stackFlags;
+	char notes[MAX_NOTES][96];          // why the stack figure is a lower bound
+	int noteFlags[MAX_NOTES];
+	const map_symbol_t *noteSymbols[MAX_NOTES];
+	int noteCount;
+	int overflow;                       // a segment or the stack is over its size
+} project_t;
+
+typedef struct row
+{
+	char project[LABEL_LEN];
+	char kind[16];                      // segment, section, symbol or stack
+	char name[2 * MAP_NAME_LEN + 4];
+	unsigned long bytes;
+	int matched;
+} row_t;
+
+typedef struct rows
+{
+	row_t *rows;
+	int count, capacity;
+} rows_t;
+
+static cpu12_t cpu;
+static project_t *current;              // project whose S19 is being loaded or decoded
+
+// MC9S12DG256 with the serial monitor, for projects without a prm file
+static const segment_t defaultSegments[] =
+{
+	{"RAM", "READ_WRITE", 0x1000, 0x3FFF, 0, 0},
+	{"ROM_4000", "READ_ONLY", 0x4000, 0x7FFF, 0, 0},
+	{"ROM_C000", "READ_ONLY", 0xC000, 0xF77F, 0, 0},
+	{"PAGE_30", "READ_ONLY", 0x308000, 0x30BFFF, 0, 0},
+	{"PAGE_31", "READ_ONLY", 0x318000, 0x31BFFF, 0, 0},
+	{"PAGE_32", "READ_ONLY", 0x328000, 0x32BFFF, 0, 0},
+	{"PAGE_33", "READ_ONLY", 0x338000, 0x33BFFF, 0, 0},
+	{"PAGE_34", "READ_ONLY", 0x348000, 0x34BFFF, 0, 0},
+	{"PAGE_35", "READ_ONLY", 0x358000, 0x35BFFF, 0, 0},
+	{"PAGE_36", "READ_ONLY", 0x368000, 0x36BFFF, 0, 0},
+	{"PAGE_37", "READ_ONLY", 0x378000, 0x37BFFF, 0, 0},
+	{"PAGE_38", "READ_ONLY", 0x388000, 0x38BFFF, 0, 0},
+	{"PAGE_39", "READ_ONLY", 0x398000, 0x39BFFF, 0, 0},
+	{"PAGE_3A", "READ_ONLY", 0x3A8000, 0x3ABFFF, 0, 0},
+	{"PAGE_3B", "READ_ONLY", 0x3B8000, 0x3BBFFF, 0, 0},
+	{"PAGE_3C", "READ_ONLY", 0x3C8000, 0x3CBFFF, 0, 0},
+	{"PAGE_3D", "READ_ONLY", 0x3D8000, 0x3DBFFF, 0, 0},
+};
+
+/************************************************
+*   findProject                                 *
+*                                               *
+*   Desc.: Works out the map, S19 and prm of a  *
+*          project folder or of a map file.     *
+*          The label is the two folders above   *
+*          bin, e.g. "Lab 8/Lab8_3", so builds  *
+*          in two checkouts compare row by row. *
+*   Outputs: 0, or -1 if there is no map        *
+************************************************/
+
+static int findProject(const char *arg, const char *target, project_t *p)
+{
+	char dir[PATH_LEN], *slash;
+	size_t n = strlen(arg);
+	int levels;
+
+	memset(p, 0, sizeof(*p));
+	if (n > 4 && strcmp(arg + n - 4, ".map") == 0)
+	{
+		snprintf(p->mapPath, sizeof(p->mapPath), "%s", arg);
+		snprintf(dir, sizeof(dir), "%s", arg);
+		slash = strrchr(dir, '/');
+		if (slash)
+			*slash = '\0';
+		else
+			snprintf(dir, sizeof(dir), ".");
+		n = strlen(dir);
+		if (n >= 3 && strcmp(dir + n - 3, "bin") == 0 && (n == 3 || dir[n - 4] == '/'))
+			dir[n > 3 ? n - 4 : 0] = '\0';
+		if (dir[0] == '\0')
+			snprintf(dir, sizeof(dir), ".");
+	}
+	else
+	{
+		snprintf(dir, sizeof(dir), "%s", arg);
+		n = strlen(dir);
+		while (n > 1 && dir[n - 1] == '/')
+			dir[--n] = '\0';
+		if (strcmp(target, "Project") == 0)
+			snprintf(p->mapPath, sizeof(p->mapPath), "%s/bin/Project.map", dir);
+		else
+			snprintf(p->mapPath, sizeof(p->mapPath), "%s/bin/Project.abs%s.map", dir, target);
+	}
+
+	// Project.absX.map goes with Project.absX.abs.s19 and prm/X.prm, Project.map with Project.abs.s19 and prm/Project.prm
+	n = strlen(p->mapPath) - 4;
+	snprintf(p->s19Path, sizeof(p->s19Path), "%.*s.abs.s19", (int)n, p->mapPath);
+	slash = strrchr(p->mapPath, '/');
+	slash = slash ? slash + 1 : p->mapPath;
+	if (strncmp(slash, "Project.abs", 11) == 0)
+		slash += 11;
+	snprintf(p->prmPath, sizeof(p->prmPath), "%s/prm/%.*s.prm", dir, (int)strlen(slash) - 4, slash);
+
+	for (levels = 0, slash = dir + strlen(dir); slash > dir; slash--)
+		if (slash[-1] == '/' && ++levels == 2)
+			break;
+	snprintf(p->label, sizeof(p->label), "%.*s", LABEL_LEN - 1, strcmp(dir, ".") == 0 ? "." : slash);
+	return access(p->mapPath, R_OK) == 0 ? 0 : -1;
+}
+
+/************************************************
+*   readPrm                                     *
+*                                               *
+*   Desc.: Reads the SEGMENTS block and the     *
+*          STACKSIZE of a linker parameter      *
+*          file. Falls back to the serial       *
+*          monitor layout if there is none.     *
+************************************************/
+
+static void readPrm(project_t *p)
+{
+	char line[512], name[MAP_NAME_LEN], type[16], from[32], to[32], *c;
+	int inSegments = 0, inComment = 0;
+	FILE *f = fopen(p->prmPath, "r");
+
+	p->stackSize = DEFAULT_STACK;
+	if (!f)
+	{
+		memcpy(p->segments, defaultSegments, sizeof(defaultSegments));
+		p->segmentCount = sizeof(defaultSegments) / sizeof(defaultSegments[0]);
+		p->prmPath[0] = '\0';
+		return;
+	}
+	while (fgets(line, sizeof(line), f))
+	{
+		// Blank out /* */ comments, which may span lines, and cut // comments
+		for (c = line; *c; c++)
+		{
+			if (inComment)
+			{
+				if (c[0] == '*' && c[1] == '/')
+				{
+					c[1] = ' ';
+					inComment = 0;
+				}
+				*c = ' ';
+			}
+			else if (c[0] == '/' && c[1] == '*')
+			{
+				c[1] = ' ';
+				*c = ' ';
+				inComment = 1;
+			}
+			else if (c[0] == '/' && c[1] == '/')
+			{
+				*c = '\0';
+				break;
+			}
+		}
+		c = line + strspn(line, " \t");
+
+		if (strncmp(c, "SEGMENTS", 8) == 0)
+			inSegments = 1;
+		else if (inSegments && strncmp(c, "END", 3) == 0)
+			inSegments = 0;
+		else if (inSegments && p->segmentCount < MAX_SEGMENTS &&
+			sscanf(line, " %63[A-Za-z0-9_] = %15s %31s TO %31[0-9A-Fa-fx]", name, type, from, to) == 4)
+		{
+			segment_t *s = &p->segments[p->segmentCount++];
+			memset(s, 0, sizeof(*s));
+			snprintf(s->name, sizeof(s->name), "%s", name);
+			snprintf(s->type, sizeof(s->type), "%s", type);
+			s->from = strtoul(from, NULL, 0);
+			s->to = strtoul(to, NULL, 0);
+		}
+		else if (sscanf(line, " STACKSIZE %31s", from) == 1)
+			p->stackSize = strtoul(from, NULL, 0);
+	}
+	fclose(f);
+}
+
+static segment_t *findSegment(project_t *p, const char *name)
+{
+	int i;
+
+	for (i = 0; i < p->segmentCount; i++)
+		if (strcmp(p->segments[i].name, name) == 0)
+			return &p->segments[i];
+	return NULL;
+}
+
+static void s19Byte(void *context, unsigned long addr, unsigned char value)
+{
+	project_t *p = context;
+	int i;
+
+	cpu12_load(&cpu, addr, value);
+	if (addr >= VECTORS_START && addr <= 0xFFFF)
+		p->vectorBytes[addr - VECTORS_START] = 1;
+	for (i = 0; i < p->segmentCount; i++)
+		if (addr >= p->segments[i].from && addr <= p->segments[i].to)
+		{
+			p->segments[i].s19Bytes++;
+			return;
+		}
+	p->otherBytes++;
+}
+
+// One note per kind and procedure
+static void note(project_t *p, int flag, const char *text, const map_symbol_t *s, unsigned long addr)
+{
+	int i;
+
+	for (i = 0; i < p->noteCount; i++)
+		if (p->noteFlags[i] == flag && p->noteSymbols[i] == s)
+			return;
+	if (p->noteCount == MAX_NOTES)
+		return;
+	p->noteFlags[p->noteCount] = flag;
+	p->noteSymbols[p->noteCount] = s;
+	snprintf(p->notes[p->noteCount++], sizeof(p->notes[0]), "%s in %s at 0x%04lX", text, s->name, addr);
+}
+
+static int symbolIndex(const project_t *p, const map_symbol_t *s)
+{
+	return s ? (int)(s - p->map.symbols) : -1;
+}
+
+static long procDepth(int index);
+
+static long callDepth(proc_t *pr, const map_symbol_t *self, unsigned long target, unsigned long at, long *best, int *via, long *pops)
+{
+	const map_symbol_t *callee = map_procedure_at(&current->map, target);
+	long need;
+
+	if (!callee)
+	{
+		pr->flags |= STK_UNKNOWN;
+		note(current, STK_UNKNOWN, "call to an unlisted address", self, at);
+		return 0;
+	}
+	need = procDepth(symbolIndex(current, callee));
+	pr->flags |= current->procs[symbolIndex(current, callee)].flags;
+	pr->enables |= current->procs[symbolIndex(current, callee)].enables;
+	if (pops)
+		*pops = current->procs[symbolIndex(current, callee)].pops;
+	if (need > *best)
+	{
+		*best = need;
+		*via = symbolIndex(current, callee);
+	}
+	return need;
+}
+
+// Records how a procedure leaves the stack: 'pops' bytes fewer than at the call
+static void returnsWith(proc_t *pr, const map_symbol_t *s, long pops, unsigned long at)
+{
+	if (pr->returns++ == 0)
+		pr->pops = pops;
+	else if (pops != pr->pops)
+	{
+		pr->flags |= STK_UNBALANCED;
+		note(current, STK_UNBALANCED, "returns with two stack depths", s, at);
+	}
+}
+
+#define MAX_NESTING     8               // local subroutines inside one procedure
+
+/************************************************
+*   walk                                        *
+*                                               *
+*   Desc.: Decodes a procedure along every path *
+*          from 'entry', tracking the bytes     *
+*          pushed since then. A call adds its   *
+*          return address and the callee's own  *
+*          need; local subroutines inside the   *
+*          procedure are walked in turn.        *
+*          Switches through _CASE_CHECKED_BYTE  *
+*          follow their jump table: a count, a  *
+*          default offset and one offset per    *
+*          case, all relative to the byte after *
+*          the default.                         *
+*   Inputs: index - map symbol of a procedure   *
+*           entry - address to start at         *
+*           nesting - local subroutine depth    *
+*   Outputs: Stack bytes used below the return  *
+*            address, callees included          *
+************************************************/
+
+static long walk(int index, unsigned int entry, int nesting)
+{
+	proc_t *pr = &current->procs[index];
+	const map_symbol_t *s = &current->map.symbols[index];
+	unsigned int start = s->addr & 0xFFFF, size = s->size ? (unsigned int)s->size : 1, page = (unsigned int)(s->addr >> 16);
+	short *seen;
+	struct { unsigned int addr; long depth; } *work;
+	int workCount = 0, workCap;
+	long deepest = 0, calleeBest = -1;
+	int calleeVia = -1;
+	unsigned int i;
+
+	seen = malloc(size * sizeof(*seen));
+	workCap = 2 * size + 8;
+	work = malloc((size_t)workCap * sizeof(*work));
+	for (i = 0; i < size; i++)
+		seen[i] = -32768;
+	work[workCount].addr = entry;
+	work[workCount++].depth = 0;
+
+	while (workCount > 0)
+	{
+		unsigned int addr = work[--workCount].addr;
+		long d = work[workCount].depth, after, use;
+		cpu12_insn_t insn;
+		unsigned long target;
+		long popped = 0;
+		int length, ends = 0;
+
+		for (;;)
+		{
+			if (addr < start || addr >= start + size)
+			{
+				// Fell or jumped out of the procedure: a tail call, or code the linker put next to it
+				unsigned long full = page && addr >= CPU12_WINDOW_START && addr < CPU12_WINDOW_END ? ((unsigned long)page << 16) | addr : addr;
+				use = d + callDepth(pr, s, full, addr, &calleeBest, &calleeVia, NULL);
+				if (use > deepest)
+					deepest = use;
+				break;
+			}
+			if (seen[addr - start] != -32768)
+			{
+				if (seen[addr - start] != d)
+				{
+					pr->flags |= STK_UNBALANCED;
+					note(current, STK_UNBALANCED, "two stack depths", s, addr);
+				}
+				break;
+			}
+			seen[addr - start] = (short)d;
+
+			cpu.mem[CPU12_PPAGE_ADDR] = (unsigned char)page;
+			length = cpu12_decode(&cpu, addr, &insn);
+			popped = 0;
+			if (strncmp(insn.text, "WAI", 3) == 0)
+				insn.stackDelta = 0;    // the interrupt it waits for is counted on its own
+			if (strncmp(insn.text, "CLI", 3) == 0 || (strncmp(insn.text, "ANDCC", 5) == 0 && strchr(insn.text, '$') &&
+				!(strtoul(strchr(insn.text, '$') + 1, NULL, 16) & 0x10)))
+				pr->enables = 1;
+			after = d - insn.stackDelta;
+			use = after > d ? after : d;
+			if (use > deepest)
+				deepest = use;
+			target = insn.target;
+			if (target != CPU12_NO_TARGET && target <= 0xFFFF && page && target >= CPU12_WINDOW_START && target < CPU12_WINDOW_END)
+				target |= (unsigned long)page << 16;
+
+			switch (insn.flow)
+			{
+				case CPU12_FLOW_CALL:
+				{
+					long ret = strncmp(insn.text, "CALL", 4) == 0 ? 3 : 2;
+					const map_symbol_t *callee;
+
+					if (insn.target == CPU12_NO_TARGET)
+					{
+						pr->flags |= STK_INDIRECT;
+						note(current, STK_INDIRECT, "indirect call", s, addr);
+						use = after + ret;
+					}
+					else
+					{
+						callee = map_procedure_at(&current->map, target);
+						if (callee == s && nesting < MAX_NESTING)
+							use = after + ret + walk(index, (unsigned int)(target & 0xFFFF), nesting + 1);
+						else if (callee && strcmp(callee->name, "_CASE_CHECKED_BYTE") == 0)
+						{
+							unsigned int table = addr + length, n = cpu12_read8(&cpu, table), k;
+
+							use = after + ret + callDepth(pr, s, target, addr, &calleeBest, &calleeVia, NULL);
+							for (k = 0; k <= n && workCount < workCap; k++)
+							{
+								work[workCount].addr = table + 2 + cpu12_read8(&cpu, table + 1 + (k == n ? 0 : k + 1));
+								work[workCount++].depth = after;
+							}
+							ends = 1;
+						}
+						else if (callee && strncmp(callee->name, "_CASE_", 6) == 0)
+						{
+							pr->flags |= STK_SWITCH;
+							note(current, STK_SWITCH, "switch table not followed", s, addr);
+							use = after + ret + callDepth(pr, s, target, addr, &calleeBest, &calleeVia, NULL);
+							ends = 1;
+						}
+						else
+							use = after + ret + callDepth(pr, s, target, addr, &calleeBest, &calleeVia, &popped);
+					}
+					if (use > deepest)
+						deepest = use;
+					break;
+				}
+
+				case CPU12_FLOW_JUMP:
+					if (insn.target == CPU12_NO_TARGET)
+					{
+						// JMP 0,X after the return address was pulled is a return, and anything
+						// pulled past it came off the caller's stack
+						if (after >= 0)
+						{
+							pr->flags |= STK_INDIRECT;
+							note(current, STK_INDIRECT, "indirect jump", s, addr);
+						}
+						else if (nesting == 0)
+							returnsWith(pr, s, -after - 2, addr);
+						ends = 1;
+					}
+					else
+					{
+						addr = (unsigned int)(target & 0xFFFF);
+						d = after;
+						continue;
+					}
+					break;
+
+				case CPU12_FLOW_BRANCH:
+					if (workCount < workCap)
+					{
+						work[workCount].addr = (unsigned int)(target & 0xFFFF);
+						work[workCount++].depth = after;
+					}
+					break;
+
+				case CPU12_FLOW_IRQ:
+					use = after + IRQ_FRAME;
+					if (use > deepest)
+						deepest = use;
+					break;
+
+				case CPU12_FLOW_RETURN:
+					// Runtime helpers such as _DLONG return their result on the stack
+					if (nesting == 0)
+						returnsWith(pr, s, -after, addr);
+					ends = 1;
+					break;
+
+				case CPU12_FLOW_RTI:
+				case CPU12_FLOW_STOP:
+					ends = 1;
+					break;
+			}
+			if (ends)
+				break;
+			addr += length;
+			d = after - popped;
+		}
+	}
+
+	free(seen);
+	free(work);
+	if (nesting == 0)
+		pr->via = calleeVia;
+	return deepest;
+}
+
+static long procDepth(int index)
+{
+	proc_t *pr = &current->procs[index];
+
+	if (pr->state == 2)
+		return pr->depth;
+	if (pr->state == 1)
+	{
+		pr->flags |= STK_RECURSIVE;
+		note(current, STK_RECURSIVE, "recursion", &current->map.symbols[index], current->map.symbols[index].addr);
+		return 0;
+	}
+	pr->state = 1;
+	pr->via = -1;
+	pr->depth = walk(index, (unsigned int)(current->map.symbols[index].addr & 0xFFFF), 0);
+	pr->state = 2;
+	return pr->depth;
+}
+
+/************************************************
+*   analyseStack                                *
+*                                               *
+*   Desc.: Worst case stack: the deepest path   *
+*          from the entry point, plus the       *
+*          deepest interrupt handler with the   *
+*          9 bytes the CPU stacks for it.       *
+*          Handlers are taken not to nest, as   *
+*          the CPU masks interrupts while one   *
+*          runs.                                *
+************************************************/
+
+static void irqDepth(project_t *p, unsigned long handler, long *irq)
+{
+	const map_symbol_t *s = map_procedure_at(&p->map, handler);
+	long need;
+
+	if (handler == p->map.entry || !s)
+		return;
+	need = IRQ_FRAME + procDepth(symbolIndex(p, s));
+	p->stackFlags |= p->procs[symbolIndex(p, s)].flags;
+	if (!p->procs[symbolIndex(p, s)].handler)
+	{
+		p->procs[symbolIndex(p, s)].handler = 1;
+		p->irqSum += need;
+		if (p->procs[symbolIndex(p, s)].enables)
+			p->irqNesting = 1;
+	}
+	if (need > *irq)
+	{
+		*irq = need;
+		p->stackIrq = symbolIndex(p, s);
+	}
+}
+
+static void analyseStack(project_t *p)
+{
+	const map_symbol_t *s;
+	long irq = 0;
+	int i;
+
+	current = p;
+	p->procs = calloc((size_t)p->map.symbolCount + 1, sizeof(*p->procs));
+	p->stackRoot = p->stackIrq = -1;
+
+	s = map_procedure_at(&p->map, p->map.entry);
+	if (s)
+	{
+		p->stackRoot = symbolIndex(p, s);
+		p->stackWorst = procDepth(p->stackRoot);
+		p->stackFlags |= p->procs[p->stackRoot].flags;
+	}
+	for (i = 0; i < p->map.vectorCount; i++)
+		irqDepth(p, p->map.vectors[i].value, &irq);
+	// "interrupt N" handlers may be missing from the map's vector list, so read the image as well
+	for (i = 0; i < 0xFFFE - VECTORS_START; i += 2)
+		if (p->vectorBytes[i] && p->vectorBytes[i + 1])
+			irqDepth(p, ((unsigned long)cpu12_read8(&cpu, VECTORS_START + i) << 8) | cpu12_read8(&cpu, VECTORS_START + i + 1), &irq);
+	p->stackWorst += p->irqNesting ? p->irqSum : irq;
+	if ((unsigned long)p->stackWorst > p->stackSize)
+		p->overflow = 1;
+}
+
+/************************************************
+*   loadProject                                 *
+*                                               *
+*   Outputs: 0, or -1 if the map lists no       *
+*            sections (not linked yet)          *
+************************************************/
+
+static int loadProject(project_t *p)
+{
+	int i;
+
+	if (map_load(p->mapPath, &p->map) < 0 || p->map.sectionCount == 0)
+		return -1;
+	readPrm(p);
+	for (i = 0; i < p->map.sectionCount; i++)
+	{
+		segment_t *s = findSegment(p, p->map.sections[i].segment);
+		if (s)
+			s->mapBytes += p->map.sections[i].size;
+	}
+	for (i = 0; i < p->segmentCount; i++)
+		if (p->segments[i].mapBytes > p->segments[i].to - p->segments[i].from + 1)
+			p->overflow = 1;
+
+	cpu12_init(&cpu);
+	p->s19Total = s19_load(p->s19Path, s19Byte, p, NULL);
+	if (p->s19Total < 0)
+		p->s19Path[0] = '\0';
+	analyseStack(p);
+	return 0;
+}
+
+static const char *projectPath(const project_t *p, const char *path)
+{
+	const char *at = strstr(path, p->label);
+	return at && strcmp(p->label, ".") != 0 ? at + strlen(p->label) + 1 : path;
+}
+
+// Register definitions and vectors: placed by address, not by the prm segments
+static int isFixed(const char *segmentOrSection)
+{
+	return strncmp(segmentOrSection, ".abs", 4) == 0 || strncmp(segmentOrSection, ".vectSeg", 8) == 0;
+}
+
+static void printAddr(unsigned long addr)
+{
+	if (addr > 0xFFFF)
+		printf("  %02lX'%04lX", addr >> 16, addr & 0xFFFF);
+	else
+		printf("     %04lX", addr);
+}
+
+static void printPath(const project_t *p, int index)
+{
+	int i;
+
+	for (i = index; i >= 0; i = p->procs[i].via)
+		printf("%s%s", i == index ? "    " : " > ", p->map.symbols[i].name);
+	printf("\n");
+}
+
+/************************************************
+*   report                                      *
+*                                               *
+*   Desc.: Prints the segments, sections,       *
+*          largest objects and stack of one     *
+*          project                              *
+************************************************/
+
+static void report(const project_t *p, int objects)
+{
+	const map_symbol_t **order;
+	int i, j, count = 0;
+
+	printf("%s: %s", p->label, projectPath(p, p->mapPath));
+	if (p->prmPath[0])
+		printf(", %s", projectPath(p, p->prmPath));
+	else
+		printf(", no prm (serial monitor layout assumed)");
+	printf("\n\n%-14s %9s %9s %7s %7s %7s %7s %5s\n", "Segment", "From", "To", "Size", "Map", "S19", "Free", "Used");
+	for (i = 0; i < p->segmentCount; i++)
+	{
+		const segment_t *s = &p->segments[i];
+		unsigned long size = s->to - s->from + 1;
+
+		printf("%-14s", s->name);
+		printAddr(s->from);
+		printAddr(s->to);
+		printf(" %7lu %7lu ", size, s->mapBytes);
+		if (p->s19Path[0] && strcmp(s->type, "READ_ONLY") == 0)
+			printf("%7lu", s->s19Bytes);
+		else
+			printf("%7s", "-");
+		printf(" %7ld %4lu%%%s\n", (long)size - (long)s->mapBytes, (s->mapBytes * 100 + size / 2) / size,
+			s->mapBytes > size ? "  OVERFLOW" : "");
+	}
+	if (p->s19Path[0])
+		printf("S19: %ld bytes, %lu outside the segments (vectors)\n", p->s19Total, p->otherBytes);
+	else
+		printf("S19: none\n");
+
+	printf("\n%-22s %-14s %9s %9s %7s\n", "Section", "Segment", "From", "To", "Size");
+	for (i = 0; i < p->map.sectionCount; i++)
+	{
+		const map_section_t *s = &p->map.sections[i];
+		if (isFixed(s->segment))
+			continue;
+		printf("%-22s %-14s", s->name, s->segment);
+		printAddr(s->from);
+		printAddr(s->to);
+		printf(" %7lu\n", s->size);
+	}
+
+	order = malloc((size_t)p->map.symbolCount * sizeof(*order));
+	for (i = 0; i < p->map.symbolCount; i++)
+		if (p->map.symbols[i].kind != MAP_LABEL && !isFixed(p->map.symbols[i].section))
+			order[count++] = &p->map.symbols[i];
+	for (i = 1; i < count; i++)         // insertion sort, largest first
+	{
+		const map_symbol_t *s = order[i];
+		for (j = i; j > 0 && order[j - 1]->size < s->size; j--)
+			order[j] = order[j - 1];
+		order[j] = s;
+	}
+	if (objects > 0 && count > 0)
+	{
+		printf("\n%-32s %-26s %-10s %7s\n", "Object", "Module", "Section", "Size");
+		for (i = 0; i < count && i < objects; i++)
+			printf("%-32s %-26s %-10s %7lu\n", order[i]->name, order[i]->module, order[i]->section, order[i]->size);
+	}
+	free(order);
+
+	printf("\nStack: STACKSIZE %lu, worst case %s%ld, headroom %ld%s\n", p->stackSize, p->stackFlags ? "at least " : "",
+		p->stackWorst, (long)p->stackSize - p->stackWorst, (unsigned long)p->stackWorst > p->stackSize ? "  OVERFLOW" : "");
+	if (p->stackRoot >= 0)
+	{
+		printf("  from the entry point, %ld:\n", p->procs[p->stackRoot].depth);
+		printPath(p, p->stackRoot);
+	}
+	if (p->irqNesting)
+	{
+		// A handler that clears the I bit can be interrupted by any other, so all of them are added up
+		printf("  plus every interrupt handler, nested, %ld with their stacking:\n", p->irqSum);
+		for (i = 0; i < p->map.symbolCount; i++)
+			if (p->procs[i].handler)
+				printf("    %s, %ld%s\n", p->map.symbols[i].name, IRQ_FRAME + p->procs[i].depth,
+					p->procs[i].enables ? ", clears the I bit" : "");
+	}
+	else if (p->stackIrq >= 0)
+	{
+		printf("  plus the deepest interrupt, %ld with its stacking:\n", IRQ_FRAME + p->procs[p->stackIrq].depth);
+		printPath(p, p->stackIrq);
+	}
+	if (!p->stackFlags && p->stackWorst > 0)
+		printf("  STACKSIZE 0x%lX would leave a quarter spare\n", ((unsigned long)p->stackWorst * 5 / 4 + 15) & ~15UL);
+	for (i = 0; i < p->noteCount; i++)
+		printf("  not counted: %s\n", p->notes[i]);
+	printf("\n");
+}
+
+static void summary(project_t *projects, int count)
+{
+	int i;
+
+	printf("%-16s %13s %13s %13s %7s %11s\n", "Project", "RAM", "ROM_C000", "ROM_4000", "Pages", "Stack");
+	for (i = 0; i < count; i++)
+	{
+		const project_t *p = &projects[i];
+		const segment_t *ram = findSegment((project_t *)p, "RAM"), *c000 = findSegment((project_t *)p, "ROM_C000");
+		const segment_t *r4000 = findSegment((project_t *)p, "ROM_4000");
+		unsigned long paged = 0;
+		char text[3][32], stack[32];
+		int j;
+
+		for (j = 0; j < p->segmentCount; j++)
+			if (strncmp(p->segments[j].name, "PAGE_", 5) == 0)
+				paged += p->segments[j].mapBytes;
+		snprintf(text[0], sizeof(text[0]), "%lu/%lu", ram ? ram->mapBytes : 0, ram ? ram->to - ram->from + 1 : 0);
+		snprintf(text[1], sizeof(text[1]), "%lu/%lu", c000 ? c000->mapBytes : 0, c000 ? c000->to - c000->from + 1 : 0);
+		snprintf(text[2], sizeof(text[2]), "%lu/%lu", r4000 ? r4000->mapBytes : 0, r4000 ? r4000->to - r4000->from + 1 : 0);
+		snprintf(stack, sizeof(stack), "%s%ld/%lu", p->stackFlags ? ">=" : "", p->stackWorst, p->stackSize);
+		printf("%-16s %13s %13s %13s %7lu %11s%s\n", p->label, text[0], text[1], text[2], paged, stack,
+			p->overflow ? "  OVERFLOW" : "");
+	}
+}
+
+static void addRow(rows_t *r, const char *project, const char *kind, const char *name, unsigned long bytes)
+{
+	row_t *row;
+
+	if (r->count == r->capacity)
+	{
+		r->capacity = r->capacity ? 2 * r->capacity : 256;
+		r->rows = realloc(r->rows, (size_t)r->capacity * sizeof(*r->rows));
+	}
+	row = &r->rows[r->count++];
+	snprintf(row->project, sizeof(row->project), "%s", project);
+	snprintf(row->kind, sizeof(row->kind), "%s", kind);
+	snprintf(row->name, sizeof(row->name), "%s", name);
+	row->bytes = bytes;
+	row->matched = 0;
+}
+
+// Symbols are keyed by module and name: static functions and string literals repeat across modules
+static void collectRows(const project_t *p, rows_t *r)
+{
+	char name[2 * MAP_NAME_LEN + 4];
+	int i;
+
+	for (i = 0; i < p->segmentCount; i++)
+		addRow(r, p->label, "segment", p->segments[i].name, p->segments[i].mapBytes);
+	for (i = 0; i < p->map.sectionCount; i++)
+		if (!isFixed(p->map.sections[i].segment))
+			addRow(r, p->label, "section", p->map.sections[i].name, p->map.sections[i].size);
+	for (i = 0; i < p->map.symbolCount; i++)
+	{
+		const map_symbol_t *s = &p->map.symbols[i];
+		if (s->kind == MAP_LABEL || isFixed(s->section))
+			continue;
+		snprintf(name, sizeof(name), "%s:%s", s->module, s->name);
+		addRow(r, p->label, "symbol", name, s->size);
+	}
+	addRow(r, p->label, "stack", "worst case", (unsigned long)p->stackWorst);
+}
+
+static int readCsv(const char *path, rows_t *r)
+{
+	char line[512], project[LABEL_LEN], kind[16], name[2 * MAP_NAME_LEN + 4];
+	unsigned long bytes;
+	int lineNumber = 0;
+	FILE *f = fopen(path, "r");
+
+	if (!f)
+	{
+		fprintf(stderr, "%s: cannot open\n", path);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f))
+	{
+		if (++lineNumber == 1)
+			continue;                   // header
+		if (sscanf(line, "%127[^,],%15[^,],%135[^,],%lu", project, kind, name, &bytes) != 4)
+		{
+			fprintf(stderr, "%s:%d: not a mapstat result\n", path, lineNumber);
+			fclose(f);
+			return -1;
+		}
+		addRow(r, project, kind, name, bytes);
+	}
+	fclose(f);
+	return 0;
+}
+
+/************************************************
+*   compare                                     *
+*                                               *
+*   Desc.: Lists every row whose size changed,  *
+*          appeared or went away               *
+*   Outputs: Number of segments and stacks that *
+*            grew                               *
+************************************************/
+
+static int compare(rows_t *now, rows_t *before)
+{
+	int i, j, worse = 0;
+
+	for (i = 0; i < now->count; i++)
+	{
+		row_t *n = &now->rows[i], *b = NULL;
+		int grown = 0;
+
+		for (j = 0; j < before->count && !b; j++)
+			if (!before->rows[j].matched && strcmp(before->rows[j].project, n->project) == 0 &&
+				strcmp(before->rows[j].kind, n->kind) == 0 && strcmp(before->rows[j].name, n->name) == 0)
+				b = &before->rows[j];
+		if (b)
+		{
+			b->matched = 1;
+			if (n->bytes == b->bytes)
+				continue;
+			grown = n->bytes > b->bytes;
+			fprintf(stderr, "%s %s %s: %lu bytes, was %lu (%+ld)\n", n->project, n->kind, n->name, n->bytes, b->bytes,
+				(long)n->bytes - (long)b->bytes);
+		}
+		else if (n->bytes)
+		{
+			grown = 1;
+			fprintf(stderr, "%s %s %s: %lu bytes, new\n", n->project, n->kind, n->name, n->bytes);
+		}
+		if (grown && (strcmp(n->kind, "segment") == 0 || strcmp(n->kind, "stack") == 0))
+			worse++;
+	}
+	for (j = 0; j < before->count; j++)
+		if (!before->rows[j].matched && before->rows[j].bytes)
+			fprintf(stderr, "%s %s %s: gone, was %lu bytes\n", before->rows[j].project, before->rows[j].kind,
+				before->rows[j].name, before->rows[j].bytes);
+	return worse;
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "usage: mapstat [-t target] [-n count] [-s] [-c] [-r reference] [project or .map ...]\n");
+	exit(2);
+}
+
+int main(int argc, char **argv)
+{
+	static project_t projects[MAX_PROJECTS];
+	const char *target = DEFAULT_TARGET, *referencePath = NULL;
+	int opt, csv = 0, summaryOnly = 0, objects = DEFAULT_OBJECTS, count = 0, overflow = 0, worse = 0, i;
+	rows_t now = {0}, before = {0};
+	glob_t found;
+
+	while ((opt = getopt(argc, argv, "t:n:scr:")) != -1)
+	{
+		switch (opt)
+		{
+			case 't': target = optarg; break;
+			case 'n': objects = atoi(optarg); break;
+			case 's': summaryOnly = 1; break;
+			case 'c': csv = 1; break;
+			case 'r': referencePath = optarg; break;
+			default: usage();
+		}
+	}
+
+	memset(&found, 0, sizeof(found));
+	if (optind == argc)
+	{
+		glob("Lab 8/*/bin", 0, NULL, &found);
+		glob("Lab 9/*/bin", GLOB_APPEND, NULL, &found);
+		for (i = 0; i < (int)found.gl_pathc; i++)
+			found.gl_pathv[i][strlen(found.gl_pathv[i]) - 4] = '\0';
+		if (found.gl_pathc == 0)
+		{
+			fprintf(stderr, "mapstat: no \"Lab 8\" or \"Lab 9\" projects here\n");
+			return 2;
+		}
+	}
+
+	for (i = 0; i < (optind == argc ? (int)found.gl_pathc : argc - optind) && count < MAX_PROJECTS; i++)
+	{
+		const char *arg = optind == argc ? found.gl_pathv[i] : argv[optind + i];
+		project_t *p = &projects[count];
+
+		if (findProject(arg, target, p) < 0)
+		{
+			fprintf(stderr, "%s: no %s\n", arg, p->mapPath);
+			continue;
+		}
+		if (loadProject(p) < 0)
+		{
+			fprintf(stderr, "%s: %s lists no sections, skipped\n", p->label, projectPath(p, p->mapPath));
+			map_free(&p->map);
+			continue;
+		}
+		overflow |= p->overflow;
+		count++;
+	}
+
+	if (csv)
+	{
+		for (i = 0; i < count; i++)
+			collectRows(&projects[i], &now);
+		printf("project,kind,name,bytes\n");
+		for (i = 0; i < now.count; i++)
+			printf("%s,%s,%s,%lu\n", now.rows[i].project, now.rows[i].kind, now.rows[i].name, now.rows[i].bytes);
+	}
+	else
+	{
+		if (!summaryOnly)
+			for (i = 0; i < count; i++)
+				report(&projects[i], objects);
+		if (count > 1 || summaryOnly)
+			summary(projects, count);
+	}
+
+	if (referencePath)
+	{
+		size_t n = strlen(referencePath);
+
+		if (now.count == 0)
+			for (i = 0; i < count; i++)
+				collectRows(&projects[i], &now);
+		if (n > 4 && strcmp(referencePath + n - 4, ".csv") == 0)
+		{
+			if (readCsv(referencePath, &before) < 0)
+				return 2;
+		}
+		else
+		{
+			// Another build of the same project(s): compare under the current labels
+			static project_t reference;
+			if (findProject(referencePath, target, &reference) < 0 || loadProject(&reference) < 0)
+			{
+				fprintf(stderr, "%s: no linked map\n", referencePath);
+				return 2;
+			}
+			collectRows(&reference, &before);
+			if (count == 1)
+				for (i = 0; i < before.count; i++)
+					snprintf(before.rows[i].project, sizeof(before.rows[i].project), "%s", projects[0].label);
+		}
+		worse = compare(&now, &before);
+	}
+
+	globfree(&found);
+	return overflow || worse ? 1 : 0;
+}
@@ -0,0 +1,199 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    pidstep.c                                      *
+*          Runs the Lab 9 position loop on the simulated  *
+*          board and measures a step response             *
+*---------------------------------------------------------*
+* Usage: pidstep [options]                                *
+*   -r counts    step size                                *
+*   -t ms        time to record after the step            *
+*   -p/-i/-d n   gains, as KP/KI/KD in Lab9_3 main.c      *
+*   -v counts/s  motor speed at 100% duty                 *
+*   -T ms        motor time constant                      *
+*   -b counts    settling band, default 2% of the step    *
+*   -m v,a,j     move with a motion profile: counts/s,    *
+*                counts/s^2, counts/s^3; 0 for a step     *
+*   -c           print the response as CSV, one row/ms    *
+**********************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <hidef.h>
+#include "derivative.h"
+#include "advancedLCD.h"
+#include "encoder.h"
+#include "control.h"
+
+#define DEFAULT_STEP    1000
+#define DEFAULT_MS      1000
+#define DEFAULT_KP      640             // Lab9_3 main.c
+#define DEFAULT_KI      16
+#define DEFAULT_KD      1280
+#define DEFAULT_SPEED   6000.0
+#define DEFAULT_TAU_MS  40.0
+#define DEFAULT_VMAX    6000L           // Lab9_3 main.c
+#define DEFAULT_AMAX    50000L
+#define DEFAULT_JMAX    1000000L
+#define SETTLE_BAND     0.02            // settled once inside 2% of the step (at least 2 counts)
+
+void Control_ISR(void);
+void Encoder_ISR(void);
+void LCD_Timer_ISR(void);
+void Timebase_ISR(void);
+
+static void usage(void)
+{
+	fprintf(stderr, "usage: pidstep [-r counts] [-t ms] [-p kp] [-i ki] [-d kd] [-v counts/s] [-T ms] [-b counts] [-m v,a,j] [-c]\n");
+	exit(2);
+}
+
+// PWM channel 0 and the LCD as Lab9_3 main.c sets them up
+static void initializeBoard(void)
+{
+	DDRB = 0xFF;
+	DDRP = 0xFF;
+	PORTB = 0x01;
+	PWMCLK = 0x01;
+	PWMPRCLK = 0x07;
+	PWMPOL = 0x01;
+	PWMCAE = 0;
+	PWMCTL = 0;
+	PWME = 0x01;
+	PWMSCLA = 0x04;
+	PWMPER0 = 0x74;
+	setOutput(0);
+
+	DDRK = 0xFF;
+	initializeLCD();
+	setLCDMode(LCD_MODE_BUFFERED);
+	printLCDText("Servo Lab v1.0$");
+	moveLCDTo(0, 1);
+	printLCDText("Refer: $");
+}
+
+int main(int argc, char **argv)
+{
+	long step = DEFAULT_STEP, position, peak, error, band = 0;
+	long vmax = DEFAULT_VMAX, amax = DEFAULT_AMAX, jmax = DEFAULT_JMAX;
+	int kp = DEFAULT_KP, ki = DEFAULT_KI, kd = DEFAULT_KD, csv = 0, opt;
+	unsigned long ms = DEFAULT_MS, t, rise10 = 0, rise90 = 0, settled = 0, arrived = 0;
+	double speed = DEFAULT_SPEED, tauMs = DEFAULT_TAU_MS, hostSeconds;
+	struct controlStats stats;
+	hal_board_t *b;
+	clock_t start;
+
+	while ((opt = getopt(argc, argv, "r:t:p:i:d:v:T:b:m:c")) != -1)
+	{
+		switch (opt)
+		{
+			case 'r': step = strtol(optarg, NULL, 0); break;
+			case 't': ms = strtoul(optarg, NULL, 0); break;
+			case 'p': kp = atoi(optarg); break;
+			case 'i': ki = atoi(optarg); break;
+			case 'd': kd = atoi(optarg); break;
+			case 'v': speed = atof(optarg); break;
+			case 'T': tauMs = atof(optarg); break;
+			case 'b': band = strtol(optarg, NULL, 0); break;
+			case 'm':
+				vmax = amax = jmax = 0;
+				if (sscanf(optarg, "%ld,%ld,%ld", &vmax, &amax, &jmax) < 1)
+					usage();
+				break;
+			case 'c': csv = 1; break;
+			default: usage();
+		}
+	}
+	if (optind != argc || step == 0 || ms == 0 || band < 0)
+		usage();
+
+	b = hal_create();
+	hal_set_vector(b, HAL_VECTOR_ECT(6), Control_ISR);
+	hal_set_vector(b, HAL_VECTOR_ECT(7), LCD_Timer_ISR);
+	hal_set_vector(b, HAL_VECTOR_PORTP, Encoder_ISR);
+	hal_set_vector(b, HAL_VECTOR_TOF, Timebase_ISR);
+	hal_motor(b, speed, tauMs / 1000.0);
+	hal_select(b);
+	start = clock();
+
+	initializeBoard();
+	initializeEncoder();
+	EnableInterrupts;
+	initializeControl(kp, ki, kd);
+	setControlProfile(vmax, amax, jmax);
+	setControlReference(0);
+	startControl();
+	hal_run(b, 10000);
+
+	resetControlStats();
+	moveControlTo(step);
+	moveLCDTo(10, 1);
+	printLCDNumber((int)step);
+	peak = 0;
+	if (!band)
+		band = labs(step) * SETTLE_BAND > 2 ? (long)(labs(step) * SETTLE_BAND) : 2;
+	if (csv)
+		printf("ms,position,reference,output\n");
+	for (t = 1; t <= ms; t++)
+	{
+		hal_run(b, 1000);
+		position = getEncoderPosition();
+		if (csv)
+			printf("%lu,%ld,%ld,%d\n", t, position, getControlReference(), getControlOutput());
+		if (!arrived && !isControlMoving())
+			arrived = t;
+		if (step > 0 ? position > peak : position < peak)
+			peak = position;
+		if (!rise10 && labs(position) * 10 >= labs(step))
+			rise10 = t;
+		if (!rise90 && labs(position) * 10 >= labs(step) * 9)
+			rise90 = t;
+		error = position - step;
+		if (labs(error) > band)
+			settled = 0;
+		else if (!settled)
+			settled = t;
+		if (t % 100 == 0)
+		{
+			moveLCDTo(0, 0);
+			printLCDText("Actual:   $");
+			printLCDNumber((int)position);
+		}
+	}
+	getControlStats(&stats);
+	hostSeconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+	if (csv)
+		return 0;
+
+	printf("Step:          %ld counts, KP %d KI %d KD %d\n", step, kp, ki, kd);
+	printf("Motor:         %.0f counts/s at 100%%, time constant %.1f ms\n", speed, tauMs);
+	if (vmax > 0 && amax > 0 && arrived)
+		printf("Profile:       %ld counts/s, %ld counts/s^2, jerk %ld counts/s^3, reference there at %lu ms\n",
+			vmax, amax, jmax, arrived);
+	else if (vmax > 0 && amax > 0)
+		printf("Profile:       %ld counts/s, %ld counts/s^2, jerk %ld counts/s^3, reference not there in %lu ms\n",
+			vmax, amax, jmax, ms);
+	else
+		printf("Profile:       none, the reference steps\n");
+	if (rise90)
+		printf("Rise time:     %lu ms (10%% to 90%%)\n", rise90 - rise10);
+	else
+		printf("Rise time:     did not reach 90%% in %lu ms\n", ms);
+	printf("Overshoot:     %ld counts (%.1f%%)\n", labs(peak) > labs(step) ? labs(peak - step) : 0L,
+		labs(peak) > labs(step) ? 100.0 * labs(peak - step) / labs(step) : 0.0);
+	if (settled)
+		printf("Settling time: %lu ms (within %ld counts)\n", settled, band);
+	else
+		printf("Settling time: not settled within %ld counts in %lu ms\n", band, ms);
+	printf("Final error:   %ld counts\n", getEncoderPosition() - step);
+	printf("Loop period:   min %u, mean %u, max %u us over %lu samples, %u overruns\n",
+		stats.minPeriod, stats.meanPeriod, stats.maxPeriod, stats.samples, stats.overruns);
+	printf("Encoder:       %lu interrupts, %u illegal transitions\n",
+		hal_interrupt_count(b, HAL_VECTOR_PORTP), getEncoderErrors());
+	printf("LCD:           [%s] [%s]\n", hal_lcd_line(b, 0), hal_lcd_line(b, 1));
+	printf("Host time:     %.3f s for %.3f s simulated\n", hostSeconds, hal_micros(b) / 1e6);
+	hal_destroy(b);
+	return 0;
+}
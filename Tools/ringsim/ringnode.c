@@ -0,0 +1,10 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    ringnode.c                                     *
+*          Node number of one copy of ringnode.so         *
+**********************************************************/
+
+#include "ringnode.h"
+
+unsigned char ringNodeId = '1';
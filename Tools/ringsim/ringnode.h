@@ -0,0 +1,20 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    ringnode.h                                     *
+*          Forced into each file of ringnode.so with      *
+*          -include                                       *
+*---------------------------------------------------------*
+* mainFinal.c takes its node number from MACHINE_ID. In  *
+* the library it is a variable, so that ringsim can give  *
+* each loaded copy its own number.                        *
+**********************************************************/
+
+#ifndef _RINGNODE_H
+#define _RINGNODE_H
+
+extern unsigned char ringNodeId;
+
+#define MACHINE_ID  ringNodeId
+
+#endif
@@ -0,0 +1,601 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    ringsim.c                                      *
+*          Runs rings of Lab 7 boards on the host and     *
+*          measures message delivery                      *
+*---------------------------------------------------------*
+* Usage: ringsim [options]                                *
+*   -n sizes     ring sizes, e.g. 2,4,8 (2 to 64)         *
+*   -t seconds   how long the nodes keep typing           *
+*   -k ms        key press (and release) time             *
+*   -g ms        pause between two messages of a node     *
+*   -l length    message length, 5 to 9 characters        *
+*   -e rate      chance that an SDA edge is lost          *
+*   -q us        time slice of each node                  *
+*   -a cycles    bus cycles per register access           *
+*   -s seed      traffic pattern                          *
+*   -m file      node library (default ./ringnode.so)     *
+*   -v           link and task counters of every node     *
+*---------------------------------------------------------*
+* Every node is a separate copy of ringnode.so: Lab 7     *
+* mainFinal.c with ringlink.c, keypad.c, textentry.c and  *
+* the LCD driver, on its own simulated board             *
+* (Tools/host). Each copy's main() runs as a coroutine    *
+* for one time slice at a time. PB0/PB1 of a node drive   *
+* PT0/PT1 of the next one and PT2 drives PB2 of the one   *
+* before, as in the port assignment comment of            *
+* mainFinal.c. Traffic is typed on the keypads and a      *
+* message counts as delivered when the recipient's LCD    *
+* shows it.                                               *
+**********************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <ucontext.h>
+#include "../host/hal.h"
+#include "ringlink.h"
+#include "scheduler.h"
+
+#define MAX_NODES       64
+#define MAX_SIZES       16
+#define STACK_SIZE      (256 * 1024)
+#define MAX_KEYS        64
+#define TAG_LENGTH      5               // 2 characters for the sender, 3 for its message count
+#define MAX_LENGTH      9               // LCD_WIDTH - 7, the longest message mainFinal.c accepts
+#define START_US        50000ULL        // boot time before the first key press
+#define LCD_POLL_US     1000ULL
+#define DRAIN_US        5000000ULL      // longest wait for messages still in the ring after typing stops
+
+#define DEFAULT_SIZES   "2,4,8,16,32,64"
+#define DEFAULT_SECONDS 5.0
+#define DEFAULT_KEY_MS  20
+#define DEFAULT_LENGTH  MAX_LENGTH
+#define DEFAULT_QUANTUM 10
+#define DEFAULT_ACCESS  12              // roughly the instructions around each access in the ring ISRs
+
+// Key codes of mainFinal.c with a meaning of their own
+#define CODE_BREAK      0x01            // ends a multi-press character
+#define CODE_NEXT       0x04            // message -> recipient -> send
+
+// Keypad legends in key number order (keypad.h); keypadTable[] in mainFinal.c gives their codes
+static const char scanLegends[] = "ABCD369#2580147*";
+static const char hexDigits[] = "0123456789ABCDEF";
+
+#define MSG_TYPING      0
+#define MSG_SENT        1
+#define MSG_DELIVERED   2
+#define MSG_BUSY        3               // the sender's outbound queue was full
+
+typedef struct message
+{
+	int sender, recipient, hops, state;
+	char text[MAX_LENGTH + 1];
+	unsigned long long sent, delivered;
+} message_t;
+
+typedef struct node
+{
+	hal_board_t *board;
+	void *lib;
+	void *stack;
+	ucontext_t context;
+	void (*main)(void);
+	void (*getRingStats)(struct ringStats *stats);
+	void (*getTaskStats)(unsigned char task, struct taskStats *stats);
+	unsigned char *id, *keyTaskId, *ringTaskId;
+	unsigned char sda;                  // SDA level as the next node sees it
+	char line[HAL_LCD_WIDTH + 1];       // bottom LCD line at the last poll
+
+	char keys[MAX_KEYS];                // legends still to press for the current message
+	int keyCount, keyNext, keyDown;
+	unsigned long long keyAt;
+	int message;                        // being typed, -1 if none
+	int typed;
+} node_t;
+
+typedef struct result
+{
+	int nodes, sent, delivered, busy, lost, misdelivered;
+	double latencyMean, latency95, latencyMax, msPerHop, messagesPerSecond, bytesPerSecond, hostSeconds;
+	unsigned long framesSent, framesAcked, resends, dropped, crcErrors, overruns;
+} result_t;
+
+static node_t nodes[MAX_NODES];
+static int nodeCount;
+static node_t *running;
+static ucontext_t scheduler;
+static message_t *messages;
+static int messageCount, messageSpace;
+static unsigned char keypadCodes[16];
+static const char * const *keyGlyphs;       // in the library that stays loaded for the whole run
+static char alphabet[16];
+static unsigned int randomState;
+
+// Options
+static const char *libraryPath = "./ringnode.so";
+static unsigned long long trafficUs, keyUs, gapUs, quantumUs;
+static int messageLength, accessCycles, verbose;
+static double edgeLossRate;
+
+static void fail(const char *message, const char *detail)
+{
+	fprintf(stderr, "ringsim: %s%s\n", message, detail ? detail : "");
+	exit(1);
+}
+
+static unsigned int nextRandom(void)
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return randomState;
+}
+
+static void *symbol(node_t *n, const char *name)
+{
+	void *p = dlsym(n->lib, name);
+
+	if (!p)
+		fail("not in the node library: ", name);
+	return p;
+}
+
+// dlopen() returns the same instance for the same file, so each node loads a private copy
+static void loadNode(node_t *n)
+{
+	char path[] = "/tmp/ringnodeXXXXXX";
+	char buf[65536];
+	FILE *in, *out;
+	size_t got;
+	int fd;
+
+	in = fopen(libraryPath, "rb");
+	if (!in)
+		fail("cannot open ", libraryPath);
+	fd = mkstemp(path);
+	out = fd < 0 ? NULL : fdopen(fd, "wb");
+	if (!out)
+		fail("cannot create ", path);
+	while ((got = fread(buf, 1, sizeof(buf), in)) > 0)
+		fwrite(buf, 1, got, out);
+	fclose(in);
+	fclose(out);
+	n->lib = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+	unlink(path);
+	if (!n->lib)
+		fail("cannot load the node library: ", dlerror());
+}
+
+/* ---- Wiring ---- */
+
+static void outputB(void *context, hal_board_t *b, int port, unsigned char outputs)
+{
+	node_t *n = context, *next = &nodes[(n - nodes + 1) % nodeCount];
+
+	(void)b;
+	(void)port;
+	if (((outputs ^ n->sda) & 0x02) && (double)nextRandom() / 4294967296.0 >= edgeLossRate)
+		n->sda = outputs & 0x02;
+	hal_set_inputs(next->board, HAL_PORT_T, 0x03, (unsigned char)((outputs & 0x01) | n->sda));
+}
+
+static void outputT(void *context, hal_board_t *b, int port, unsigned char outputs)
+{
+	node_t *n = context, *previous = &nodes[(n - nodes + nodeCount - 1) % nodeCount];
+
+	(void)b;
+	(void)port;
+	hal_set_inputs(previous->board, HAL_PORT_B, 0x04, outputs & 0x04);
+}
+
+/* ---- Coroutines ---- */
+
+static void yieldNode(void *context, hal_board_t *b)
+{
+	node_t *n = context;
+
+	(void)b;
+	swapcontext(&n->context, &scheduler);
+}
+
+static void startNode(void)
+{
+	running->main();
+	fail("a node's main() returned", NULL);
+}
+
+static void createNode(node_t *n, int index)
+{
+	n->board = hal_create();
+	loadNode(n);
+	n->main = (void (*)(void))symbol(n, "ringNodeMain");
+	n->getRingStats = (void (*)(struct ringStats *))symbol(n, "getRingStats");
+	n->getTaskStats = (void (*)(unsigned char, struct taskStats *))symbol(n, "getTaskStats");
+	n->id = symbol(n, "ringNodeId");
+	n->keyTaskId = symbol(n, "keyTaskId");
+	n->ringTaskId = symbol(n, "ringTaskId");
+	*n->id = (unsigned char)hexDigits[index % 16];
+	hal_set_vector(n->board, HAL_VECTOR_ECT(0), (hal_isr_t)symbol(n, "RingClock_ISR"));
+	hal_set_vector(n->board, HAL_VECTOR_ECT(1), (hal_isr_t)symbol(n, "RingData_ISR"));
+	hal_set_vector(n->board, HAL_VECTOR_ECT(3), (hal_isr_t)symbol(n, "RingSend_ISR"));
+	hal_set_vector(n->board, HAL_VECTOR_ECT(5), (hal_isr_t)symbol(n, "Keypad_ISR"));
+	hal_set_vector(n->board, HAL_VECTOR_ECT(7), (hal_isr_t)symbol(n, "LCD_Timer_ISR"));
+	hal_set_vector(n->board, HAL_VECTOR_TOF, (hal_isr_t)symbol(n, "Timebase_ISR"));
+	hal_set_access_cycles(n->board, (unsigned int)accessCycles);
+	hal_watch(n->board, HAL_PORT_B, outputB, n);
+	hal_watch(n->board, HAL_PORT_T, outputT, n);
+	n->sda = 0x02;
+	memset(n->line, 0, sizeof(n->line));
+	n->keyCount = n->keyNext = n->keyDown = 0;
+	n->keyAt = START_US + (unsigned long long)index * keyUs / 4;   // not all in step
+	n->message = -1;
+	n->typed = 0;
+
+	n->stack = malloc(STACK_SIZE);
+	if (!n->stack)
+		fail("out of memory", NULL);
+	getcontext(&n->context);
+	n->context.uc_stack.ss_sp = n->stack;
+	n->context.uc_stack.ss_size = STACK_SIZE;
+	n->context.uc_link = NULL;
+	makecontext(&n->context, startNode, 0);
+}
+
+static void destroyNode(node_t *n)
+{
+	hal_destroy(n->board);
+	dlclose(n->lib);
+	free(n->stack);
+}
+
+/* ---- Traffic ---- */
+
+// Legend to press, and how many times, to type 'c' from the keyGlyphs[] table of mainFinal.c
+static int keysFor(char c, char *legend)
+{
+	const char *found;
+	int j, presses, best = 0;
+
+	for (j = 0; j < 16; j++)
+	{
+		if (!keyGlyphs[j] || (found = strchr(keyGlyphs[j], c)) == NULL || c == '\0')
+			continue;
+		presses = (int)(found - keyGlyphs[j]) + 1;
+		if (!best || presses < best)
+		{
+			best = presses;
+			*legend = scanLegends[j];
+		}
+	}
+	return best;
+}
+
+static char legendOf(unsigned char code)
+{
+	int j;
+
+	for (j = 0; j < 16; j++)
+		if (keypadCodes[j] == code)
+			return scanLegends[j];
+	fail("mainFinal.c has no key for a code ringsim needs", NULL);
+	return 0;
+}
+
+static void addKeys(node_t *n, char c, char *last)
+{
+	char legend = 0;
+	int presses = keysFor(c, &legend);
+
+	if (!presses)
+		fail("cannot type a character of the message", NULL);
+	if (legend == *last)
+		n->keys[n->keyCount++] = legendOf(CODE_BREAK);
+	while (presses--)
+		n->keys[n->keyCount++] = legend;
+	*last = legend;
+}
+
+static void planMessage(node_t *n)
+{
+	int sender = (int)(n - nodes), target, hops, i, symbols = (int)strlen(alphabet);
+	message_t *m;
+	char last = 0;
+
+	// Any other node number on the ring; with more than 16 nodes the first one downstream gets it
+	do
+		target = (int)(nextRandom() % (unsigned int)nodeCount);
+	while (*nodes[target].id == *n->id);
+	for (hops = 1; *nodes[(sender + hops) % nodeCount].id != *nodes[target].id; hops++)
+		;
+
+	if (messageCount == messageSpace)
+	{
+		messageSpace = messageSpace ? 2 * messageSpace : 1024;
+		messages = realloc(messages, sizeof(*messages) * (size_t)messageSpace);
+		if (!messages)
+			fail("out of memory", NULL);
+	}
+	m = &messages[messageCount];
+	m->sender = sender;
+	m->recipient = (sender + hops) % nodeCount;
+	m->hops = hops;
+	m->state = MSG_TYPING;
+	m->text[0] = alphabet[sender / symbols % symbols];
+	m->text[1] = alphabet[sender % symbols];
+	m->text[2] = alphabet[n->typed / (symbols * symbols) % symbols];
+	m->text[3] = alphabet[n->typed / symbols % symbols];
+	m->text[4] = alphabet[n->typed % symbols];
+	for (i = TAG_LENGTH; i < messageLength; i++)
+		m->text[i] = alphabet[(n->typed + i) % symbols];
+	m->text[messageLength] = '\0';
+	n->typed++;
+
+	n->keyCount = n->keyNext = 0;
+	for (i = 0; i < messageLength; i++)
+		addKeys(n, m->text[i], &last);
+	n->keys[n->keyCount++] = legendOf(CODE_NEXT);
+	last = 0;
+	addKeys(n, (char)*nodes[m->recipient].id, &last);
+	n->keys[n->keyCount++] = legendOf(CODE_NEXT);
+	n->message = messageCount++;
+}
+
+static void typeKeys(node_t *n, unsigned long long now)
+{
+	if (now < n->keyAt)
+		return;
+	if (n->message < 0)
+	{
+		if (now < START_US + trafficUs)
+			planMessage(n);
+		return;
+	}
+	hal_key(n->board, n->keys[n->keyNext], !n->keyDown);
+	n->keyDown = !n->keyDown;
+	n->keyAt = now + keyUs;
+	if (n->keyDown || ++n->keyNext < n->keyCount)
+		return;
+
+	// The last key is up: mainFinal.c queues the message on its next pass
+	messages[n->message].state = MSG_SENT;
+	messages[n->message].sent = now;
+	n->message = -1;
+	n->keyAt = now + keyUs + gapUs;
+}
+
+static message_t *findMessage(const char *text)
+{
+	int i;
+
+	for (i = messageCount - 1; i >= 0; i--)
+		if (messages[i].state == MSG_SENT && strncmp(messages[i].text, text, TAG_LENGTH) == 0)
+			return &messages[i];
+	return NULL;
+}
+
+// mainFinal.c shows a message for this node on the bottom line as "Recv: text", and "Not sent: busy"
+// there when queueRingFrame() failed
+static void watchLcd(node_t *n, unsigned long long now, result_t *r)
+{
+	const char *line = hal_lcd_line(n->board, 1);
+	message_t *m;
+	int i;
+
+	if (strcmp(line, n->line) == 0)
+		return;
+	strcpy(n->line, line);
+	if (strncmp(line, "Recv: ", 6) == 0 && (m = findMessage(line + 6)) != NULL)
+	{
+		m->state = MSG_DELIVERED;
+		m->delivered = now;
+		if (m->recipient != n - nodes)
+			r->misdelivered++;
+	}
+	else if (strncmp(line, "Not sent: busy", 14) == 0)
+	{
+		for (i = messageCount - 1; i >= 0; i--)
+			if (messages[i].sender == n - nodes && messages[i].state == MSG_SENT)
+			{
+				messages[i].state = MSG_BUSY;
+				break;
+			}
+	}
+}
+
+static int compareDouble(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static int outstanding(void)
+{
+	int i;
+
+	for (i = 0; i < messageCount; i++)
+		if (messages[i].state == MSG_SENT || messages[i].state == MSG_TYPING)
+			return 1;
+	return 0;
+}
+
+/* ---- One ring ---- */
+
+static void runRing(int count, result_t *r)
+{
+	unsigned long long now, end = START_US + trafficUs + DRAIN_US;
+	double *latencies, perHop = 0;
+	struct ringStats stats;
+	struct taskStats keyStats, ringStats;
+	clock_t start = clock();
+	int i, n = 0;
+
+	memset(r, 0, sizeof(*r));
+	r->nodes = nodeCount = count;
+	messageCount = 0;
+	for (i = 0; i < count; i++)
+		createNode(&nodes[i], i);
+
+	for (now = 0; now < end; now += quantumUs)
+	{
+		for (i = 0; i < count; i++)
+		{
+			typeKeys(&nodes[i], now);
+			hal_select(nodes[i].board);
+			hal_set_deadline(nodes[i].board, now + quantumUs, yieldNode, &nodes[i]);
+			running = &nodes[i];
+			swapcontext(&scheduler, &nodes[i].context);
+		}
+		if (now % LCD_POLL_US == 0)
+		{
+			for (i = 0; i < count; i++)
+				watchLcd(&nodes[i], now, r);
+			if (now > START_US + trafficUs && !outstanding())
+				break;
+		}
+	}
+	hal_select(NULL);
+
+	latencies = malloc(sizeof(double) * (size_t)(messageCount + 1));
+	for (i = 0; i < messageCount; i++)
+	{
+		message_t *m = &messages[i];
+		if (m->state == MSG_TYPING)
+			continue;
+		r->sent++;
+		if (m->state == MSG_BUSY)
+			r->busy++;
+		else if (m->state == MSG_SENT)
+			r->lost++;
+		else
+		{
+			latencies[n++] = (m->delivered - m->sent) / 1000.0;
+			perHop += (m->delivered - m->sent) / 1000.0 / m->hops;
+			r->latencyMean += (m->delivered - m->sent) / 1000.0;
+		}
+	}
+	r->delivered = n;
+	if (n)
+	{
+		qsort(latencies, (size_t)n, sizeof(double), compareDouble);
+		r->latencyMean /= n;
+		r->latency95 = latencies[(n * 95 + 99) / 100 - 1];
+		r->latencyMax = latencies[n - 1];
+		r->msPerHop = perHop / n;
+	}
+	free(latencies);
+	r->messagesPerSecond = n / (trafficUs / 1e6);
+	r->bytesPerSecond = r->messagesPerSecond * messageLength;
+
+	if (verbose)
+		printf("\n%d nodes\nNode  Sent      Acked     Forwarded  Fwd ms (mean/max)  Resends  Dropped  CRC  Overruns  Queue in/out"
+			"  Task max run us (key/ring)\n", count);
+	for (i = 0; i < count; i++)
+	{
+		nodes[i].getRingStats(&stats);
+		r->framesSent += stats.framesSent;
+		r->framesAcked += stats.framesAcked;
+		r->resends += stats.resends;
+		r->dropped += stats.framesDropped;
+		r->crcErrors += stats.crcErrors;
+		r->overruns += stats.rxOverruns;
+		if (!verbose)
+			continue;
+		nodes[i].getTaskStats(*nodes[i].keyTaskId, &keyStats);
+		nodes[i].getTaskStats(*nodes[i].ringTaskId, &ringStats);
+		printf("%2d %c  %-9lu %-9lu %-10lu %7.1f/%-10.1f %-8u %-8u %-4u %-9u %u/%-11u %lu/%lu\n", i,
+			*nodes[i].id, stats.framesSent, stats.framesAcked, stats.framesForwarded, stats.forwardLatencyMean / 1000.0,
+			stats.forwardLatencyMax / 1000.0, stats.resends, stats.framesDropped, stats.crcErrors,
+			stats.rxOverruns, stats.rxQueueMax, stats.txQueueMax, keyStats.worstRunUs, ringStats.worstRunUs);
+	}
+	for (i = 0; i < count; i++)
+		destroyNode(&nodes[i]);
+	r->hostSeconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "usage: ringsim [-n sizes] [-t seconds] [-k ms] [-g ms] [-l length] [-e rate] [-q us] [-a cycles]\n"
+		"               [-s seed] [-m ringnode.so] [-v]\n");
+	exit(2);
+}
+
+int main(int argc, char **argv)
+{
+	const char *sizeList = DEFAULT_SIZES;
+	int sizes[MAX_SIZES], sizeCount = 0, opt, i, j;
+	double seconds = DEFAULT_SECONDS;
+	unsigned long keyMs = DEFAULT_KEY_MS, gapMs = 0;
+	char *end;
+	result_t r;
+	node_t probe;
+
+	messageLength = DEFAULT_LENGTH;
+	quantumUs = DEFAULT_QUANTUM;
+	accessCycles = DEFAULT_ACCESS;
+	randomState = 1;
+	while ((opt = getopt(argc, argv, "n:t:k:g:l:e:q:a:s:m:v")) != -1)
+	{
+		switch (opt)
+		{
+			case 'n': sizeList = optarg; break;
+			case 't': seconds = atof(optarg); break;
+			case 'k': keyMs = strtoul(optarg, NULL, 0); break;
+			case 'g': gapMs = strtoul(optarg, NULL, 0); break;
+			case 'l': messageLength = atoi(optarg); break;
+			case 'e': edgeLossRate = atof(optarg); break;
+			case 'q': quantumUs = strtoull(optarg, NULL, 0); break;
+			case 'a': accessCycles = atoi(optarg); break;
+			case 's': randomState = (unsigned int)strtoul(optarg, NULL, 0) | 1; break;
+			case 'm': libraryPath = optarg; break;
+			case 'v': verbose = 1; break;
+			default: usage();
+		}
+	}
+	for (end = (char *)sizeList; *end && sizeCount < MAX_SIZES; end += *end == ',')
+	{
+		sizes[sizeCount] = (int)strtol(end, &end, 10);
+		if (sizes[sizeCount] < 2 || sizes[sizeCount] > MAX_NODES || (*end && *end != ','))
+			usage();
+		sizeCount++;
+	}
+	if (optind != argc || sizeCount == 0 || seconds <= 0 || keyMs == 0 || quantumUs == 0 || accessCycles <= 0
+		|| messageLength < TAG_LENGTH || messageLength > MAX_LENGTH || edgeLossRate < 0 || edgeLossRate >= 1)
+		usage();
+	trafficUs = (unsigned long long)(seconds * 1e6);
+	keyUs = keyMs * 1000ULL;
+	gapUs = gapMs * 1000ULL;
+
+	// The key codes and the characters of each key; the first of each (bar space) takes a single press
+	loadNode(&probe);
+	memcpy(keypadCodes, symbol(&probe, "keypadTable"), sizeof(keypadCodes));
+	keyGlyphs = symbol(&probe, "keyGlyphs");
+	for (i = 0, j = 0; i < 16; i++)
+		if (keyGlyphs[i] && keyGlyphs[i][0] > ' ')
+			alphabet[j++] = keyGlyphs[i][0];
+
+	printf("%.1f s of typing, %lu ms per key, %d character messages, SDA edge loss %g\n",
+		seconds, keyMs, messageLength, edgeLossRate);
+	if (!verbose)
+		printf("Nodes  Sent  Deliv  Busy  Lost   Latency ms mean/p95/max  ms/hop  Msg/s  Bytes/s  Frames  Resends  Dropped  CRC  Host s\n");
+	for (i = 0; i < sizeCount; i++)
+	{
+		runRing(sizes[i], &r);
+		if (verbose)
+			printf("Nodes  Sent  Deliv  Busy  Lost   Latency ms mean/p95/max  ms/hop  Msg/s  Bytes/s  Frames  Resends  Dropped  CRC  Host s\n");
+		printf("%5d %5d %6d %5d %5d   %8.1f/%6.1f/%7.1f %7.2f %6.2f %8.1f %7lu %8lu %8lu %4lu %7.1f\n",
+			r.nodes, r.sent, r.delivered, r.busy, r.lost, r.latencyMean, r.latency95, r.latencyMax, r.msPerHop,
+			r.messagesPerSecond, r.bytesPerSecond, r.framesSent, r.resends, r.dropped, r.crcErrors, r.hostSeconds);
+		if (r.misdelivered)
+			printf("      %d messages shown on the wrong node\n", r.misdelivered);
+		fflush(stdout);
+	}
+	free(messages);
+	dlclose(probe.lib);
+	return 0;
+}
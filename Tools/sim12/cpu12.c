@@ -0,0 +1,1284 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    cpu12.c                                        *
+*          CPU12 instruction execution                    *
+*---------------------------------------------------------*
+* Every instruction is charged the number of bus cycles   *
+* listed for the HCS12 in the CPU12 Reference Manual      *
+* (one cycle per letter of its access detail).            *
+**********************************************************/
+
+#include <string.h>
+#include "cpu12.h"
+
+// Cycle counts of the indexed addressing classes IDX, IDX1, IDX2, [D,IDX], [IDX2] for each instruction group
+const unsigned char cpu12_idxCycles[IDXCYC_GROUPS][5] =
+{
+	{3, 3, 4, 6, 6},        // IDXCYC_READ   rPf      rPO      frPP      fIfrPf     fIPrPf
+	{2, 3, 3, 4, 4},        // IDXCYC_WRITE  Pw       PwO      PwP       PIfw       PIPw
+	{3, 4, 5, 6, 6},        // IDXCYC_RMW    rPw      rPwO     frPwP     fIfrPw     fIPrPw
+	{2, 2, 2, 2, 2},        // IDXCYC_LEA    Pf       PO       PP
+	{3, 3, 4, 6, 6},        // IDXCYC_JMP    PPP      PPP      fPPP      fIfPPP     fIfPPP
+	{4, 4, 5, 7, 7},        // IDXCYC_JSR    PPPS     PPPS     fPPPS     fIfPPPS    fIfPPPS
+	{7, 7, 8, 10, 10},      // IDXCYC_CALL   gnSsPPP  gnSsPPP  fgnSsPPP  fIignSsPPP fIignSsPPP
+	{4, 4, 6, 6, 6},        // IDXCYC_BSET   rPwO     rPwP     frPwPO
+	{4, 5, 6, 6, 6},        // IDXCYC_BRSET  rPPP     rfPPP    PrfPPP
+	{4, 4, 5, 7, 7},        // IDXCYC_MIN    OrPf     OrPO     OfrPP     OfIfrPf    OfIPrPf
+	{4, 5, 6, 7, 7}         // IDXCYC_MINM   OrPw     OrPwO    OfrPwP    OfIfrPw    OfIPrPw
+};
+
+#define cycRead     cpu12_idxCycles[IDXCYC_READ]
+#define cycWrite    cpu12_idxCycles[IDXCYC_WRITE]
+#define cycRmw      cpu12_idxCycles[IDXCYC_RMW]
+#define cycLea      cpu12_idxCycles[IDXCYC_LEA]
+#define cycJmp      cpu12_idxCycles[IDXCYC_JMP]
+#define cycJsr      cpu12_idxCycles[IDXCYC_JSR]
+#define cycCall     cpu12_idxCycles[IDXCYC_CALL]
+#define cycBset     cpu12_idxCycles[IDXCYC_BSET]
+#define cycBrset    cpu12_idxCycles[IDXCYC_BRSET]
+#define cycMin      cpu12_idxCycles[IDXCYC_MIN]
+#define cycMinm     cpu12_idxCycles[IDXCYC_MINM]
+
+// Pointer location of the last indirect indexed operand; CALL [..] reads its page byte from there
+static unsigned int indirectPointer;
+
+
+/************************************************
+*   Memory access                               *
+************************************************/
+
+static int isWindow(unsigned int addr)
+{
+	return addr >= CPU12_WINDOW_START && addr < CPU12_WINDOW_END;
+}
+
+static int isReadOnly(unsigned int addr)
+{
+	return (addr >= CPU12_IO_END && addr < CPU12_RAM_START) || addr >= CPU12_RAM_END;
+}
+
+unsigned char cpu12_read8(cpu12_t *cpu, unsigned int addr)
+{
+	unsigned int page;
+
+	addr &= 0xFFFF;
+	if (addr < CPU12_IO_END && cpu->io_read)
+		return cpu->io_read(cpu, addr);
+	if (isWindow(addr))
+	{
+		page = cpu->mem[CPU12_PPAGE_ADDR];
+		if (page < CPU12_PAGE_FIRST || page >= CPU12_PAGE_FIRST + CPU12_PAGE_COUNT)
+			return 0xFF;                    // erased / unimplemented page
+		return cpu->flash[page - CPU12_PAGE_FIRST][addr - CPU12_WINDOW_START];
+	}
+	return cpu->mem[addr];
+}
+
+unsigned int cpu12_read16(cpu12_t *cpu, unsigned int addr)
+{
+	return ((unsigned int)cpu12_read8(cpu, addr) << 8) | cpu12_read8(cpu, addr + 1);
+}
+
+void cpu12_write8(cpu12_t *cpu, unsigned int addr, unsigned char value)
+{
+	addr &= 0xFFFF;
+	if (addr < CPU12_IO_END)
+	{
+		if (cpu->io_write)
+			cpu->io_write(cpu, addr, value);
+		else
+			cpu->mem[addr] = value;
+	}
+	else if (isReadOnly(addr))
+		cpu->romWriteCount++;
+	else
+		cpu->mem[addr] = value;
+}
+
+void cpu12_write16(cpu12_t *cpu, unsigned int addr, unsigned int value)
+{
+	cpu12_write8(cpu, addr, (unsigned char)(value >> 8));
+	cpu12_write8(cpu, addr + 1, (unsigned char)value);
+}
+
+void cpu12_load(cpu12_t *cpu, unsigned long addr, unsigned char value)
+{
+	unsigned long page = addr >> 16;
+	unsigned int offset = (unsigned int)(addr & 0xFFFF);
+
+	if (page != 0)
+	{
+		// Banked linker address, e.g. 0x308000 for PAGE_30
+		if (page >= CPU12_PAGE_FIRST && page < CPU12_PAGE_FIRST + CPU12_PAGE_COUNT && isWindow(offset))
+			cpu->flash[page - CPU12_PAGE_FIRST][offset - CPU12_WINDOW_START] = value;
+		return;
+	}
+
+	cpu->mem[offset] = value;
+	// The fixed flash blocks are also visible through the window as PAGE_3E and PAGE_3F
+	if (offset >= 0x4000 && offset < 0x8000)
+		cpu->flash[0x3E - CPU12_PAGE_FIRST][offset - 0x4000] = value;
+	else if (offset >= 0xC000)
+		cpu->flash[0x3F - CPU12_PAGE_FIRST][offset - 0xC000] = value;
+}
+
+
+/************************************************
+*   Registers and stack                         *
+************************************************/
+
+unsigned int cpu12_d(cpu12_t *cpu)
+{
+	return ((unsigned int)cpu->a << 8) | cpu->b;
+}
+
+void cpu12_set_d(cpu12_t *cpu, unsigned int d)
+{
+	cpu->a = (unsigned char)(d >> 8);
+	cpu->b = (unsigned char)d;
+}
+
+static unsigned char fetch8(cpu12_t *cpu)
+{
+	unsigned char v = cpu12_read8(cpu, cpu->pc);
+	cpu->pc = (cpu->pc + 1) & 0xFFFF;
+	return v;
+}
+
+static unsigned int fetch16(cpu12_t *cpu)
+{
+	unsigned int v = cpu12_read16(cpu, cpu->pc);
+	cpu->pc = (cpu->pc + 2) & 0xFFFF;
+	return v;
+}
+
+static void push8(cpu12_t *cpu, unsigned char v)
+{
+	cpu->sp = (cpu->sp - 1) & 0xFFFF;
+	cpu12_write8(cpu, cpu->sp, v);
+}
+
+static void push16(cpu12_t *cpu, unsigned int v)
+{
+	cpu->sp = (cpu->sp - 2) & 0xFFFF;
+	cpu12_write16(cpu, cpu->sp, v);
+}
+
+static unsigned char pull8(cpu12_t *cpu)
+{
+	unsigned char v = cpu12_read8(cpu, cpu->sp);
+	cpu->sp = (cpu->sp + 1) & 0xFFFF;
+	return v;
+}
+
+static unsigned int pull16(cpu12_t *cpu)
+{
+	unsigned int v = cpu12_read16(cpu, cpu->sp);
+	cpu->sp = (cpu->sp + 2) & 0xFFFF;
+	return v;
+}
+
+// Index register selected by the 'rr' field of an indexed postbyte: X, Y, SP or PC
+static unsigned int getIndex(cpu12_t *cpu, int rr, unsigned int pcNext)
+{
+	switch (rr)
+	{
+		case 0: return cpu->x;
+		case 1: return cpu->y;
+		case 2: return cpu->sp;
+		default: return pcNext;
+	}
+}
+
+static void setIndex(cpu12_t *cpu, int rr, unsigned int v)
+{
+	v &= 0xFFFF;
+	if (rr == 0)
+		cpu->x = v;
+	else if (rr == 1)
+		cpu->y = v;
+	else if (rr == 2)
+		cpu->sp = v;
+}
+
+// Decodes an indexed postbyte (and its extension bytes) at PC and returns the effective address. 'tail' is
+// the number of operand bytes that follow the index bytes; PC-relative offsets are taken from the end of
+// the instruction.
+static unsigned int indexedAddress(cpu12_t *cpu, int *cls, int tail)
+{
+	unsigned char xb = fetch8(cpu);
+	int rr, offset;
+	unsigned int r, ea;
+
+	if ((xb & 0x20) == 0)
+	{
+		// rr0nnnnn: 5-bit signed constant offset
+		offset = xb & 0x1F;
+		if (offset & 0x10)
+			offset -= 0x20;
+		*cls = IDX_0;
+		return (getIndex(cpu, (xb >> 6) & 3, cpu->pc + tail) + offset) & 0xFFFF;
+	}
+
+	if ((xb & 0xC0) != 0xC0)
+	{
+		// rr1pnnnn: auto pre/post increment or decrement by 1..8
+		rr = (xb >> 6) & 3;
+		offset = xb & 0x0F;
+		offset = (offset & 0x08) ? offset - 16 : offset + 1;
+		r = getIndex(cpu, rr, 0);
+		if (xb & 0x10)
+		{
+			ea = r;
+			setIndex(cpu, rr, r + offset);
+		}
+		else
+		{
+			ea = (r + offset) & 0xFFFF;
+			setIndex(cpu, rr, ea);
+		}
+		*cls = IDX_0;
+		return ea;
+	}
+
+	rr = (xb >> 3) & 3;
+	if ((xb & 0x04) == 0)
+	{
+		if ((xb & 0x02) == 0)
+		{
+			// 111rr00s: 9-bit signed offset
+			offset = fetch8(cpu);
+			if (xb & 0x01)
+				offset -= 0x100;
+			*cls = IDX_1;
+			return (getIndex(cpu, rr, cpu->pc + tail) + offset) & 0xFFFF;
+		}
+		// 111rr010: 16-bit offset, 111rr011: [16-bit offset] indirect
+		offset = fetch16(cpu);
+		ea = (getIndex(cpu, rr, cpu->pc + tail) + offset) & 0xFFFF;
+		if (xb & 0x01)
+		{
+			*cls = IDX_2I;
+			indirectPointer = ea;
+			return cpu12_read16(cpu, ea);
+		}
+		*cls = IDX_2;
+		return ea;
+	}
+
+	// 111rr1aa: accumulator offset A, B, D or [D,r] indirect
+	r = getIndex(cpu, rr, cpu->pc + tail);
+	switch (xb & 0x03)
+	{
+		case 0: *cls = IDX_0; return (r + cpu->a) & 0xFFFF;
+		case 1: *cls = IDX_0; return (r + cpu->b) & 0xFFFF;
+		case 2: *cls = IDX_0; return (r + cpu12_d(cpu)) & 0xFFFF;
+		default:
+			*cls = IDX_DI;
+			indirectPointer = (r + cpu12_d(cpu)) & 0xFFFF;
+			return cpu12_read16(cpu, indirectPointer);
+	}
+}
+
+
+/************************************************
+*   Condition code helpers                      *
+************************************************/
+
+static void setFlag(cpu12_t *cpu, unsigned char flag, int on)
+{
+	if (on)
+		cpu->ccr |= flag;
+	else
+		cpu->ccr &= (unsigned char)~flag;
+}
+
+static void nz8(cpu12_t *cpu, unsigned int r)
+{
+	setFlag(cpu, CCR_N, r & 0x80);
+	setFlag(cpu, CCR_Z, (r & 0xFF) == 0);
+}
+
+static void nz16(cpu12_t *cpu, unsigned int r)
+{
+	setFlag(cpu, CCR_N, r & 0x8000);
+	setFlag(cpu, CCR_Z, (r & 0xFFFF) == 0);
+}
+
+// Logical operations and loads: N, Z, V=0
+static unsigned int logic8(cpu12_t *cpu, unsigned int r)
+{
+	nz8(cpu, r);
+	cpu->ccr &= (unsigned char)~CCR_V;
+	return r & 0xFF;
+}
+
+static unsigned int logic16(cpu12_t *cpu, unsigned int r)
+{
+	nz16(cpu, r);
+	cpu->ccr &= (unsigned char)~CCR_V;
+	return r & 0xFFFF;
+}
+
+static unsigned int add8(cpu12_t *cpu, unsigned int a, unsigned int b, unsigned int c)
+{
+	unsigned int r = (a + b + c) & 0xFF;
+	unsigned int carries = (a & b) | (b & ~r) | (~r & a);
+
+	setFlag(cpu, CCR_H, carries & 0x08);
+	setFlag(cpu, CCR_V, ((a & b & ~r) | (~a & ~b & r)) & 0x80);
+	setFlag(cpu, CCR_C, carries & 0x80);
+	nz8(cpu, r);
+	return r;
+}
+
+static unsigned int sub8(cpu12_t *cpu, unsigned int a, unsigned int b, unsigned int c)
+{
+	unsigned int r = (a - b - c) & 0xFF;
+
+	setFlag(cpu, CCR_V, ((a & ~b & ~r) | (~a & b & r)) & 0x80);
+	setFlag(cpu, CCR_C, ((~a & b) | (b & r) | (r & ~a)) & 0x80);
+	nz8(cpu, r);
+	return r;
+}
+
+static unsigned int add16(cpu12_t *cpu, unsigned int a, unsigned int b)
+{
+	unsigned int r = (a + b) & 0xFFFF;
+
+	setFlag(cpu, CCR_V, ((a & b & ~r) | (~a & ~b & r)) & 0x8000);
+	setFlag(cpu, CCR_C, ((a & b) | (b & ~r) | (~r & a)) & 0x8000);
+	nz16(cpu, r);
+	return r;
+}
+
+static unsigned int sub16(cpu12_t *cpu, unsigned int a, unsigned int b)
+{
+	unsigned int r = (a - b) & 0xFFFF;
+
+	setFlag(cpu, CCR_V, ((a & ~b & ~r) | (~a & b & r)) & 0x8000);
+	setFlag(cpu, CCR_C, ((~a & b) | (b & r) | (r & ~a)) & 0x8000);
+	nz16(cpu, r);
+	return r;
+}
+
+// Read-modify-write group 0x40-0x48 / 0x50-0x58 / 0x60-0x68 / 0x70-0x78, selected by the low nibble
+static unsigned int rmw8(cpu12_t *cpu, int op, unsigned int v)
+{
+	unsigned int r, c = cpu->ccr & CCR_C;
+
+	switch (op)
+	{
+		case 0x0:   // NEG
+			r = (0 - v) & 0xFF;
+			nz8(cpu, r);
+			setFlag(cpu, CCR_V, r == 0x80);
+			setFlag(cpu, CCR_C, r != 0);
+			return r;
+		case 0x1:   // COM
+			r = ~v & 0xFF;
+			nz8(cpu, r);
+			cpu->ccr &= (unsigned char)~CCR_V;
+			cpu->ccr |= CCR_C;
+			return r;
+		case 0x2:   // INC
+			r = (v + 1) & 0xFF;
+			nz8(cpu, r);
+			setFlag(cpu, CCR_V, v == 0x7F);
+			return r;
+		case 0x3:   // DEC
+			r = (v - 1) & 0xFF;
+			nz8(cpu, r);
+			setFlag(cpu, CCR_V, v == 0x80);
+			return r;
+		case 0x4:   // LSR
+			r = v >> 1;
+			setFlag(cpu, CCR_C, v & 0x01);
+			break;
+		case 0x5:   // ROL
+			r = ((v << 1) | c) & 0xFF;
+			setFlag(cpu, CCR_C, v & 0x80);
+			break;
+		case 0x6:   // ROR
+			r = (v >> 1) | (c << 7);
+			setFlag(cpu, CCR_C, v & 0x01);
+			break;
+		case 0x7:   // ASR
+			r = (v >> 1) | (v & 0x80);
+			setFlag(cpu, CCR_C, v & 0x01);
+			break;
+		default:    // ASL / LSL
+			r = (v << 1) & 0xFF;
+			setFlag(cpu, CCR_C, v & 0x80);
+			break;
+	}
+	// Shifts and rotates: V = N ^ C
+	nz8(cpu, r);
+	setFlag(cpu, CCR_V, ((cpu->ccr & CCR_N) != 0) != ((cpu->ccr & CCR_C) != 0));
+	return r;
+}
+
+static int branchTaken(cpu12_t *cpu, int cond)
+{
+	int n = (cpu->ccr & CCR_N) != 0, z = (cpu->ccr & CCR_Z) != 0;
+	int v = (cpu->ccr & CCR_V) != 0, c = (cpu->ccr & CCR_C) != 0;
+
+	switch (cond & 0x0F)
+	{
+		case 0x0: return 1;                 // BRA
+		case 0x1: return 0;                 // BRN
+		case 0x2: return !(c || z);         // BHI
+		case 0x3: return c || z;            // BLS
+		case 0x4: return !c;                // BCC / BHS
+		case 0x5: return c;                 // BCS / BLO
+		case 0x6: return !z;                // BNE
+		case 0x7: return z;                 // BEQ
+		case 0x8: return !v;                // BVC
+		case 0x9: return v;                 // BVS
+		case 0xA: return !n;                // BPL
+		case 0xB: return n;                 // BMI
+		case 0xC: return n == v;            // BGE
+		case 0xD: return n != v;            // BLT
+		case 0xE: return !z && n == v;      // BGT
+		default:  return z || n != v;       // BLE
+	}
+}
+
+
+/************************************************
+*   Register transfers (TFR/EXG/SEX)            *
+************************************************/
+
+static unsigned int readReg(cpu12_t *cpu, int r)
+{
+	switch (r & 7)
+	{
+		case 0: return cpu->a;
+		case 1: return cpu->b;
+		case 2: return cpu->ccr;
+		case 3: return 0;                   // TMP3 is not visible to user code
+		case 4: return cpu12_d(cpu);
+		case 5: return cpu->x;
+		case 6: return cpu->y;
+		default: return cpu->sp;
+	}
+}
+
+static void writeReg(cpu12_t *cpu, int r, unsigned int v)
+{
+	switch (r & 7)
+	{
+		case 0: cpu->a = (unsigned char)v; break;
+		case 1: cpu->b = (unsigned char)v; break;
+		case 2: cpu->ccr = (unsigned char)v; break;
+		case 3: break;
+		case 4: cpu12_set_d(cpu, v & 0xFFFF); break;
+		case 5: cpu->x = v & 0xFFFF; break;
+		case 6: cpu->y = v & 0xFFFF; break;
+		default: cpu->sp = v & 0xFFFF; break;
+	}
+}
+
+static int isWide(int r)
+{
+	return (r & 7) >= 3;
+}
+
+static void transfer(cpu12_t *cpu, unsigned char eb)
+{
+	int src = (eb >> 4) & 7, dst = eb & 7;
+	unsigned int vs = readReg(cpu, src), vd = readReg(cpu, dst);
+
+	if (eb & 0x80)
+	{
+		// EXG: an 8-bit register receives the low byte, a 16-bit register receives $00:r8
+		writeReg(cpu, dst, (!isWide(dst) || isWide(src)) ? vs : (vs & 0xFF));
+		writeReg(cpu, src, (!isWide(src) || isWide(dst)) ? vd : (vd & 0xFF));
+	}
+	else
+	{
+		// TFR: 8-bit to 16-bit transfers sign extend (this is how SEX is encoded)
+		if (isWide(dst) && !isWide(src))
+			vs = (vs & 0x80) ? (vs | 0xFF00) : vs;
+		writeReg(cpu, dst, vs);
+	}
+}
+
+
+/************************************************
+*   Arithmetic helpers                          *
+************************************************/
+
+static void daa(cpu12_t *cpu)
+{
+	unsigned int a = cpu->a, adjust = 0, carry = cpu->ccr & CCR_C;
+
+	if ((cpu->ccr & CCR_H) || (a & 0x0F) > 9)
+		adjust |= 0x06;
+	if (carry || a > 0x99)
+	{
+		adjust |= 0x60;
+		carry = 1;
+	}
+	a = (a + adjust) & 0xFF;
+	cpu->a = (unsigned char)a;
+	nz8(cpu, a);
+	setFlag(cpu, CCR_C, carry);
+}
+
+static long signExtend16(unsigned int v)
+{
+	return (v & 0x8000) ? (long)v - 0x10000L : (long)v;
+}
+
+static void emacs(cpu12_t *cpu, unsigned int addr)
+{
+	long product = signExtend16(cpu12_read16(cpu, cpu->x)) * signExtend16(cpu12_read16(cpu, cpu->y));
+	unsigned long acc = ((unsigned long)cpu12_read16(cpu, addr) << 16) | cpu12_read16(cpu, addr + 2);
+	unsigned long p = (unsigned long)product & 0xFFFFFFFFUL;
+	unsigned long r = (acc + p) & 0xFFFFFFFFUL;
+
+	setFlag(cpu, CCR_N, r & 0x80000000UL);
+	setFlag(cpu, CCR_Z, r == 0);
+	setFlag(cpu, CCR_V, ((acc & p & ~r) | (~acc & ~p & r)) & 0x80000000UL);
+	setFlag(cpu, CCR_C, ((acc & p) | (p & ~r) | (~r & acc)) & 0x80000000UL);
+	cpu12_write16(cpu, addr, (unsigned int)(r >> 16));
+	cpu12_write16(cpu, addr + 2, (unsigned int)(r & 0xFFFF));
+}
+
+static void ediv(cpu12_t *cpu, int isSigned)
+{
+	unsigned long dividend = ((unsigned long)cpu->y << 16) | cpu12_d(cpu);
+	long q, r, sd, sx;
+
+	cpu->ccr &= (unsigned char)~(CCR_V | CCR_C);
+	if (cpu->x == 0)
+	{
+		cpu->ccr |= CCR_C;
+		return;
+	}
+	if (isSigned)
+	{
+		sd = (long)(dividend ^ 0x80000000UL) - 0x7FFFFFFFL - 1;
+		sx = signExtend16(cpu->x);
+		q = sd / sx;
+		r = sd % sx;
+		if (q > 32767 || q < -32768)
+		{
+			cpu->ccr |= CCR_V;
+			return;
+		}
+	}
+	else
+	{
+		q = (long)(dividend / cpu->x);
+		r = (long)(dividend % cpu->x);
+		if (dividend / cpu->x > 0xFFFFUL)
+		{
+			cpu->ccr |= CCR_V;
+			return;
+		}
+	}
+	cpu->y = (unsigned int)q & 0xFFFF;
+	cpu12_set_d(cpu, (unsigned int)r & 0xFFFF);
+	nz16(cpu, cpu->y);
+}
+
+static void idiv(cpu12_t *cpu, int op)
+{
+	unsigned int d = cpu12_d(cpu), x = cpu->x;
+	long q, r;
+
+	cpu->ccr &= (unsigned char)~(CCR_V | CCR_C);
+	if (x == 0)
+	{
+		cpu->ccr |= CCR_C;
+		if (op != 0x15)
+			cpu->x = 0xFFFF;
+		return;
+	}
+	if (op == 0x10)                         // IDIV
+	{
+		q = d / x;
+		r = d % x;
+		cpu->ccr &= (unsigned char)~CCR_N;
+	}
+	else if (op == 0x11)                    // FDIV
+	{
+		if (x <= d)
+		{
+			cpu->ccr |= CCR_V;
+			cpu->x = 0xFFFF;
+			return;
+		}
+		q = (long)((((unsigned long)d) << 16) / x);
+		r = (long)((((unsigned long)d) << 16) % x);
+	}
+	else                                    // IDIVS
+	{
+		if (d == 0x8000 && x == 0xFFFF)
+		{
+			cpu->ccr |= CCR_V;
+			return;
+		}
+		q = signExtend16(d) / signExtend16(x);
+		r = signExtend16(d) % signExtend16(x);
+		setFlag(cpu, CCR_N, q < 0);
+	}
+	cpu->x = (unsigned int)q & 0xFFFF;
+	cpu12_set_d(cpu, (unsigned int)r & 0xFFFF);
+	setFlag(cpu, CCR_Z, cpu->x == 0);
+}
+
+
+/************************************************
+*   cpu12_init / cpu12_reset / cpu12_interrupt  *
+************************************************/
+
+void cpu12_init(cpu12_t *cpu)
+{
+	memset(cpu, 0, sizeof(*cpu));
+	memset(cpu->flash, 0xFF, sizeof(cpu->flash));
+	memset(cpu->mem + CPU12_RAM_END, 0xFF, sizeof(cpu->mem) - CPU12_RAM_END);
+}
+
+void cpu12_reset(cpu12_t *cpu)
+{
+	cpu->ccr = CCR_S | CCR_X | CCR_I;
+	cpu->mem[CPU12_PPAGE_ADDR] = 0x3F;
+	cpu->pc = cpu12_read16(cpu, 0xFFFE);
+	cpu->cycles = 0;
+	cpu->instructions = 0;
+	cpu->waiting = 0;
+}
+
+int cpu12_interrupt(cpu12_t *cpu, unsigned int vector)
+{
+	if (cpu->ccr & CCR_I)
+		return 0;
+
+	if (cpu->waiting)
+	{
+		// WAI has already stacked the registers
+		cpu->waiting = 0;
+		cpu->cycles += 5;                   // fVfPPP
+	}
+	else
+	{
+		push16(cpu, cpu->pc);
+		push16(cpu, cpu->y);
+		push16(cpu, cpu->x);
+		push8(cpu, cpu->a);
+		push8(cpu, cpu->b);
+		push8(cpu, cpu->ccr);
+		cpu->cycles += 9;                   // VSPSSPSsP
+	}
+	cpu->ccr |= CCR_I;
+	cpu->pc = cpu12_read16(cpu, vector);
+	cpu->flowKind = CPU12_FLOW_IRQ;
+	cpu->flowTarget = cpu->pc;
+	return 1;
+}
+
+
+/************************************************
+*   cpu12_step                                  *
+************************************************/
+
+static int stepPage2(cpu12_t *cpu);
+
+int cpu12_step(cpu12_t *cpu)
+{
+	unsigned char op, post, mask, m8;
+	unsigned int addr, v, w, target;
+	int cls = IDX_0, cyc = 1, rel, status = CPU12_OK;
+	unsigned long long startCycles = cpu->cycles;
+
+	cpu->lastPc = cpu->pc;
+	cpu->flowKind = CPU12_FLOW_NONE;
+	cpu->lastPage2 = 0;
+	if (cpu->waiting)
+	{
+		// Idle in WAI: time passes until a peripheral raises an interrupt
+		cpu->cycles++;
+		cpu->lastCycles = 1;
+		return CPU12_OK;
+	}
+	op = fetch8(cpu);
+	cpu->lastOpcode = op;
+
+	switch (op)
+	{
+		case 0x00:                          // BGND
+			cyc = 5;
+			status = CPU12_HALT;
+			break;
+		case 0x01:                          // MEM (fuzzy membership)
+			status = CPU12_UNSUPPORTED;
+			break;
+		case 0x02: cpu->y = (cpu->y + 1) & 0xFFFF; setFlag(cpu, CCR_Z, cpu->y == 0); break;  // INY
+		case 0x03: cpu->y = (cpu->y - 1) & 0xFFFF; setFlag(cpu, CCR_Z, cpu->y == 0); break;  // DEY
+		case 0x08: cpu->x = (cpu->x + 1) & 0xFFFF; setFlag(cpu, CCR_Z, cpu->x == 0); break;  // INX
+		case 0x09: cpu->x = (cpu->x - 1) & 0xFFFF; setFlag(cpu, CCR_Z, cpu->x == 0); break;  // DEX
+
+		case 0x04:                          // DBEQ/DBNE/TBEQ/TBNE/IBEQ/IBNE
+		{
+			int kind, reg, wide, taken;
+			post = fetch8(cpu);
+			rel = fetch8(cpu);
+			if (post & 0x10)
+				rel -= 0x100;
+			kind = (post >> 5) & 7;
+			reg = post & 7;
+			wide = isWide(reg);
+			v = readReg(cpu, reg);
+			if (kind == 0 || kind == 1)
+				v = (v - 1) & (wide ? 0xFFFF : 0xFF);
+			else if (kind == 4 || kind == 5)
+				v = (v + 1) & (wide ? 0xFFFF : 0xFF);
+			if (kind != 2 && kind != 3)
+				writeReg(cpu, reg, v);
+			taken = (v == 0) == ((kind & 1) == 0);
+			if (taken)
+				cpu->pc = (cpu->pc + rel) & 0xFFFF;
+			cyc = 3;
+			break;
+		}
+
+		case 0x05:                          // JMP indexed
+			target = indexedAddress(cpu, &cls, 0);
+			cpu->pc = target;
+			cyc = cycJmp[cls];
+			break;
+		case 0x06:                          // JMP extended
+			cpu->pc = fetch16(cpu);
+			cyc = 3;
+			break;
+		case 0x07:                          // BSR
+			rel = (signed char)fetch8(cpu);
+			push16(cpu, cpu->pc);
+			cpu->pc = (cpu->pc + rel) & 0xFFFF;
+			cpu->flowKind = CPU12_FLOW_CALL;
+			cyc = 4;
+			break;
+		case 0x0A:                          // RTC
+			cpu->mem[CPU12_PPAGE_ADDR] = pull8(cpu);
+			cpu->pc = pull16(cpu);
+			cpu->flowKind = CPU12_FLOW_RETURN;
+			cyc = 7;
+			break;
+		case 0x0B:                          // RTI
+			cpu->ccr = (unsigned char)((pull8(cpu) & ~CCR_X) | (cpu->ccr & CCR_X));
+			cpu->b = pull8(cpu);
+			cpu->a = pull8(cpu);
+			cpu->x = pull16(cpu);
+			cpu->y = pull16(cpu);
+			cpu->pc = pull16(cpu);
+			cpu->flowKind = CPU12_FLOW_RTI;
+			cyc = 8;
+			break;
+
+		case 0x0C: case 0x0D: case 0x1C: case 0x1D: case 0x4C: case 0x4D:   // BSET / BCLR
+			if (op == 0x0C || op == 0x0D)
+			{
+				addr = indexedAddress(cpu, &cls, 1);
+				cyc = cycBset[cls];
+			}
+			else if (op == 0x1C || op == 0x1D)
+			{
+				addr = fetch16(cpu);
+				cyc = 4;
+			}
+			else
+			{
+				addr = fetch8(cpu);
+				cyc = 4;
+			}
+			mask = fetch8(cpu);
+			m8 = cpu12_read8(cpu, addr);
+			m8 = (op & 1) ? (unsigned char)(m8 & ~mask) : (unsigned char)(m8 | mask);
+			cpu12_write8(cpu, addr, (unsigned char)logic8(cpu, m8));
+			break;
+
+		case 0x0E: case 0x0F: case 0x1E: case 0x1F: case 0x4E: case 0x4F:   // BRSET / BRCLR
+			if (op == 0x0E || op == 0x0F)
+			{
+				addr = indexedAddress(cpu, &cls, 2);
+				cyc = cycBrset[cls];
+			}
+			else if (op == 0x1E || op == 0x1F)
+			{
+				addr = fetch16(cpu);
+				cyc = 5;
+			}
+			else
+			{
+				addr = fetch8(cpu);
+				cyc = 4;
+			}
+			mask = fetch8(cpu);
+			rel = (signed char)fetch8(cpu);
+			m8 = cpu12_read8(cpu, addr);
+			if ((op & 1) ? ((m8 & mask) == 0) : ((~m8 & mask) == 0))
+				cpu->pc = (cpu->pc + rel) & 0xFFFF;
+			break;
+
+		case 0x10: cpu->ccr &= fetch8(cpu); break;                          // ANDCC
+		case 0x14: cpu->ccr |= (unsigned char)(fetch8(cpu) & ~CCR_X); break; // ORCC
+		case 0x11: ediv(cpu, 0); cyc = 11; break;                           // EDIV
+		case 0x12:                                                          // MUL
+			cpu12_set_d(cpu, (unsigned int)cpu->a * cpu->b);
+			setFlag(cpu, CCR_C, cpu->b & 0x80);
+			cyc = 1;
+			break;
+		case 0x13:                                                          // EMUL
+		{
+			unsigned long r = (unsigned long)cpu12_d(cpu) * cpu->y;
+			cpu->y = (unsigned int)(r >> 16) & 0xFFFF;
+			cpu12_set_d(cpu, (unsigned int)(r & 0xFFFF));
+			setFlag(cpu, CCR_N, r & 0x80000000UL);
+			setFlag(cpu, CCR_Z, (r & 0xFFFFFFFFUL) == 0);
+			setFlag(cpu, CCR_C, r & 0x8000);
+			cyc = 3;
+			break;
+		}
+
+		case 0x15:                          // JSR indexed
+			target = indexedAddress(cpu, &cls, 0);
+			push16(cpu, cpu->pc);
+			cpu->pc = target;
+			cpu->flowKind = CPU12_FLOW_CALL;
+			cyc = cycJsr[cls];
+			break;
+		case 0x16:                          // JSR extended
+			target = fetch16(cpu);
+			push16(cpu, cpu->pc);
+			cpu->pc = target;
+			cpu->flowKind = CPU12_FLOW_CALL;
+			cyc = 4;
+			break;
+		case 0x17:                          // JSR direct
+			target = fetch8(cpu);
+			push16(cpu, cpu->pc);
+			cpu->pc = target;
+			cpu->flowKind = CPU12_FLOW_CALL;
+			cyc = 4;
+			break;
+
+		case 0x18:
+			return stepPage2(cpu);
+
+		case 0x19: cpu->y = indexedAddress(cpu, &cls, 0); cyc = cycLea[cls]; break;    // LEAY
+		case 0x1A: cpu->x = indexedAddress(cpu, &cls, 0); cyc = cycLea[cls]; break;    // LEAX
+		case 0x1B: cpu->sp = indexedAddress(cpu, &cls, 0); cyc = cycLea[cls]; break;   // LEAS
+
+		case 0x20: case 0x21: case 0x22: case 0x23: case 0x24: case 0x25: case 0x26: case 0x27:
+		case 0x28: case 0x29: case 0x2A: case 0x2B: case 0x2C: case 0x2D: case 0x2E: case 0x2F:
+			rel = (signed char)fetch8(cpu);
+			if (branchTaken(cpu, op))
+			{
+				cpu->pc = (cpu->pc + rel) & 0xFFFF;
+				cyc = 3;
+			}
+			break;
+
+		case 0x30: cpu->x = pull16(cpu); cyc = 3; break;        // PULX
+		case 0x31: cpu->y = pull16(cpu); cyc = 3; break;        // PULY
+		case 0x32: cpu->a = pull8(cpu); cyc = 3; break;         // PULA
+		case 0x33: cpu->b = pull8(cpu); cyc = 3; break;         // PULB
+		case 0x34: push16(cpu, cpu->x); cyc = 2; break;         // PSHX
+		case 0x35: push16(cpu, cpu->y); cyc = 2; break;         // PSHY
+		case 0x36: push8(cpu, cpu->a); cyc = 2; break;          // PSHA
+		case 0x37: push8(cpu, cpu->b); cyc = 2; break;          // PSHB
+		case 0x38:                                              // PULC
+			cpu->ccr = (unsigned char)((pull8(cpu) & ~CCR_X) | (cpu->ccr & CCR_X));
+			cyc = 3;
+			break;
+		case 0x39: push8(cpu, cpu->ccr); cyc = 2; break;        // PSHC
+		case 0x3A: cpu12_set_d(cpu, pull16(cpu)); cyc = 3; break;   // PULD
+		case 0x3B: push16(cpu, cpu12_d(cpu)); cyc = 2; break;   // PSHD
+		case 0x3C:                                              // wavr
+			status = CPU12_UNSUPPORTED;
+			break;
+		case 0x3D:                                              // RTS
+			cpu->pc = pull16(cpu);
+			cpu->flowKind = CPU12_FLOW_RETURN;
+			cyc = 5;
+			break;
+		case 0x3E:                                              // WAI
+			push16(cpu, cpu->pc);
+			push16(cpu, cpu->y);
+			push16(cpu, cpu->x);
+			push8(cpu, cpu->a);
+			push8(cpu, cpu->b);
+			push8(cpu, cpu->ccr);
+			cpu->waiting = 1;
+			cyc = 8;                                            // OSSSSsf + wake-up
+			if (cpu->ccr & CCR_I)
+			{
+				cpu->sp = (cpu->sp + 9) & 0xFFFF;
+				cpu->waiting = 0;
+				status = CPU12_HALT;
+			}
+			break;
+		case 0x3F:                                              // SWI
+			push16(cpu, cpu->pc);
+			push16(cpu, cpu->y);
+			push16(cpu, cpu->x);
+			push8(cpu, cpu->a);
+			push8(cpu, cpu->b);
+			push8(cpu, cpu->ccr);
+			cpu->ccr |= CCR_I;
+			cpu->pc = cpu12_read16(cpu, 0xFFF6);
+			cpu->flowKind = CPU12_FLOW_IRQ;
+			cyc = 9;
+			break;
+
+		case 0x40: case 0x41: case 0x42: case 0x43: case 0x44: case 0x45: case 0x46: case 0x47: case 0x48:
+			cpu->a = (unsigned char)rmw8(cpu, op & 0x0F, cpu->a);
+			break;
+		case 0x50: case 0x51: case 0x52: case 0x53: case 0x54: case 0x55: case 0x56: case 0x57: case 0x58:
+			cpu->b = (unsigned char)rmw8(cpu, op & 0x0F, cpu->b);
+			break;
+		case 0x49:                          // LSRD
+			v = cpu12_d(cpu);
+			setFlag(cpu, CCR_C, v & 1);
+			v >>= 1;
+			cpu12_set_d(cpu, v);
+			nz16(cpu, v);
+			setFlag(cpu, CCR_V, cpu->ccr & CCR_C);
+			break;
+		case 0x59:                          // ASLD
+			v = cpu12_d(cpu);
+			setFlag(cpu, CCR_C, v & 0x8000);
+			v = (v << 1) & 0xFFFF;
+			cpu12_set_d(cpu, v);
+			nz16(cpu, v);
+			setFlag(cpu, CCR_V, ((cpu->ccr & CCR_N) != 0) != ((cpu->ccr & CCR_C) != 0));
+			break;
+
+		case 0x4A:                          // CALL extended
+		case 0x4B:                          // CALL indexed
+		{
+			unsigned char page;
+			if (op == 0x4A)
+			{
+				target = fetch16(cpu);
+				page = fetch8(cpu);
+				cyc = 7;
+			}
+			else
+			{
+				target = indexedAddress(cpu, &cls, 1);
+				if (cls == IDX_DI || cls == IDX_2I)
+				{
+					// Indirect CALL: the page byte follows the 16-bit address in memory, not in the instruction
+					page = cpu12_read8(cpu, indirectPointer + 2);
+				}
+				else
+					page = fetch8(cpu);
+				cyc = cycCall[cls];
+			}
+			push16(cpu, cpu->pc);
+			push8(cpu, cpu->mem[CPU12_PPAGE_ADDR]);
+			cpu12_write8(cpu, CPU12_PPAGE_ADDR, page);
+			cpu->pc = target;
+			cpu->flowKind = CPU12_FLOW_CALL;
+			break;
+		}
+
+		case 0x5A: case 0x5B: case 0x5C: case 0x5D: case 0x5E: case 0x5F:      // stores, direct
+		case 0x6A: case 0x6B: case 0x6C: case 0x6D: case 0x6E: case 0x6F:      // stores, indexed
+		case 0x7A: case 0x7B: case 0x7C: case 0x7D: case 0x7E: case 0x7F:      // stores, extended
+			if ((op & 0xF0) == 0x50)
+			{
+				addr = fetch8(cpu);
+				cyc = 2;
+			}
+			else if ((op & 0xF0) == 0x60)
+			{
+				addr = indexedAddress(cpu, &cls, 0);
+				cyc = cycWrite[cls];
+			}
+			else
+			{
+				addr = fetch16(cpu);
+				cyc = 3;
+			}
+			switch (op & 0x0F)
+			{
+				case 0xA: cpu12_write8(cpu, addr, (unsigned char)logic8(cpu, cpu->a)); break;
+				case 0xB: cpu12_write8(cpu, addr, (unsigned char)logic8(cpu, cpu->b)); break;
+				case 0xC: cpu12_write16(cpu, addr, logic16(cpu, cpu12_d(cpu))); break;
+				case 0xD: cpu12_write16(cpu, addr, logic16(cpu, cpu->y)); break;
+				case 0xE: cpu12_write16(cpu, addr, logic16(cpu, cpu->x)); break;
+				default:  cpu12_write16(cpu, addr, logic16(cpu, cpu->sp)); break;
+			}
+			break;
+
+		case 0x60: case 0x61: case 0x62: case 0x63: case 0x64: case 0x65: case 0x66: case 0x67: case 0x68:
+		case 0x70: case 0x71: case 0x72: case 0x73: case 0x74: case 0x75: case 0x76: case 0x77: case 0x78:
+			if (op & 0x10)
+			{
+				addr = fetch16(cpu);
+				cyc = 4;
+			}
+			else
+			{
+				addr = indexedAddress(cpu, &cls, 0);
+				cyc = cycRmw[cls];
+			}
+			cpu12_write8(cpu, addr, (unsigned char)rmw8(cpu, op & 0x0F, cpu12_read8(cpu, addr)));
+			break;
+
+		case 0x69:                          // CLR indexed
+		case 0x79:                          // CLR extended
+			if (op == 0x79)
+			{
+				addr = fetch16(cpu);
+				cyc = 3;
+			}
+			else
+			{
+				addr = indexedAddress(cpu, &cls, 0);
+				cyc = cycWrite[cls];
+			}
+			cpu12_write8(cpu, addr, 0);
+			cpu->ccr = (unsigned char)((cpu->ccr & ~(CCR_N | CCR_V | CCR_C)) | CCR_Z);
+			break;
+
+		case 0x87: cpu->a = 0; cpu->ccr = (unsigned char)((cpu->ccr & ~(CCR_N | CCR_V | CCR_C)) | CCR_Z); break;  // CLRA
+		case 0xC7: cpu->b = 0; cpu->ccr = (unsigned char)((cpu->ccr & ~(CCR_N | CCR_V | CCR_C)) | CCR_Z); break;  // CLRB
+		case 0x97: logic8(cpu, cpu->a); cpu->ccr &= (unsigned char)~CCR_C; break;          // TSTA
+		case 0xD7: logic8(cpu, cpu->b); cpu->ccr &= (unsigned char)~CCR_C; break;          // TSTB
+		case 0xA7: break;                                                                   // NOP
+		case 0xB7: transfer(cpu, fetch8(cpu)); break;                                       // TFR / EXG / SEX
+		case 0xE7: case 0xF7:                                                               // TST
+			if (op == 0xF7)
+			{
+				addr = fetch16(cpu);
+				cyc = 3;
+			}
+			else
+			{
+				addr = indexedAddress(cpu, &cls, 0);
+				cyc = cycRead[cls];
+			}
+			logic8(cpu, cpu12_read8(cpu, addr));
+			cpu->ccr &= (unsigned char)~CCR_C;
+			break;
+
+		default:
+		{
+			// 0x80-0xFF: accumulator A (0x80-0xBF) and B/D/X/Y/SP (0xC0-0xFF) operations with IMM/DIR/IDX/EXT
+			int mode = (op >> 4) & 3, col = op & 0x0F, hi = op >= 0xC0;
+			int wide = col == 0x3 || col >= 0xC;
+
+			if (op < 0x80)
+			{
+				status = CPU12_ILLEGAL;
+				break;
+			}
+			if (mode == 0)
+			{
+				v = wide ? fetch16(cpu) : fetch8(cpu);
+				cyc = wide ? 2 : 1;
+			}
+			else
+			{
+				if (mode == 1)
+				{
+					addr = fetch8(cpu);
+					cyc = 3;
+				}
+				else if (mode == 3)
+				{
+					addr = fetch16(cpu);
+					cyc = 3;
+				}
+				else
+				{
+					addr = indexedAddress(cpu, &cls, 0);
+					cyc = cycRead[cls];
+				}
+				v = wide ? cpu12_read16(cpu, addr) : cpu12_read8(cpu, addr);
+			}
+
+			w = hi ? cpu->b : cpu->a;
+			switch (col)
+			{
+				case 0x0: w = sub8(cpu, w, v, 0); break;                                   // SUBA/SUBB
+				case 0x1: sub8(cpu, w, v, 0); break;                                       // CMPA/CMPB
+				case 0x2: w = sub8(cpu, w, v, cpu->ccr & CCR_C); break;                    // SBCA/SBCB
+				case 0x3:                                                                  // SUBD/ADDD
+					cpu12_set_d(cpu, hi ? add16(cpu, cpu12_d(cpu), v) : sub16(cpu, cpu12_d(cpu), v));
+					break;
+				case 0x4: w = logic8(cpu, w & v); break;                                   // ANDA/ANDB
+				case 0x5: logic8(cpu, w & v); break;                                       // BITA/BITB
+				case 0x6: w = logic8(cpu, v); break;                                       // LDAA/LDAB
+				case 0x8: w = logic8(cpu, w ^ v); break;                                   // EORA/EORB
+				case 0x9: w = add8(cpu, w, v, cpu->ccr & CCR_C); break;                    // ADCA/ADCB
+				case 0xA: w = logic8(cpu, w | v); break;                                   // ORAA/ORAB
+				case 0xB: w = add8(cpu, w, v, 0); break;                                   // ADDA/ADDB
+				case 0xC: if (hi) cpu12_set_d(cpu, logic16(cpu, v)); else sub16(cpu, cpu12_d(cpu), v); break;  // LDD/CPD
+				case 0xD: if (hi) cpu->y = logic16(cpu, v); else sub16(cpu, cpu->y, v); break;                 // LDY/CPY
+				case 0xE: if (hi) cpu->x = logic16(cpu, v); else sub16(cpu, cpu->x, v); break;                 // LDX/CPX
+				default:  if (hi) cpu->sp = logic16(cpu, v); else sub16(cpu, cpu->sp, v); break;               // LDS/CPS
+			}
+			if (col <= 0xB && col != 0x3)
+			{
+				if (hi)
+					cpu->b = (unsigned char)w;
+				else
+					cpu->a = (unsigned char)w;
+			}
+			break;
+		}
+	}
+
+	if (cpu->flowKind == CPU12_FLOW_CALL)
+		cpu->flowTarget = cpu->pc;
+	cpu->cycles += cyc;
+	cpu->lastCycles = (unsigned int)(cpu->cycles - startCycles);
+	cpu->instructions++;
+	if (status != CPU12_OK)
+		cpu->pc = cpu->lastPc;
+	return status;
+}
+
+// Page 2 opcodes (0x18 prefix)
+static int stepPage2(cpu12_t *cpu)
+{
+	unsigned char op = fetch8(cpu);
+	unsigned int addr, src, v, w;
+	int cls = IDX_0, cyc = 2, rel, status = CPU12_OK;
+	unsigned long long startCycles = cpu->cycles;
+
+	cpu->lastPage2 = 1;
+	cpu->lastOpcode = op;
+
+	switch (op)
+	{
+		// MOVW: the operand order in the instruction stream is source before destination, except that an
+		// indexed destination postbyte precedes an immediate or extended source.
+		case 0x00: addr = indexedAddress(cpu, &cls, 2); v = fetch16(cpu); cpu12_write16(cpu, addr, v); cyc = 4; break;
+		case 0x01: addr = indexedAddress(cpu, &cls, 2); src = fetch16(cpu); cpu12_write16(cpu, addr, cpu12_read16(cpu, src)); cyc = 5; break;
+		case 0x02: src = indexedAddress(cpu, &cls, 1); v = cpu12_read16(cpu, src); addr = indexedAddress(cpu, &cls, 0); cpu12_write16(cpu, addr, v); cyc = 5; break;
+		case 0x03: v = fetch16(cpu); addr = fetch16(cpu); cpu12_write16(cpu, addr, v); cyc = 5; break;
+		case 0x04: src = fetch16(cpu); addr = fetch16(cpu); cpu12_write16(cpu, addr, cpu12_read16(cpu, src)); cyc = 6; break;
+		case 0x05: src = indexedAddress(cpu, &cls, 2); addr = fetch16(cpu); cpu12_write16(cpu, addr, cpu12_read16(cpu, src)); cyc = 5; break;
+		// MOVB
+		case 0x08: addr = indexedAddress(cpu, &cls, 1); v = fetch8(cpu); cpu12_write8(cpu, addr, (unsigned char)v); cyc = 4; break;
+		case 0x09: addr = indexedAddress(cpu, &cls, 2); src = fetch16(cpu); cpu12_write8(cpu, addr, cpu12_read8(cpu, src)); cyc = 5; break;
+		case 0x0A: src = indexedAddress(cpu, &cls, 1); v = cpu12_read8(cpu, src); addr = indexedAddress(cpu, &cls, 0); cpu12_write8(cpu, addr, (unsigned char)v); cyc = 5; break;
+		case 0x0B: v = fetch8(cpu); addr = fetch16(cpu); cpu12_write8(cpu, addr, (unsigned char)v); cyc = 4; break;
+		case 0x0C: src = fetch16(cpu); addr = fetch16(cpu); cpu12_write8(cpu, addr, cpu12_read8(cpu, src)); cyc = 6; break;
+		case 0x0D: src = indexedAddress(cpu, &cls, 2); addr = fetch16(cpu); cpu12_write8(cpu, addr, cpu12_read8(cpu, src)); cyc = 5; break;
+
+		case 0x06: cpu->a = (unsigned char)add8(cpu, cpu->a, cpu->b, 0); break;       // ABA
+		case 0x07: daa(cpu); cyc = 3; break;                                           // DAA
+		case 0x0E: cpu->b = (unsigned char)logic8(cpu, cpu->a); break;                 // TAB
+		case 0x0F: cpu->a = (unsigned char)logic8(cpu, cpu->b); break;                 // TBA
+		case 0x16: cpu->a = (unsigned char)sub8(cpu, cpu->a, cpu->b, 0); break;       // SBA
+		case 0x17: sub8(cpu, cpu->a, cpu->b, 0); break;                                // CBA
+
+		case 0x10: case 0x11: case 0x15: idiv(cpu, op); cyc = 12; break;              // IDIV / FDIV / IDIVS
+		case 0x12: emacs(cpu, fetch16(cpu)); cyc = 13; break;                          // EMACS
+		case 0x13:                                                                     // EMULS
+		{
+			long r = signExtend16(cpu12_d(cpu)) * signExtend16(cpu->y);
+			unsigned long u = (unsigned long)r & 0xFFFFFFFFUL;
+			cpu->y = (unsigned int)(u >> 16);
+			cpu12_set_d(cpu, (unsigned int)(u & 0xFFFF));
+			setFlag(cpu, CCR_N, u & 0x80000000UL);
+			setFlag(cpu, CCR_Z, u == 0);
+			setFlag(cpu, CCR_C, u & 0x8000);
+			cyc = 3;
+			break;
+		}
+		case 0x14: ediv(cpu, 1); cyc = 12; break;                                      // EDIVS
+
+		case 0x18: case 0x19:                                                          // MAXA / MINA
+			addr = indexedAddress(cpu, &cls, 0);
+			v = cpu12_read8(cpu, addr);
+			sub8(cpu, cpu->a, v, 0);
+			if ((op == 0x18) ? (cpu->ccr & CCR_C) != 0 : (cpu->ccr & CCR_C) == 0)
+				cpu->a = (unsigned char)v;
+			cyc = cycMin[cls];
+			break;
+		case 0x1A: case 0x1B:                                                          // EMAXD / EMIND
+			addr = indexedAddress(cpu, &cls, 0);
+			v = cpu12_read16(cpu, addr);
+			sub16(cpu, cpu12_d(cpu), v);
+			if ((op == 0x1A) ? (cpu->ccr & CCR_C) != 0 : (cpu->ccr & CCR_C) == 0)
+				cpu12_set_d(cpu, v);
+			cyc = cycMin[cls];
+			break;
+		case 0x1C: case 0x1D:                                                          // MAXM / MINM
+			addr = indexedAddress(cpu, &cls, 0);
+			v = cpu12_read8(cpu, addr);
+			sub8(cpu, cpu->a, v, 0);
+			if ((op == 0x1C) ? (cpu->ccr & CCR_C) == 0 : (cpu->ccr & CCR_C) != 0)
+				cpu12_write8(cpu, addr, cpu->a);
+			cyc = cycMinm[cls];
+			break;
+		case 0x1E: case 0x1F:                                                          // EMAXM / EMINM
+			addr = indexedAddress(cpu, &cls, 0);
+			v = cpu12_read16(cpu, addr);
+			sub16(cpu, cpu12_d(cpu), v);
+			if ((op == 0x1E) ? (cpu->ccr & CCR_C) == 0 : (cpu->ccr & CCR_C) != 0)
+				cpu12_write16(cpu, addr, cpu12_d(cpu));
+			cyc = cycMinm[cls];
+			break;
+
+		case 0x20: case 0x21: case 0x22: case 0x23: case 0x24: case 0x25: case 0x26: case 0x27:
+		case 0x28: case 0x29: case 0x2A: case 0x2B: case 0x2C: case 0x2D: case 0x2E: case 0x2F:
+			rel = (int)fetch16(cpu);
+			if (rel & 0x8000)
+				rel -= 0x10000;
+			if (branchTaken(cpu, op))
+			{
+				cpu->pc = (cpu->pc + rel) & 0xFFFF;
+				cyc = 4;                    // OPPP
+			}
+			else
+				cyc = 3;                    // OPO
+			break;
+
+		case 0x3D:                                                                     // TBL
+			addr = indexedAddress(cpu, &cls, 0);
+			v = cpu12_read8(cpu, addr);
+			w = cpu12_read8(cpu, addr + 1);
+			cpu->a = (unsigned char)((v + (((long)w - (long)v) * cpu->b) / 256) & 0xFF);
+			nz8(cpu, cpu->a);
+			cyc = 6;
+			break;
+		case 0x3F:                                                                     // ETBL
+			addr = indexedAddress(cpu, &cls, 0);
+			v = cpu12_read16(cpu, addr);
+			w = cpu12_read16(cpu, addr + 2);
+			cpu12_set_d(cpu, (unsigned int)((v + (((long)w - (long)v) * cpu->b) / 256) & 0xFFFF));
+			nz16(cpu, cpu12_d(cpu));
+			cyc = 10;
+			break;
+
+		case 0x3E:                                                                     // STOP
+			cyc = 8;
+			status = CPU12_HALT;
+			break;
+		case 0x3A: case 0x3B: case 0x3C:                                               // REV / REVW / WAV
+			status = CPU12_UNSUPPORTED;
+			break;
+		default:                                                                       // TRAP
+			status = CPU12_ILLEGAL;
+			break;
+	}
+
+	cpu->cycles += cyc;
+	cpu->lastCycles = (unsigned int)(cpu->cycles - startCycles);
+	cpu->instructions++;
+	if (status != CPU12_OK)
+		cpu->pc = cpu->lastPc;
+	return status;
+}
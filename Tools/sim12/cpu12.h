@@ -0,0 +1,145 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    cpu12.h                                        *
+*          Host-side CPU12 instruction set simulator      *
+*---------------------------------------------------------*
+* Instruction timing follows the HCS12 column of the      *
+* access detail in "MIE438 - CPU12RM.pdf", Appendix A.    *
+**********************************************************/
+
+#ifndef _CPU12_H
+#define _CPU12_H
+
+// CCR bits
+#define CCR_S   0x80
+#define CCR_X   0x40
+#define CCR_H   0x20
+#define CCR_I   0x10
+#define CCR_N   0x08
+#define CCR_Z   0x04
+#define CCR_V   0x02
+#define CCR_C   0x01
+
+// Memory map of the MC9S12DG256 as set up by the serial monitor (see prm/HCS12_Serial_Monitor.prm)
+#define CPU12_IO_END        0x0400      // register space 0x0000-0x03FF
+#define CPU12_RAM_START     0x1000
+#define CPU12_RAM_END       0x4000      // RAM 0x1000-0x3FFF
+#define CPU12_WINDOW_START  0x8000      // PPAGE window 0x8000-0xBFFF
+#define CPU12_WINDOW_END    0xC000
+#define CPU12_PPAGE_ADDR    0x0030
+#define CPU12_PAGE_FIRST    0x30        // PAGE_30 ... PAGE_3F
+#define CPU12_PAGE_COUNT    16
+#define CPU12_PAGE_SIZE     0x4000
+
+// Reasons for cpu12_step() to stop execution
+#define CPU12_OK            0
+#define CPU12_HALT          1           // BGND, STOP or WAI with interrupts masked
+#define CPU12_ILLEGAL       2           // unimplemented opcode (TRAP)
+#define CPU12_UNSUPPORTED   3           // fuzzy logic instructions (MEM, REV, REVW, WAV, wavr)
+
+// Indexed addressing classes, used to select the cycle count of an instruction
+#define IDX_0   0   // 5-bit offset, auto increment/decrement, accumulator offset
+#define IDX_1   1   // 9-bit offset
+#define IDX_2   2   // 16-bit offset
+#define IDX_DI  3   // [D,xysp]
+#define IDX_2I  4   // [oprx16,xysp]
+
+// Instruction groups sharing one row of indexed cycle counts (cpu12_idxCycles[group][class])
+#define IDXCYC_READ     0
+#define IDXCYC_WRITE    1
+#define IDXCYC_RMW      2
+#define IDXCYC_LEA      3
+#define IDXCYC_JMP      4
+#define IDXCYC_JSR      5
+#define IDXCYC_CALL     6
+#define IDXCYC_BSET     7
+#define IDXCYC_BRSET    8
+#define IDXCYC_MIN      9
+#define IDXCYC_MINM     10
+#define IDXCYC_GROUPS   11
+
+extern const unsigned char cpu12_idxCycles[IDXCYC_GROUPS][5];
+
+typedef struct cpu12 cpu12_t;
+
+// Peripheral hooks for the register block 0x0000-0x03FF. When unset, registers behave as plain RAM.
+typedef unsigned char (*cpu12_io_read_t)(cpu12_t *cpu, unsigned int addr);
+typedef void (*cpu12_io_write_t)(cpu12_t *cpu, unsigned int addr, unsigned char value);
+
+struct cpu12
+{
+	unsigned char a, b, ccr;
+	unsigned int x, y, sp, pc;
+
+	unsigned long long cycles;          // bus cycles since reset
+	unsigned long long instructions;
+
+	unsigned char mem[0x10000];         // logical 64K map; 0x8000-0xBFFF is shadowed by the PPAGE window
+	unsigned char flash[CPU12_PAGE_COUNT][CPU12_PAGE_SIZE];
+
+	cpu12_io_read_t io_read;
+	cpu12_io_write_t io_write;
+	void *user;
+
+	// Information about the last executed instruction, for profilers and tracers
+	unsigned int lastPc;
+	unsigned char lastOpcode, lastPage2;
+	unsigned int lastCycles;
+	int flowKind;                       // CPU12_FLOW_*
+	unsigned int flowTarget;
+
+	int romWriteCount;                  // writes into flash areas are ignored but counted
+	int waiting;                        // stopped in WAI until the next unmasked interrupt
+};
+
+// Control flow classification of the last executed instruction
+#define CPU12_FLOW_NONE     0
+#define CPU12_FLOW_CALL     1           // BSR, JSR, CALL
+#define CPU12_FLOW_RETURN   2           // RTS, RTC
+#define CPU12_FLOW_RTI      3
+#define CPU12_FLOW_IRQ      4           // interrupt or SWI entry
+#define CPU12_FLOW_JUMP     5           // BRA, LBRA, JMP (cpu12_decode only)
+#define CPU12_FLOW_BRANCH   6           // conditional branches and loop primitives (cpu12_decode only)
+#define CPU12_FLOW_STOP     7           // BGND, STOP, WAI, illegal opcodes (cpu12_decode only)
+
+#define CPU12_NO_TARGET     0xFFFFFFFFUL
+
+// Static description of one instruction, produced by cpu12_decode() without executing it
+typedef struct cpu12_insn
+{
+	unsigned int addr;
+	int length;                         // bytes
+	int cycles;                         // bus cycles; for branches the taken case
+	int cyclesNotTaken;                 // equal to 'cycles' for everything but branches
+	int flow;                           // CPU12_FLOW_*
+	unsigned long target;               // destination of direct branches, jumps and calls, else CPU12_NO_TARGET
+	int stackDelta;                     // SP change by pushes, pulls, LEAS and SP auto increment/decrement
+	char text[64];                      // mnemonic and operands
+} cpu12_insn_t;
+
+void cpu12_init(cpu12_t *cpu);
+void cpu12_reset(cpu12_t *cpu);
+
+// Loads a byte into the memory image; accepts the linker's paged addresses (0x308000 etc.) as well as logical ones
+void cpu12_load(cpu12_t *cpu, unsigned long addr, unsigned char value);
+
+unsigned char cpu12_read8(cpu12_t *cpu, unsigned int addr);
+unsigned int cpu12_read16(cpu12_t *cpu, unsigned int addr);
+void cpu12_write8(cpu12_t *cpu, unsigned int addr, unsigned char value);
+void cpu12_write16(cpu12_t *cpu, unsigned int addr, unsigned int value);
+
+// Executes one instruction and returns CPU12_OK or one of the stop reasons
+int cpu12_step(cpu12_t *cpu);
+
+// Stacks the CPU state and vectors through 'vector' (e.g. 0xFFEE for ECT channel 0), as for a hardware interrupt.
+// Returns 0 if the interrupt was masked by the I bit.
+int cpu12_interrupt(cpu12_t *cpu, unsigned int vector);
+
+// Decodes the instruction at 'addr' (through the current PPAGE window), returns its length in bytes
+int cpu12_decode(cpu12_t *cpu, unsigned int addr, cpu12_insn_t *insn);
+
+unsigned int cpu12_d(cpu12_t *cpu);
+void cpu12_set_d(cpu12_t *cpu, unsigned int d);
+
+#endif
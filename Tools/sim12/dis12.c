@@ -0,0 +1,594 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    dis12.c                                        *
+*          CPU12 instruction decoder / disassembler       *
+*---------------------------------------------------------*
+* Decodes length, HCS12 cycle count, control flow and     *
+* stack effect of an instruction without executing it.   *
+**********************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "cpu12.h"
+
+static const char *regNames[8] = {"A", "B", "CCR", "TMP3", "D", "X", "Y", "SP"};
+static const char *idxNames[4] = {"X", "Y", "SP", "PC"};
+static const char *branchNames[16] =
+{
+	"BRA", "BRN", "BHI", "BLS", "BCC", "BCS", "BNE", "BEQ",
+	"BVC", "BVS", "BPL", "BMI", "BGE", "BLT", "BGT", "BLE"
+};
+static const char *rmwNames[9] = {"NEG", "COM", "INC", "DEC", "LSR", "ROL", "ROR", "ASR", "ASL"};
+static const char *storeNames[6] = {"STAA", "STAB", "STD", "STY", "STX", "STS"};
+static const char *aluNames[2][16] =
+{
+	{"SUBA", "CMPA", "SBCA", "SUBD", "ANDA", "BITA", "LDAA", "", "EORA", "ADCA", "ORAA", "ADDA", "CPD", "CPY", "CPX", "CPS"},
+	{"SUBB", "CMPB", "SBCB", "ADDD", "ANDB", "BITB", "LDAB", "", "EORB", "ADCB", "ORAB", "ADDB", "LDD", "LDY", "LDX", "LDS"}
+};
+
+// Decodes the indexed postbyte at 'addr' into 'text'. Returns the number of postbyte and offset bytes.
+static int decodeIndexed(cpu12_t *cpu, unsigned int addr, int *cls, char *text, int *stackDelta)
+{
+	unsigned char xb = cpu12_read8(cpu, addr);
+	int rr, offset;
+
+	if ((xb & 0x20) == 0)
+	{
+		offset = xb & 0x1F;
+		if (offset & 0x10)
+			offset -= 0x20;
+		rr = (xb >> 6) & 3;
+		sprintf(text, "%d,%s", offset, idxNames[rr]);
+		*cls = IDX_0;
+		return 1;
+	}
+
+	if ((xb & 0xC0) != 0xC0)
+	{
+		rr = (xb >> 6) & 3;
+		offset = xb & 0x0F;
+		offset = (offset & 0x08) ? offset - 16 : offset + 1;
+		if (xb & 0x10)
+			sprintf(text, "%d,%s%s", offset < 0 ? -offset : offset, idxNames[rr], offset < 0 ? "-" : "+");
+		else
+			sprintf(text, "%d,%s%s", offset < 0 ? -offset : offset, offset < 0 ? "-" : "+", idxNames[rr]);
+		if (rr == 2)
+			*stackDelta += offset;
+		*cls = IDX_0;
+		return 1;
+	}
+
+	rr = (xb >> 3) & 3;
+	if ((xb & 0x04) == 0)
+	{
+		if ((xb & 0x02) == 0)
+		{
+			offset = cpu12_read8(cpu, addr + 1);
+			if (xb & 0x01)
+				offset -= 0x100;
+			sprintf(text, "%d,%s", offset, idxNames[rr]);
+			*cls = IDX_1;
+			return 2;
+		}
+		offset = (int)cpu12_read16(cpu, addr + 1);
+		if (xb & 0x01)
+		{
+			sprintf(text, "[%d,%s]", offset, idxNames[rr]);
+			*cls = IDX_2I;
+		}
+		else
+		{
+			if (offset & 0x8000)
+				offset -= 0x10000;
+			sprintf(text, "%d,%s", offset, idxNames[rr]);
+			*cls = IDX_2;
+		}
+		return 3;
+	}
+
+	switch (xb & 0x03)
+	{
+		case 0: sprintf(text, "A,%s", idxNames[rr]); *cls = IDX_0; break;
+		case 1: sprintf(text, "B,%s", idxNames[rr]); *cls = IDX_0; break;
+		case 2: sprintf(text, "D,%s", idxNames[rr]); *cls = IDX_0; break;
+		default: sprintf(text, "[D,%s]", idxNames[rr]); *cls = IDX_DI; break;
+	}
+	return 1;
+}
+
+// Constant displacement of a LEAS postbyte, used for stack frame allocation/release
+static int leasOffset(cpu12_t *cpu, unsigned int addr, int *known)
+{
+	unsigned char xb = cpu12_read8(cpu, addr);
+	int offset;
+
+	*known = 0;
+	if ((xb & 0x20) == 0 && ((xb >> 6) & 3) == 2)
+	{
+		offset = xb & 0x1F;
+		*known = 1;
+		return (offset & 0x10) ? offset - 0x20 : offset;
+	}
+	if ((xb & 0xE4) == 0xE0 && ((xb >> 3) & 3) == 2 && (xb & 0x03) != 0x03)
+	{
+		*known = 1;
+		if ((xb & 0x02) == 0)
+		{
+			offset = cpu12_read8(cpu, addr + 1);
+			return (xb & 0x01) ? offset - 0x100 : offset;
+		}
+		offset = (int)cpu12_read16(cpu, addr + 1);
+		return (offset & 0x8000) ? offset - 0x10000 : offset;
+	}
+	return 0;
+}
+
+static void setText(cpu12_insn_t *insn, const char *mnemonic, const char *operands)
+{
+	if (operands && operands[0])
+		sprintf(insn->text, "%-5s %s", mnemonic, operands);
+	else
+		sprintf(insn->text, "%s", mnemonic);
+}
+
+static int decodePage2(cpu12_t *cpu, unsigned int addr, cpu12_insn_t *insn);
+
+int cpu12_decode(cpu12_t *cpu, unsigned int addr, cpu12_insn_t *insn)
+{
+	unsigned char op = cpu12_read8(cpu, addr), post;
+	char ops[40], idx[24];
+	int cls = IDX_0, n, rel, known;
+
+	memset(insn, 0, sizeof(*insn));
+	insn->addr = addr;
+	insn->target = CPU12_NO_TARGET;
+	insn->length = 1;
+	insn->cycles = 1;
+	ops[0] = 0;
+
+	switch (op)
+	{
+		case 0x00: setText(insn, "BGND", 0); insn->cycles = 5; insn->flow = CPU12_FLOW_STOP; break;
+		case 0x01: setText(insn, "MEM", 0); insn->cycles = 5; break;
+		case 0x02: setText(insn, "INY", 0); break;
+		case 0x03: setText(insn, "DEY", 0); break;
+		case 0x08: setText(insn, "INX", 0); break;
+		case 0x09: setText(insn, "DEX", 0); break;
+		case 0x10: sprintf(ops, "#$%02X", cpu12_read8(cpu, addr + 1)); setText(insn, "ANDCC", ops); insn->length = 2; break;
+		case 0x14: sprintf(ops, "#$%02X", cpu12_read8(cpu, addr + 1)); setText(insn, "ORCC", ops); insn->length = 2; break;
+		case 0x11: setText(insn, "EDIV", 0); insn->cycles = 11; break;
+		case 0x12: setText(insn, "MUL", 0); break;
+		case 0x13: setText(insn, "EMUL", 0); insn->cycles = 3; break;
+
+		case 0x04:
+		{
+			static const char *loopNames[8] = {"DBEQ", "DBNE", "TBEQ", "TBNE", "IBEQ", "IBNE", "?", "?"};
+			post = cpu12_read8(cpu, addr + 1);
+			rel = cpu12_read8(cpu, addr + 2);
+			if (post & 0x10)
+				rel -= 0x100;
+			insn->length = 3;
+			insn->cycles = insn->cyclesNotTaken = 3;
+			insn->flow = CPU12_FLOW_BRANCH;
+			insn->target = (addr + 3 + rel) & 0xFFFF;
+			sprintf(ops, "%s,$%04lX", regNames[post & 7], insn->target);
+			setText(insn, loopNames[(post >> 5) & 7], ops);
+			return insn->length;
+		}
+
+		case 0x05:                          // JMP idx
+		case 0x15:                          // JSR idx
+			n = decodeIndexed(cpu, addr + 1, &cls, idx, &insn->stackDelta);
+			insn->length = 1 + n;
+			setText(insn, op == 0x05 ? "JMP" : "JSR", idx);
+			insn->cycles = cpu12_idxCycles[op == 0x05 ? IDXCYC_JMP : IDXCYC_JSR][cls];
+			insn->flow = op == 0x05 ? CPU12_FLOW_JUMP : CPU12_FLOW_CALL;
+			break;
+		case 0x06:
+		case 0x16:
+			insn->length = 3;
+			insn->target = cpu12_read16(cpu, addr + 1);
+			sprintf(ops, "$%04lX", insn->target);
+			setText(insn, op == 0x06 ? "JMP" : "JSR", ops);
+			insn->cycles = op == 0x06 ? 3 : 4;
+			insn->flow = op == 0x06 ? CPU12_FLOW_JUMP : CPU12_FLOW_CALL;
+			break;
+		case 0x17:
+			insn->length = 2;
+			insn->target = cpu12_read8(cpu, addr + 1);
+			sprintf(ops, "$%02lX", insn->target);
+			setText(insn, "JSR", ops);
+			insn->cycles = 4;
+			insn->flow = CPU12_FLOW_CALL;
+			break;
+		case 0x07:
+			insn->length = 2;
+			insn->target = (addr + 2 + (signed char)cpu12_read8(cpu, addr + 1)) & 0xFFFF;
+			sprintf(ops, "$%04lX", insn->target);
+			setText(insn, "BSR", ops);
+			insn->cycles = 4;
+			insn->flow = CPU12_FLOW_CALL;
+			break;
+		case 0x0A: setText(insn, "RTC", 0); insn->cycles = 7; insn->flow = CPU12_FLOW_RETURN; break;
+		case 0x0B: setText(insn, "RTI", 0); insn->cycles = 8; insn->flow = CPU12_FLOW_RTI; break;
+
+		case 0x0C: case 0x0D: case 0x1C: case 0x1D: case 0x4C: case 0x4D:
+		case 0x0E: case 0x0F: case 0x1E: case 0x1F: case 0x4E: case 0x4F:
+		{
+			int isBranch = (op & 0x02) != 0;
+			const char *name = isBranch ? ((op & 1) ? "BRCLR" : "BRSET") : ((op & 1) ? "BCLR" : "BSET");
+			if ((op & 0xF0) == 0x00)
+			{
+				n = decodeIndexed(cpu, addr + 1, &cls, idx, &insn->stackDelta);
+				insn->cycles = cpu12_idxCycles[isBranch ? IDXCYC_BRSET : IDXCYC_BSET][cls];
+			}
+			else if ((op & 0xF0) == 0x10)
+			{
+				n = 2;
+				sprintf(idx, "$%04X", cpu12_read16(cpu, addr + 1));
+				insn->cycles = isBranch ? 5 : 4;
+			}
+			else
+			{
+				n = 1;
+				sprintf(idx, "$%02X", cpu12_read8(cpu, addr + 1));
+				insn->cycles = 4;
+			}
+			insn->length = 2 + n + (isBranch ? 1 : 0);
+			if (isBranch)
+			{
+				rel = (signed char)cpu12_read8(cpu, addr + 2 + n);
+				insn->target = (addr + insn->length + rel) & 0xFFFF;
+				insn->flow = CPU12_FLOW_BRANCH;
+				sprintf(ops, "%s,#$%02X,$%04lX", idx, cpu12_read8(cpu, addr + 1 + n), insn->target);
+			}
+			else
+				sprintf(ops, "%s,#$%02X", idx, cpu12_read8(cpu, addr + 1 + n));
+			setText(insn, name, ops);
+			break;
+		}
+
+		case 0x18:
+			return decodePage2(cpu, addr, insn);
+
+		case 0x19: case 0x1A: case 0x1B:
+			n = decodeIndexed(cpu, addr + 1, &cls, idx, &insn->stackDelta);
+			insn->length = 1 + n;
+			insn->cycles = cpu12_idxCycles[IDXCYC_LEA][cls];
+			setText(insn, op == 0x19 ? "LEAY" : (op == 0x1A ? "LEAX" : "LEAS"), idx);
+			if (op == 0x1B)
+			{
+				rel = leasOffset(cpu, addr + 1, &known);
+				if (known)
+					insn->stackDelta = rel;
+			}
+			break;
+
+		case 0x20: case 0x21: case 0x22: case 0x23: case 0x24: case 0x25: case 0x26: case 0x27:
+		case 0x28: case 0x29: case 0x2A: case 0x2B: case 0x2C: case 0x2D: case 0x2E: case 0x2F:
+			insn->length = 2;
+			insn->target = (addr + 2 + (signed char)cpu12_read8(cpu, addr + 1)) & 0xFFFF;
+			sprintf(ops, "$%04lX", insn->target);
+			setText(insn, branchNames[op & 0x0F], ops);
+			if (op == 0x20)
+			{
+				insn->cycles = insn->cyclesNotTaken = 3;
+				insn->flow = CPU12_FLOW_JUMP;
+			}
+			else if (op == 0x21)
+				insn->cycles = insn->cyclesNotTaken = 1;
+			else
+			{
+				insn->cycles = 3;
+				insn->cyclesNotTaken = 1;
+				insn->flow = CPU12_FLOW_BRANCH;
+			}
+			return insn->length;
+
+		case 0x30: setText(insn, "PULX", 0); insn->cycles = 3; insn->stackDelta = 2; break;
+		case 0x31: setText(insn, "PULY", 0); insn->cycles = 3; insn->stackDelta = 2; break;
+		case 0x32: setText(insn, "PULA", 0); insn->cycles = 3; insn->stackDelta = 1; break;
+		case 0x33: setText(insn, "PULB", 0); insn->cycles = 3; insn->stackDelta = 1; break;
+		case 0x34: setText(insn, "PSHX", 0); insn->cycles = 2; insn->stackDelta = -2; break;
+		case 0x35: setText(insn, "PSHY", 0); insn->cycles = 2; insn->stackDelta = -2; break;
+		case 0x36: setText(insn, "PSHA", 0); insn->cycles = 2; insn->stackDelta = -1; break;
+		case 0x37: setText(insn, "PSHB", 0); insn->cycles = 2; insn->stackDelta = -1; break;
+		case 0x38: setText(insn, "PULC", 0); insn->cycles = 3; insn->stackDelta = 1; break;
+		case 0x39: setText(insn, "PSHC", 0); insn->cycles = 2; insn->stackDelta = -1; break;
+		case 0x3A: setText(insn, "PULD", 0); insn->cycles = 3; insn->stackDelta = 2; break;
+		case 0x3B: setText(insn, "PSHD", 0); insn->cycles = 2; insn->stackDelta = -2; break;
+		case 0x3C: setText(insn, "wavr", 0); insn->flow = CPU12_FLOW_STOP; break;
+		case 0x3D: setText(insn, "RTS", 0); insn->cycles = 5; insn->flow = CPU12_FLOW_RETURN; break;
+		case 0x3E: setText(insn, "WAI", 0); insn->cycles = 8; insn->stackDelta = -9; break;
+		case 0x3F: setText(insn, "SWI", 0); insn->cycles = 9; insn->flow = CPU12_FLOW_IRQ; break;
+
+		case 0x40: case 0x41: case 0x42: case 0x43: case 0x44: case 0x45: case 0x46: case 0x47: case 0x48:
+		case 0x50: case 0x51: case 0x52: case 0x53: case 0x54: case 0x55: case 0x56: case 0x57: case 0x58:
+			sprintf(ops, "%s%s", rmwNames[op & 0x0F], (op & 0x10) ? "B" : "A");
+			setText(insn, ops, 0);
+			break;
+		case 0x49: setText(insn, "LSRD", 0); break;
+		case 0x59: setText(insn, "ASLD", 0); break;
+
+		case 0x4A:
+			insn->length = 4;
+			insn->target = ((unsigned long)cpu12_read8(cpu, addr + 3) << 16) | cpu12_read16(cpu, addr + 1);
+			sprintf(ops, "$%04X,$%02X", cpu12_read16(cpu, addr + 1), cpu12_read8(cpu, addr + 3));
+			setText(insn, "CALL", ops);
+			insn->cycles = 7;
+			insn->flow = CPU12_FLOW_CALL;
+			break;
+		case 0x4B:
+			n = decodeIndexed(cpu, addr + 1, &cls, idx, &insn->stackDelta);
+			if (cls == IDX_DI || cls == IDX_2I)
+			{
+				insn->length = 1 + n;
+				setText(insn, "CALL", idx);
+			}
+			else
+			{
+				insn->length = 2 + n;
+				sprintf(ops, "%s,$%02X", idx, cpu12_read8(cpu, addr + 1 + n));
+				setText(insn, "CALL", ops);
+			}
+			insn->cycles = cpu12_idxCycles[IDXCYC_CALL][cls];
+			insn->flow = CPU12_FLOW_CALL;
+			break;
+
+		case 0x5A: case 0x5B: case 0x5C: case 0x5D: case 0x5E: case 0x5F:
+		case 0x6A: case 0x6B: case 0x6C: case 0x6D: case 0x6E: case 0x6F:
+		case 0x7A: case 0x7B: case 0x7C: case 0x7D: case 0x7E: case 0x7F:
+			if ((op & 0xF0) == 0x50)
+			{
+				insn->length = 2;
+				sprintf(ops, "$%02X", cpu12_read8(cpu, addr + 1));
+				insn->cycles = 2;
+			}
+			else if ((op & 0xF0) == 0x60)
+			{
+				n = decodeIndexed(cpu, addr + 1, &cls, ops, &insn->stackDelta);
+				insn->length = 1 + n;
+				insn->cycles = cpu12_idxCycles[IDXCYC_WRITE][cls];
+			}
+			else
+			{
+				insn->length = 3;
+				sprintf(ops, "$%04X", cpu12_read16(cpu, addr + 1));
+				insn->cycles = 3;
+			}
+			setText(insn, storeNames[(op & 0x0F) - 0x0A], ops);
+			break;
+
+		case 0x60: case 0x61: case 0x62: case 0x63: case 0x64: case 0x65: case 0x66: case 0x67: case 0x68: case 0x69:
+		case 0x70: case 0x71: case 0x72: case 0x73: case 0x74: case 0x75: case 0x76: case 0x77: case 0x78: case 0x79:
+			if (op & 0x10)
+			{
+				insn->length = 3;
+				sprintf(ops, "$%04X", cpu12_read16(cpu, addr + 1));
+				insn->cycles = (op == 0x79) ? 3 : 4;
+			}
+			else
+			{
+				n = decodeIndexed(cpu, addr + 1, &cls, ops, &insn->stackDelta);
+				insn->length = 1 + n;
+				insn->cycles = cpu12_idxCycles[(op == 0x69) ? IDXCYC_WRITE : IDXCYC_RMW][cls];
+			}
+			setText(insn, (op & 0x0F) == 0x09 ? "CLR" : rmwNames[op & 0x0F], ops);
+			break;
+
+		case 0x87: setText(insn, "CLRA", 0); break;
+		case 0xC7: setText(insn, "CLRB", 0); break;
+		case 0x97: setText(insn, "TSTA", 0); break;
+		case 0xD7: setText(insn, "TSTB", 0); break;
+		case 0xA7: setText(insn, "NOP", 0); break;
+		case 0xB7:
+			post = cpu12_read8(cpu, addr + 1);
+			insn->length = 2;
+			sprintf(ops, "%s,%s", regNames[(post >> 4) & 7], regNames[post & 7]);
+			if (post & 0x80)
+				setText(insn, "EXG", ops);
+			else if ((post & 0x77) == 0x27 || (post & 0x77) == 0x72)
+				setText(insn, "TFR", ops);
+			else if (!((post >> 4) & 4) && (post & 4))
+				setText(insn, "SEX", ops);
+			else
+				setText(insn, "TFR", ops);
+			break;
+		case 0xE7:
+			n = decodeIndexed(cpu, addr + 1, &cls, ops, &insn->stackDelta);
+			insn->length = 1 + n;
+			insn->cycles = cpu12_idxCycles[IDXCYC_READ][cls];
+			setText(insn, "TST", ops);
+			break;
+		case 0xF7:
+			insn->length = 3;
+			sprintf(ops, "$%04X", cpu12_read16(cpu, addr + 1));
+			insn->cycles = 3;
+			setText(insn, "TST", ops);
+			break;
+
+		default:
+		{
+			int mode = (op >> 4) & 3, col = op & 0x0F, hi = op >= 0xC0;
+			int wide = col == 0x3 || col >= 0xC;
+
+			if (op < 0x80)
+			{
+				setText(insn, "TRAP", 0);
+				insn->flow = CPU12_FLOW_STOP;
+				break;
+			}
+			if (mode == 0)
+			{
+				insn->length = wide ? 3 : 2;
+				if (wide)
+					sprintf(ops, "#$%04X", cpu12_read16(cpu, addr + 1));
+				else
+					sprintf(ops, "#$%02X", cpu12_read8(cpu, addr + 1));
+				insn->cycles = wide ? 2 : 1;
+			}
+			else if (mode == 1)
+			{
+				insn->length = 2;
+				sprintf(ops, "$%02X", cpu12_read8(cpu, addr + 1));
+				insn->cycles = 3;
+			}
+			else if (mode == 3)
+			{
+				insn->length = 3;
+				sprintf(ops, "$%04X", cpu12_read16(cpu, addr + 1));
+				insn->cycles = 3;
+			}
+			else
+			{
+				n = decodeIndexed(cpu, addr + 1, &cls, ops, &insn->stackDelta);
+				insn->length = 1 + n;
+				insn->cycles = cpu12_idxCycles[IDXCYC_READ][cls];
+			}
+			setText(insn, aluNames[hi][col], ops);
+			break;
+		}
+	}
+
+	insn->cyclesNotTaken = insn->cycles;
+	return insn->length;
+}
+
+static int decodePage2(cpu12_t *cpu, unsigned int addr, cpu12_insn_t *insn)
+{
+	unsigned char op = cpu12_read8(cpu, addr + 1);
+	char ops[56], src[24], dst[24];
+	int cls = IDX_0, n, m, rel;
+
+	ops[0] = 0;
+	insn->length = 2;
+	insn->cycles = 2;
+
+	switch (op)
+	{
+		case 0x00: case 0x01: case 0x02: case 0x03: case 0x04: case 0x05:
+		case 0x08: case 0x09: case 0x0A: case 0x0B: case 0x0C: case 0x0D:
+		{
+			const char *name = (op & 0x08) ? "MOVB" : "MOVW";
+			int wide = (op & 0x08) == 0;
+			switch (op & 0x07)
+			{
+				case 0:     // #,idx
+					n = decodeIndexed(cpu, addr + 2, &cls, dst, &insn->stackDelta);
+					if (wide)
+						sprintf(src, "#$%04X", cpu12_read16(cpu, addr + 2 + n));
+					else
+						sprintf(src, "#$%02X", cpu12_read8(cpu, addr + 2 + n));
+					insn->length = 2 + n + (wide ? 2 : 1);
+					insn->cycles = 4;
+					break;
+				case 1:     // ext,idx
+					n = decodeIndexed(cpu, addr + 2, &cls, dst, &insn->stackDelta);
+					sprintf(src, "$%04X", cpu12_read16(cpu, addr + 2 + n));
+					insn->length = 4 + n;
+					insn->cycles = 5;
+					break;
+				case 2:     // idx,idx
+					n = decodeIndexed(cpu, addr + 2, &cls, src, &insn->stackDelta);
+					m = decodeIndexed(cpu, addr + 2 + n, &cls, dst, &insn->stackDelta);
+					insn->length = 2 + n + m;
+					insn->cycles = 5;
+					break;
+				case 3:     // #,ext
+					if (wide)
+						sprintf(src, "#$%04X", cpu12_read16(cpu, addr + 2));
+					else
+						sprintf(src, "#$%02X", cpu12_read8(cpu, addr + 2));
+					n = wide ? 2 : 1;
+					sprintf(dst, "$%04X", cpu12_read16(cpu, addr + 2 + n));
+					insn->length = 4 + n;
+					insn->cycles = wide ? 5 : 4;
+					break;
+				case 4:     // ext,ext
+					sprintf(src, "$%04X", cpu12_read16(cpu, addr + 2));
+					sprintf(dst, "$%04X", cpu12_read16(cpu, addr + 4));
+					insn->length = 6;
+					insn->cycles = 6;
+					break;
+				default:    // idx,ext
+					n = decodeIndexed(cpu, addr + 2, &cls, src, &insn->stackDelta);
+					sprintf(dst, "$%04X", cpu12_read16(cpu, addr + 2 + n));
+					insn->length = 4 + n;
+					insn->cycles = 5;
+					break;
+			}
+			sprintf(ops, "%s,%s", src, dst);
+			setText(insn, name, ops);
+			break;
+		}
+
+		case 0x06: setText(insn, "ABA", 0); break;
+		case 0x07: setText(insn, "DAA", 0); insn->cycles = 3; break;
+		case 0x0E: setText(insn, "TAB", 0); break;
+		case 0x0F: setText(insn, "TBA", 0); break;
+		case 0x16: setText(insn, "SBA", 0); break;
+		case 0x17: setText(insn, "CBA", 0); break;
+		case 0x10: setText(insn, "IDIV", 0); insn->cycles = 12; break;
+		case 0x11: setText(insn, "FDIV", 0); insn->cycles = 12; break;
+		case 0x15: setText(insn, "IDIVS", 0); insn->cycles = 12; break;
+		case 0x14: setText(insn, "EDIVS", 0); insn->cycles = 12; break;
+		case 0x13: setText(insn, "EMULS", 0); insn->cycles = 3; break;
+		case 0x12:
+			sprintf(ops, "$%04X", cpu12_read16(cpu, addr + 2));
+			setText(insn, "EMACS", ops);
+			insn->length = 4;
+			insn->cycles = 13;
+			break;
+
+		case 0x18: case 0x19: case 0x1A: case 0x1B: case 0x1C: case 0x1D: case 0x1E: case 0x1F:
+		{
+			static const char *names[8] = {"MAXA", "MINA", "EMAXD", "EMIND", "MAXM", "MINM", "EMAXM", "EMINM"};
+			n = decodeIndexed(cpu, addr + 2, &cls, ops, &insn->stackDelta);
+			insn->length = 2 + n;
+			insn->cycles = cpu12_idxCycles[(op & 0x04) ? IDXCYC_MINM : IDXCYC_MIN][cls];
+			setText(insn, names[op & 7], ops);
+			break;
+		}
+
+		case 0x20: case 0x21: case 0x22: case 0x23: case 0x24: case 0x25: case 0x26: case 0x27:
+		case 0x28: case 0x29: case 0x2A: case 0x2B: case 0x2C: case 0x2D: case 0x2E: case 0x2F:
+			rel = (int)cpu12_read16(cpu, addr + 2);
+			if (rel & 0x8000)
+				rel -= 0x10000;
+			insn->length = 4;
+			insn->target = (addr + 4 + rel) & 0xFFFF;
+			sprintf(ops, "$%04lX", insn->target);
+			sprintf(src, "L%s", branchNames[op & 0x0F]);
+			setText(insn, src, ops);
+			if (op == 0x20)
+			{
+				insn->cycles = insn->cyclesNotTaken = 4;
+				insn->flow = CPU12_FLOW_JUMP;
+			}
+			else if (op == 0x21)
+				insn->cycles = insn->cyclesNotTaken = 3;
+			else
+			{
+				insn->cycles = 4;
+				insn->cyclesNotTaken = 3;
+				insn->flow = CPU12_FLOW_BRANCH;
+			}
+			return insn->length;
+
+		case 0x3A: setText(insn, "REV", 0); insn->flow = CPU12_FLOW_STOP; break;
+		case 0x3B: setText(insn, "REVW", 0); insn->flow = CPU12_FLOW_STOP; break;
+		case 0x3C: setText(insn, "WAV", 0); insn->flow = CPU12_FLOW_STOP; break;
+		case 0x3D: case 0x3F:
+			n = decodeIndexed(cpu, addr + 2, &cls, ops, &insn->stackDelta);
+			insn->length = 2 + n;
+			insn->cycles = op == 0x3D ? 6 : 10;
+			setText(insn, op == 0x3D ? "TBL" : "ETBL", ops);
+			break;
+		case 0x3E: setText(insn, "STOP", 0); insn->cycles = 8; insn->flow = CPU12_FLOW_STOP; break;
+		default:   setText(insn, "TRAP", 0); insn->flow = CPU12_FLOW_STOP; break;
+	}
+
+	insn->cyclesNotTaken = insn->cycles;
+	return insn->length;
+}
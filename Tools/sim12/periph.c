@@ -0,0 +1,205 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    periph.c                                       *
+*          Peripheral models for the CPU12 simulator      *
+**********************************************************/
+
+#include <string.h>
+#include "periph.h"
+
+#define TSCR1_TEN       0x80
+#define TSCR1_TFFCA     0x10
+#define TSCR2_TOI       0x80
+#define TSCR2_TCRE      0x08
+#define TFLG2_TOF       0x80
+#define CRGFLG_LOCK     0x08
+#define SPICR1_SPIE     0x80
+#define SPICR1_SPE      0x40
+#define SPICR1_SPTIE    0x20
+#define SPISR_SPIF      0x80
+#define SPISR_SPTEF     0x20
+
+static unsigned int tc(cpu12_t *cpu, int n)
+{
+	return ((unsigned int)cpu->mem[REG_TC0 + 2 * n] << 8) | cpu->mem[REG_TC0 + 2 * n + 1];
+}
+
+// Bus cycles per SPI bit: (SPPR + 1) * 2^(SPR + 1)
+static unsigned long spiBitCycles(cpu12_t *cpu)
+{
+	unsigned char br = cpu->mem[REG_SPI0BR];
+	return (unsigned long)(((br >> 4) & 7) + 1) << ((br & 7) + 1);
+}
+
+static void spiStart(periph_t *p, cpu12_t *cpu, unsigned char value)
+{
+	p->spiShift = value;
+	p->spiShifting = 1;
+	p->spiRemaining = 8 * spiBitCycles(cpu);
+	cpu->mem[REG_SPI0SR] |= SPISR_SPTEF;
+}
+
+static unsigned char ioRead(cpu12_t *cpu, unsigned int addr)
+{
+	periph_t *p = (periph_t *)cpu->user;
+	int n;
+
+	switch (addr)
+	{
+		case REG_TCNT:
+			if (cpu->mem[REG_TSCR1] & TSCR1_TFFCA)
+				cpu->mem[REG_TFLG2] &= (unsigned char)~TFLG2_TOF;
+			return (unsigned char)(p->tcnt >> 8);
+		case REG_TCNT + 1:
+			return (unsigned char)p->tcnt;
+		case REG_CRGFLG:
+			return cpu->mem[addr] | CRGFLG_LOCK;    // the PLL locks immediately
+		case REG_SPI0DR:
+			cpu->mem[REG_SPI0SR] &= (unsigned char)~SPISR_SPIF;
+			return cpu->mem[addr];
+	}
+
+	if (addr >= REG_TC0 && addr < REG_TC0 + 16 && (cpu->mem[REG_TSCR1] & TSCR1_TFFCA))
+	{
+		n = (addr - REG_TC0) / 2;
+		cpu->mem[REG_TFLG1] &= (unsigned char)~(1 << n);
+	}
+	return cpu->mem[addr];
+}
+
+static void ioWrite(cpu12_t *cpu, unsigned int addr, unsigned char value)
+{
+	periph_t *p = (periph_t *)cpu->user;
+	int n;
+
+	switch (addr)
+	{
+		case REG_TFLG1:
+		case REG_TFLG2:
+		case REG_PIFP:
+			cpu->mem[addr] &= (unsigned char)~value;   // write 1 to clear
+			return;
+		case REG_TCNT:
+		case REG_TCNT + 1:
+			return;                                     // writes have no effect in normal modes
+		case REG_CRGFLG:
+			cpu->mem[addr] &= (unsigned char)~(value & 0x90);
+			return;
+		case REG_SPI0SR:
+			return;
+		case REG_SPI0DR:
+			if (!(cpu->mem[REG_SPI0CR1] & SPICR1_SPE))
+				return;
+			if (!p->spiShifting)
+				spiStart(p, cpu, value);
+			else
+			{
+				p->spiNext = value;
+				p->spiPending = 1;
+				cpu->mem[REG_SPI0SR] &= (unsigned char)~SPISR_SPTEF;
+			}
+			return;
+		case REG_SPI0CR1:
+			cpu->mem[addr] = value;
+			if (value & SPICR1_SPE)
+				cpu->mem[REG_SPI0SR] |= SPISR_SPTEF;
+			return;
+	}
+
+	if (addr >= REG_TC0 && addr < REG_TC0 + 16 && (cpu->mem[REG_TSCR1] & TSCR1_TFFCA))
+	{
+		n = (addr - REG_TC0) / 2;
+		cpu->mem[REG_TFLG1] &= (unsigned char)~(1 << n);
+	}
+	cpu->mem[addr] = value;
+}
+
+void periph_attach(periph_t *p, cpu12_t *cpu)
+{
+	memset(p, 0, sizeof(*p));
+	cpu->user = p;
+	cpu->io_read = ioRead;
+	cpu->io_write = ioWrite;
+	cpu->mem[REG_SPI0SR] = SPISR_SPTEF;
+	cpu->mem[REG_SPI0BR] = 0;
+}
+
+static void timerTick(periph_t *p, cpu12_t *cpu)
+{
+	unsigned char tios = cpu->mem[REG_TIOS];
+	int n;
+
+	p->tcnt = (p->tcnt + 1) & 0xFFFF;
+	if (p->tcnt == 0)
+		cpu->mem[REG_TFLG2] |= TFLG2_TOF;
+
+	if (tios)
+	{
+		for (n = 0; n < 8; n++)
+			if ((tios & (1 << n)) && tc(cpu, n) == p->tcnt)
+				cpu->mem[REG_TFLG1] |= (unsigned char)(1 << n);
+		// TCRE: channel 7 compare resets the counter
+		if ((cpu->mem[REG_TSCR2] & TSCR2_TCRE) && (tios & 0x80) && tc(cpu, 7) == p->tcnt)
+			p->tcnt = 0xFFFF;
+	}
+}
+
+void periph_tick(periph_t *p, cpu12_t *cpu, unsigned int cycles)
+{
+	unsigned int prescale;
+
+	if (cpu->mem[REG_TSCR1] & TSCR1_TEN)
+	{
+		prescale = 1u << (cpu->mem[REG_TSCR2] & 7);
+		p->prescaleCount += cycles;
+		while (p->prescaleCount >= prescale)
+		{
+			p->prescaleCount -= prescale;
+			timerTick(p, cpu);
+		}
+	}
+
+	if (p->spiShifting)
+	{
+		if (p->spiRemaining > cycles)
+			p->spiRemaining -= cycles;
+		else
+		{
+			// Byte done. The monitor board has nothing on MISO, so the received byte reads back 0xFF.
+			p->spiShifting = 0;
+			p->spiBytes++;
+			if (p->spiTx)
+				p->spiTx(p->spiContext, p->spiShift);
+			cpu->mem[REG_SPI0DR] = 0xFF;
+			cpu->mem[REG_SPI0SR] |= SPISR_SPIF;
+			if (p->spiPending)
+			{
+				p->spiPending = 0;
+				spiStart(p, cpu, p->spiNext);
+			}
+		}
+	}
+}
+
+unsigned int periph_pending(periph_t *p, cpu12_t *cpu)
+{
+	unsigned char flags = cpu->mem[REG_TFLG1] & cpu->mem[REG_TIE];
+	unsigned char spcr1 = cpu->mem[REG_SPI0CR1], spsr = cpu->mem[REG_SPI0SR];
+	unsigned int vector = 0;
+	int n;
+
+	(void)p;
+	// Higher vector addresses have higher priority
+	for (n = 0; n < 8 && !vector; n++)
+		if (flags & (1 << n))
+			vector = VECTOR_ECT(n);
+	if (!vector && (cpu->mem[REG_TFLG2] & TFLG2_TOF) && (cpu->mem[REG_TSCR2] & TSCR2_TOI))
+		vector = VECTOR_TOF;
+	if (!vector && (spcr1 & SPICR1_SPE)
+		&& (((spcr1 & SPICR1_SPIE) && (spsr & SPISR_SPIF)) || ((spcr1 & SPICR1_SPTIE) && (spsr & SPISR_SPTEF))))
+		vector = VECTOR_SPI0;
+	if (!vector && (cpu->mem[REG_PIFP] & cpu->mem[REG_PIEP]))
+		vector = VECTOR_PORTP;
+	return vector;
+}
@@ -0,0 +1,69 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    periph.h                                       *
+*          Peripheral models for the CPU12 simulator      *
+*---------------------------------------------------------*
+* Models the parts of the MC9S12DG256 the labs rely on    *
+* for timing: the ECT free-running counter, output        *
+* compare and overflow flags/interrupts, SPI0 transfer    *
+* timing, the Port P interrupt flags and the CRG lock     *
+* bit. All other registers behave as plain memory.        *
+**********************************************************/
+
+#ifndef _PERIPH_H
+#define _PERIPH_H
+
+#include "cpu12.h"
+
+// Register addresses (see mc9s12dg256.h)
+#define REG_PPAGE       0x0030
+#define REG_CRGFLG      0x0037
+#define REG_TIOS        0x0040
+#define REG_TCNT        0x0044
+#define REG_TSCR1       0x0046
+#define REG_TIE         0x004C
+#define REG_TSCR2       0x004D
+#define REG_TFLG1       0x004E
+#define REG_TFLG2       0x004F
+#define REG_TC0         0x0050
+#define REG_SPI0CR1     0x00D8
+#define REG_SPI0BR      0x00DA
+#define REG_SPI0SR      0x00DB
+#define REG_SPI0DR      0x00DD
+#define REG_PIEP        0x025E
+#define REG_PIFP        0x025F
+
+// Interrupt vectors
+#define VECTOR_ECT(n)   (0xFFEE - 2 * (n))
+#define VECTOR_TOF      0xFFDE
+#define VECTOR_SPI0     0xFFD8
+#define VECTOR_PORTP    0xFF8E
+#define VECTOR_COUNT    64                  // 0xFF80-0xFFFF
+
+typedef struct periph
+{
+	unsigned int tcnt;
+	unsigned int prescaleCount;
+
+	// SPI0: one byte in the shifter plus one waiting in the data register
+	int spiShifting, spiPending;
+	unsigned long spiRemaining;             // bus cycles until the byte in the shifter is done
+	unsigned char spiShift, spiNext;
+	unsigned long spiBytes;
+	void (*spiTx)(void *context, unsigned char value);
+	void *spiContext;
+
+	unsigned long interruptCount[VECTOR_COUNT];
+} periph_t;
+
+// Installs the register hooks of 'cpu' (uses cpu->user)
+void periph_attach(periph_t *p, cpu12_t *cpu);
+
+// Advances the peripherals by the bus cycles of the last instruction
+void periph_tick(periph_t *p, cpu12_t *cpu, unsigned int cycles);
+
+// Vector of the highest priority enabled and pending interrupt, or 0
+unsigned int periph_pending(periph_t *p, cpu12_t *cpu);
+
+#endif
@@ -0,0 +1,316 @@
+/**********************************************************
+* MIE 438 - Microprocessors and Embedded Microcontrollers *
+*---------------------------------------------------------*
+* File:    sim12.c                                        *
+*          Runs a lab's .s19 image on the host and        *
+*          reports where the bus cycles went              *
+*---------------------------------------------------------*
+* Usage: sim12 [options] image.s19                        *
+*   -m file.map  function names for the profile           *
+*   -c cycles    stop after this many bus cycles          *
+*   -s symbol    stop when execution reaches 'symbol'     *
+*   -b hz        bus clock used to convert to time        *
+*   -t           trace every instruction to stderr        *
+**********************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "cpu12.h"
+#include "periph.h"
+#include "../lib/s19.h"
+#include "../lib/mapfile.h"
+
+#define DEFAULT_CYCLES  100000000ULL
+#define DEFAULT_BUS_HZ  8000000UL       // 16MHz crystal without the PLL (Lab 9); Lab 8 runs the PLL at 24MHz
+#define MAX_FRAMES      256
+
+// Pseudo functions ahead of the map's procedures
+#define UNKNOWN         0
+#define IDLE            1
+
+typedef struct function
+{
+	const char *name;
+	unsigned long addr;
+	unsigned long calls;
+	unsigned long long self, inclusive;
+	int depth;
+} function_t;
+
+typedef struct frame
+{
+	int function;
+	unsigned int sp;                    // SP right after the return address / interrupt frame was stacked
+	unsigned long long entry;
+} frame_t;
+
+static cpu12_t cpu;
+static periph_t periph;
+static map_file_t map;
+static function_t *functions;
+static int functionCount;
+static short owner[0x10000];            // function index of each non-banked address, -1 if unknown
+static frame_t frames[MAX_FRAMES];
+static int frameCount;
+static unsigned int lowestSp = 0x10000; // deepest the stack has reached, SP being 0 until the firmware sets it
+
+static void loadByte(void *context, unsigned long addr, unsigned char value)
+{
+	cpu12_load((cpu12_t *)context, addr, value);
+}
+
+static void buildFunctions(void)
+{
+	int i, f;
+	unsigned long a;
+
+	memset(owner, 0xFF, sizeof(owner));
+	functions = calloc((size_t)map.symbolCount + 2, sizeof(*functions));
+	functions[UNKNOWN].name = "(unknown)";
+	functions[IDLE].name = "(idle in WAI)";
+	functionCount = 2;
+	for (i = 0; i < map.symbolCount; i++)
+	{
+		const map_symbol_t *s = &map.symbols[i];
+		if (s->kind != MAP_PROCEDURE)
+			continue;
+		f = functionCount++;
+		functions[f].name = s->name;
+		functions[f].addr = s->addr;
+		if (s->addr <= 0xFFFF)
+			for (a = s->addr; a < s->addr + s->size && a <= 0xFFFF; a++)
+				owner[a] = (short)f;
+	}
+}
+
+// Function owning a logical address, looking banked code up through the current PPAGE
+static int functionAt(unsigned int addr)
+{
+	const map_symbol_t *s;
+	int i, f;
+
+	if (addr < CPU12_WINDOW_START || addr >= CPU12_WINDOW_END)
+		return owner[addr] < 0 ? UNKNOWN : owner[addr];
+
+	s = map_procedure_at(&map, ((unsigned long)cpu.mem[CPU12_PPAGE_ADDR] << 16) | addr);
+	if (!s)
+		return owner[addr] < 0 ? UNKNOWN : owner[addr];
+	for (i = 0, f = 2; i < map.symbolCount; i++)
+	{
+		if (&map.symbols[i] == s)
+			return f;
+		if (map.symbols[i].kind == MAP_PROCEDURE)
+			f++;
+	}
+	return UNKNOWN;
+}
+
+static void enter(int f, unsigned long long entry)
+{
+	functions[f].calls++;
+	functions[f].depth++;
+	if (frameCount < MAX_FRAMES)
+	{
+		frames[frameCount].function = f;
+		frames[frameCount].sp = cpu.sp;
+		frames[frameCount].entry = entry;
+		frameCount++;
+	}
+}
+
+static void leave(frame_t *fr, unsigned long long now)
+{
+	function_t *fn = &functions[fr->function];
+
+	// Recursive activations are already covered by the outermost one
+	if (--fn->depth == 0)
+		fn->inclusive += now - fr->entry;
+}
+
+// Drops every frame whose stacked return information lies below SP, i.e. has been pulled
+static void unwind(unsigned long long now)
+{
+	while (frameCount > 0 && frames[frameCount - 1].sp < cpu.sp)
+		leave(&frames[--frameCount], now);
+}
+
+// A jump to the first instruction of another function (e.g. "JMP shortWait" ending writeLCDValue) is a
+// tail call: the new function takes over the caller's frame and returns on its behalf
+static void tailCall(unsigned long long now)
+{
+	int f = functionAt(cpu.pc);
+	frame_t *top;
+
+	if (f == UNKNOWN || functions[f].addr != cpu.pc || f == functionAt(cpu.lastPc) || frameCount == 0)
+		return;
+	top = &frames[frameCount - 1];
+	leave(top, now);
+	functions[f].calls++;
+	functions[f].depth++;
+	top->function = f;
+	top->entry = now;
+}
+
+static void trace(void)
+{
+	cpu12_insn_t insn;
+	int f = functionAt(cpu.pc);
+
+	cpu12_decode(&cpu, cpu.pc, &insn);
+	fprintf(stderr, "%10llu %04X %-14.14s %-26s A=%02X B=%02X X=%04X Y=%04X SP=%04X CCR=%02X\n",
+		cpu.cycles, cpu.pc, functions[f].name, insn.text, cpu.a, cpu.b, cpu.x, cpu.y, cpu.sp, cpu.ccr);
+}
+
+static int compareSelf(const void *a, const void *b)
+{
+	const function_t *fa = (const function_t *)a, *fb = (const function_t *)b;
+
+	if (fa->self != fb->self)
+		return fa->self < fb->self ? 1 : -1;
+	return 0;
+}
+
+static void report(const char *reason, unsigned long busHz)
+{
+	unsigned long long total = cpu.cycles ? cpu.cycles : 1;
+	int i;
+
+	printf("Stopped: %s at PC=%04X\n", reason, cpu.pc);
+	printf("Bus cycles:    %llu (%.3f ms at %.1f MHz)\n", cpu.cycles, cpu.cycles * 1000.0 / busHz, busHz / 1e6);
+	printf("Instructions:  %llu (%.2f cycles/instruction)\n", cpu.instructions,
+		cpu.instructions ? (double)cpu.cycles / cpu.instructions : 0.0);
+	printf("SPI bytes:     %lu\n", periph.spiBytes);
+	if (cpu.romWriteCount)
+		printf("Writes to ROM: %d (ignored)\n", cpu.romWriteCount);
+	for (i = 0; i < VECTOR_COUNT; i++)
+		if (periph.interruptCount[i])
+			printf("Interrupts:    %lu through vector %04X\n", periph.interruptCount[i], 0xFF80 + 2 * i);
+	for (i = 0; i < map.sectionCount && strcmp(map.sections[i].name, ".stack") != 0; i++)
+		;
+	if (i < map.sectionCount && lowestSp <= map.sections[i].to + 1)
+		printf("Stack:         %lu of %lu bytes (SP down to %04X)\n", map.sections[i].to + 1 - lowestSp,
+			map.sections[i].size, lowestSp);
+	else if (lowestSp < 0x10000)
+		printf("Stack:         SP down to %04X\n", lowestSp);
+
+	qsort(functions, (size_t)functionCount, sizeof(*functions), compareSelf);
+	printf("\n%-24s %10s %14s %7s %14s %12s\n", "Function", "Calls", "Self cycles", "Self%", "Inclusive", "Cycles/call");
+	for (i = 0; i < functionCount; i++)
+	{
+		function_t *fn = &functions[i];
+		if (!fn->self && !fn->calls)
+			continue;
+		printf("%-24.24s %10lu %14llu %6.2f%% %14llu %12.1f\n", fn->name, fn->calls, fn->self,
+			100.0 * fn->self / total, fn->inclusive, fn->calls ? (double)fn->inclusive / fn->calls : 0.0);
+	}
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "usage: sim12 [-m file.map] [-c cycles] [-s symbol] [-b hz] [-t] image.s19\n");
+	exit(2);
+}
+
+int main(int argc, char **argv)
+{
+	const char *mapPath = NULL, *stopSymbol = NULL, *reason = "cycle limit";
+	unsigned long long maxCycles = DEFAULT_CYCLES, before;
+	unsigned long busHz = DEFAULT_BUS_HZ;
+	unsigned long stopAddr = CPU12_NO_TARGET;
+	unsigned int vector;
+	int opt, tracing = 0, status, f, i;
+
+	while ((opt = getopt(argc, argv, "m:c:s:b:t")) != -1)
+	{
+		switch (opt)
+		{
+			case 'm': mapPath = optarg; break;
+			case 'c': maxCycles = strtoull(optarg, NULL, 0); break;
+			case 's': stopSymbol = optarg; break;
+			case 'b': busHz = strtoul(optarg, NULL, 0); break;
+			case 't': tracing = 1; break;
+			default: usage();
+		}
+	}
+	if (optind != argc - 1 || busHz == 0)
+		usage();
+
+	cpu12_init(&cpu);
+	if (s19_load(argv[optind], loadByte, &cpu, NULL) < 0)
+		return 1;
+	if (mapPath && map_load(mapPath, &map) < 0)
+		return 1;
+	buildFunctions();
+	if (stopSymbol)
+	{
+		const map_symbol_t *s = map_find(&map, stopSymbol);
+		if (!s)
+		{
+			fprintf(stderr, "%s: not in the map\n", stopSymbol);
+			return 1;
+		}
+		stopAddr = s->addr & 0xFFFF;
+	}
+
+	periph_attach(&periph, &cpu);
+	cpu12_reset(&cpu);
+	enter(functionAt(cpu.pc), 0);
+	frames[0].sp = 0x10000;             // the reset frame is never returned from
+
+	while (cpu.cycles < maxCycles)
+	{
+		if (cpu.pc == stopAddr)
+		{
+			reason = stopSymbol;
+			break;
+		}
+
+		vector = periph_pending(&periph, &cpu);
+		before = cpu.cycles;
+		if (vector && cpu12_interrupt(&cpu, vector))
+		{
+			periph.interruptCount[(vector - 0xFF80) / 2]++;
+			f = functionAt(cpu.pc);
+			functions[f].self += cpu.cycles - before;
+			enter(f, before);
+			periph_tick(&periph, &cpu, (unsigned int)(cpu.cycles - before));
+			if (cpu.sp < lowestSp)
+				lowestSp = cpu.sp;
+			continue;
+		}
+
+		if (tracing)
+			trace();
+		f = cpu.waiting ? IDLE : functionAt(cpu.pc);
+		status = cpu12_step(&cpu);
+		functions[f].self += cpu.lastCycles;
+		periph_tick(&periph, &cpu, cpu.lastCycles);
+		if (cpu.sp && cpu.sp < lowestSp)
+			lowestSp = cpu.sp;
+
+		if (status != CPU12_OK)
+		{
+			reason = status == CPU12_HALT ? "halted (BGND/STOP/WAI with I set)" :
+				status == CPU12_ILLEGAL ? "illegal opcode" : "unsupported fuzzy logic instruction";
+			break;
+		}
+		if (cpu.flowKind == CPU12_FLOW_CALL)
+			enter(functionAt(cpu.pc), cpu.cycles - cpu.lastCycles);
+		else if (cpu.flowKind == CPU12_FLOW_RETURN || cpu.flowKind == CPU12_FLOW_RTI)
+			unwind(cpu.cycles);
+		else
+			tailCall(cpu.cycles);
+	}
+
+	// Charge functions still active at the end of the run
+	while (frameCount > 0)
+		leave(&frames[--frameCount], cpu.cycles);
+	for (i = 0; i < functionCount; i++)
+		functions[i].depth = 0;
+
+	report(reason, busHz);
+	map_free(&map);
+	return 0;
+}